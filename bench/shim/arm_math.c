@@ -0,0 +1,97 @@
+#include "arm_math.h"
+
+#include <math.h>
+#include <string.h>
+
+const arm_cfft_instance_q15 arm_cfft_sR_q15_len256 = { 256 };
+
+static q15_t sat_q15(int64_t v) {
+    return v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : (q15_t)v;
+}
+
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15 *S, uint16_t numTaps,
+                                     uint8_t M, const q15_t *pCoeffs, q15_t *pState,
+                                     uint32_t blockSize) {
+    if (blockSize % M) {
+        return ARM_MATH_LENGTH_ERROR;
+    }
+    S->M = M;
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    memset(pState, 0, (numTaps + blockSize - 1) * sizeof(q15_t));
+    return ARM_MATH_SUCCESS;
+}
+
+/* The state holds the last numTaps - 1 inputs, then the block */
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15 *S, const q15_t *pSrc,
+                          q15_t *pDst, uint32_t blockSize) {
+    int taps = S->numTaps;
+    q15_t *x = S->pState;
+
+    memcpy(x + taps - 1, pSrc, blockSize * sizeof(q15_t));
+    for (uint32_t o = 0; o < blockSize / S->M; o++) {
+        const q15_t *newest = x + taps - 1 + (o + 1) * S->M - 1;
+        int64_t acc = 0;
+        for (int k = 0; k < taps; k++) {
+            acc += (int32_t)S->pCoeffs[k] * newest[-k];
+        }
+        pDst[o] = sat_q15(acc >> 15);
+    }
+    memmove(x, x + blockSize, (taps - 1) * sizeof(q15_t));
+}
+
+/* Radix-2 in double, rounded back to q15 once at the end */
+void arm_cfft_q15(const arm_cfft_instance_q15 *S, q15_t *p1, uint8_t ifftFlag,
+                  uint8_t bitReverseFlag) {
+    int n = S->fftLen;
+    double re[256], im[256];
+    double sign = ifftFlag ? 1.0 : -1.0;
+
+    for (int i = 0, j = 0; i < n; i++) {
+        re[j] = p1[2 * i];
+        im[j] = p1[2 * i + 1];
+        /* j is i bit-reversed */
+        for (int bit = n >> 1; bit; bit >>= 1) {
+            if ((j ^= bit) & bit) {
+                break;
+            }
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        double step = sign * 2.0 * M_PI / len;
+        for (int k = 0; k < len / 2; k++) {
+            double wr = cos(step * k), wi = sin(step * k);
+            for (int i = k; i < n; i += len) {
+                int m = i + len / 2;
+                double tr = re[m] * wr - im[m] * wi;
+                double ti = re[m] * wi + im[m] * wr;
+                re[m] = re[i] - tr;
+                im[m] = im[i] - ti;
+                re[i] += tr;
+                im[i] += ti;
+            }
+        }
+    }
+
+    for (int k = 0; k < n; k++) {
+        p1[2 * k] = sat_q15(llround(re[k] / n));
+        p1[2 * k + 1] = sat_q15(llround(im[k] / n));
+    }
+}
+
+void arm_shift_q15(const q15_t *pSrc, int8_t shiftBits, q15_t *pDst, uint32_t blockSize) {
+    for (uint32_t i = 0; i < blockSize; i++) {
+        pDst[i] = sat_q15(shiftBits >= 0 ? (int32_t)pSrc[i] << shiftBits
+                                         : pSrc[i] >> -shiftBits);
+    }
+}
+
+q15_t arm_sin_q15(q15_t x) {
+    return sat_q15(llround(32767.0 * sin(2.0 * M_PI * x / 32768.0)));
+}
+
+q15_t arm_cos_q15(q15_t x) {
+    return sat_q15(llround(32767.0 * cos(2.0 * M_PI * x / 32768.0)));
+}
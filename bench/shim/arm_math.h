@@ -0,0 +1,46 @@
+#ifndef BENCH_SHIM_ARM_MATH_H
+#define BENCH_SHIM_ARM_MATH_H
+
+/* The few CMSIS-DSP q15 functions the FT8 decoder calls, in plain C with
+ * the library's scaling and saturation, so its fixed-point results carry
+ * over. Their speed does not: these are written for clarity, not to
+ * match the Cortex-M4 kernels, so decode timings compare host to host. */
+#include <stdint.h>
+
+typedef int16_t q15_t;
+
+typedef enum {
+    ARM_MATH_SUCCESS = 0,
+    ARM_MATH_LENGTH_ERROR = -2,
+} arm_status;
+
+typedef struct {
+    uint8_t M;
+    uint16_t numTaps;
+    const q15_t *pCoeffs;
+    q15_t *pState;          // numTaps + blockSize - 1
+} arm_fir_decimate_instance_q15;
+
+typedef struct {
+    uint16_t fftLen;
+} arm_cfft_instance_q15;
+
+extern const arm_cfft_instance_q15 arm_cfft_sR_q15_len256;
+
+arm_status arm_fir_decimate_init_q15(arm_fir_decimate_instance_q15 *S, uint16_t numTaps,
+                                     uint8_t M, const q15_t *pCoeffs, q15_t *pState,
+                                     uint32_t blockSize);
+void arm_fir_decimate_q15(const arm_fir_decimate_instance_q15 *S, const q15_t *pSrc,
+                          q15_t *pDst, uint32_t blockSize);
+
+/* Scaled down by fftLen, as the library's q15 transform is */
+void arm_cfft_q15(const arm_cfft_instance_q15 *S, q15_t *p1, uint8_t ifftFlag,
+                  uint8_t bitReverseFlag);
+
+void arm_shift_q15(const q15_t *pSrc, int8_t shiftBits, q15_t *pDst, uint32_t blockSize);
+
+/* x is a fraction of a turn, 0 to 32767 */
+q15_t arm_sin_q15(q15_t x);
+q15_t arm_cos_q15(q15_t x);
+
+#endif // BENCH_SHIM_ARM_MATH_H
@@ -0,0 +1 @@
+/* newlib-only header modes/ftx.h includes; nothing needed from it here */
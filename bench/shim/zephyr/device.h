@@ -0,0 +1,10 @@
+#ifndef BENCH_SHIM_ZEPHYR_DEVICE_H
+#define BENCH_SHIM_ZEPHYR_DEVICE_H
+
+struct device {
+    const char *name;
+    const void *config;
+    void *data;
+};
+
+#endif // BENCH_SHIM_ZEPHYR_DEVICE_H
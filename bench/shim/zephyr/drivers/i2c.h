@@ -0,0 +1,12 @@
+#ifndef BENCH_SHIM_ZEPHYR_DRIVERS_I2C_H
+#define BENCH_SHIM_ZEPHYR_DRIVERS_I2C_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+struct i2c_dt_spec {
+    const struct device *bus;
+    uint16_t addr;
+};
+
+#endif // BENCH_SHIM_ZEPHYR_DRIVERS_I2C_H
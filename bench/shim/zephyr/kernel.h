@@ -0,0 +1,42 @@
+#ifndef BENCH_SHIM_ZEPHYR_KERNEL_H
+#define BENCH_SHIM_ZEPHYR_KERNEL_H
+
+/* The kernel as the benchmarked sources see it: one thread, no clock
+ * but the host's, locks that never contend. */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <zephyr/sys/util.h>
+
+typedef struct { int64_t ticks; } k_timeout_t;
+#define K_FOREVER           ((k_timeout_t){ -1 })
+#define K_NO_WAIT           ((k_timeout_t){ 0 })
+
+struct k_mutex { int locked; };
+#define K_MUTEX_DEFINE(name) struct k_mutex name
+
+static inline int k_mutex_lock(struct k_mutex *m, k_timeout_t timeout) {
+    m->locked++;
+    return 0;
+}
+
+static inline int k_mutex_unlock(struct k_mutex *m) {
+    m->locked--;
+    return 0;
+}
+
+int64_t k_uptime_get(void);
+
+/* Cycles are host nanoseconds */
+uint32_t k_cycle_get_32(void);
+
+static inline uint64_t k_cyc_to_us_floor64(uint64_t cycles) {
+    return cycles / 1000;
+}
+
+#define printk printf
+
+#endif // BENCH_SHIM_ZEPHYR_KERNEL_H
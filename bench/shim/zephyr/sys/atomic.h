@@ -0,0 +1,19 @@
+#ifndef BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
+#define BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
+
+typedef long atomic_t;
+typedef long atomic_val_t;
+
+static inline atomic_val_t atomic_get(const atomic_t *target) {
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_set(atomic_t *target, atomic_val_t value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline atomic_val_t atomic_inc(atomic_t *target) {
+    return __atomic_fetch_add(target, 1, __ATOMIC_SEQ_CST);
+}
+
+#endif // BENCH_SHIM_ZEPHYR_SYS_ATOMIC_H
@@ -0,0 +1,8 @@
+#ifndef BENCH_SHIM_ZEPHYR_SYS_BARRIER_H
+#define BENCH_SHIM_ZEPHYR_SYS_BARRIER_H
+
+static inline void barrier_dmem_fence_full(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif // BENCH_SHIM_ZEPHYR_SYS_BARRIER_H
@@ -0,0 +1,14 @@
+#ifndef BENCH_SHIM_ZEPHYR_SYS_UTIL_H
+#define BENCH_SHIM_ZEPHYR_SYS_UTIL_H
+
+#define ARRAY_SIZE(a)       (sizeof(a) / sizeof((a)[0]))
+#ifndef MIN
+#define MIN(a, b)           (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)           (((a) > (b)) ? (a) : (b))
+#endif
+#define CLAMP(v, lo, hi)    MIN(MAX(v, lo), hi)
+#define BUILD_ASSERT(expr, ...) _Static_assert(expr, "" __VA_ARGS__)
+
+#endif // BENCH_SHIM_ZEPHYR_SYS_UTIL_H
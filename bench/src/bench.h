@@ -0,0 +1,41 @@
+#ifndef BENCH_BENCH_H
+#define BENCH_BENCH_H
+
+#include <stdint.h>
+
+/* One measured operation. run does it iterations times over varied
+ * inputs and returns something folded from every result, so the work
+ * cannot be optimised away; unit names what one iteration is. Cases
+ * that take milliseconds an iteration set their own count in
+ * iterations; 0 takes the one from the command line. */
+struct bench_case {
+    const char *name;
+    const char *unit;
+    uint32_t (*run)(uint32_t iterations);
+    uint32_t iterations;
+};
+
+extern const struct bench_case fec_cases[];
+extern const int fec_case_count;
+extern const struct bench_case ft8_decode_cases[];
+extern const int ft8_decode_case_count;
+extern const struct bench_case ftx_cases[];
+extern const int ftx_case_count;
+extern const struct bench_case gnss_cases[];
+extern const int gnss_case_count;
+extern const struct bench_case wspr_cases[];
+extern const int wspr_case_count;
+
+/* Decode each of count WAV recordings as an FT8 slot */
+int ft8_bench_wav(const char *const *paths, int count, uint32_t center_hz);
+
+/* xorshift32: the same inputs on every run and every host */
+static inline uint32_t bench_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+#endif // BENCH_BENCH_H
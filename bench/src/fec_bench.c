@@ -0,0 +1,102 @@
+#include "bench.h"
+
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#include "modes/fec.h"
+#include "modes/encoders/fst4w.h"
+
+/* The FEC kernels on their own, below the encoders that use them: the
+ * CRCs over the bits each mode covers, FST4W's LDPC(240,74) codeword,
+ * and WSPR's K=32 code whole and a symbol at a time. FTX's LDPC parity
+ * is timed as "LDPC codeword" with the FTX cases. */
+#define POOL    256
+#define MSG_BYTES   11
+
+static uint8_t msgs[POOL][MSG_BYTES];
+
+static const uint32_t wspr_polys[2] = { 0xF2D05351u, 0xE4613C47u };
+static const struct fec_conv wspr_code = { 32, 2, wspr_polys };
+static bool pools_ready;
+
+static void make_pools(void) {
+    uint32_t seed = 0xFEC;
+
+    if (pools_ready) {
+        return;
+    }
+    for (int i = 0; i < POOL; i++) {
+        for (int b = 0; b < MSG_BYTES; b++) {
+            msgs[i][b] = bench_rand(&seed);
+        }
+    }
+    pools_ready = true;
+}
+
+static uint32_t run_crc14(uint32_t n) {
+    uint32_t sink = 0;
+
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        sink += fec_crc(&fec_crc14, msgs[i % POOL], 82);
+    }
+    return sink;
+}
+
+static uint32_t run_crc24(uint32_t n) {
+    uint32_t sink = 0;
+
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        sink += fec_crc(&fec_crc24, msgs[i % POOL], 50);
+    }
+    return sink;
+}
+
+/* CRC-24 and parity over 50 message bits */
+static uint32_t run_ldpc_240(uint32_t n) {
+    uint8_t codeword[FST4W_CODEWORD_BYTES];
+    uint32_t sink = 0;
+
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        fst4w_encode_codeword(msgs[i % POOL], codeword);
+        sink += codeword[i % sizeof(codeword)];
+    }
+    return sink;
+}
+
+/* 50 message bits and 31 of tail, as WSPR sends */
+static uint32_t run_conv_encode(uint32_t n) {
+    uint8_t out[21];
+    uint32_t sink = 0;
+
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        memset(out, 0, sizeof(out));
+        fec_conv_encode(&wspr_code, msgs[i % POOL], 50, out);
+        sink += out[i % sizeof(out)];
+    }
+    return sink;
+}
+
+static uint32_t run_conv_state(uint32_t n) {
+    uint32_t sink = 0;
+
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t state = fec_conv_state(&wspr_code, msgs[(i / 81) % POOL], 50, i % 81);
+        sink += fec_conv_output(&wspr_code, state, i & 1);
+    }
+    return sink;
+}
+
+const struct bench_case fec_cases[] = {
+    { "CRC-14", "msg", run_crc14 },
+    { "CRC-24", "msg", run_crc24 },
+    { "LDPC(240,74) codeword", "msg", run_ldpc_240 },
+    { "conv K=32 encode", "msg", run_conv_encode },
+    { "conv K=32 state", "bit", run_conv_state },
+};
+const int fec_case_count = ARRAY_SIZE(fec_cases);
@@ -0,0 +1,245 @@
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "modes/ftx.h"
+#include "modes/encoders/ft8.h"
+#include "modes/decoders/ft8.h"
+
+/* The FT8 receiver over whole slots: synthesised ones for the case, the
+ * recordings given with --wav for ft8_bench_wav. Slots are built the way
+ * tests/src/ft8_decode_test.c builds them, three signals from the
+ * encoder in white noise, so the decodes per slot of the two agree. */
+#define SLOTS           4
+#define NOISE_RMS       1000.0
+#define FEED_CHUNK      960
+#define MAX_DECODES     16
+
+struct slot_signal {
+    ftx_payload_t payload;
+    double freq_hz;
+    double dt_s;
+    double snr_db;
+};
+
+#define CALL(c)     { .type = C28_TYPE_CALLSIGN, .payload.callsign = c }
+#define CQ          { .type = C28_TYPE_CQ }
+#define GRID(g)     { .type = G15_TYPE_GRID, .payload.grid = g }
+#define REPORT(r)   { .type = G15_TYPE_REPORT, .payload.report = r }
+
+static const struct slot_signal signals[] = {
+    {
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CQ, .c28_1 = CALL("K1ABC"),
+                                              .g15 = GRID("FN42") } },
+        1351.0, 0.0, -12.0,
+    },
+    {
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CALL("K1ABC"), .c28_1 = CALL("W9XYZ"),
+                                              .R1 = true, .g15 = REPORT(-12) } },
+        1503.1, 0.37, -14.0,
+    },
+    {
+        { .type = FTX_MODE_FREE_TEXT, .data.free_text.text = "TNX BOB 73 GL" },
+        1590.0, -0.3, -10.0,
+    },
+};
+
+static int16_t slots[SLOTS][FT8_RX_SLOT_SAMPLES];
+static float audio[FT8_RX_SLOT_SAMPLES];
+static bool slots_ready;
+
+static double noise_gauss(uint32_t *seed) {
+    double u = (bench_rand(seed) + 1.0) / 4294967297.0;
+    double v = (bench_rand(seed) + 1.0) / 4294967297.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void add_signal(const struct slot_signal *sig) {
+    tx_sequence_t seq;
+    double noise_power = NOISE_RMS * NOISE_RMS * 2500.0 / (FT8_RX_SAMPLE_HZ / 2);
+    double amp = sqrt(2.0 * noise_power * pow(10.0, sig->snr_db / 10.0));
+    int start = (int)((0.5 + sig->dt_s) * FT8_RX_SAMPLE_HZ);
+    double phase = 0;
+
+    generate_ft8_sequence(&sig->payload, &seq);
+    for (size_t s = 0; s < seq.total_symbols; s++) {
+        double hz = sig->freq_hz + seq.symbols[s].freq_offset_uhz * 1e-6;
+        int samples = seq.symbols[s].duration_us * FT8_RX_SAMPLE_HZ / 1000000;
+
+        for (int n = 0; n < samples; n++) {
+            int i = start + (int)s * samples + n;
+            phase += 2.0 * M_PI * hz / FT8_RX_SAMPLE_HZ;
+            if (i >= 0 && i < FT8_RX_SLOT_SAMPLES) {
+                audio[i] += (float)(amp * sin(phase));
+            }
+        }
+    }
+}
+
+static void make_slots(void) {
+    if (slots_ready) {
+        return;
+    }
+    for (int slot = 0; slot < SLOTS; slot++) {
+        uint32_t seed = 0x5EED + slot;
+
+        memset(audio, 0, sizeof(audio));
+        for (size_t i = 0; i < ARRAY_SIZE(signals); i++) {
+            add_signal(&signals[i]);
+        }
+        for (int i = 0; i < FT8_RX_SLOT_SAMPLES; i++) {
+            double v = audio[i] + NOISE_RMS * noise_gauss(&seed);
+            slots[slot][i] = (int16_t)lrint(CLAMP(v, INT16_MIN, INT16_MAX));
+        }
+    }
+    slots_ready = true;
+}
+
+static int decode_slot(const int16_t *samples, size_t count, uint32_t center_hz,
+                       struct ft8_decode *out) {
+    size_t off = 0;
+    int taken;
+
+    if (ft8_rx_start(center_hz)) {
+        return 0;
+    }
+    do {
+        taken = ft8_rx_feed(samples + off, MIN(FEED_CHUNK, count - off));
+        off += taken;
+    } while (taken == FEED_CHUNK);
+
+    return ft8_rx_decode(out, MAX_DECODES);
+}
+
+static uint32_t run_decode(uint32_t iterations) {
+    struct ft8_decode out[MAX_DECODES];
+    uint32_t sink = 0;
+
+    make_slots();
+    for (uint32_t i = 0; i < iterations; i++) {
+        int n = decode_slot(slots[i % SLOTS], FT8_RX_SLOT_SAMPLES, 1500, out);
+
+        sink = sink * 31 + n;
+        for (int d = 0; d < n; d++) {
+            sink += out[d].freq_hz;
+        }
+    }
+    return sink;
+}
+
+const struct bench_case ft8_decode_cases[] = {
+    { "FT8 decode slot", "slot", run_decode, SLOTS },
+};
+const int ft8_decode_case_count = ARRAY_SIZE(ft8_decode_cases);
+
+static const char *c28_text(const c28_t *c, char *buf) {
+    switch (c->type) {
+    case C28_TYPE_CQ:
+        return "CQ";
+    case C28_TYPE_CQ_MOD:
+        snprintf(buf, 12, "CQ_%s", c->payload.cq_modifier);
+        return buf;
+    case C28_TYPE_DE:
+        return "DE";
+    case C28_TYPE_QRZ:
+        return "QRZ";
+    case C28_TYPE_CALLSIGN:
+        return c->payload.callsign;
+    default:
+        snprintf(buf, 12, "<%06x>", (unsigned)c->payload.hash);
+        return buf;
+    }
+}
+
+static void print_message(const ftx_payload_t *p) {
+    char a[12], b[12];
+
+    switch (p->type) {
+    case FTX_MODE_FREE_TEXT:
+        printf("%s", p->data.free_text.text);
+        break;
+    case FTX_MODE_STD: {
+        const g15_t *g = &p->data.std.g15;
+
+        printf("%s %s %s", c28_text(&p->data.std.c28_0, a), c28_text(&p->data.std.c28_1, b),
+               p->data.std.R1 ? "R" : "");
+        switch (g->type) {
+        case G15_TYPE_GRID:
+            printf("%s", g->payload.grid);
+            break;
+        case G15_TYPE_REPORT:
+            printf("%+03d", g->payload.report);
+            break;
+        case G15_TYPE_RRR:
+            printf("RRR");
+            break;
+        case G15_TYPE_RR73:
+            printf("RR73");
+            break;
+        case G15_TYPE_73:
+            printf("73");
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+    default:
+        printf("(message type %d)", p->type);
+        break;
+    }
+}
+
+/* Decode each recording as one slot and list what came out, in the
+ * columns WSJT-X uses, then the decodes and CPU time per slot */
+int ft8_bench_wav(const char *const *paths, int count, uint32_t center_hz) {
+    static uint8_t wav[44 + 2 * FT8_RX_SLOT_SAMPLES + 4096];
+    struct ft8_decode out[MAX_DECODES];
+    uint32_t decodes = 0, cpu_us = 0;
+    int slots_read = 0;
+
+    for (int f = 0; f < count; f++) {
+        const int16_t *samples;
+        size_t len, n_samples;
+        FILE *file = fopen(paths[f], "rb");
+
+        if (!file) {
+            perror(paths[f]);
+            return -1;
+        }
+        len = fread(wav, 1, sizeof(wav), file);
+        fclose(file);
+        if (ft8_wav_samples(wav, len, &samples, &n_samples)) {
+            fprintf(stderr, "%s: not 12 kHz mono 16-bit PCM\n", paths[f]);
+            return -1;
+        }
+
+        int n = decode_slot(samples, n_samples, center_hz, out);
+        struct ft8_rx_stats stats;
+        ft8_rx_get_stats(&stats);
+
+        printf("%s: %d decodes of %u candidates, front end %u us, decode %u us\n", paths[f],
+               n, stats.candidates, stats.feed_cpu_us, stats.decode_cpu_us);
+        for (int d = 0; d < n; d++) {
+            printf("  %3d %4.1f %4u ~  ", out[d].snr_db, out[d].dt_ms / 1000.0,
+                   out[d].freq_hz);
+            print_message(&out[d].payload);
+            printf("\n");
+        }
+
+        decodes += n;
+        cpu_us += stats.feed_cpu_us + stats.decode_cpu_us;
+        slots_read++;
+    }
+
+    if (slots_read) {
+        printf("%d slots: %.1f decodes per slot, %u us CPU per slot\n", slots_read,
+               (double)decodes / slots_read, cpu_us / slots_read);
+    }
+    return 0;
+}
@@ -0,0 +1,252 @@
+#include "bench.h"
+
+#include <string.h>
+
+#include "modes/ftx.h"
+#include "modes/encoders/ft8.h"
+#include "modes/encoders/ft4.h"
+
+/* The FTX payload codecs and the encoders above them, over pools of
+ * generated callsigns, free text, sections and states. The pools are a
+ * power of two so the index is a mask, not a division. */
+#define POOL    256
+
+static const char f71_chars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?";
+static const char *sections[] = {
+    "CT", "EMA", "ENY", "NLI", "SNJ", "WPA", "NFL", "SFL", "WCF", "NTX",
+    "STX", "WTX", "LAX", "ORG", "SCV", "SDG", "EWA", "WWA", "ONE", "GTA",
+    "MAR", "QC", "BC", "DX",
+};
+static const char *states[] = {
+    "AL", "AZ", "CA", "CO", "FL", "GA", "IL", "MA", "NY", "OH",
+    "TX", "WA", "ON", "QC", "BC", "NS",
+};
+
+static char calls[POOL][7];
+static char long_calls[POOL][12];
+static char texts[POOL][14];
+static ftx_payload_t std_msgs[POOL];
+static ftx_payload_t text_msgs[POOL];
+static ftx_payload_t field_day_msgs[POOL];
+static ftx_payload_t nonstd_msgs[POOL];
+static uint8_t packed[POOL][10];
+static bool pools_ready;
+
+static char letter(uint32_t *seed) {
+    return 'A' + bench_rand(seed) % 26;
+}
+
+/* Prefix of one or two letters, area digit, suffix of one to three */
+static void make_call(uint32_t *seed, char *call) {
+    int n = 0;
+
+    call[n++] = letter(seed);
+    if (bench_rand(seed) & 1) {
+        call[n++] = letter(seed);
+    }
+    call[n++] = '0' + bench_rand(seed) % 10;
+    for (int s = 1 + bench_rand(seed) % 3; s > 0; s--) {
+        call[n++] = letter(seed);
+    }
+    call[n] = '\0';
+}
+
+static void make_pools(void) {
+    uint32_t seed = 0x1234567;
+
+    if (pools_ready) {
+        return;
+    }
+
+    for (int i = 0; i < POOL; i++) {
+        make_call(&seed, calls[i]);
+        /* Portable: K1ABC/P2 style, past what c28 holds */
+        size_t len = strlen(calls[i]);
+        memcpy(long_calls[i], calls[i], len);
+        long_calls[i][len] = '/';
+        long_calls[i][len + 1] = letter(&seed);
+        long_calls[i][len + 2] = '0' + bench_rand(&seed) % 10;
+        long_calls[i][len + 3] = '\0';
+
+        len = 1 + bench_rand(&seed) % 13;
+        for (size_t c = 0; c < len; c++) {
+            texts[i][c] = f71_chars[bench_rand(&seed) % (sizeof(f71_chars) - 1)];
+        }
+        texts[i][len] = '\0';
+    }
+
+    for (int i = 0; i < POOL; i++) {
+        const char *call0 = calls[i];
+        const char *call1 = calls[(i + 1) % POOL];
+        ftx_payload_t *p;
+
+        p = &std_msgs[i];
+        p->type = FTX_MODE_STD;
+        p->data.std.c28_0.type = C28_TYPE_CALLSIGN;
+        strcpy(p->data.std.c28_0.payload.callsign, call0);
+        p->data.std.c28_1.type = C28_TYPE_CALLSIGN;
+        strcpy(p->data.std.c28_1.payload.callsign, call1);
+        p->data.std.g15.type = G15_TYPE_REPORT;
+        p->data.std.g15.payload.report = -24 + (int)(bench_rand(&seed) % 40);
+
+        p = &text_msgs[i];
+        p->type = FTX_MODE_FREE_TEXT;
+        strcpy(p->data.free_text.text, texts[i]);
+
+        p = &field_day_msgs[i];
+        p->type = FTX_MODE_FIELD_DAY;
+        p->data.field_day.c28_0.type = C28_TYPE_CALLSIGN;
+        strcpy(p->data.field_day.c28_0.payload.callsign, call0);
+        p->data.field_day.c28_1.type = C28_TYPE_CALLSIGN;
+        strcpy(p->data.field_day.c28_1.payload.callsign, call1);
+        p->data.field_day.n4 = bench_rand(&seed) % 16;
+        p->data.field_day.k3 = FD_CLASS_A + bench_rand(&seed) % 6;
+        strcpy(p->data.field_day.S7, sections[i % ARRAY_SIZE(sections)]);
+
+        p = &nonstd_msgs[i];
+        p->type = FTX_MODE_NONSTD;
+        p->data.nonstd.h12 = bench_rand(&seed) & 0xFFF;
+        strcpy(p->data.nonstd.c58, long_calls[i]);
+        p->data.nonstd.r2 = R2_TYPE_RR73;
+
+        encode_ftx_payload(&std_msgs[i], packed[i]);
+    }
+
+    pools_ready = true;
+}
+
+static uint32_t run_c28(uint32_t n) {
+    uint32_t sink = 0;
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        sink ^= encode_c28(&std_msgs[i % POOL].data.std.c28_0) + i;
+    }
+    return sink;
+}
+
+static uint32_t run_c58(uint32_t n) {
+    uint32_t sink = 0;
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        sink ^= (uint32_t)encode_c58(long_calls[i % POOL]) + i;
+    }
+    return sink;
+}
+
+static uint32_t run_hash22(uint32_t n) {
+    uint32_t sink = 0;
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        sink ^= hash_callsign(long_calls[i % POOL], 22) + i;
+    }
+    return sink;
+}
+
+static uint32_t run_f71(uint32_t n) {
+    uint32_t sink = 0;
+    uint8_t out[9];
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        encode_f71(texts[i % POOL], out);
+        sink ^= out[8] + i;
+    }
+    return sink;
+}
+
+static uint32_t run_s7(uint32_t n) {
+    uint32_t sink = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sink += (uint32_t)encode_S7(sections[i % ARRAY_SIZE(sections)]);
+    }
+    return sink;
+}
+
+static uint32_t run_s13(uint32_t n) {
+    s13_t s13 = { .type = S13_TYPE_STATE };
+    uint32_t sink = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        strcpy(s13.payload.state, states[i % ARRAY_SIZE(states)]);
+        sink += encode_s13(&s13);
+    }
+    return sink;
+}
+
+static uint32_t run_payloads(const ftx_payload_t *msgs, uint32_t n) {
+    uint32_t sink = 0;
+    uint8_t out[10];
+    for (uint32_t i = 0; i < n; i++) {
+        encode_ftx_payload(&msgs[i % POOL], out);
+        sink ^= out[i % 10] + i;
+    }
+    return sink;
+}
+
+static uint32_t run_payload_std(uint32_t n) {
+    make_pools();
+    return run_payloads(std_msgs, n);
+}
+
+static uint32_t run_payload_text(uint32_t n) {
+    make_pools();
+    return run_payloads(text_msgs, n);
+}
+
+static uint32_t run_payload_field_day(uint32_t n) {
+    make_pools();
+    return run_payloads(field_day_msgs, n);
+}
+
+static uint32_t run_payload_nonstd(uint32_t n) {
+    make_pools();
+    return run_payloads(nonstd_msgs, n);
+}
+
+static uint32_t run_codeword(uint32_t n) {
+    uint32_t sink = 0;
+    uint8_t cw[FTX_CODEWORD_BYTES];
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        ftx_encode_codeword(packed[i % POOL], cw);
+        sink ^= cw[21] + i;
+    }
+    return sink;
+}
+
+static uint32_t run_ft8(uint32_t n) {
+    uint32_t sink = 0;
+    tx_sequence_t seq;
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        generate_ft8_sequence(&std_msgs[i % POOL], &seq);
+        sink ^= (uint32_t)seq.symbols[i % seq.total_symbols].freq_offset_uhz + i;
+    }
+    return sink;
+}
+
+static uint32_t run_ft4(uint32_t n) {
+    uint32_t sink = 0;
+    tx_sequence_t seq;
+    make_pools();
+    for (uint32_t i = 0; i < n; i++) {
+        generate_ft4_sequence(&std_msgs[i % POOL], &seq);
+        sink ^= (uint32_t)seq.symbols[i % seq.total_symbols].freq_offset_uhz + i;
+    }
+    return sink;
+}
+
+const struct bench_case ftx_cases[] = {
+    { "c28 callsign", "call", run_c28 },
+    { "c58 callsign", "call", run_c58 },
+    { "hash22", "call", run_hash22 },
+    { "f71 text", "msg", run_f71 },
+    { "S7 section", "key", run_s7 },
+    { "s13 state", "key", run_s13 },
+    { "payload standard", "msg", run_payload_std },
+    { "payload free text", "msg", run_payload_text },
+    { "payload field day", "msg", run_payload_field_day },
+    { "payload nonstandard", "msg", run_payload_nonstd },
+    { "LDPC codeword", "msg", run_codeword },
+    { "FT8 sequence", "msg", run_ft8 },
+    { "FT4 sequence", "msg", run_ft4 },
+};
+const int ftx_case_count = ARRAY_SIZE(ftx_cases);
@@ -0,0 +1,86 @@
+#include "bench.h"
+
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+
+#include "gnss_ublox_m10.h"
+
+/* The UBX stream parser over a second of DDC output repeated: NAV-PVT
+ * and NAV-TIMEUTC with NMEA between, fed in the driver's read size. */
+#define READ_CHUNK  128     // GNSS_UBLOX_M10_READ_CHUNK default
+
+static const char nmea[] =
+    "$GNRMC,120018.00,A,4230.00000,N,07100.00000,W,0.010,,181026,,,A,V*02\r\n"
+    "$GNGGA,120018.00,4230.00000,N,07100.00000,W,1,09,0.92,12.3,M,-33.6,M,,*40\r\n";
+
+static struct m10_stream stream;
+
+static size_t ubx_put(uint8_t *out, uint8_t cls, uint8_t id, const uint8_t *payload,
+                      uint16_t len) {
+    uint8_t ck_a = 0, ck_b = 0;
+
+    out[0] = UBX_SYNC1;
+    out[1] = UBX_SYNC2;
+    out[2] = cls;
+    out[3] = id;
+    sys_put_le16(len, &out[4]);
+    memcpy(&out[6], payload, len);
+    for (size_t i = 2; i < 6u + len; i++) {
+        ck_a += out[i];
+        ck_b += ck_a;
+    }
+    out[6 + len] = ck_a;
+    out[7 + len] = ck_b;
+    return 8 + len;
+}
+
+static size_t make_epoch(uint8_t *out, uint32_t *seed) {
+    uint8_t pvt[UBX_NAV_PVT_LEN];
+    uint8_t tu[UBX_NAV_TIMEUTC_LEN];
+    size_t n = 0;
+
+    for (size_t i = 0; i < sizeof(pvt); i++) {
+        pvt[i] = (uint8_t)bench_rand(seed);
+    }
+    for (size_t i = 0; i < sizeof(tu); i++) {
+        tu[i] = (uint8_t)bench_rand(seed);
+    }
+
+    memcpy(out, nmea, sizeof(nmea) - 1);
+    n += sizeof(nmea) - 1;
+    n += ubx_put(&out[n], UBX_CLASS_NAV, UBX_ID_NAV_PVT, pvt, sizeof(pvt));
+    n += ubx_put(&out[n], UBX_CLASS_NAV, UBX_ID_NAV_TIMEUTC, tu, sizeof(tu));
+    return n;
+}
+
+/* One iteration is one byte of stream */
+static uint32_t run_ubx(uint32_t n) {
+    static uint8_t buf[4096];
+    uint32_t seed = 0x2468ace;
+    size_t len = 0;
+    uint32_t sink = 0;
+
+    while (len + 512 <= sizeof(buf)) {
+        len += make_epoch(&buf[len], &seed);
+    }
+
+    m10_stream_init(&stream);
+    for (uint32_t done = 0; done < n;) {
+        for (size_t i = 0; i < len && done < n; i += READ_CHUNK) {
+            size_t chunk = MIN(MIN((size_t)READ_CHUNK, len - i), (size_t)(n - done));
+            sink += m10_stream_feed(&stream, &buf[i], chunk);
+            done += chunk;
+        }
+    }
+
+    struct m10_fix fix;
+    if (m10_stream_get_fix(&stream, &fix) == 0) {
+        sink ^= fix.itow_ms;
+    }
+    return sink;
+}
+
+const struct bench_case gnss_cases[] = {
+    { "UBX stream", "byte", run_ubx },
+};
+const int gnss_case_count = ARRAY_SIZE(gnss_cases);
@@ -0,0 +1,135 @@
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS  2000000
+#define MAX_BASELINE        64
+#define MAX_WAV             256
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int64_t k_uptime_get(void) {
+    return (int64_t)(now_ns() / 1e6);
+}
+
+uint32_t k_cycle_get_32(void) {
+    return (uint32_t)(uint64_t)now_ns();
+}
+
+struct baseline {
+    char name[48];
+    double ns;
+};
+
+static struct baseline baseline[MAX_BASELINE];
+static int baseline_count;
+
+/* Lines of "ns name", as --save writes them */
+static int load_baseline(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    while (baseline_count < MAX_BASELINE &&
+           fscanf(f, "%lf %47[^\n]\n", &baseline[baseline_count].ns,
+                  baseline[baseline_count].name) == 2) {
+        baseline_count++;
+    }
+    fclose(f);
+    return 0;
+}
+
+static const struct baseline *find_baseline(const char *name) {
+    for (int i = 0; i < baseline_count; i++) {
+        if (!strcmp(baseline[i].name, name)) {
+            return &baseline[i];
+        }
+    }
+    return NULL;
+}
+
+static void run_cases(const struct bench_case *cases, int count, uint32_t iterations,
+                      FILE *save) {
+    for (int i = 0; i < count; i++) {
+        const struct bench_case *c = &cases[i];
+        uint32_t n = c->iterations ? c->iterations : iterations;
+
+        double t0 = now_ns();
+        uint32_t sink = c->run(n);
+        double ns = (now_ns() - t0) / n;
+
+        printf("%-24s %10.1f ns/%-4s %8.2f M/s  [%08x]", c->name, ns, c->unit,
+               1e3 / ns, sink);
+        const struct baseline *b = find_baseline(c->name);
+        if (b) {
+            printf("  %+6.1f%%", (ns - b->ns) * 100 / b->ns);
+        }
+        printf("\n");
+
+        if (save) {
+            fprintf(save, "%.2f %s\n", ns, c->name);
+        }
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [iterations] [--baseline FILE | --save FILE]\n"
+                    "       %s [--center HZ] --wav FILE...\n", prog, prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    FILE *save = NULL;
+    const char *wav[MAX_WAV];
+    int wav_count = 0;
+    uint32_t center_hz = 1500;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+            /* A missing baseline is not an error: there is nothing yet */
+            load_baseline(argv[++i]);
+        } else if (!strcmp(argv[i], "--save") && i + 1 < argc) {
+            save = fopen(argv[++i], "w");
+            if (!save) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else if (!strcmp(argv[i], "--wav") && i + 1 < argc) {
+            /* Everything up to the next option is a recording */
+            while (i + 1 < argc && argv[i + 1][0] != '-' && wav_count < MAX_WAV) {
+                wav[wav_count++] = argv[++i];
+            }
+        } else if (!strcmp(argv[i], "--center") && i + 1 < argc) {
+            center_hz = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (argv[i][0] >= '1' && argv[i][0] <= '9') {
+            iterations = (uint32_t)strtoul(argv[i], NULL, 10);
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    if (wav_count) {
+        return ft8_bench_wav(wav, wav_count, center_hz) ? 1 : 0;
+    }
+
+    printf("%u iterations per case%s\n", iterations,
+           baseline_count ? ", change against the baseline" : "");
+    run_cases(fec_cases, fec_case_count, iterations, save);
+    run_cases(ftx_cases, ftx_case_count, iterations, save);
+    run_cases(ft8_decode_cases, ft8_decode_case_count, iterations, save);
+    run_cases(wspr_cases, wspr_case_count, iterations, save);
+    run_cases(gnss_cases, gnss_case_count, iterations, save);
+
+    if (save) {
+        fclose(save);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.h"
+
+#include <zephyr/sys/util.h>
+
+#include "radio_core.h"
+#include "modes/encoders/wspr.h"
+#include "modes/encoders/fst4w.h"
+
+/* WSPR and FST4W symbols are computed one at a time as the engine
+ * reaches them; one iteration is one channel symbol, in order, message
+ * after message. The FST4W encode at each message start is counted. */
+static const wspr_payload_t messages[] = {
+    { "K1ABC", "FN42", 37 },
+    { "KH6XYZ", "BL11", 23 },
+    { "VK2ZZZ", "QF56", 60 },
+};
+
+static uint32_t run_wspr(uint32_t n) {
+    tx_sequence_t seq;
+    tx_symbol_t sym;
+    uint32_t sink = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        size_t index = i % 162;
+        if (index == 0) {
+            generate_wspr_sequence(&messages[(i / 162) % ARRAY_SIZE(messages)], &seq);
+        }
+        seq.source(&seq, index, &sym);
+        sink += (uint32_t)sym.freq_offset_uhz;
+    }
+    return sink;
+}
+
+static uint32_t run_fst4w(uint32_t n) {
+    tx_sequence_t seq;
+    tx_symbol_t sym;
+    uint32_t sink = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        size_t index = i % FST4W_SYMBOL_COUNT;
+        if (index == 0) {
+            generate_fst4w_sequence(&messages[(i / FST4W_SYMBOL_COUNT) % ARRAY_SIZE(messages)],
+                                    FST4W_120, &seq);
+        }
+        seq.source(&seq, index, &sym);
+        sink += (uint32_t)sym.freq_offset_uhz + sym.duration_us;
+    }
+    return sink;
+}
+
+const struct bench_case wspr_cases[] = {
+    { "WSPR symbol", "sym", run_wspr },
+    { "FST4W symbol", "sym", run_fst4w },
+};
+const int wspr_case_count = ARRAY_SIZE(wspr_cases);
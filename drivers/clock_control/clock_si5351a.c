@@ -11,7 +11,6 @@
 
 #define si5351a_MULTISYNTH_MIN_FREQ      500000ULL
 #define si5351a_MULTISYNTH_DIVBY4_FREQ   150000000ULL
-#define si5351a_MULTISYNTH_MAX_FREQ      200000000ULL
 #define si5351a_MULTISYNTH_SHARE_MAX     100000000ULL
 
 #define si5351a_PLL_FIXED                80000000000ULL
@@ -26,11 +25,11 @@
 #define si5351a_PLL_A_MIN                15
 #define si5351a_PLL_A_MAX                90
 #define si5351a_PLL_B_MAX                1048574
-#define RFRAC_DENOM 1000000ULL
+
+#define si5351a_CORRECTION_MAX_PPB       200000
 
 #define si5351a_PLLA_PARAMETERS          26
 #define si5351a_PLLB_PARAMETERS          34
-#define si5351a_CLK0_PARAMETERS          42
 #define si5351a_CLK1_PARAMETERS          50
 #define si5351a_CLK2_PARAMETERS          58
 
@@ -52,9 +51,6 @@
 #define si5351a_OUTPUT_CLK_DIV_64        6
 #define si5351a_OUTPUT_CLK_DIV_128       7
 
-#define si5351a_MULTISYNTH_A_MIN         6
-#define si5351a_MULTISYNTH_A_MAX         1800
-
 #define si5351a_PLL_RESET                177
 #define si5351a_PLL_RESET_B              (1<<7)
 #define si5351a_PLL_RESET_A              (1<<5)
@@ -107,12 +103,35 @@
 #define si5351a_REGISTER_149_SPREAD_SPECTRUM_PARAMETERS 149
 #define si5351a_REGISTER_183_CRYSTAL_INTERNAL_LOAD_CAPACITANCE 183
 
+#define SI5351A_BUS_TIMEOUT K_MSEC(10)
+
+/* Serialises blocking accesses against an in-flight asynchronous write */
+static int si5351a_bus_acquire(const struct device *dev) {
+    struct si5351a_data *data = dev->data;
+
+    if (k_sem_take(&data->bus_idle, SI5351A_BUS_TIMEOUT)) {
+        return -EBUSY;
+    }
+    return 0;
+}
+
+static void si5351a_bus_release(const struct device *dev) {
+    struct si5351a_data *data = dev->data;
+
+    k_sem_give(&data->bus_idle);
+}
+
 int si5351a_write_reg(const struct device *dev, uint8_t reg, uint8_t value) {
     const struct si5351a_config *cfg = dev->config;
     uint8_t buf[2] = { reg, value };
     int ret;
 
+    ret = si5351a_bus_acquire(dev);
+    if (ret) {
+        return ret;
+    }
     ret = i2c_write_dt(&cfg->i2c, buf, sizeof(buf));
+    si5351a_bus_release(dev);
     if (ret) {
         return ret;
     }
@@ -130,7 +149,12 @@ int si5351a_write_multiple(const struct device *dev, uint8_t start_reg, uint8_t
     buf[0] = start_reg;
     memcpy(&buf[1], values, length);
 
+    ret = si5351a_bus_acquire(dev);
+    if (ret) {
+        return ret;
+    }
     ret = i2c_write_dt(&cfg->i2c, buf, length + 1);
+    si5351a_bus_release(dev);
     if (ret) {
         return ret;
     }
@@ -142,7 +166,12 @@ int si5351a_read_reg(const struct device *dev, uint8_t reg, uint8_t *value) {
     const struct si5351a_config *cfg = dev->config;
     int ret;
 
+    ret = si5351a_bus_acquire(dev);
+    if (ret) {
+        return ret;
+    }
     ret = i2c_write_read_dt(&cfg->i2c, &reg, sizeof(reg), value, sizeof(*value));
+    si5351a_bus_release(dev);
     if (ret) {
         return ret;
     }
@@ -180,6 +209,8 @@ static int si5351a_init(const struct device *dev) {
         return -ENODEV;
     }
 
+    k_sem_init(&data->bus_idle, 1, 1);
+
     uint8_t status_reg = 0;
     int retries = 1000;
     do {
@@ -230,6 +261,8 @@ static int si5351a_init(const struct device *dev) {
     data->pllb_configured = false;
     data->plla_freq = 0;
     data->pllb_freq = 0;
+    data->plla_correction_ppb = 0;
+    data->pllb_correction_ppb = 0;
     data->initialised = true;
 
     return 0;
@@ -303,29 +336,9 @@ int si5351a_set_pll(const struct device *dev, char pll, uint32_t a, uint32_t b,
         return -EINVAL;
     }
 
-    uint32_t p1, p2, p3;
-
-    if (b == 0) {
-        p1 = 128 * a - 512;
-        p2 = b;
-        p3 = c;
-    } else {
-        p1 = (uint32_t)(128 * a + floor(128 * ((double)b / (double)c)) - 512);
-        p2 = (128 * b - c * floor(128 * ((double)b / (double)c)));
-        p3 = c;
-    }
-
     uint8_t reg_base = (pll == 'A') ? si5351a_PLLA_PARAMETERS : si5351a_PLLB_PARAMETERS;
-    uint8_t reg_vals[8] = {
-        (p3 & 0x0000FF00) >> 8,
-        (p3 & 0x000000FF),
-        (p1 & 0x00030000) >> 16,
-        (p1 & 0x0000FF00) >> 8,
-        (p1 & 0x000000FF),
-        ((p3 & 0x000F0000) >> 12) | ((p2 & 0x000F0000) >> 16),
-        (p2 & 0x0000FF00) >> 8,
-        (p2 & 0x000000FF),
-    };
+    uint8_t reg_vals[8];
+    si5351a_pack_params(a, b, c, reg_vals);
 
     int ret = si5351a_write_multiple(dev, reg_base, reg_vals, sizeof(reg_vals));
     if (ret) {
@@ -347,26 +360,81 @@ int si5351a_set_pll(const struct device *dev, char pll, uint32_t a, uint32_t b,
     return 0;
 }
 
-int si5351a_set_pll_freq(const struct device *dev, char pll, uint32_t freq) {
+/* Solve freq = xtal * (1 + ppb/1e9) * (a + b/c). The reference is carried
+ * in millihertz so single-ppb corrections still move the numerator. */
+static void si5351a_calc_pll(const struct device *dev, uint32_t freq, int32_t ppb,
+                             uint32_t *a, uint32_t *b, uint32_t *c) {
     const struct si5351a_config *cfg = dev->config;
+    uint64_t xtal_mhz = (uint64_t)((int64_t)cfg->xtal_freq * 1000 +
+                                   (int64_t)cfg->xtal_freq * ppb / 1000000);
+
+    si5351a_calc_ratio((uint64_t)freq * 1000, xtal_mhz, a, b, c);
+}
+
+int si5351a_set_pll_freq(const struct device *dev, char pll, uint32_t freq) {
+    struct si5351a_data *data = dev->data;
 
     if (freq < si5351a_PLL_VCO_MIN || freq > si5351a_PLL_VCO_MAX) {
         return -EINVAL;
     }
 
-    uint32_t a = freq / cfg->xtal_freq;
-    uint64_t remainder = (uint64_t)freq % cfg->xtal_freq;
-    uint32_t b, c;
+    int32_t ppb = (pll == 'A') ? data->plla_correction_ppb : data->pllb_correction_ppb;
+    uint32_t a, b, c;
+    si5351a_calc_pll(dev, freq, ppb, &a, &b, &c);
+
+    int ret = si5351a_set_pll(dev, pll, a, b, c);
+    if (ret) {
+        return ret;
+    }
 
-    if (remainder == 0) {
-        b = 0;
-        c = 1;
+    /* Multisynth plans are made against the nominal VCO frequency; the
+     * correction lives entirely in the PLL feedback divider. */
+    if (pll == 'A') {
+        data->plla_freq = freq;
     } else {
-        c = RFRAC_DENOM;
-        b = (uint32_t)((remainder * c) / cfg->xtal_freq);
+        data->pllb_freq = freq;
     }
 
-    return si5351a_set_pll(dev, pll, a, b, c);
+    return 0;
+}
+
+int si5351a_set_pll_correction(const struct device *dev, char pll, int32_t ppb) {
+    struct si5351a_data *data = dev->data;
+
+    if (pll != 'A' && pll != 'B') {
+        return -EINVAL;
+    }
+    if (ppb > si5351a_CORRECTION_MAX_PPB || ppb < -si5351a_CORRECTION_MAX_PPB) {
+        return -ERANGE;
+    }
+
+    uint32_t freq;
+    if (pll == 'A') {
+        data->plla_correction_ppb = ppb;
+        freq = data->plla_configured ? data->plla_freq : 0;
+    } else {
+        data->pllb_correction_ppb = ppb;
+        freq = data->pllb_configured ? data->pllb_freq : 0;
+    }
+
+    if (freq == 0) {
+        /* Picked up by the next si5351a_set_pll_freq() */
+        return 0;
+    }
+
+    uint32_t a, b, c;
+    si5351a_calc_pll(dev, freq, ppb, &a, &b, &c);
+    if (a < si5351a_PLL_A_MIN || a > si5351a_PLL_A_MAX || b > si5351a_PLL_B_MAX) {
+        return -EINVAL;
+    }
+
+    /* Rewrite only the feedback parameters: no multisynth replan and no PLL
+     * reset, so the output stays up through a transmission. */
+    uint8_t reg_base = (pll == 'A') ? si5351a_PLLA_PARAMETERS : si5351a_PLLB_PARAMETERS;
+    uint8_t reg_vals[8];
+    si5351a_pack_params(a, b, c, reg_vals);
+
+    return si5351a_write_multiple(dev, reg_base, reg_vals, sizeof(reg_vals));
 }
 
 int si5351a_set_ms(const struct device *dev, uint8_t ms, uint32_t a, uint32_t b, uint32_t c, char pll) {
@@ -386,29 +454,9 @@ int si5351a_set_ms(const struct device *dev, uint8_t ms, uint32_t a, uint32_t b,
         return -EINVAL;
     }
 
-    uint32_t p1, p2, p3;
-
-    if (b == 0) {
-        p1 = 128 * a - 512;
-        p2 = b;
-        p3 = c;
-    } else {
-        p1 = (uint32_t)(128 * a + floor(128 * ((double)b / (double)c)) - 512);
-        p2 = (128 * b - c * floor(128 * ((double)b / (double)c)));
-        p3 = c;
-    }
-
     uint8_t reg_base = si5351a_CLK0_PARAMETERS + ms * 8;
-    uint8_t reg_vals[8] = {
-        (p3 & 0x0000FF00) >> 8,
-        (p3 & 0x000000FF),
-        (p1 & 0x00030000) >> 16,
-        (p1 & 0x0000FF00) >> 8,
-        (p1 & 0x000000FF),
-        ((p3 & 0x000F0000) >> 12) | ((p2 & 0x000F0000) >> 16),
-        (p2 & 0x0000FF00) >> 8,
-        (p2 & 0x000000FF),
-    };
+    uint8_t reg_vals[8];
+    si5351a_pack_params(a, b, c, reg_vals);
 
     int ret = si5351a_write_multiple(dev, reg_base, reg_vals, sizeof(reg_vals));
     if (ret) {
@@ -417,19 +465,11 @@ int si5351a_set_ms(const struct device *dev, uint8_t ms, uint32_t a, uint32_t b,
 
     /* Configure CLK control register: power up output, set source to MSx,
      * select PLL, set 8mA drive strength */
-    uint8_t clk_ctrl = si5351a_CLK_INPUT_MULTISYNTH_N | 0x03; /* MSx source, 8mA drive */
-    if (pll == 'B') {
-        clk_ctrl |= si5351a_CLK_PLL_SELECT;
-    }
-    if (b == 0) {
-        clk_ctrl |= si5351a_CLK_INTEGER_MODE;
-    }
-
-    return si5351a_write_reg(dev, si5351a_CLK0_CTRL + ms, clk_ctrl);
+    return si5351a_set_clk_ctrl(dev, ms, pll, b == 0);
 }
 
-int si5351a_set_ms_freq(const struct device *dev, uint8_t ms,
-                       uint32_t freq_hz, uint32_t freq_millihz, char pll) {
+static int si5351a_calc_ms(const struct device *dev, uint8_t ms, uint64_t freq_uhz, char pll,
+                           uint32_t *a, uint32_t *b, uint32_t *c) {
     struct si5351a_data *data = dev->data;
 
     if (ms > 7) {
@@ -438,29 +478,151 @@ int si5351a_set_ms_freq(const struct device *dev, uint8_t ms,
     if (pll != 'A' && pll != 'B') {
         return -EINVAL;
     }
-    if (freq_millihz >= 1000) {
-        return -EINVAL;
-    }
 
     uint32_t pll_freq = (pll == 'A') ? data->plla_freq : data->pllb_freq;
     if (pll_freq == 0) {
         return -EINVAL;
     }
 
-    uint64_t freq_mhz = (uint64_t)freq_hz * 1000 + freq_millihz;
-    if (freq_mhz == 0) {
+    if (freq_uhz == 0 || freq_uhz > si5351a_MULTISYNTH_MAX_FREQ * 1000000) {
         return -EINVAL;
     }
 
-    uint64_t pll_freq_mhz = (uint64_t)pll_freq * 1000;
-    uint32_t a = (uint32_t)(pll_freq_mhz / freq_mhz);
-    uint64_t remainder = pll_freq_mhz % freq_mhz;
-    uint32_t c = RFRAC_DENOM;
-    uint32_t b = (uint32_t)((remainder * c) / freq_mhz);
+    si5351a_calc_ratio((uint64_t)pll_freq * 1000000, freq_uhz, a, b, c);
+
+    return 0;
+}
+
+int si5351a_set_ms_freq(const struct device *dev, uint8_t ms, uint64_t freq_uhz, char pll) {
+    uint32_t a, b, c;
+
+    int ret = si5351a_calc_ms(dev, ms, freq_uhz, pll, &a, &b, &c);
+    if (ret) {
+        return ret;
+    }
 
     return si5351a_set_ms(dev, ms, a, b, c, pll);
 }
 
+int si5351a_prepare_ms_freq(const struct device *dev, uint8_t ms, uint64_t freq_uhz, char pll,
+                            struct si5351a_ms_regs *regs) {
+    struct si5351a_data *data = dev->data;
+
+    if (pll != 'A' && pll != 'B') {
+        return -EINVAL;
+    }
+
+    return si5351a_plan_ms_regs((pll == 'A') ? data->plla_freq : data->pllb_freq, ms, freq_uhz,
+                                regs);
+}
+
+int si5351a_write_ms_regs(const struct device *dev, const struct si5351a_ms_regs *regs) {
+    const struct si5351a_config *cfg = dev->config;
+
+    int ret = si5351a_bus_acquire(dev);
+    if (ret) {
+        return ret;
+    }
+    ret = i2c_write_dt(&cfg->i2c, regs->buf, sizeof(regs->buf));
+    si5351a_bus_release(dev);
+
+    return ret;
+}
+
+#ifdef CONFIG_SI5351A_ASYNC
+static void si5351a_async_done(const struct device *i2c_dev, int result, void *user_data) {
+    const struct device *dev = user_data;
+    struct si5351a_data *data = dev->data;
+    si5351a_callback_t cb = data->async_cb;
+    void *cb_data = data->async_user_data;
+
+    si5351a_bus_release(dev);
+
+    if (cb) {
+        cb(dev, result, cb_data);
+    }
+}
+#endif
+
+int si5351a_write_ms_regs_async(const struct device *dev, const struct si5351a_ms_regs *regs,
+                                si5351a_callback_t cb, void *user_data) {
+    struct si5351a_data *data = dev->data;
+    const struct si5351a_config *cfg = dev->config;
+
+    if (k_sem_take(&data->bus_idle, K_NO_WAIT)) {
+        return -EBUSY;
+    }
+
+#ifdef CONFIG_SI5351A_ASYNC
+    data->async_cb = cb;
+    data->async_user_data = user_data;
+    data->async_msg.buf = (uint8_t *)regs->buf;
+    data->async_msg.len = sizeof(regs->buf);
+    data->async_msg.flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+
+    int ret = i2c_transfer_cb_dt(&cfg->i2c, &data->async_msg, 1,
+                                 si5351a_async_done, (void *)dev);
+    if (ret != -ENOSYS) {
+        if (ret) {
+            si5351a_bus_release(dev);
+        }
+        return ret;
+    }
+#endif
+
+    /* Bus driver has no callback support: complete inline */
+    int result = i2c_write_dt(&cfg->i2c, regs->buf, sizeof(regs->buf));
+    si5351a_bus_release(dev);
+    if (cb) {
+        cb(dev, result, user_data);
+    }
+
+    return 0;
+}
+
+int si5351a_set_clk_ctrl(const struct device *dev, uint8_t ms, char pll, bool integer_mode) {
+    if (ms > 7) {
+        return -EINVAL;
+    }
+    if (pll != 'A' && pll != 'B') {
+        return -EINVAL;
+    }
+
+    uint8_t clk_ctrl = si5351a_CLK_INPUT_MULTISYNTH_N | 0x03; /* MSx source, 8mA drive */
+    if (pll == 'B') {
+        clk_ctrl |= si5351a_CLK_PLL_SELECT;
+    }
+    if (integer_mode) {
+        clk_ctrl |= si5351a_CLK_INTEGER_MODE;
+    }
+
+    int ret = si5351a_write_reg(dev, si5351a_CLK0_CTRL + ms, clk_ctrl);
+    if (ret == 0) {
+        struct si5351a_data *data = dev->data;
+        data->clk_ctrl[ms] = clk_ctrl;
+    }
+    return ret;
+}
+
+int si5351a_set_clk_invert(const struct device *dev, uint8_t ms, bool invert) {
+    struct si5351a_data *data = dev->data;
+
+    if (ms > 7) {
+        return -EINVAL;
+    }
+
+    uint8_t clk_ctrl = data->clk_ctrl[ms] & ~si5351a_CLK_INVERT;
+    if (invert) {
+        clk_ctrl |= si5351a_CLK_INVERT;
+    }
+
+    int ret = si5351a_write_reg(dev, si5351a_CLK0_CTRL + ms, clk_ctrl);
+    if (ret == 0) {
+        data->clk_ctrl[ms] = clk_ctrl;
+    }
+    return ret;
+}
+
 int si5351a_enable_output(const struct device *dev, uint8_t output, bool enable) {
     if (output > 7) {
         return -EINVAL;
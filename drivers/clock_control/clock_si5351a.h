@@ -1,6 +1,7 @@
 #include "config.h"
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/device.h>
+#include <zephyr/kernel.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -25,6 +26,14 @@ struct si5351a_int_status {
     uint8_t LOS_STKY;
 };
 
+typedef void (*si5351a_callback_t)(const struct device *dev, int result, void *user_data);
+
+/* Pre-computed multisynth parameter block: start register followed by the
+ * eight P1/P2/P3 bytes, ready to go out in a single bus write. */
+struct si5351a_ms_regs {
+    uint8_t buf[9];
+};
+
 struct si5351a_data {
     bool initialised;
     bool plla_configured;
@@ -33,8 +42,37 @@ struct si5351a_data {
     uint32_t pllb_freq;
     struct si5351a_status dev_status;
     struct si5351a_int_status dev_int_status;
+    int32_t plla_correction_ppb;
+    int32_t pllb_correction_ppb;
+    uint8_t clk_ctrl[8];
+    struct k_sem bus_idle;
+    struct i2c_msg async_msg;
+    si5351a_callback_t async_cb;
+    void *async_user_data;
 };
 
+/* Largest c of an a + b/c divider, PLL or multisynth: 20 register bits */
+#define si5351a_FRAC_DENOM_MAX  1048575ULL
+
+#define si5351a_MULTISYNTH_MAX_FREQ      200000000ULL
+#define si5351a_MULTISYNTH_A_MIN         6
+#define si5351a_MULTISYNTH_A_MAX         1800
+#define si5351a_CLK0_PARAMETERS          42
+
+/* a + b/c as close to num/den as c <= si5351a_FRAC_DENOM_MAX allows,
+ * with b < c and c = 1 for an integer ratio. */
+void si5351a_calc_ratio(uint64_t num, uint64_t den, uint32_t *a, uint32_t *b, uint32_t *c);
+
+/* Encode a + b/c into the P1/P2/P3 layout shared by the PLL and multisynth
+ * parameter blocks. Integer-only so it can run on the symbol path. */
+void si5351a_pack_params(uint32_t a, uint32_t b, uint32_t c, uint8_t reg_vals[8]);
+
+/* The block si5351a_prepare_ms_freq() builds for multisynth ms dividing a
+ * PLL at pll_freq Hz down to freq_uhz; -EINVAL when either is out of
+ * range or the divider is */
+int si5351a_plan_ms_regs(uint32_t pll_freq, uint8_t ms, uint64_t freq_uhz,
+                         struct si5351a_ms_regs *regs);
+
 struct si5351a_multisynth_config {
     uint32_t P1;
     uint32_t P2;
@@ -52,7 +90,17 @@ int si5351a_update_status(const struct device *dev);
 int si5351a_reset_pll(const struct device *dev, bool reset_a, bool reset_b);
 int si5351a_set_pll(const struct device *dev, char pll, uint32_t a, uint32_t b, uint32_t c);
 int si5351a_set_pll_freq(const struct device *dev, char pll, uint32_t freq);
+int si5351a_set_pll_correction(const struct device *dev, char pll, int32_t ppb);
 int si5351a_set_ms(const struct device *dev, uint8_t ms, uint32_t a, uint32_t b, uint32_t c, char pll);
-int si5351a_set_ms_freq(const struct device *dev, uint8_t ms,
-                       uint32_t freq_hz, uint32_t freq_millihz, char pll);
+/* Output frequencies are in microhertz */
+int si5351a_set_ms_freq(const struct device *dev, uint8_t ms, uint64_t freq_uhz, char pll);
+int si5351a_set_clk_ctrl(const struct device *dev, uint8_t ms, char pll, bool integer_mode);
+/* 180 degree output phase via the CLK_INVERT bit, a single register write
+ * on top of the last si5351a_set_clk_ctrl() for that output */
+int si5351a_set_clk_invert(const struct device *dev, uint8_t ms, bool invert);
+int si5351a_prepare_ms_freq(const struct device *dev, uint8_t ms, uint64_t freq_uhz, char pll,
+                            struct si5351a_ms_regs *regs);
+int si5351a_write_ms_regs(const struct device *dev, const struct si5351a_ms_regs *regs);
+int si5351a_write_ms_regs_async(const struct device *dev, const struct si5351a_ms_regs *regs,
+                                si5351a_callback_t cb, void *user_data);
 int si5351a_enable_output(const struct device *dev, uint8_t output, bool enable);
\ No newline at end of file
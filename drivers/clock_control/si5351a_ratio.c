@@ -0,0 +1,82 @@
+#include "clock_si5351a.h"
+
+#include <errno.h>
+
+/* Walk the continued fraction of the remainder: each convergent is the
+ * closest fraction with a denominator no larger than its own. When the
+ * next one no longer fits, the semiconvergent with the largest
+ * denominator that does is closer than the last convergent exactly when
+ * it is more than halfway to the next one. */
+void si5351a_calc_ratio(uint64_t num, uint64_t den, uint32_t *a, uint32_t *b, uint32_t *c) {
+    uint64_t p0 = 0, q0 = 1;    // convergent before last
+    uint64_t p1 = 1, q1 = 0;    // last convergent
+    uint64_t n = num % den;
+    uint64_t d = den;
+
+    *a = (uint32_t)(num / den);
+
+    while (d != 0) {
+        uint64_t t = n / d;
+        uint64_t r = n - t * d;
+
+        if (q1 != 0 && t > (si5351a_FRAC_DENOM_MAX - q0) / q1) {
+            uint64_t s = (si5351a_FRAC_DENOM_MAX - q0) / q1;
+            if (2 * s > t) {
+                p1 = s * p1 + p0;
+                q1 = s * q1 + q0;
+            }
+            break;
+        }
+
+        uint64_t p = t * p1 + p0;
+        uint64_t q = t * q1 + q0;
+        p0 = p1;
+        q0 = q1;
+        p1 = p;
+        q1 = q;
+        n = d;
+        d = r;
+    }
+
+    /* An exact integer ratio ends on 0/1 */
+    *b = (uint32_t)p1;
+    *c = (uint32_t)q1;
+}
+
+void si5351a_pack_params(uint32_t a, uint32_t b, uint32_t c, uint8_t reg_vals[8]) {
+    uint32_t frac = (128 * b) / c;
+    uint32_t p1 = 128 * a + frac - 512;
+    uint32_t p2 = 128 * b - c * frac;
+    uint32_t p3 = c;
+
+    reg_vals[0] = (p3 & 0x0000FF00) >> 8;
+    reg_vals[1] = (p3 & 0x000000FF);
+    reg_vals[2] = (p1 & 0x00030000) >> 16;
+    reg_vals[3] = (p1 & 0x0000FF00) >> 8;
+    reg_vals[4] = (p1 & 0x000000FF);
+    reg_vals[5] = ((p3 & 0x000F0000) >> 12) | ((p2 & 0x000F0000) >> 16);
+    reg_vals[6] = (p2 & 0x0000FF00) >> 8;
+    reg_vals[7] = (p2 & 0x000000FF);
+}
+
+int si5351a_plan_ms_regs(uint32_t pll_freq, uint8_t ms, uint64_t freq_uhz,
+                         struct si5351a_ms_regs *regs) {
+    uint32_t a, b, c;
+
+    if (ms > 7 || pll_freq == 0) {
+        return -EINVAL;
+    }
+    if (freq_uhz == 0 || freq_uhz > si5351a_MULTISYNTH_MAX_FREQ * 1000000) {
+        return -EINVAL;
+    }
+
+    si5351a_calc_ratio((uint64_t)pll_freq * 1000000, freq_uhz, &a, &b, &c);
+    if (a < si5351a_MULTISYNTH_A_MIN || a > si5351a_MULTISYNTH_A_MAX) {
+        return -EINVAL;
+    }
+
+    regs->buf[0] = si5351a_CLK0_PARAMETERS + ms * 8;
+    si5351a_pack_params(a, b, c, &regs->buf[1]);
+
+    return 0;
+}
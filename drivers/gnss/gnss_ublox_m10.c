@@ -0,0 +1,142 @@
+#include "gnss_ublox_m10.h"
+
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(ublox_m10, CONFIG_LOG_DEFAULT_LEVEL);
+
+#define DT_DRV_COMPAT u_blox_m10
+
+struct m10_data {
+    const struct device *dev;
+    struct m10_stream stream;
+    uint8_t rx_buf[CONFIG_GNSS_UBLOX_M10_READ_CHUNK];
+    struct k_thread thread;
+    K_KERNEL_STACK_MEMBER(stack, CONFIG_GNSS_UBLOX_M10_STACK_SIZE);
+};
+
+static void ubx_frame(uint8_t *frame, uint8_t cls, uint8_t id,
+                      const uint8_t *payload, uint16_t len) {
+    uint8_t ck_a = 0, ck_b = 0;
+
+    frame[0] = UBX_SYNC1;
+    frame[1] = UBX_SYNC2;
+    frame[2] = cls;
+    frame[3] = id;
+    sys_put_le16(len, &frame[4]);
+    memcpy(&frame[6], payload, len);
+
+    for (size_t i = 2; i < 6 + len; i++) {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    frame[6 + len] = ck_a;
+    frame[7 + len] = ck_b;
+}
+
+/* RAM layer only: NMEA off on DDC, NAV-PVT and NAV-TIMEUTC every epoch */
+static int m10_configure(const struct device *dev) {
+    const struct m10_config *cfg = dev->config;
+    static const uint8_t valset[] = {
+        0x00, 0x01, 0x00, 0x00,
+        0x02, 0x00, 0x72, 0x10, 0x00,   /* CFG-I2COUTPROT-NMEA = 0 */
+        0x06, 0x00, 0x91, 0x20, 0x01,   /* CFG-MSGOUT-UBX_NAV_PVT_I2C = 1 */
+        0x5b, 0x00, 0x91, 0x20, 0x01,   /* CFG-MSGOUT-UBX_NAV_TIMEUTC_I2C = 1 */
+    };
+    uint8_t frame[sizeof(valset) + 8];
+
+    ubx_frame(frame, UBX_CLASS_CFG, UBX_ID_CFG_VALSET, valset, sizeof(valset));
+    return i2c_write_dt(&cfg->i2c, frame, sizeof(frame));
+}
+
+static int m10_poll(const struct device *dev) {
+    const struct m10_config *cfg = dev->config;
+    struct m10_data *data = dev->data;
+    uint8_t avail_buf[2];
+
+    int ret = i2c_burst_read_dt(&cfg->i2c, M10_REG_BYTES_AVAIL_HI, avail_buf, sizeof(avail_buf));
+    if (ret) {
+        return ret;
+    }
+
+    uint16_t avail = sys_get_be16(avail_buf);
+    if (avail == 0xFFFF) {
+        return 0;
+    }
+
+    while (avail > 0) {
+        size_t n = MIN(avail, sizeof(data->rx_buf));
+        ret = i2c_burst_read_dt(&cfg->i2c, M10_REG_STREAM, data->rx_buf, n);
+        if (ret) {
+            return ret;
+        }
+        m10_stream_feed(&data->stream, data->rx_buf, n);
+        avail -= n;
+    }
+
+    return 0;
+}
+
+static void m10_thread(void *p1, void *p2, void *p3) {
+    const struct device *dev = p1;
+    struct m10_data *data = dev->data;
+    bool configured = false;
+
+    while (1) {
+        if (!configured) {
+            configured = m10_configure(dev) == 0;
+        }
+
+        if (m10_poll(dev)) {
+            data->stream.stats.bus_errors++;
+            configured = false;
+        }
+
+        k_sleep(K_MSEC(CONFIG_GNSS_UBLOX_M10_POLL_MS));
+    }
+}
+
+int m10_get_fix(const struct device *dev, struct m10_fix *out) {
+    struct m10_data *data = dev->data;
+    return m10_stream_get_fix(&data->stream, out);
+}
+
+void m10_get_stats(const struct device *dev, struct m10_stats *out) {
+    struct m10_data *data = dev->data;
+    *out = data->stream.stats;
+}
+
+static int m10_init(const struct device *dev) {
+    const struct m10_config *cfg = dev->config;
+    struct m10_data *data = dev->data;
+
+    if (!i2c_is_ready_dt(&cfg->i2c)) {
+        LOG_ERR("I2C bus not ready");
+        return -ENODEV;
+    }
+
+    data->dev = dev;
+    m10_stream_init(&data->stream);
+
+    k_thread_create(&data->thread, data->stack, K_KERNEL_STACK_SIZEOF(data->stack),
+                    m10_thread, (void *)dev, NULL, NULL,
+                    CONFIG_GNSS_UBLOX_M10_THREAD_PRIO, 0, K_NO_WAIT);
+    k_thread_name_set(&data->thread, "m10");
+
+    return 0;
+}
+
+#define M10_INST(inst)                                              \
+    static struct m10_data m10_data_##inst;                         \
+    static const struct m10_config m10_config_##inst = {            \
+        .i2c = I2C_DT_SPEC_INST_GET(inst),                          \
+    };                                                              \
+    DEVICE_DT_INST_DEFINE(inst, m10_init, NULL,                     \
+                          &m10_data_##inst,                         \
+                          &m10_config_##inst,                       \
+                          POST_KERNEL,                              \
+                          CONFIG_GNSS_UBLOX_M10_INIT_PRIORITY,      \
+                          NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(M10_INST)
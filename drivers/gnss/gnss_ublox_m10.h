@@ -0,0 +1,115 @@
+#ifndef DRIVERS_GNSS_UBLOX_M10_H
+#define DRIVERS_GNSS_UBLOX_M10_H
+
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* DDC (I2C) register map */
+#define M10_REG_BYTES_AVAIL_HI  0xFD
+#define M10_REG_STREAM          0xFF
+
+#define UBX_SYNC1               0xB5
+#define UBX_SYNC2               0x62
+#define UBX_CLASS_NAV           0x01
+#define UBX_CLASS_CFG           0x06
+#define UBX_ID_NAV_PVT          0x07
+#define UBX_ID_NAV_TIMEUTC      0x21
+#define UBX_ID_CFG_VALSET       0x8A
+
+#define UBX_NAV_PVT_LEN         92
+#define UBX_NAV_TIMEUTC_LEN     20
+
+/* NAV-PVT fixType */
+#define M10_FIX_NONE            0
+#define M10_FIX_2D              2
+#define M10_FIX_3D              3
+#define M10_FIX_TIME_ONLY       5
+
+/* Latest navigation solution. Time fields come from whichever of NAV-PVT
+ * or NAV-TIMEUTC arrived last; position only from NAV-PVT. */
+struct m10_fix {
+    uint32_t itow_ms;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    bool time_valid;
+    int32_t nano;
+    uint32_t t_acc_ns;
+    uint8_t fix_type;
+    bool fix_ok;
+    uint8_t num_sv;
+    int32_t lat_e7;
+    int32_t lon_e7;
+    int32_t height_msl_mm;
+    uint32_t h_acc_mm;
+    uint32_t v_acc_mm;
+    int64_t updated_ms;
+};
+
+struct m10_stats {
+    uint32_t bytes;
+    uint32_t pvt;
+    uint32_t timeutc;
+    uint32_t bad_checksum;
+    uint32_t bus_errors;
+};
+
+#define M10_MAX_FIELDS          18
+
+struct m10_field {
+    uint8_t off;
+    uint8_t len;
+};
+
+/* Streaming UBX decoder. Fields of interest are assembled straight from
+ * the input bytes by payload offset; payloads are never buffered. */
+struct m10_parser {
+    uint8_t state;
+    uint8_t msg_class;
+    uint8_t msg_id;
+    uint16_t len;
+    uint16_t pos;
+    uint8_t ck_a;
+    uint8_t ck_b;
+    uint8_t rx_ck_a;
+    const struct m10_field *fields;
+    uint8_t n_fields;
+    uint8_t field;
+    uint32_t slots[M10_MAX_FIELDS];
+};
+
+/* Byte stream to fix: the DDC stream of one receiver after the bus.
+ * Kept apart from the driver so canned streams can be fed to it. */
+struct m10_stream {
+    struct m10_parser parser;
+    /* Latched seqlock: while seq is odd fix[0] is being written and
+     * readers use fix[1], and the other way round while it is even. A
+     * reader never waits on a preempted writer. */
+    atomic_t seq;
+    struct m10_fix fix[2];
+    struct m10_fix work;
+    struct m10_stats stats;
+};
+
+struct m10_config {
+    struct i2c_dt_spec i2c;
+};
+
+void m10_stream_init(struct m10_stream *s);
+/* Parse len bytes; returns the number of NAV messages applied. The fix
+ * is published once per call, so a message's fields land together. */
+int m10_stream_feed(struct m10_stream *s, const uint8_t *buf, size_t len);
+int m10_stream_get_fix(struct m10_stream *s, struct m10_fix *out);
+
+/* Lock-free copy of the latest fix; -EAGAIN until the first message */
+int m10_get_fix(const struct device *dev, struct m10_fix *out);
+void m10_get_stats(const struct device *dev, struct m10_stats *out);
+
+#endif // DRIVERS_GNSS_UBLOX_M10_H
@@ -0,0 +1,264 @@
+#include "gnss_ublox_m10.h"
+
+#include <zephyr/sys/barrier.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <string.h>
+
+enum {
+    UBX_SYNC_1,
+    UBX_SYNC_2,
+    UBX_CLASS,
+    UBX_ID,
+    UBX_LEN_1,
+    UBX_LEN_2,
+    UBX_PAYLOAD,
+    UBX_CK_A,
+    UBX_CK_B,
+};
+
+#define UBX_MSG_DONE 1
+
+/* Payload offsets we keep, sorted by offset; slot index = table index */
+enum {
+    PVT_ITOW, PVT_YEAR, PVT_MONTH, PVT_DAY, PVT_HOUR, PVT_MIN, PVT_SEC,
+    PVT_VALID, PVT_TACC, PVT_NANO, PVT_FIX_TYPE, PVT_FLAGS, PVT_NUM_SV,
+    PVT_LON, PVT_LAT, PVT_HMSL, PVT_HACC, PVT_VACC,
+};
+
+static const struct m10_field pvt_fields[] = {
+    [PVT_ITOW] = { 0, 4 },      [PVT_YEAR] = { 4, 2 },
+    [PVT_MONTH] = { 6, 1 },     [PVT_DAY] = { 7, 1 },
+    [PVT_HOUR] = { 8, 1 },      [PVT_MIN] = { 9, 1 },
+    [PVT_SEC] = { 10, 1 },      [PVT_VALID] = { 11, 1 },
+    [PVT_TACC] = { 12, 4 },     [PVT_NANO] = { 16, 4 },
+    [PVT_FIX_TYPE] = { 20, 1 }, [PVT_FLAGS] = { 21, 1 },
+    [PVT_NUM_SV] = { 23, 1 },   [PVT_LON] = { 24, 4 },
+    [PVT_LAT] = { 28, 4 },      [PVT_HMSL] = { 36, 4 },
+    [PVT_HACC] = { 40, 4 },     [PVT_VACC] = { 44, 4 },
+};
+
+enum {
+    TU_ITOW, TU_TACC, TU_NANO, TU_YEAR, TU_MONTH, TU_DAY, TU_HOUR, TU_MIN,
+    TU_SEC, TU_VALID,
+};
+
+static const struct m10_field timeutc_fields[] = {
+    [TU_ITOW] = { 0, 4 },   [TU_TACC] = { 4, 4 },   [TU_NANO] = { 8, 4 },
+    [TU_YEAR] = { 12, 2 },  [TU_MONTH] = { 14, 1 }, [TU_DAY] = { 15, 1 },
+    [TU_HOUR] = { 16, 1 },  [TU_MIN] = { 17, 1 },   [TU_SEC] = { 18, 1 },
+    [TU_VALID] = { 19, 1 },
+};
+
+BUILD_ASSERT(ARRAY_SIZE(pvt_fields) <= M10_MAX_FIELDS);
+BUILD_ASSERT(ARRAY_SIZE(timeutc_fields) <= M10_MAX_FIELDS);
+
+/* NAV-PVT valid: validDate | validTime | fullyResolved */
+#define PVT_VALID_UTC       0x07
+#define PVT_FLAGS_FIX_OK    0x01
+/* NAV-TIMEUTC valid: validUTC */
+#define TU_VALID_UTC        0x04
+
+static inline void ubx_ck(struct m10_parser *p, uint8_t b) {
+    p->ck_a += b;
+    p->ck_b += p->ck_a;
+}
+
+static void ubx_select_fields(struct m10_parser *p) {
+    p->fields = NULL;
+    p->n_fields = 0;
+
+    if (p->msg_class != UBX_CLASS_NAV) {
+        return;
+    }
+    if (p->msg_id == UBX_ID_NAV_PVT && p->len == UBX_NAV_PVT_LEN) {
+        p->fields = pvt_fields;
+        p->n_fields = ARRAY_SIZE(pvt_fields);
+    } else if (p->msg_id == UBX_ID_NAV_TIMEUTC && p->len == UBX_NAV_TIMEUTC_LEN) {
+        p->fields = timeutc_fields;
+        p->n_fields = ARRAY_SIZE(timeutc_fields);
+    }
+
+    p->field = 0;
+    memset(p->slots, 0, p->n_fields * sizeof(p->slots[0]));
+}
+
+static inline void ubx_payload_byte(struct m10_parser *p, uint8_t b) {
+    if (p->field >= p->n_fields) {
+        return;
+    }
+
+    const struct m10_field *f = &p->fields[p->field];
+    if (p->pos < f->off) {
+        return;
+    }
+
+    uint8_t shift = p->pos - f->off;
+    p->slots[p->field] |= (uint32_t)b << (8 * shift);
+    if (shift + 1 == f->len) {
+        p->field++;
+    }
+}
+
+/* Feed one byte. Returns UBX_MSG_DONE when a message with a field table
+ * passed its checksum, -EBADMSG on a checksum failure, 0 otherwise. */
+static int ubx_parse(struct m10_parser *p, uint8_t b) {
+    switch (p->state) {
+    case UBX_SYNC_1:
+        if (b == UBX_SYNC1) {
+            p->state = UBX_SYNC_2;
+        }
+        return 0;
+    case UBX_SYNC_2:
+        p->state = (b == UBX_SYNC2) ? UBX_CLASS : (b == UBX_SYNC1 ? UBX_SYNC_2 : UBX_SYNC_1);
+        p->ck_a = 0;
+        p->ck_b = 0;
+        return 0;
+    case UBX_CLASS:
+        p->msg_class = b;
+        ubx_ck(p, b);
+        p->state = UBX_ID;
+        return 0;
+    case UBX_ID:
+        p->msg_id = b;
+        ubx_ck(p, b);
+        p->state = UBX_LEN_1;
+        return 0;
+    case UBX_LEN_1:
+        p->len = b;
+        ubx_ck(p, b);
+        p->state = UBX_LEN_2;
+        return 0;
+    case UBX_LEN_2:
+        p->len |= (uint16_t)b << 8;
+        ubx_ck(p, b);
+        p->pos = 0;
+        ubx_select_fields(p);
+        p->state = p->len ? UBX_PAYLOAD : UBX_CK_A;
+        return 0;
+    case UBX_PAYLOAD:
+        ubx_ck(p, b);
+        ubx_payload_byte(p, b);
+        if (++p->pos == p->len) {
+            p->state = UBX_CK_A;
+        }
+        return 0;
+    case UBX_CK_A:
+        p->rx_ck_a = b;
+        p->state = UBX_CK_B;
+        return 0;
+    case UBX_CK_B:
+    default:
+        p->state = UBX_SYNC_1;
+        if (p->rx_ck_a != p->ck_a || b != p->ck_b) {
+            return -EBADMSG;
+        }
+        return p->n_fields ? UBX_MSG_DONE : 0;
+    }
+}
+
+static void m10_publish(struct m10_stream *s) {
+    atomic_inc(&s->seq);
+    barrier_dmem_fence_full();
+    s->fix[0] = s->work;
+    barrier_dmem_fence_full();
+    atomic_inc(&s->seq);
+    barrier_dmem_fence_full();
+    s->fix[1] = s->work;
+}
+
+static void m10_apply_pvt(struct m10_stream *s, const uint32_t *v) {
+    struct m10_fix *fix = &s->work;
+
+    fix->itow_ms = v[PVT_ITOW];
+    fix->year = (uint16_t)v[PVT_YEAR];
+    fix->month = (uint8_t)v[PVT_MONTH];
+    fix->day = (uint8_t)v[PVT_DAY];
+    fix->hour = (uint8_t)v[PVT_HOUR];
+    fix->min = (uint8_t)v[PVT_MIN];
+    fix->sec = (uint8_t)v[PVT_SEC];
+    fix->time_valid = (v[PVT_VALID] & PVT_VALID_UTC) == PVT_VALID_UTC;
+    fix->t_acc_ns = v[PVT_TACC];
+    fix->nano = (int32_t)v[PVT_NANO];
+    fix->fix_type = (uint8_t)v[PVT_FIX_TYPE];
+    fix->fix_ok = (v[PVT_FLAGS] & PVT_FLAGS_FIX_OK) != 0;
+    fix->num_sv = (uint8_t)v[PVT_NUM_SV];
+    fix->lon_e7 = (int32_t)v[PVT_LON];
+    fix->lat_e7 = (int32_t)v[PVT_LAT];
+    fix->height_msl_mm = (int32_t)v[PVT_HMSL];
+    fix->h_acc_mm = v[PVT_HACC];
+    fix->v_acc_mm = v[PVT_VACC];
+    s->stats.pvt++;
+}
+
+static void m10_apply_timeutc(struct m10_stream *s, const uint32_t *v) {
+    struct m10_fix *fix = &s->work;
+
+    fix->itow_ms = v[TU_ITOW];
+    fix->t_acc_ns = v[TU_TACC];
+    fix->nano = (int32_t)v[TU_NANO];
+    fix->year = (uint16_t)v[TU_YEAR];
+    fix->month = (uint8_t)v[TU_MONTH];
+    fix->day = (uint8_t)v[TU_DAY];
+    fix->hour = (uint8_t)v[TU_HOUR];
+    fix->min = (uint8_t)v[TU_MIN];
+    fix->sec = (uint8_t)v[TU_SEC];
+    fix->time_valid = (v[TU_VALID] & TU_VALID_UTC) != 0;
+    s->stats.timeutc++;
+}
+
+int m10_stream_feed(struct m10_stream *s, const uint8_t *buf, size_t len) {
+    struct m10_parser *p = &s->parser;
+    int applied = 0;
+
+    s->stats.bytes += len;
+
+    for (size_t i = 0; i < len; i++) {
+        int ret = ubx_parse(p, buf[i]);
+        if (ret == 0) {
+            continue;
+        }
+        if (ret < 0) {
+            s->stats.bad_checksum++;
+            continue;
+        }
+
+        if (p->msg_id == UBX_ID_NAV_PVT) {
+            m10_apply_pvt(s, p->slots);
+        } else {
+            m10_apply_timeutc(s, p->slots);
+        }
+        applied++;
+    }
+
+    /* One publish per bulk read: PVT and TIMEUTC of the same epoch land
+     * together. */
+    if (applied) {
+        s->work.updated_ms = k_uptime_get();
+        m10_publish(s);
+    }
+
+    return applied;
+}
+
+int m10_stream_get_fix(struct m10_stream *s, struct m10_fix *out) {
+    atomic_val_t seq;
+
+    do {
+        seq = atomic_get(&s->seq);
+        if (seq == 0) {
+            return -EAGAIN;
+        }
+        barrier_dmem_fence_full();
+        *out = s->fix[seq & 1];
+        barrier_dmem_fence_full();
+    } while (atomic_get(&s->seq) != seq);
+
+    return 0;
+}
+
+void m10_stream_init(struct m10_stream *s) {
+    memset(s, 0, sizeof(*s));
+    s->parser.state = UBX_SYNC_1;
+    atomic_set(&s->seq, 0);
+}
@@ -8,6 +8,7 @@ LOG_MODULE_REGISTER(tps55289, CONFIG_REGULATOR_LOG_LEVEL);
 #define DT_DRV_COMPAT ti_tps55289
 
 struct tps55289_config {
+    struct regulator_common_config common;
     struct i2c_dt_spec i2c;
     bool external_fb;
     uint32_t r_top;
@@ -18,31 +19,109 @@ struct tps55289_config {
     bool discharge;
 };
 
+/* Shadow of the registers this driver writes. The device is only ever
+ * written through this driver, so reads are served from here. */
 struct tps55289_data {
     struct regulator_common_data common;
+    uint16_t ref;
+    uint8_t mode;
+    uint8_t status;
 };
 
+static int32_t tps55289_ref_to_uv(const struct device *dev, uint16_t ref) {
+    const struct tps55289_config *cfg = dev->config;
+    static const uint32_t ratios_x10000[] = {2256, 1128, 752, 564};
+
+    /* Vref = 45mV + (Val * 0.5645mV) */
+    uint64_t vref_uv = 45000ULL + ((uint64_t)ref * 5645ULL) / 10ULL;
+
+    if (cfg->external_fb) {
+        return (int32_t)((vref_uv * (cfg->r_top + cfg->r_bottom)) / cfg->r_bottom);
+    }
+    return (int32_t)((vref_uv * 10000) / ratios_x10000[cfg->int_fb_ratio & 0x03]);
+}
+
+static int tps55289_write_mode(const struct device *dev, uint8_t mode) {
+    const struct tps55289_config *cfg = dev->config;
+    struct tps55289_data *data = dev->data;
+
+    if (mode == data->mode) {
+        return 0;
+    }
+
+    int ret = i2c_reg_write_byte_dt(&cfg->i2c, TPS55289_REG_MODE, mode);
+    if (ret == 0) {
+        data->mode = mode;
+    }
+    return ret;
+}
+
 /* --- API Implementation --- */
 
 static int tps55289_enable(const struct device *dev) {
-    const struct tps55289_config *cfg = dev->config;
+    struct tps55289_data *data = dev->data;
     LOG_INF("Enabling TPS55289 output");
-    return i2c_reg_update_byte_dt(&cfg->i2c, TPS55289_REG_MODE, TPS55289_MODE_OE, TPS55289_MODE_OE);
+    return tps55289_write_mode(dev, data->mode | TPS55289_MODE_OE);
 }
 
 static int tps55289_disable(const struct device *dev) {
-    const struct tps55289_config *cfg = dev->config;
+    struct tps55289_data *data = dev->data;
     LOG_INF("Disabling TPS55289 output");
-    return i2c_reg_update_byte_dt(&cfg->i2c, TPS55289_REG_MODE, TPS55289_MODE_OE, 0);
+    return tps55289_write_mode(dev, data->mode & ~TPS55289_MODE_OE);
 }
 
-static int tps55289_get_status(const struct device *dev, uint8_t *status_reg) {
+int tps55289_get_status(const struct device *dev, uint8_t *status_reg) {
     const struct tps55289_config *cfg = dev->config;
-    return i2c_reg_read_byte_dt(&cfg->i2c, TPS55289_REG_STATUS, status_reg);
+    struct tps55289_data *data = dev->data;
+
+    int ret = i2c_reg_read_byte_dt(&cfg->i2c, TPS55289_REG_STATUS, status_reg);
+    if (ret == 0) {
+        data->status = *status_reg;
+    }
+    return ret;
+}
+
+static int tps55289_get_error_flags(const struct device *dev, regulator_error_flags_t *flags) {
+    uint8_t status;
+
+    int ret = tps55289_get_status(dev, &status);
+    if (ret) {
+        return ret;
+    }
+
+    *flags = 0;
+    if (status & (TPS55289_STATUS_SCP | TPS55289_STATUS_OCP)) {
+        *flags |= REGULATOR_ERROR_OVER_CURRENT;
+    }
+    if (status & TPS55289_STATUS_OVP) {
+        *flags |= REGULATOR_ERROR_OVER_VOLTAGE;
+    }
+    return 0;
+}
+
+static unsigned int tps55289_count_voltages(const struct device *dev) {
+    return TPS55289_REF_MAX + 1;
+}
+
+static int tps55289_list_voltage(const struct device *dev, unsigned int idx, int32_t *volt_uv) {
+    if (idx > TPS55289_REF_MAX) {
+        return -EINVAL;
+    }
+
+    *volt_uv = tps55289_ref_to_uv(dev, idx);
+    return 0;
+}
+
+static int tps55289_get_voltage(const struct device *dev, int32_t *volt_uv) {
+    struct tps55289_data *data = dev->data;
+
+    *volt_uv = tps55289_ref_to_uv(dev, data->ref);
+    return 0;
 }
 
 static int tps55289_set_voltage(const struct device *dev, int32_t min_uv, int32_t max_uv) {
     const struct tps55289_config *cfg = dev->config;
+    struct tps55289_data *data = dev->data;
     uint64_t vref_uv;
 
     if (cfg->external_fb) {
@@ -57,9 +136,18 @@ static int tps55289_set_voltage(const struct device *dev, int32_t min_uv, int32_
 
     /* Vref = 45mV + (Val * 0.5645mV) -> Val = (Vref - 45) / 0.5645 */
     uint32_t val = (uint32_t)(((vref_uv - 45000ULL) * 10ULL) / 5645ULL);
+    val = MIN(val, TPS55289_REF_MAX);
+    if (val == data->ref) {
+        return 0;
+    }
+
     uint8_t buf[2] = { val & 0xFF, (val >> 8) & 0x07 };
 
-    return i2c_burst_write_dt(&cfg->i2c, TPS55289_REG_REF_LSB, buf, 2);
+    int ret = i2c_burst_write_dt(&cfg->i2c, TPS55289_REG_REF_LSB, buf, 2);
+    if (ret == 0) {
+        data->ref = val;
+    }
+    return ret;
 }
 
 static int tps55289_set_current_limit(const struct device *dev, int32_t min_ua, int32_t max_ua) {
@@ -77,8 +165,17 @@ static int tps55289_set_current_limit(const struct device *dev, int32_t min_ua,
 
 static int tps55289_init(const struct device *dev) {
     const struct tps55289_config *cfg = dev->config;
+    struct tps55289_data *data = dev->data;
     if (!device_is_ready(cfg->i2c.bus)) return -ENODEV;
 
+    regulator_common_data_init(dev);
+
+    /* Seed the REF shadow; everything else is written below */
+    uint8_t ref_buf[2];
+    int ret = i2c_burst_read_dt(&cfg->i2c, TPS55289_REG_REF_LSB, ref_buf, 2);
+    if (ret) return ret;
+    data->ref = ref_buf[0] | ((ref_buf[1] & 0x07) << 8);
+
     /* Set Feedback Source */
     uint8_t fs_val = (cfg->external_fb ? TPS55289_FS_FB_SEL : 0) | (cfg->int_fb_ratio & 0x03);
     i2c_reg_write_byte_dt(&cfg->i2c, TPS55289_REG_VOUT_FS, fs_val);
@@ -91,21 +188,29 @@ static int tps55289_init(const struct device *dev) {
 
     /* Initial Mode Setup */
     uint8_t mode_val = (cfg->discharge ? TPS55289_MODE_DISCHG : 0) | TPS55289_MODE_HICCUP;
-    i2c_reg_write_byte_dt(&cfg->i2c, TPS55289_REG_MODE, mode_val);
+    ret = i2c_reg_write_byte_dt(&cfg->i2c, TPS55289_REG_MODE, mode_val);
+    if (ret) return ret;
+    data->mode = mode_val;
+    data->status = 0;
 
-    return 0;
+    return regulator_common_init(dev, false);
 }
 
 static const struct regulator_driver_api tps55289_api = {
     .enable = tps55289_enable,
     .disable = tps55289_disable,
+    .count_voltages = tps55289_count_voltages,
+    .list_voltage = tps55289_list_voltage,
     .set_voltage = tps55289_set_voltage,
+    .get_voltage = tps55289_get_voltage,
     .set_current_limit = tps55289_set_current_limit,
+    .get_error_flags = tps55289_get_error_flags,
 };
 
 #define TPS55289_DEVICE(inst)                                                                      \
     static struct tps55289_data tps55289_data_##inst;                                              \
     static const struct tps55289_config tps55289_config_##inst = {                                 \
+        .common = REGULATOR_DT_INST_COMMON_CONFIG_INIT(inst),                                      \
         .i2c = I2C_DT_SPEC_INST_GET(inst),                                                         \
         .external_fb = DT_INST_PROP(inst, ti_external_feedback),                                   \
         .r_top = DT_INST_PROP_BY_IDX(inst, ti_feedback_resistors_ohms, 0),                         \
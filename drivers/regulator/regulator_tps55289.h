@@ -2,6 +2,7 @@
 #define ZEPHYR_DRIVERS_REGULATOR_TPS55289_H_
 
 #include <zephyr/types.h>
+#include <zephyr/device.h>
 
 /* Register Map */
 #define TPS55289_REG_REF_LSB      0x00
@@ -13,6 +14,9 @@
 #define TPS55289_REG_MODE         0x06
 #define TPS55289_REG_STATUS       0x07
 
+/* Highest REF code: Vref tops out at 1200mV */
+#define TPS55289_REF_MAX          2046
+
 /* MODE Register Bits (06h) */
 #define TPS55289_MODE_OE          BIT(7)
 #define TPS55289_MODE_FSWDBL      BIT(6)
@@ -29,6 +33,7 @@
 #define TPS55289_STATUS_OCP       BIT(6)
 #define TPS55289_STATUS_OVP       BIT(5)
 #define TPS55289_STATUS_MODE_MASK 0x03
+#define TPS55289_STATUS_FAULT_MASK (TPS55289_STATUS_SCP | TPS55289_STATUS_OCP | TPS55289_STATUS_OVP)
 
 enum tps55289_mode {
     TPS55289_OP_MODE_BOOST      = 0,
@@ -36,4 +41,7 @@ enum tps55289_mode {
     TPS55289_OP_MODE_BUCK_BOOST = 2,
 };
 
+/* Reads STATUS (fault bits clear on read) and refreshes the cached copy */
+int tps55289_get_status(const struct device *dev, uint8_t *status_reg);
+
 #endif /* ZEPHYR_DRIVERS_REGULATOR_TPS55289_H_ */
\ No newline at end of file
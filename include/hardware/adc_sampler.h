@@ -0,0 +1,49 @@
+#ifndef HARDWARE_ADC_SAMPLER_H
+#define HARDWARE_ADC_SAMPLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <zephyr/sys/slist.h>
+
+/* Frames per DMA half-buffer */
+#define ADC_SAMPLER_BLOCK     64
+#define ADC_SAMPLER_VREF_MV   3300
+#define ADC_SAMPLER_FULL      4095
+
+/* One scan of the power detectors: channel 11 (PA6) forward, channel 12
+ * (PA7) reflected, raw 12-bit counts. */
+struct adc_frame {
+    uint16_t fwd;
+    uint16_t ref;
+};
+
+/* Handlers run in the DMA ISR once per completed half-buffer. The frames
+ * stay valid until the handler returns. */
+struct adc_sampler_listener {
+    sys_snode_t node;
+    void (*handler)(const struct adc_frame *frames, size_t count);
+};
+
+/* Called from the ADC ISR at the highest interrupt priority */
+typedef void (*adc_sampler_awd_handler_t)(void);
+
+int adc_sampler_init(void);
+void adc_sampler_add_listener(struct adc_sampler_listener *listener);
+uint32_t adc_sampler_frame_hz(void);
+
+/* Analog watchdog on the reflected channel. It fires once when a
+ * conversion exceeds high_raw and then stays quiet until re-armed. Arming
+ * briefly restarts the scan, so consumers may see one short half-buffer. */
+int adc_sampler_arm_watchdog(uint16_t high_raw, adc_sampler_awd_handler_t handler);
+void adc_sampler_disarm_watchdog(void);
+
+static inline uint32_t adc_sampler_to_mv(uint32_t raw) {
+    return raw * ADC_SAMPLER_VREF_MV / ADC_SAMPLER_FULL;
+}
+
+static inline uint32_t adc_sampler_from_mv(uint32_t mv) {
+    uint32_t raw = mv * ADC_SAMPLER_FULL / ADC_SAMPLER_VREF_MV;
+    return raw > ADC_SAMPLER_FULL ? ADC_SAMPLER_FULL : raw;
+}
+
+#endif // HARDWARE_ADC_SAMPLER_H
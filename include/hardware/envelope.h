@@ -0,0 +1,78 @@
+#ifndef HARDWARE_ENVELOPE_H
+#define HARDWARE_ENVELOPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "radio_core.h"
+
+/* Transmit amplitude envelope on DAC1. The level sits at full scale
+ * unless a shaped symbol is on air, so unshaped modes are unaffected.
+ * Ramps are raised-cosine tables that TIM6 paces into the DAC by DMA;
+ * starting one is a few register writes and the only other CPU work is
+ * its transfer-complete interrupt. */
+
+/* Raised-cosine ramps, 0 to full scale and back in ENVELOPE_STEPS steps
+ * of the 12-bit DAC */
+#define ENVELOPE_STEPS  64
+
+extern const uint16_t envelope_rise[ENVELOPE_STEPS + 1];
+extern const uint16_t envelope_fall[ENVELOPE_STEPS + 1];
+
+/* Longest ramp the pacing timer can stretch to */
+uint32_t envelope_max_ramp_us(void);
+
+/* Hardware cycles between DAC steps of a ramp_us ramp, rounded down so
+ * the ramp never runs long; under 2 sets the end level at once */
+uint32_t envelope_step_cycles(uint32_t ramp_us);
+
+/* Ramps of a shaped symbol over [start_ticks, end_ticks): each is half
+ * the symbol or the longest ramp, whichever is shorter. The rise starts
+ * at start_ticks; the fall starts at fall_ticks and reaches zero on
+ * end_ticks or just before it, where the next symbol's phase flips. */
+struct envelope_plan {
+    uint32_t ramp_us;
+    int64_t fall_ticks;
+};
+
+void envelope_plan_shape(int64_t start_ticks, int64_t end_ticks, struct envelope_plan *plan);
+
+struct envelope_status {
+    bool ready;
+    uint32_t rise_us;       // keyed (CW) rise and fall time
+    uint32_t ramps;
+    uint32_t underruns;     // DAC DMA underruns, each a ramp cut short
+    /* CPU time per ramp: the start plus the completion interrupt */
+    uint32_t last_cpu_ns;
+    uint32_t max_cpu_ns;
+    uint32_t avg_cpu_ns;
+};
+
+int envelope_init(void);
+
+bool envelope_ready(void);
+
+/* Keyed ramp time; -EINVAL beyond what the pacing timer can stretch to */
+int envelope_set_rise_us(uint32_t rise_us);
+
+/* Key the envelope up or down now, for a TX_SHAPE_KEYED symbol lasting
+ * duration_us. The ramp is cut to half the symbol if the rise time would
+ * not fit; a duration of 0 sets the level at once. */
+void envelope_key(bool on, uint32_t duration_us);
+
+/* Play the ramps of a TX_SHAPE_RAMP_* symbol occupying
+ * [start_ticks, end_ticks) in absolute kernel ticks. Each ramp is a
+ * raised cosine over half the symbol; the rise starts now and the fall
+ * lands on zero at end_ticks. */
+void envelope_shape(int64_t start_ticks, int64_t end_ticks, uint8_t shape);
+
+/* Abandon any ramp and return to full scale */
+void envelope_stop(void);
+
+/* Cycle counter when the last falling ramp reached zero */
+uint32_t envelope_null_cycles(void);
+
+void envelope_get_status(struct envelope_status *out);
+
+void envelope_reset_stats(void);
+
+#endif // HARDWARE_ENVELOPE_H
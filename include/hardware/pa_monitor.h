@@ -0,0 +1,7 @@
+#ifndef HARDWARE_PA_MONITOR_H
+#define HARDWARE_PA_MONITOR_H
+
+/* Start polling the PA supply for faults; called when the PA is keyed */
+void pa_monitor_kick(void);
+
+#endif // HARDWARE_PA_MONITOR_H
@@ -0,0 +1,39 @@
+#ifndef HARDWARE_PPS_H
+#define HARDWARE_PPS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/sys/slist.h>
+
+/* One captured PPS edge. "ticks" counts the capture timer clock (MCU clock,
+ * or the Si5351 CLK2 output with CONFIG_PPS_TIMER_CLK2), "cycles" is the
+ * k_cycle_get_32() value back-dated to the edge itself. Intervals are the
+ * deltas to the previous accepted edge. */
+struct pps_event {
+    uint32_t seq;
+    uint32_t ticks;
+    uint32_t cycles;
+    uint32_t tick_interval;
+    uint32_t cycle_interval;
+};
+
+/* Handlers run in the capture ISR and must not block */
+struct pps_listener {
+    sys_snode_t node;
+    void (*handler)(const struct pps_event *evt);
+};
+
+/* Runs in the capture ISR once the timer reaches the armed count; "late"
+ * is how many timer ticks the ISR ran after the match. */
+typedef void (*pps_compare_handler_t)(uint32_t late);
+
+int pps_init(void);
+void pps_add_listener(struct pps_listener *listener);
+uint32_t pps_timer_hz(void);
+uint32_t pps_timer_now(void);
+void pps_compare_arm(uint32_t ticks, pps_compare_handler_t handler);
+void pps_compare_cancel(void);
+uint32_t pps_last_cycles(void);
+bool pps_present(void);
+
+#endif /* HARDWARE_PPS_H */
@@ -0,0 +1,22 @@
+#ifndef HARDWARE_SWR_GUARD_H
+#define HARDWARE_SWR_GUARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Latencies are measured from entry into the watchdog ISR */
+struct swr_guard_status {
+    bool armed;
+    bool tripped;
+    uint16_t threshold_mv;
+    uint32_t rx_latency_ns;
+    uint32_t off_latency_us;
+};
+
+/* Arm on the reflected detector at threshold_mv; 0 disarms. Either call
+ * clears a latched trip. */
+int swr_guard_set_threshold(uint16_t threshold_mv);
+bool swr_guard_tripped(void);
+void swr_guard_get_status(struct swr_guard_status *out);
+
+#endif // HARDWARE_SWR_GUARD_H
@@ -0,0 +1,70 @@
+#ifndef MODES_DECODERS_FT8_H
+#define MODES_DECODERS_FT8_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "modes/ftx.h"
+
+/* FT8 receiver for one 15 s slot of 12 kHz audio at a time. Samples are
+ * mixed down around a centre frequency, decimated to 800 Hz complex and
+ * turned into a waterfall of 3.125 Hz columns every half symbol as they
+ * arrive, so a slot is never held as audio. At the end of the slot the
+ * waterfall is searched for Costas arrays and each candidate is decoded.
+ *
+ * RAM budget on the STM32L431 (64 KB SRAM), all static:
+ *   waterfall     186 rows x 2 x CONFIG_FT8_DECODE_BINS   20,832 at 56 bins
+ *   decimators    I/Q FIR state and block buffers          1,696
+ *   FFT           overlap buffer and work buffer           1,536
+ *   LDPC          check messages and bit totals (ftx.c)    1,858
+ *   candidates    soft bits and payloads decoded             732
+ * about 26 KB at the default width of 350 Hz. Each further 6.25 Hz of
+ * width costs 372 bytes; the 700 Hz the decimation passes needs 47 KB.
+ *
+ * Not reentrant: one slot at a time, fed and decoded from one thread. */
+
+#define FT8_RX_SAMPLE_HZ    12000
+#define FT8_RX_SLOT_SAMPLES (15 * FT8_RX_SAMPLE_HZ)
+
+struct ft8_decode {
+    ftx_payload_t payload;
+    uint16_t freq_hz;       // audio frequency of tone 0
+    int16_t dt_ms;          // start relative to 0.5 s into the slot
+    int8_t snr_db;          // rough, in 2500 Hz
+    int16_t sync_score;     // Costas match, 0.5 dB units
+};
+
+struct ft8_rx_stats {
+    uint32_t slots;
+    /* Last slot decoded */
+    uint32_t candidates;
+    uint32_t decodes;
+    uint32_t ldpc_failures;     // candidates that never satisfied the checks
+    uint32_t crc_failures;
+    uint32_t feed_cpu_us;       // front end over the whole slot
+    uint32_t decode_cpu_us;     // sync search, soft bits and LDPC
+    /* Across slots */
+    uint32_t total_decodes;
+    uint32_t max_decode_cpu_us;
+};
+
+/* Begin a slot with the window centred on center_hz of audio. Samples
+ * fed from here on are the slot, starting at its UTC boundary. */
+int ft8_rx_start(uint32_t center_hz);
+
+/* Feed 12 kHz samples. Returns how many were taken, fewer than count once
+ * the slot is full; call from thread context. */
+int ft8_rx_feed(const int16_t *samples, size_t count);
+
+/* Search the slot fed so far and decode up to max_decodes messages into
+ * out, strongest sync first. Returns the number decoded. */
+int ft8_rx_decode(struct ft8_decode *out, int max_decodes);
+
+void ft8_rx_get_stats(struct ft8_rx_stats *out);
+
+void ft8_rx_reset_stats(void);
+
+/* Locate the samples of a 12 kHz mono 16-bit PCM WAV image, as WSJT-X
+ * saves its slots, for feeding a recording. -EINVAL for anything else. */
+int ft8_wav_samples(const uint8_t *wav, size_t len, const int16_t **samples, size_t *count);
+
+#endif // MODES_DECODERS_FT8_H
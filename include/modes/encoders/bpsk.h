@@ -0,0 +1,19 @@
+#ifndef MODES_ENCODERS_BPSK_H
+#define MODES_ENCODERS_BPSK_H
+
+#include "radio_core.h"
+
+#define BPSK31_SYMBOL_US    32000   // 31.25 Bd
+#define BPSK31_PREAMBLE     32      // reversals ahead of the text
+#define BPSK31_POSTAMBLE    32      // steady carrier after it
+
+/* Varicode text, a phase reversal for each 0 bit. Symbols are produced
+ * on demand from phase bits held by the encoder; the next call
+ * replaces them. */
+int generate_bpsk31_sequence(const char* text, tx_sequence_t* tx_sequence);
+
+/* Symbols the sequence for text will have, preamble and postamble
+ * included */
+size_t bpsk31_symbol_count(const char* text);
+
+#endif // MODES_ENCODERS_BPSK_H
@@ -4,6 +4,26 @@
 #include <stdint.h>
 #include "radio_core.h"
 
+/* Gaps are key-up time between characters and words. Farnsworth timing
+ * keeps elements at the character speed and stretches the gaps so text
+ * arrives at the (lower) effective speed. */
+typedef struct {
+    uint32_t dot_us;
+    uint32_t char_gap_us;
+    uint32_t word_gap_us;
+} cw_timing_t;
+
+/* effective_wpm of 0, or not below wpm, gives standard spacing */
+void cw_timing(uint32_t wpm, uint32_t effective_wpm, cw_timing_t* timing);
+
+/* Morse for c in one byte, 0 when it has none. Elements run from bit 0
+ * up, 1 for a dash, and end below a marker bit: A (.-) is 0b110. Shift
+ * right while the code is above 1 to key it. */
+uint8_t cw_code(char c);
+
+/* Elements in a code from cw_code */
+int cw_code_length(uint8_t code);
+
 void generate_cw_sequence(const char* text, uint32_t wpm, tx_sequence_t* tx_sequence);
 
-#endif // MODES_ENCODERS_CW_H
\ No newline at end of file
+#endif // MODES_ENCODERS_CW_H
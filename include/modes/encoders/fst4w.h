@@ -0,0 +1,49 @@
+#ifndef MODES_ENCODERS_FST4W_H
+#define MODES_ENCODERS_FST4W_H
+
+#include <stdint.h>
+#include "radio_core.h"
+#include "modes/encoders/wspr.h"
+
+/* FST4W: the WSPR message with a CRC-24 and LDPC(240,74), sent as
+ * 160 symbols of 4-GFSK. 120 data symbols are framed by five 8-symbol
+ * sync words. The T/R period sets the symbol length. A symbol is nsps
+ * samples at 12 kHz, and the tones are 12000 / nsps Hz apart:
+ *   FST4W-120    nsps 8200     109.3 s    1.464 Hz
+ *   FST4W-300    nsps 21504    286.7 s    0.558 Hz
+ *   FST4W-900    nsps 66560    887.5 s    0.180 Hz
+ *   FST4W-1800   nsps 134400   1792.0 s   0.089 Hz */
+enum fst4w_period {
+    FST4W_120,
+    FST4W_300,
+    FST4W_900,
+    FST4W_1800,
+    FST4W_PERIOD_COUNT,
+};
+
+#define FST4W_SYMBOL_COUNT      160
+#define FST4W_LDPC_K            74      // message + CRC
+#define FST4W_LDPC_M            166     // parity bits
+#define FST4W_LDPC_N            240
+#define FST4W_CODEWORD_BYTES    30
+#define FST4W_TX_DELAY_US       1000000U    // into the period, as WSPR
+
+/* T/R period in us, and samples per symbol at 12 kHz */
+uint32_t fst4w_period_us(enum fst4w_period period);
+uint32_t fst4w_symbol_samples(enum fst4w_period period);
+
+/* Time from the start of the transmission to the start of symbol k, in
+ * us. Each boundary is rounded on its own, so rounding never builds up. */
+uint64_t fst4w_symbol_start_us(enum fst4w_period period, size_t k);
+
+/* The 50-bit message of wspr_pack_message, its CRC-24 and the parity */
+void fst4w_encode_codeword(const uint8_t message[WSPR_MESSAGE_BYTES],
+                           uint8_t codeword[FST4W_CODEWORD_BYTES]);
+
+/* Symbols are computed on demand through the sequence's source, from a
+ * codeword held by the encoder. The next call replaces it. The first
+ * symbol is shaped to ramp up and the last to ramp down. */
+int generate_fst4w_sequence(const wspr_payload_t *payload, enum fst4w_period period,
+                            tx_sequence_t *tx_sequence);
+
+#endif // MODES_ENCODERS_FST4W_H
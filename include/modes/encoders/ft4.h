@@ -0,0 +1,16 @@
+#ifndef MODES_ENCODERS_FT4_H
+#define MODES_ENCODERS_FT4_H
+
+#include <stdint.h>
+#include "radio_core.h"
+#include "modes/ftx.h"
+
+#define FT4_SLOT_US         7500000U
+#define FT4_TX_DELAY_US     300000U   // into the slot, as WSJT-X keys it
+
+/* Fills tx_sequence with 105 symbols (103 plus a ramp symbol at each end,
+ * shaped to rise and to fall) from a buffer owned by the encoder; the
+ * next call overwrites it. */
+int generate_ft4_sequence(const ftx_payload_t* payload, tx_sequence_t* tx_sequence);
+
+#endif // MODES_ENCODERS_FT4_H
@@ -5,6 +5,11 @@
 #include "radio_core.h"
 #include "modes/ftx.h"
 
-void generate_ft8_sequence(const ftx_payload_t* payload, const tx_sequence_t* tx_sequence);
+#define FT8_SLOT_US         15000000U
+#define FT8_TX_DELAY_US     500000U   // into the slot, as WSJT-X keys it
+
+/* Fills tx_sequence with 79 symbols from a buffer owned by the encoder;
+ * the next call overwrites it. */
+int generate_ft8_sequence(const ftx_payload_t* payload, tx_sequence_t* tx_sequence);
 
 #endif // MODES_ENCODERS_FT8_H
\ No newline at end of file
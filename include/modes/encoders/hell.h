@@ -0,0 +1,20 @@
+#ifndef MODES_ENCODERS_HELL_H
+#define MODES_ENCODERS_HELL_H
+
+#include "radio_core.h"
+
+/* Feld-Hell: 122.5 Bd on-off keying. Each character is a 7-column cell
+ * scanned bottom to top, 14 rows to a column with whole pixels two rows
+ * high, so a pixel lasts 8.163 ms and a character 400 ms. */
+#define HELL_COLUMNS        7
+#define HELL_PIXELS         7       // per column
+#define HELL_CELL_PIXELS    (HELL_COLUMNS * HELL_PIXELS)
+#define HELL_CELL_US        400000  // one pixel is HELL_CELL_US / HELL_CELL_PIXELS
+
+/* Runs of equal pixels are streamed to the engine as keyed symbols as the
+ * cells are scanned. Pixel k starts at round(k * 400000 / 49) us from
+ * the start, so rounding never builds up along the message. The text is
+ * copied; the next call replaces it. */
+int generate_hell_sequence(const char* text, tx_sequence_t* tx_sequence);
+
+#endif // MODES_ENCODERS_HELL_H
@@ -10,7 +10,32 @@ typedef struct {
     float    stop_bits;
     bool     reverse_shift;
     bool     use_center_freq;
+    bool     unshift_on_space;  // receiver returns to LTRS after a space
+    uint8_t  diddles;           // LTRS idle characters ahead of the text
 } rtty_config_t;
 
+#define RTTY_SYMBOLS_PER_CHAR   7   /* start, 5 data, stop */
+#define RTTY_BAUDOT_LTRS        0x1F
+
+/* Tone offsets and bit times derived from an rtty_config_t */
+typedef struct {
+    uint32_t   bit_us;
+    uint32_t   stop_us;
+    freq_uhz_t mark_offset;
+    freq_uhz_t space_offset;
+} rtty_keying_t;
+
+void rtty_keying(const rtty_config_t* config, rtty_keying_t* keying);
+
+/* Baudot codes for c into out, preceded by a shift when the receiver is
+ * in the wrong case. *figs tracks the receiver's shift. Returns the
+ * number of codes written (0 when c has no ITA2 character). */
+int rtty_encode_char(char c, bool* figs, bool unshift_on_space, uint8_t out[2]);
+
+/* Symbol pos (0 is the start bit, RTTY_SYMBOLS_PER_CHAR - 1 the stop) */
+void rtty_code_symbol(const rtty_keying_t* keying, uint8_t code, int pos, tx_symbol_t* out);
+
+/* Symbols are produced on demand from a packed copy of the text held by
+ * the encoder; the next call replaces it. */
 int generate_rtty_sequence(const char* text, const rtty_config_t* config, tx_sequence_t* tx_sequence);
 #endif // MODES_ENCODERS_RTTY_H
\ No newline at end of file
@@ -10,6 +10,16 @@ typedef struct {
     int power_dbm;
 } wspr_payload_t;
 
+#define WSPR_MESSAGE_BITS   50
+#define WSPR_MESSAGE_BYTES  7
+
+/* The 50-bit message, 28 bits of callsign then 22 of locator and power,
+ * MSB first and zero padded to whole bytes. FST4W sends the same one.
+ * -1 for a callsign, locator or power WSPR cannot carry. */
+int wspr_pack_message(const wspr_payload_t *payload, uint8_t message[WSPR_MESSAGE_BYTES]);
+
+/* Symbols are computed on demand through the sequence's source from a
+ * message held by the encoder; the next call replaces it. */
 int generate_wspr_sequence(const wspr_payload_t* payload, tx_sequence_t* tx_sequence);
 
 #endif // MODES_ENCODERS_WSPR_H
@@ -0,0 +1,80 @@
+#ifndef MODES_FEC_H
+#define MODES_FEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Forward error correction kernels shared by the digital mode encoders.
+ * Plain C with no kernel dependencies, so it builds for the target and
+ * on a host alike. Bit strings are packed MSB first throughout. */
+
+static inline uint8_t fec_parity32(uint32_t v) {
+    v ^= v >> 16;
+    v ^= v >> 8;
+    v ^= v >> 4;
+    return (0x6996 >> (v & 0x0F)) & 1;
+}
+
+/* Bit pos of an MSB-first bit string */
+static inline uint8_t fec_get_bit(const uint8_t *bits, size_t pos) {
+    return (bits[pos / 8] >> (7 - pos % 8)) & 1;
+}
+
+/* Copy nbits from the top of MSB-first words into dst from bit pos on.
+ * The destination bits must be clear. */
+void fec_put_bits(uint8_t *dst, size_t pos, const uint32_t *words, size_t nbits);
+
+/* MSB-first CRC, zero initial value, no final XOR. table[b] is the
+ * remainder of byte b shifted to the top of a width-bit register. */
+struct fec_crc {
+    uint8_t width;
+    uint32_t poly;
+    const uint32_t *table;
+};
+
+/* FT8/FT4: width 14, poly 0x2757 */
+extern const struct fec_crc fec_crc14;
+
+/* FST4W: width 24, poly 0x00065B */
+extern const struct fec_crc fec_crc24;
+
+uint32_t fec_crc(const struct fec_crc *crc, const uint8_t *bits, size_t nbits);
+
+/* Fill table for a CRC of width 8 to 32 and the given poly, for codes
+ * with no table built in */
+void fec_crc_make_table(uint8_t width, uint32_t poly, uint32_t table[256]);
+
+/* Parity of a systematic block code such as LDPC, evaluated a column at
+ * a time: each set message bit XORs its generator column (all m parity
+ * bits, packed into parity_words words) into the result, so every
+ * parity bit advances in parallel. columns holds k rows of
+ * parity_words words. */
+void fec_block_parity(const uint32_t *columns, size_t parity_words,
+                      const uint8_t *msg, size_t k, uint32_t *parity);
+
+/* Convolutional code of rate 1/rate and the given constraint length
+ * (at most 32), one generator polynomial per output bit. */
+struct fec_conv {
+    uint8_t constraint;
+    uint8_t rate;
+    const uint32_t *polys;
+};
+
+/* Encoder register after input bit k of an nbits message, bit k in the
+ * LSB. Bits past the message read as zero, which is the flush tail.
+ * Constant time from a few byte loads, so a channel symbol can be
+ * computed on its own without running the encoder up to it. */
+uint32_t fec_conv_state(const struct fec_conv *code, const uint8_t *msg,
+                        size_t nbits, size_t k);
+
+/* Output bit j of the rate outputs for register state */
+static inline uint8_t fec_conv_output(const struct fec_conv *code, uint32_t state, int j) {
+    return fec_parity32(state & code->polys[j]);
+}
+
+/* Encode nbits plus constraint - 1 tail bits into out, rate bits per
+ * input; out must be clear */
+void fec_conv_encode(const struct fec_conv *code, const uint8_t *msg, size_t nbits,
+                     uint8_t *out);
+
+#endif // MODES_FEC_H
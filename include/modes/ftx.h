@@ -97,6 +97,7 @@ typedef struct {
             c28_t c28_1;
             uint16_t h10; // 10-bit callsign hash
             int8_t r5;    // Report: -30 to +32, even numbers only
+            char h10_call[12]; // Hashed callsign; when set, h10 is ignored and hashed from it
         } dxpedition;
 
         struct {
@@ -146,6 +147,7 @@ typedef struct {
             bool h1;      // Flag: hashed callsign is second callsign
             r2_t r2;      // RRR, RR73, 73, or blank
             bool c1;      // Flag: first callsign is CQ, h12 is ignored
+            char h12_call[12]; // Hashed callsign; when set, h12 is ignored and hashed from it
         } nonstd;
 
         struct {
@@ -155,6 +157,8 @@ typedef struct {
             uint8_t r3;   // Report: 2-9
             uint16_t s11; // Serial number (0-2047)
             char g25[7];  // 6-character grid + null terminator
+            char h12_call[12]; // Hashed callsign; when set, h12 is ignored and hashed from it
+            char h22_call[12]; // Hashed callsign; when set, h22 is ignored and hashed from it
         } eu_vhf_5;
         
     } data;
@@ -177,4 +181,31 @@ void encode_t71(const char *hex, uint8_t *output);
 
 void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output);
 
+// Inverses of the encoders above; -EINVAL for values no encoder produces.
+// Hashed callsigns found in ftx_callhash fill the *_call fields.
+int decode_c28(uint32_t n28, c28_t *c28);
+void decode_g15(uint16_t n15, g15_t *g15);
+void decode_f71(const uint8_t *input, char *text);   // text holds 14
+void decode_c58(uint64_t n58, char *callsign);       // callsign holds 12
+
+// packed is the 10-byte payload as encode_ftx_payload lays it out
+int decode_ftx_payload(const uint8_t *packed, ftx_payload_t *payload);
+
+#define FTX_PAYLOAD_BITS    77
+#define FTX_CRC_BITS        14
+#define FTX_LDPC_K          91   // payload + CRC
+#define FTX_LDPC_M          83   // parity bits
+#define FTX_LDPC_N          174
+#define FTX_CODEWORD_BYTES  22
+
+// payload is the 10-byte output of encode_ftx_payload
+uint16_t ftx_crc14(const uint8_t *payload);
+// 174-bit codeword, MSB first: payload, CRC-14, then LDPC parity
+void ftx_encode_codeword(const uint8_t *payload, uint8_t *codeword);
+// Min-sum decode of 174 soft bits, positive for a 1 in any consistent
+// scale, into a codeword laid out as above. Returns the number of parity
+// checks still failing after at most max_iterations; 0 is a codeword,
+// which the CRC must still confirm.
+int ftx_ldpc_decode(const int16_t *llr, int max_iterations, uint8_t *codeword);
+
 #endif // MODES_ENCODERS_FTX_H
@@ -0,0 +1,32 @@
+#ifndef MODES_FTX_CALLHASH_H
+#define MODES_FTX_CALLHASH_H
+
+#include <stdint.h>
+#include "modes/ftx.h"
+
+/* Recently seen callsigns and their hashes, most recent first. Only the
+ * 22-bit hash is kept: the 12- and 10-bit hashes are its top bits, so
+ * every width is a shift away and a hash of any width can be looked up
+ * by the call it came from.
+ *
+ * Payload encoders hash the callsign text fields through the table, and
+ * the payload decoder fills them back in from it. With
+ * CONFIG_FTX_CALLHASH_PERSIST the calls are saved to settings a while
+ * after a new one arrives and loaded again at boot. */
+
+#define FTX_CALL_LEN    12      // 11 characters and the terminator
+
+/* hash_callsign() of the call at 22 bits, after dropping blanks and <>
+ * and folding to upper case. The call is remembered unless it is empty,
+ * which hashes to 0. */
+uint32_t ftx_callhash_add(const char *call);
+
+/* The most recent call whose hash at nbits (10, 12 or 22) is hash, into
+ * call. -ENOENT, with call empty, when none is known. */
+int ftx_callhash_find(uint32_t hash, int nbits, char *call);
+
+/* Remember the callsigns a decoded payload carries in full, so later
+ * messages naming them by hash can be resolved */
+void ftx_callhash_learn(const ftx_payload_t *payload);
+
+#endif // MODES_FTX_CALLHASH_H
@@ -0,0 +1,50 @@
+#ifndef MODES_KEYER_H
+#define MODES_KEYER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "modes/encoders/rtty.h"
+
+/* Live keyer: text streamed from the host into a FIFO is keyed as it
+ * arrives, one character at a time. CW holds key-up and RTTY sends LTRS
+ * diddles while the FIFO is dry. */
+enum keyer_mode {
+    KEYER_CW = 0,
+    KEYER_RTTY,
+};
+
+struct keyer_config {
+    uint8_t mode;
+    freq_uhz_t base_freq_uhz;
+    uint8_t wpm;            // CW element speed
+    uint8_t effective_wpm;  // CW Farnsworth text speed, 0 for none
+    rtty_config_t rtty;     // diddles unused; idle time is always diddled
+};
+
+/* idle counts CW dots or RTTY characters sent with the FIFO empty */
+struct keyer_status {
+    bool active;
+    bool finishing;
+    uint16_t fill;
+    uint16_t capacity;
+    uint32_t chars;
+    uint32_t idle;
+};
+
+/* Start keying. Text already queued is kept, so it can be typed ahead. */
+int keyer_start(const struct keyer_config *cfg);
+
+/* Queue text; returns how many bytes fit. In CW, <..> runs the enclosed
+ * letters together as a prosign. */
+size_t keyer_write(const uint8_t *text, size_t len);
+
+/* End the transmission once the FIFO drains instead of idling */
+void keyer_finish(void);
+
+/* Stop keying now and drop queued text */
+void keyer_abort(void);
+
+void keyer_get_status(struct keyer_status *out);
+
+#endif // MODES_KEYER_H
@@ -0,0 +1,95 @@
+#ifndef MODES_MODE_H
+#define MODES_MODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/sys/iterable_sections.h>
+#include "radio_core.h"
+
+/* Transmit modes the host can start by id. Each one registers a struct
+ * tx_mode with TX_MODE_DEFINE from its own source file, which Kconfig
+ * leaves out of the build along with its encoder when the mode is
+ * disabled. Ids are fixed, so a mode compiled out leaves a gap. */
+enum tx_mode_id {
+    TX_MODE_CW = 0,
+    TX_MODE_RTTY,
+    TX_MODE_BPSK31,
+    TX_MODE_HELL,
+    TX_MODE_WSPR,
+    TX_MODE_FT8,
+    TX_MODE_FT4,
+    TX_MODE_FST4W_120,
+    TX_MODE_FST4W_300,
+    TX_MODE_FST4W_900,
+    TX_MODE_FST4W_1800,
+    TX_MODE_COUNT,
+};
+
+/* Symbols and airtime of a parsed message. Streamed modes that merge
+ * runs of symbols give an upper bound on the count. */
+struct tx_mode_estimate {
+    uint32_t symbols;
+    uint32_t duration_ms;
+};
+
+/* The hooks run in turn on the command thread. parse checks the mode's
+ * part of a start command and keeps what open needs, replacing the last
+ * message parsed; open encodes it into seq while the engine is stopped,
+ * so the mode may replace buffers the previous sequence streamed from.
+ *
+ * Slotted modes start slot_delay_us into the next slot_us period of the
+ * UTC minute, or of the hour for FST4W's periods of several minutes; a
+ * slot_us of 0 starts at once. */
+struct tx_mode {
+    const char *name;
+    uint8_t id;
+    uint32_t slot_us;
+    uint32_t slot_delay_us;
+    int (*parse)(const uint8_t *payload, size_t len);
+    void (*estimate)(struct tx_mode_estimate *est);
+    int (*open)(tx_sequence_t *seq);
+};
+
+#define TX_MODE_DEFINE(_name, ...) \
+    STRUCT_SECTION_ITERABLE(tx_mode, _name) = { __VA_ARGS__ }
+
+/* Encode latency, the time from parse to a sequence ready to start. For
+ * streamed modes most of the encoding is deferred to the symbols. */
+struct tx_mode_stats {
+    uint32_t encodes;
+    uint32_t failures;      // payloads refused by parse or open
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t avg_us;
+};
+
+struct tx_mode_start {
+    struct tx_mode_estimate est;
+    int64_t start_utc_us;   // 0 for a mode started at once
+    uint32_t encode_us;
+};
+
+/* NULL when id is not built in */
+const struct tx_mode *tx_mode_find(uint8_t id);
+
+/* Parse and encode a message for mode id, then hand it to the engine at
+ * base: at the next slot of a slotted mode, or at once when now is set
+ * or the mode has no slots. */
+int tx_mode_start(uint8_t id, const uint8_t *payload, size_t len, freq_uhz_t base,
+                  bool now, struct tx_mode_start *out);
+
+/* Text of a payload, terminated, in a buffer shared by the modes. Valid
+ * until the next call; the encoders copy what they keep. */
+const char *tx_mode_text(const uint8_t *payload, size_t len);
+
+/* First instant at least lead_us after now_us (UTC microseconds) in
+ * slots of slot_us counted from the epoch, so aligned to the UTC minute
+ * or hour they divide, keyed delay_us in */
+int64_t tx_mode_next_slot_us(int64_t now_us, int64_t lead_us, uint32_t slot_us,
+                             uint32_t delay_us);
+
+void tx_mode_get_stats(const struct tx_mode *mode, struct tx_mode_stats *out);
+void tx_mode_reset_stats(void);
+
+#endif // MODES_MODE_H
@@ -0,0 +1,47 @@
+#ifndef MODES_SEQ_CACHE_H
+#define MODES_SEQ_CACHE_H
+
+#include <stdint.h>
+#include "radio_core.h"
+#include "modes/encoders/wspr.h"
+#include "modes/ftx.h"
+
+/* Encoded sequences of recent messages, so a beacon repeating the same
+ * few messages encodes each once. Entries are keyed by mode and the
+ * message as encoded, and hold the distinct symbols of the sequence with
+ * a packed index per symbol: a WSPR message is 41 bytes of indices where
+ * the encoder recomputes the convolutional code for every symbol.
+ *
+ * With CONFIG_SEQ_CACHE_SPILL each new entry is also written to settings
+ * on storage_partition, where a RAM miss looks before encoding, so the
+ * cache survives a reset.
+ *
+ * Each call behaves like the encoder it stands in for: the sequence it
+ * fills streams from a copy owned by the cache that the next call
+ * replaces. Sequences that are too long, or use more than eight distinct
+ * symbols, come back from the encoder uncached. */
+
+struct seq_cache_stats {
+    uint32_t hits;
+    uint32_t misses;            // encoded, cached or not
+    uint32_t evictions;
+    uint32_t uncached;          // encoded but not cacheable
+    uint32_t spill_hits;        // RAM misses found in storage
+    uint32_t spill_writes;
+    uint32_t spill_errors;
+    uint8_t entries;
+    uint8_t capacity;
+};
+
+int seq_cache_wspr(const wspr_payload_t *payload, tx_sequence_t *tx_sequence);
+
+int seq_cache_ft8(const ftx_payload_t *payload, tx_sequence_t *tx_sequence);
+
+int seq_cache_ft4(const ftx_payload_t *payload, tx_sequence_t *tx_sequence);
+
+void seq_cache_get_stats(struct seq_cache_stats *out);
+
+/* Counters only; the entries stay */
+void seq_cache_reset_stats(void);
+
+#endif // MODES_SEQ_CACHE_H
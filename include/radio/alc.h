@@ -0,0 +1,29 @@
+#ifndef RADIO_ALC_H
+#define RADIO_ALC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Levels are forward detector millivolts; mapping that to watts is up to
+ * the host's calibration of the coupler. */
+struct alc_status {
+    bool enabled;
+    bool active;
+    bool saturated;
+    uint16_t target_mv;
+    uint16_t fwd_mv;
+    int32_t supply_uv;
+};
+
+void alc_init(void);
+void alc_set_target(bool enable, uint16_t target_mv);
+void alc_get_status(struct alc_status *out);
+
+/* Close the loop; called when the PA supply is switched on */
+void alc_kick(void);
+
+/* Detector samples are dropped while the gate is shut, so an envelope
+ * keyed down with the supply still on does not wind the loop up */
+void alc_set_gate(bool open);
+
+#endif // RADIO_ALC_H
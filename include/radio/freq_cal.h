@@ -0,0 +1,28 @@
+#ifndef RADIO_FREQ_CAL_H
+#define RADIO_FREQ_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FREQ_CAL_PPS_PRESENT  (1u << 0)
+#define FREQ_CAL_MCU_VALID    (1u << 1)
+#define FREQ_CAL_REF_VALID    (1u << 2)
+#define FREQ_CAL_REF_MEASURED (1u << 3)  /* reference counted via CLK2 */
+#define FREQ_CAL_WARM_START   (1u << 4)  /* applied value came from flash */
+
+/* Errors are in ppb, positive when the clock runs fast against PPS */
+struct freq_cal_status {
+    int32_t mcu_ppb;
+    int32_t ref_ppb;
+    int32_t applied_ppb;
+    uint32_t edges;
+    uint32_t windows;
+    uint32_t rejected;
+    uint8_t flags;
+};
+
+int freq_cal_init(void);
+void freq_cal_get_status(struct freq_cal_status *out);
+int freq_cal_set_ppb(int32_t ppb);
+
+#endif // RADIO_FREQ_CAL_H
@@ -3,14 +3,15 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "radio_core.h"
 
-extern uint64_t base_frequency;
+extern freq_uhz_t base_frequency;
 extern bool tx_active;
 
-#define BAND_30M_MIN_FREQ  (10100000ULL * 100)
-#define BAND_30M_MAX_FREQ  (10150000ULL * 100)
+#define BAND_30M_MIN_FREQ  FREQ_HZ(10100000)
+#define BAND_30M_MAX_FREQ  FREQ_HZ(10150000)
 
-static inline uint64_t clamp_frequency(uint64_t freq) {
+static inline freq_uhz_t clamp_frequency(freq_uhz_t freq) {
     if (freq < BAND_30M_MIN_FREQ) return BAND_30M_MIN_FREQ;
     if (freq > BAND_30M_MAX_FREQ) return BAND_30M_MAX_FREQ;
     return freq;
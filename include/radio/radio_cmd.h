@@ -13,6 +13,25 @@ void handle_get_buck_boost_regulator(const uint8_t *payload, uint8_t length, uin
 void handle_reset(const uint8_t *payload, uint8_t length, uint16_t id);
 void handle_tr_switch(const uint8_t *payload, uint8_t length, uint16_t id);
 void handle_tx_test_signal(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_tx_stats(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_calibration(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_set_calibration(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_set_alc(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_alc(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_set_telemetry(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_set_swr_trip(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_swr_trip(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_timebase(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_time_probe(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_time_adjust(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_keyer_start(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_keyer_text(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_keyer(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_set_envelope(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_envelope(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_seq_cache(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_mode_start(const uint8_t *payload, uint8_t length, uint16_t id);
+void handle_get_mode_stats(const uint8_t *payload, uint8_t length, uint16_t id);
 
 void send_debug_message(const char *message);
 
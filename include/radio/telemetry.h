@@ -0,0 +1,15 @@
+#ifndef RADIO_TELEMETRY_H
+#define RADIO_TELEMETRY_H
+
+#include <stdint.h>
+
+#define TELEMETRY_MAX_HZ        100
+#define TELEMETRY_MAX_BATCH     8
+
+void telemetry_init(void);
+
+/* Stream rate_hz windows per second, batch_len windows per packet.
+ * rate_hz = 0 stops the stream. */
+int telemetry_configure(uint16_t rate_hz, uint8_t batch_len);
+
+#endif // RADIO_TELEMETRY_H
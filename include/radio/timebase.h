@@ -0,0 +1,67 @@
+#ifndef RADIO_TIMEBASE_H
+#define RADIO_TIMEBASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/sys/slist.h>
+
+/* Where timebase_now_us() currently gets its time from */
+enum timebase_state {
+    TIMEBASE_FREE = 0,      /* no RTC time either; seconds since boot */
+    TIMEBASE_RTC,           /* RTC seconds, nominal or calibrated rate */
+    TIMEBASE_ACQUIRING,     /* PPS present, fit not settled yet */
+    TIMEBASE_LOCKED,        /* PPS fit within CONFIG_TIMEBASE_LOCK_NS */
+    TIMEBASE_HOLDOVER,      /* PPS lost after lock; last fitted rate */
+    TIMEBASE_HOST,          /* offset and rate trimmed by the host */
+};
+
+#define TIMEBASE_UTC_GNSS     (1u << 0)  /* edge labels checked against GNSS */
+#define TIMEBASE_RTC_SYNCED   (1u << 1)  /* RTC written from a locked edge */
+
+/* Residuals are timer capture minus the model's prediction for that edge */
+struct timebase_status {
+    uint8_t state;
+    uint8_t flags;
+    uint8_t fit_edges;
+    int32_t rate_ppb;
+    int32_t last_residual_ns;
+    uint32_t rms_residual_ns;
+    uint32_t max_residual_ns;
+    uint32_t edges;
+    uint32_t rejected;
+    uint32_t restarts;
+    uint32_t alarms;
+    uint32_t late_alarms;
+    uint32_t max_alarm_latency_ns;
+};
+
+struct timebase_alarm;
+
+/* Runs in the capture timer ISR; late_ns is the measured lateness */
+typedef void (*timebase_alarm_handler_t)(struct timebase_alarm *alarm, uint32_t late_ns);
+
+struct timebase_alarm {
+    sys_snode_t node;
+    int64_t utc_us;
+    timebase_alarm_handler_t handler;
+};
+
+int timebase_init(void);
+
+/* Microseconds since the Unix epoch (UTC) */
+int64_t timebase_now_us(void);
+
+/* Fire alarm->handler at the given UTC instant. Re-starting an armed
+ * alarm moves it; a time already past fires as soon as possible. */
+int timebase_alarm_start(struct timebase_alarm *alarm, int64_t utc_us);
+void timebase_alarm_cancel(struct timebase_alarm *alarm);
+
+void timebase_get_status(struct timebase_status *out);
+
+/* Step the time by step_us and trim the rate by rate_ppb (positive when
+ * the device was running fast). Refused with -EPERM once PPS labels are
+ * checked against GNSS; while PPS is tracked only whole seconds of the
+ * step are applied, since the edges own the sub-second phase. */
+int timebase_host_adjust(int64_t step_us, int32_t rate_ppb);
+
+#endif // RADIO_TIMEBASE_H
@@ -3,12 +3,56 @@
 
 #include "radio_core.h"
 
+/* Per-symbol synthesizer bus timing, in microseconds. "bus" is submit to
+ * completion of the tone change; "lag" is symbol boundary to completion.
+ * Start lateness is scheduled UTC instant to first symbol, for
+ * tx_engine_start_at. */
+struct tx_engine_stats {
+    uint32_t symbols;
+    uint32_t overruns;
+    uint32_t errors;
+    uint32_t last_bus_us;
+    uint32_t min_bus_us;
+    uint32_t max_bus_us;
+    uint32_t avg_bus_us;
+    uint32_t last_lag_us;
+    uint32_t max_lag_us;
+    uint32_t starts;
+    uint32_t last_start_late_us;
+    uint32_t max_start_late_us;
+    /* Phase reversals, and how long after the envelope null each landed */
+    uint32_t flips;
+    uint32_t last_flip_lag_us;
+    uint32_t max_flip_lag_us;
+    /* How long each symbol lasted against its duration, measured where
+     * symbols are applied, and the running sum since the sequence began */
+    int32_t  last_sym_err_us;
+    uint32_t max_sym_err_us;
+    int32_t  drift_us;
+    uint32_t max_drift_us;
+};
+
 void tx_engine_init();
 
 void tx_engine_start(tx_sequence_t *seq);
 
+/* Start seq at a UTC instant from the timebase. The engine is stopped
+ * meanwhile; tx_engine_stop also drops the pending start. */
+int tx_engine_start_at(tx_sequence_t *seq, int64_t utc_us);
+
 void tx_engine_stop();
 
+/* Drop synthesizer output and PA supply without touching sequencing
+ * state, for fault paths outside the workqueue. Blocks on I2C. */
+void tx_engine_rf_off();
+
 bool tx_engine_is_active();
 
+/* Index of the symbol on air, -1 when idle. Safe to call from ISRs. */
+int32_t tx_engine_current_symbol();
+
+void tx_engine_get_stats(struct tx_engine_stats *out);
+
+void tx_engine_reset_stats();
+
 #endif /* RADIO_TX_ENGINE_H */
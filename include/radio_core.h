@@ -5,18 +5,50 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/* Envelope ramps of a shaped symbol, each a raised cosine over half of it */
+#define TX_SHAPE_RAMP_UP    (1u << 0)   // rise from zero at the start
+#define TX_SHAPE_RAMP_DOWN  (1u << 1)   // fall to zero at the end
+/* On-off keying by the envelope: tx_on rises and key-up falls over the
+ * envelope rise time, with the carrier left running underneath */
+#define TX_SHAPE_KEYED      (1u << 2)
+
+/* Frequencies and tone offsets in microhertz, from the host protocol
+ * through the encoders to the synthesiser, with no float on the way: a
+ * WSPR step of 12000/8192 Hz is within a quarter of a microhertz. */
+typedef int64_t freq_uhz_t;
+
+#define FREQ_UHZ_PER_HZ     1000000LL
+#define FREQ_HZ(hz)         ((freq_uhz_t)(hz) * FREQ_UHZ_PER_HZ)
+/* num/den Hz, rounded to the nearest microhertz */
+#define FREQ_RATIO(num, den) \
+    (((freq_uhz_t)(num) * FREQ_UHZ_PER_HZ + (den) / 2) / (den))
+
 typedef struct {
-    float freq_offset_hz;
+    freq_uhz_t freq_offset_uhz;
     uint32_t duration_us;
     bool     tx_on;
+    bool     invert;    // carrier phase 180 degrees
+    uint8_t  shape;     // TX_SHAPE_*, 0 for a constant level
 } tx_symbol_t;
 
-typedef struct {
+struct tx_sequence;
+
+/* Writes symbol index of seq to *out; 0 or a negative errno. Streams
+ * that do not know their length set total_symbols to SIZE_MAX and end
+ * with -ENODATA. */
+typedef int (*tx_symbol_source_t)(const struct tx_sequence *seq, size_t index,
+                                  tx_symbol_t *out);
+
+typedef struct tx_sequence {
     char* mode_name;
-    uint32_t base_freq_hz;
+    freq_uhz_t base_freq_uhz;
     
     tx_symbol_t* symbols; 
     size_t total_symbols;
+
+    // Used instead of symbols when that is NULL
+    tx_symbol_source_t source;
+    void* source_ctx;
     
     // Runtime state
     size_t current_index;
@@ -7,4 +7,7 @@
 void uart_handler_init();
 int send_uart_data(const uint8_t *data, size_t length);
 
+/* Timebase time at which the packet now being dispatched finished arriving */
+int64_t uart_handler_rx_time_us();
+
 #endif // UART_HANDLER_H
\ No newline at end of file
@@ -1,8 +1,8 @@
-use std::time::{Duration, Instant};
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
 use std::sync::{Arc, Mutex, OnceLock};
 use std::io::{Read, Write};
 use serialport::SerialPort;
-use std::sync::atomic::{AtomicU16, AtomicBool, Ordering};
+use std::sync::atomic::{AtomicU16, AtomicU32, AtomicBool, Ordering};
 use std::collections::HashMap;
 use std::thread;
 
@@ -12,8 +12,20 @@ use crc::{Crc, CRC_16_KERMIT};
 const RESP_ACK: u8 = 0xFF;
 const RESP_NACK: u8 = 0xFE;
 const DEBUG_MSG_CMD: u8 = 0xFC;
+const PA_FAULT_EVENT: u8 = 0xFB;
+const TELEMETRY_EVENT: u8 = 0xFA;
+const SWR_TRIP_EVENT: u8 = 0xF9;
+const TELEMETRY_WINDOW_BYTES: usize = 20;
+const ADC_VREF_MV: f32 = 3300.0;
+const ADC_FULL_SCALE: f32 = 4095.0;
 const HEADER_BYTE: u8 = 0xAA;
 const HEADER_SIZE: usize = 5;
+/// Device-side UART rate, used for wire-time correction when the host
+/// side of the link has no baud rate of its own
+const DEVICE_BAUD: u32 = 115_200;
+/// Shortest gap between corrections before residual offset is read as drift
+const DRIFT_MIN_INTERVAL_US: i64 = 30_000_000;
+const DRIFT_MAX_PPB: i64 = 100_000;
 
 const BAND_30M_MIN_HZ: f64 = 10_100_000.0;
 const BAND_30M_MAX_HZ: f64 = 10_150_000.0;
@@ -50,6 +62,112 @@ pub fn set_debug_logger(logger: Option<Box<dyn DebugLogger>>) {
     }
 }
 
+/// Unsolicited notifications from the device
+#[derive(uniffi::Enum)]
+pub enum DeviceEvent {
+    /// The PA supply reported a fault and transmission was stopped
+    PaFault { short_circuit: bool, over_current: bool, over_voltage: bool },
+    /// Reflected power crossed the trip threshold and RF was cut
+    SwrTrip { status: SwrGuardStatus },
+}
+
+#[derive(uniffi::Record, Clone)]
+pub struct SwrGuardStatus {
+    pub armed: bool,
+    pub tripped: bool,
+    pub threshold_mv: u16,
+    /// Watchdog interrupt to T/R relay in receive
+    pub rx_latency_ns: u32,
+    /// Watchdog interrupt to synthesizer and PA supply off
+    pub off_latency_us: u32,
+}
+
+fn parse_swr_status(payload: &[u8]) -> Option<SwrGuardStatus> {
+    let p = payload.get(..11)?;
+    Some(SwrGuardStatus {
+        armed: p[0] & 0x01 != 0,
+        tripped: p[0] & 0x02 != 0,
+        threshold_mv: u16::from_le_bytes([p[1], p[2]]),
+        rx_latency_ns: u32::from_le_bytes([p[3], p[4], p[5], p[6]]),
+        off_latency_us: u32::from_le_bytes([p[7], p[8], p[9], p[10]]),
+    })
+}
+
+#[uniffi::export(callback_interface)]
+pub trait EventListener: Send + Sync {
+    fn on_event(&self, event: DeviceEvent);
+}
+
+type EventSlot = Arc<Mutex<Option<Box<dyn EventListener>>>>;
+
+fn parse_event(pkt: &ParsedPacket) -> Option<DeviceEvent> {
+    match pkt.ptype {
+        PA_FAULT_EVENT => {
+            let status = *pkt.payload.first()?;
+            Some(DeviceEvent::PaFault {
+                short_circuit: status & 0x80 != 0,
+                over_current: status & 0x40 != 0,
+                over_voltage: status & 0x20 != 0,
+            })
+        }
+        SWR_TRIP_EVENT => Some(DeviceEvent::SwrTrip { status: parse_swr_status(&pkt.payload)? }),
+        _ => None,
+    }
+}
+
+/// Detector statistics over one telemetry window, in millivolts
+#[derive(uniffi::Record, Clone)]
+pub struct DetectorStats {
+    pub min_mv: f32,
+    pub max_mv: f32,
+    pub mean_mv: f32,
+    pub rms_mv: f32,
+}
+
+#[derive(uniffi::Record, Clone)]
+pub struct TelemetryFrame {
+    pub seq: u16,
+    /// Symbol on air when the window closed, None when idle
+    pub symbol_index: Option<u16>,
+    pub forward: DetectorStats,
+    pub reflected: DetectorStats,
+}
+
+/// Receives telemetry one device packet (a batch of windows) at a time
+#[uniffi::export(callback_interface)]
+pub trait TelemetrySubscriber: Send + Sync {
+    fn on_batch(&self, frames: Vec<TelemetryFrame>);
+}
+
+type TelemetrySlot = Arc<Mutex<Option<Box<dyn TelemetrySubscriber>>>>;
+
+fn parse_telemetry(payload: &[u8]) -> Option<Vec<TelemetryFrame>> {
+    let count = *payload.first()? as usize;
+    let body = payload.get(1..1 + count * TELEMETRY_WINDOW_BYTES)?;
+    let mv = |raw: u16| raw as f32 * ADC_VREF_MV / ADC_FULL_SCALE;
+
+    let frames = body
+        .chunks_exact(TELEMETRY_WINDOW_BYTES)
+        .map(|w| {
+            let half = |i: usize| u16::from_le_bytes([w[i], w[i + 1]]);
+            let stats = |i: usize| DetectorStats {
+                min_mv: mv(half(i)),
+                max_mv: mv(half(i + 2)),
+                mean_mv: mv(half(i + 4)),
+                rms_mv: mv(half(i + 6)),
+            };
+            let symbol = half(2);
+            TelemetryFrame {
+                seq: half(0),
+                symbol_index: if symbol == u16::MAX { None } else { Some(symbol) },
+                forward: stats(4),
+                reflected: stats(12),
+            }
+        })
+        .collect();
+    Some(frames)
+}
+
 #[derive(Debug, thiserror::Error, uniffi::Error)]
 pub enum MiniHFError {
     #[error("Serial error: {0}")]
@@ -197,11 +315,297 @@ pub struct BuckRegulatorState {
     pub voltage_level: u8,
 }
 
+#[derive(uniffi::Record)]
+pub struct TxStats {
+    pub symbols: u32,
+    pub overruns: u32,
+    pub errors: u32,
+    pub last_bus_us: u32,
+    pub min_bus_us: u32,
+    pub max_bus_us: u32,
+    pub avg_bus_us: u32,
+    pub last_lag_us: u32,
+    pub max_lag_us: u32,
+    /// Scheduled starts, and how late the first symbol went out
+    pub starts: u32,
+    pub last_start_late_us: u32,
+    pub max_start_late_us: u32,
+    /// BPSK phase reversals, and how long after the envelope null each landed
+    pub flips: u32,
+    pub last_flip_lag_us: u32,
+    pub max_flip_lag_us: u32,
+    /// How long each symbol lasted against its nominal duration, and the
+    /// running sum of those errors since the sequence began
+    pub last_sym_err_us: i32,
+    pub max_sym_err_us: u32,
+    pub drift_us: i32,
+    pub max_drift_us: u32,
+}
+
+#[derive(uniffi::Record)]
+pub struct CalibrationStatus {
+    pub mcu_ppb: i32,
+    pub ref_ppb: i32,
+    pub applied_ppb: i32,
+    pub pps_edges: u32,
+    pub windows: u32,
+    pub rejected: u32,
+    pub pps_present: bool,
+    pub mcu_valid: bool,
+    pub ref_valid: bool,
+    pub ref_measured: bool,
+    pub warm_start: bool,
+}
+
+#[derive(uniffi::Enum, Clone, Copy, PartialEq, Eq, Debug)]
+pub enum TimebaseState {
+    /// No RTC time either; counting from boot
+    Free,
+    /// Whole seconds from the RTC
+    Rtc,
+    /// PPS present, fit not settled
+    Acquiring,
+    Locked,
+    /// PPS lost after lock; running on the last fitted rate
+    Holdover,
+    /// Offset and rate set by host time sync
+    Host,
+}
+
+fn parse_timebase_state(b: u8) -> Option<TimebaseState> {
+    Some(match b {
+        0 => TimebaseState::Free,
+        1 => TimebaseState::Rtc,
+        2 => TimebaseState::Acquiring,
+        3 => TimebaseState::Locked,
+        4 => TimebaseState::Holdover,
+        5 => TimebaseState::Host,
+        _ => return None,
+    })
+}
+
+#[derive(uniffi::Record)]
+pub struct TimebaseStatus {
+    pub state: TimebaseState,
+    /// PPS edge labels were checked against GNSS time
+    pub utc_from_gnss: bool,
+    pub rtc_synced: bool,
+    pub fit_edges: u8,
+    /// Device time (UTC microseconds since the Unix epoch) when the reply was built
+    pub now_us: u64,
+    /// Fitted capture timer rate against nominal
+    pub rate_ppb: i32,
+    pub last_residual_ns: i32,
+    pub rms_residual_ns: u32,
+    pub max_residual_ns: u32,
+    pub pps_edges: u32,
+    pub rejected: u32,
+    pub restarts: u32,
+    pub alarms: u32,
+    pub late_alarms: u32,
+    pub max_alarm_latency_ns: u32,
+}
+
+#[derive(uniffi::Record, Clone)]
+pub struct TimeSyncReport {
+    /// Device minus host time before the correction
+    pub offset_us: i64,
+    /// The true offset lies within offset_us +/- this, from the best round trip
+    pub uncertainty_us: u64,
+    pub round_trip_us: u64,
+    pub rounds: u8,
+    /// Rate trim sent with the correction, positive when the device ran fast
+    pub drift_ppb: i32,
+    /// False when nothing needed correcting or the device refused (GNSS owns its time)
+    pub applied: bool,
+    pub device_state: TimebaseState,
+}
+
+#[uniffi::export(callback_interface)]
+pub trait TimeSyncListener: Send + Sync {
+    fn on_sync(&self, report: TimeSyncReport);
+    fn on_sync_error(&self, message: String);
+}
+
+#[derive(Default)]
+struct SyncState {
+    /// Host time of the last applied correction
+    last_correction_us: Option<i64>,
+}
+
+struct TimeSample {
+    offset_us: i64,
+    delay_us: i64,
+    state: TimebaseState,
+}
+
+#[derive(uniffi::Record)]
+pub struct AlcStatus {
+    pub enabled: bool,
+    pub active: bool,
+    pub saturated: bool,
+    pub target_mv: u16,
+    pub forward_mv: u16,
+    pub supply_uv: u32,
+}
+
+#[derive(uniffi::Record, Clone)]
+pub struct RttyKeying {
+    pub baud: f32,
+    pub shift_hz: u16,
+    pub stop_bits: f32,
+    pub reverse: bool,
+    /// Mark and space either side of the carrier instead of mark on it
+    pub center: bool,
+    /// Receiver drops back to letters after a space, so figures re-shift
+    pub unshift_on_space: bool,
+}
+
+#[derive(uniffi::Record)]
+pub struct KeyerStatus {
+    pub active: bool,
+    /// Transmission ends once the queue drains
+    pub finishing: bool,
+    pub queued: u16,
+    pub capacity: u16,
+    /// Characters taken from the queue since the keyer started
+    pub chars: u32,
+    /// CW dots or RTTY diddles sent while the queue was empty
+    pub idle: u32,
+}
+
+#[derive(uniffi::Record)]
+pub struct EnvelopeStatus {
+    pub ready: bool,
+    /// CW element rise and fall time
+    pub rise_us: u32,
+    pub ramps: u32,
+    pub underruns: u32,
+    /// CPU time per ramp: the DMA start plus its completion interrupt
+    pub last_cpu_ns: u32,
+    pub max_cpu_ns: u32,
+    pub avg_cpu_ns: u32,
+}
+
+#[derive(uniffi::Record)]
+pub struct SeqCacheStats {
+    pub hits: u32,
+    /// Messages encoded, whether or not they could be cached
+    pub misses: u32,
+    pub evictions: u32,
+    pub uncached: u32,
+    /// RAM misses found in settings storage
+    pub spill_hits: u32,
+    pub spill_writes: u32,
+    pub spill_errors: u32,
+    pub entries: u8,
+    pub capacity: u8,
+}
+
+/// Transmit modes of the start-mode command. Firmware built without a
+/// mode NACKs it and leaves it out of `get_mode_stats`.
+#[derive(uniffi::Enum, Clone, Copy, PartialEq, Eq, Debug)]
+pub enum TxMode {
+    Cw,
+    Rtty,
+    Bpsk31,
+    Hell,
+    Wspr,
+    Ft8,
+    Ft4,
+    Fst4w120,
+    Fst4w300,
+    Fst4w900,
+    Fst4w1800,
+}
+
+/// Power, grid and callsign, as WSPR and FST4W take them
+fn wspr_payload(callsign: &str, grid: &str, power_dbm: u8) -> Result<Vec<u8>, MiniHFError> {
+    if grid.len() != 4 || callsign.is_empty() || callsign.len() > 6 {
+        return Err(MiniHFError::InvalidArgument("callsign or grid malformed".into()));
+    }
+    let mut payload = vec![power_dbm];
+    payload.extend_from_slice(grid.as_bytes());
+    payload.extend_from_slice(callsign.as_bytes());
+    Ok(payload)
+}
+
+fn parse_tx_mode(b: u8) -> Option<TxMode> {
+    Some(match b {
+        0 => TxMode::Cw,
+        1 => TxMode::Rtty,
+        2 => TxMode::Bpsk31,
+        3 => TxMode::Hell,
+        4 => TxMode::Wspr,
+        5 => TxMode::Ft8,
+        6 => TxMode::Ft4,
+        7 => TxMode::Fst4w120,
+        8 => TxMode::Fst4w300,
+        9 => TxMode::Fst4w900,
+        10 => TxMode::Fst4w1800,
+        _ => return None,
+    })
+}
+
+#[derive(uniffi::Enum, Clone)]
+pub enum FtxMessage {
+    /// Up to 13 characters of FT8/FT4 free text
+    FreeText { text: String },
+    /// Any 77-bit message, packed MSB first into 10 bytes
+    Packed { bits: Vec<u8> },
+}
+
+#[derive(uniffi::Record)]
+pub struct ModeStart {
+    /// Upper bound for modes that merge runs of symbols
+    pub symbols: u32,
+    pub duration_ms: u32,
+    /// UTC microseconds of the slot the message is keyed in; None when
+    /// keyed at once
+    pub start_utc_us: Option<i64>,
+    /// Time from receiving the message to a sequence ready to send
+    pub encode_us: u32,
+}
+
+#[derive(uniffi::Record)]
+pub struct ModeStats {
+    pub mode: TxMode,
+    pub encodes: u32,
+    /// Messages refused by the mode
+    pub failures: u32,
+    pub last_us: u32,
+    pub max_us: u32,
+    pub avg_us: u32,
+}
+
+fn parse_keyer_status(b: &[u8]) -> Option<KeyerStatus> {
+    if b.len() < 13 { return None; }
+    Some(KeyerStatus {
+        active: b[0] & 0x01 != 0,
+        finishing: b[0] & 0x02 != 0,
+        queued: u16::from_le_bytes([b[1], b[2]]),
+        capacity: u16::from_le_bytes([b[3], b[4]]),
+        chars: u32::from_le_bytes([b[5], b[6], b[7], b[8]]),
+        idle: u32::from_le_bytes([b[9], b[10], b[11], b[12]]),
+    })
+}
+
+/// Largest text fragment per keyer packet, leaving room for the control byte
+const KEYER_CHUNK: usize = 254;
+
 #[derive(Clone)]
 struct ParsedPacket {
     ptype: u8,
     id: u16,
     payload: Vec<u8>,
+    received: Instant,
+}
+
+struct TimedResponse {
+    payload: Vec<u8>,
+    sent: Instant,
+    received: Instant,
+    request_len: usize,
 }
 
 #[derive(uniffi::Object)]
@@ -211,6 +615,12 @@ pub struct MiniHF {
     timeout: Duration,
     responses: Arc<Mutex<HashMap<u16, ParsedPacket>>>,
     is_running: Arc<AtomicBool>,
+    events: EventSlot,
+    telemetry: TelemetrySlot,
+    baud: u32,
+    fast_poll: Arc<AtomicBool>,
+    sync: Mutex<SyncState>,
+    sync_generation: AtomicU32,
 }
 
 impl Drop for MiniHF {
@@ -241,6 +651,12 @@ impl MiniHF {
             timeout: Duration::from_millis(timeout_ms),
             responses: Arc::new(Mutex::new(HashMap::new())),
             is_running: Arc::new(AtomicBool::new(true)),
+            events: Arc::new(Mutex::new(None)),
+            telemetry: Arc::new(Mutex::new(None)),
+            baud,
+            fast_poll: Arc::new(AtomicBool::new(false)),
+            sync: Mutex::new(SyncState::default()),
+            sync_generation: AtomicU32::new(0),
         });
 
         hf.spawn_reader_thread();
@@ -265,6 +681,12 @@ impl MiniHF {
                 timeout: Duration::from_millis(timeout_ms),
                 responses: Arc::new(Mutex::new(HashMap::new())),
                 is_running: Arc::new(AtomicBool::new(true)),
+                events: Arc::new(Mutex::new(None)),
+                telemetry: Arc::new(Mutex::new(None)),
+                baud: DEVICE_BAUD,
+                fast_poll: Arc::new(AtomicBool::new(false)),
+                sync: Mutex::new(SyncState::default()),
+                sync_generation: AtomicU32::new(0),
             });
 
             hf.spawn_reader_thread();
@@ -305,7 +727,8 @@ impl MiniHF {
             ));
         }
         let clamped = clamp_freq_hz(freq_hz);
-        let freq_int = (clamped * 100.0).round() as u64;
+        // Sent in microhertz
+        let freq_int = (clamped * 1e6).round() as u64;
         let payload = freq_int.to_le_bytes().to_vec();
         self.transact(0x03, payload)?;
         Ok(())
@@ -318,7 +741,7 @@ impl MiniHF {
         let mut bytes = [0u8; 8];
         bytes.copy_from_slice(&resp[0..8]);
         let freq_int = u64::from_le_bytes(bytes);
-        Ok(freq_int as f64 / 100.0)
+        Ok(freq_int as f64 / 1e6)
     }
 
     pub fn set_buck_boost_regulator(&self, enabled: bool, voltage_level: u8) -> Result<(), MiniHFError> {
@@ -360,6 +783,431 @@ impl MiniHF {
         Ok(())
     }
 
+    pub fn get_tx_stats(&self, reset: bool) -> Result<TxStats, MiniHFError> {
+        let resp = self.transact(0x09, vec![if reset { 1 } else { 0 }])?;
+        if resp.len() < 76 { return Err(MiniHFError::InvalidPacket); }
+        let word = |i: usize| u32::from_le_bytes([resp[i], resp[i + 1], resp[i + 2], resp[i + 3]]);
+        Ok(TxStats {
+            symbols: word(0),
+            overruns: word(4),
+            errors: word(8),
+            last_bus_us: word(12),
+            min_bus_us: word(16),
+            max_bus_us: word(20),
+            avg_bus_us: word(24),
+            last_lag_us: word(28),
+            max_lag_us: word(32),
+            starts: word(36),
+            last_start_late_us: word(40),
+            max_start_late_us: word(44),
+            flips: word(48),
+            last_flip_lag_us: word(52),
+            max_flip_lag_us: word(56),
+            last_sym_err_us: word(60) as i32,
+            max_sym_err_us: word(64),
+            drift_us: word(68) as i32,
+            max_drift_us: word(72),
+        })
+    }
+
+    pub fn get_calibration(&self) -> Result<CalibrationStatus, MiniHFError> {
+        let resp = self.transact(0x0A, vec![])?;
+        if resp.len() < 25 { return Err(MiniHFError::InvalidPacket); }
+        let word = |i: usize| u32::from_le_bytes([resp[i], resp[i + 1], resp[i + 2], resp[i + 3]]);
+        let flags = resp[24];
+        Ok(CalibrationStatus {
+            mcu_ppb: word(0) as i32,
+            ref_ppb: word(4) as i32,
+            applied_ppb: word(8) as i32,
+            pps_edges: word(12),
+            windows: word(16),
+            rejected: word(20),
+            pps_present: flags & 0x01 != 0,
+            mcu_valid: flags & 0x02 != 0,
+            ref_valid: flags & 0x04 != 0,
+            ref_measured: flags & 0x08 != 0,
+            warm_start: flags & 0x10 != 0,
+        })
+    }
+
+    pub fn get_timebase(&self) -> Result<TimebaseStatus, MiniHFError> {
+        let resp = self.transact(0x11, vec![])?;
+        if resp.len() < 51 { return Err(MiniHFError::InvalidPacket); }
+        let word = |i: usize| u32::from_le_bytes([resp[i], resp[i + 1], resp[i + 2], resp[i + 3]]);
+        let state = parse_timebase_state(resp[0]).ok_or(MiniHFError::InvalidPacket)?;
+        let mut now = [0u8; 8];
+        now.copy_from_slice(&resp[3..11]);
+        Ok(TimebaseStatus {
+            state,
+            utc_from_gnss: resp[1] & 0x01 != 0,
+            rtc_synced: resp[1] & 0x02 != 0,
+            fit_edges: resp[2],
+            now_us: u64::from_le_bytes(now),
+            rate_ppb: word(11) as i32,
+            last_residual_ns: word(15) as i32,
+            rms_residual_ns: word(19),
+            max_residual_ns: word(23),
+            pps_edges: word(27),
+            rejected: word(31),
+            restarts: word(35),
+            alarms: word(39),
+            late_alarms: word(43),
+            max_alarm_latency_ns: word(47),
+        })
+    }
+
+    /// Measure the device clock against this host over `rounds` exchanges,
+    /// keep the one with the shortest round trip, and step the device onto
+    /// host time. Residual offset seen on a later call is turned into a rate trim.
+    pub fn sync_time(&self, rounds: u8) -> Result<TimeSyncReport, MiniHFError> {
+        if rounds == 0 {
+            return Err(MiniHFError::InvalidArgument("rounds must be non-zero".into()));
+        }
+        let mut sync = self.sync.lock().unwrap();
+        let sample = self.measure_offset(rounds)?;
+        let now_us = host_now_us()?;
+        let uncertainty_us = sample.delay_us / 2;
+
+        let mut report = TimeSyncReport {
+            offset_us: sample.offset_us,
+            uncertainty_us: uncertainty_us as u64,
+            round_trip_us: sample.delay_us as u64,
+            rounds,
+            drift_ppb: 0,
+            applied: false,
+            device_state: sample.state,
+        };
+
+        // Anything inside the uncertainty is not worth acting on
+        if sample.offset_us.abs() <= uncertainty_us {
+            return Ok(report);
+        }
+
+        if let Some(last_us) = sync.last_correction_us {
+            let elapsed_us = now_us - last_us;
+            if elapsed_us >= DRIFT_MIN_INTERVAL_US {
+                let ppb = sample.offset_us as i128 * 1_000_000_000 / elapsed_us as i128;
+                report.drift_ppb = (ppb as i64).clamp(-DRIFT_MAX_PPB, DRIFT_MAX_PPB) as i32;
+            }
+        }
+
+        let mut payload = (-sample.offset_us).to_le_bytes().to_vec();
+        payload.extend_from_slice(&report.drift_ppb.to_le_bytes());
+        match self.transact(0x13, payload) {
+            Ok(_) => {
+                report.applied = true;
+                sync.last_correction_us = Some(now_us);
+            }
+            Err(MiniHFError::Nack) => report.drift_ppb = 0,
+            Err(e) => return Err(e),
+        }
+        Ok(report)
+    }
+
+    /// Run `sync_time` every `interval_secs` on a background thread until
+    /// `stop_time_sync` or `close`
+    pub fn start_time_sync(
+        self: Arc<Self>,
+        interval_secs: u32,
+        rounds: u8,
+        listener: Option<Box<dyn TimeSyncListener>>,
+    ) -> Result<(), MiniHFError> {
+        if interval_secs == 0 || rounds == 0 {
+            return Err(MiniHFError::InvalidArgument("interval and rounds must be non-zero".into()));
+        }
+        let generation = self.sync_generation.fetch_add(1, Ordering::SeqCst) + 1;
+        let hf = self.clone();
+
+        thread::spawn(move || {
+            let interval = Duration::from_secs(interval_secs as u64);
+            while hf.is_running.load(Ordering::Relaxed)
+                && hf.sync_generation.load(Ordering::SeqCst) == generation
+            {
+                let result = hf.sync_time(rounds);
+                if let Some(ref l) = listener {
+                    match result {
+                        Ok(report) => l.on_sync(report),
+                        Err(e) => l.on_sync_error(e.to_string()),
+                    }
+                }
+
+                let deadline = Instant::now() + interval;
+                while Instant::now() < deadline {
+                    if !hf.is_running.load(Ordering::Relaxed)
+                        || hf.sync_generation.load(Ordering::SeqCst) != generation
+                    {
+                        return;
+                    }
+                    thread::sleep(Duration::from_millis(100));
+                }
+            }
+        });
+        Ok(())
+    }
+
+    pub fn stop_time_sync(&self) {
+        self.sync_generation.fetch_add(1, Ordering::SeqCst);
+    }
+
+    pub fn set_calibration_ppb(&self, ppb: i32) -> Result<(), MiniHFError> {
+        self.transact(0x0B, ppb.to_le_bytes().to_vec())?;
+        Ok(())
+    }
+
+    /// Hold the forward power detector at `target_mv` by trimming the PA supply
+    pub fn set_alc(&self, enabled: bool, target_mv: u16) -> Result<(), MiniHFError> {
+        let mut payload = vec![if enabled { 1 } else { 0 }];
+        payload.extend_from_slice(&target_mv.to_le_bytes());
+        self.transact(0x0C, payload)?;
+        Ok(())
+    }
+
+    pub fn get_alc(&self) -> Result<AlcStatus, MiniHFError> {
+        let resp = self.transact(0x0D, vec![])?;
+        if resp.len() < 9 { return Err(MiniHFError::InvalidPacket); }
+        Ok(AlcStatus {
+            enabled: resp[0] & 0x01 != 0,
+            active: resp[0] & 0x02 != 0,
+            saturated: resp[0] & 0x04 != 0,
+            target_mv: u16::from_le_bytes([resp[1], resp[2]]),
+            forward_mv: u16::from_le_bytes([resp[3], resp[4]]),
+            supply_uv: u32::from_le_bytes([resp[5], resp[6], resp[7], resp[8]]),
+        })
+    }
+
+    /// Stream `rate_hz` detector windows per second, `windows_per_packet` per batch
+    pub fn start_telemetry(
+        &self,
+        rate_hz: u16,
+        windows_per_packet: u8,
+        subscriber: Box<dyn TelemetrySubscriber>,
+    ) -> Result<(), MiniHFError> {
+        if rate_hz == 0 || windows_per_packet == 0 {
+            return Err(MiniHFError::InvalidArgument("rate and batch size must be non-zero".into()));
+        }
+        if let Ok(mut guard) = self.telemetry.lock() {
+            *guard = Some(subscriber);
+        }
+        let mut payload = rate_hz.to_le_bytes().to_vec();
+        payload.push(windows_per_packet);
+        self.transact(0x0E, payload)?;
+        Ok(())
+    }
+
+    pub fn stop_telemetry(&self) -> Result<(), MiniHFError> {
+        let result = self.transact(0x0E, vec![0, 0, 0]);
+        if let Ok(mut guard) = self.telemetry.lock() {
+            *guard = None;
+        }
+        result.map(|_| ())
+    }
+
+    /// Arm the reflected-power trip at `threshold_mv`; 0 disarms. Clears a latched trip.
+    pub fn set_swr_trip(&self, threshold_mv: u16) -> Result<(), MiniHFError> {
+        self.transact(0x0F, threshold_mv.to_le_bytes().to_vec())?;
+        Ok(())
+    }
+
+    pub fn get_swr_trip(&self) -> Result<SwrGuardStatus, MiniHFError> {
+        let resp = self.transact(0x10, vec![])?;
+        parse_swr_status(&resp).ok_or(MiniHFError::InvalidPacket)
+    }
+
+    /// Key CW live from text sent with `keyer_send`. `effective_wpm` below
+    /// `wpm` stretches the gaps (Farnsworth); 0 keeps standard spacing.
+    pub fn start_cw_keyer(&self, wpm: u8, effective_wpm: u8) -> Result<(), MiniHFError> {
+        if wpm == 0 {
+            return Err(MiniHFError::InvalidArgument("wpm must be greater than 0".into()));
+        }
+        self.transact(0x14, vec![0, 0, wpm, effective_wpm, 0, 0, 0, 0, 0])?;
+        Ok(())
+    }
+
+    /// Key RTTY live from text sent with `keyer_send`, diddling while idle
+    pub fn start_rtty_keyer(&self, keying: RttyKeying) -> Result<(), MiniHFError> {
+        if !(keying.baud > 0.0 && keying.baud < 655.0) {
+            return Err(MiniHFError::InvalidArgument("baud out of range".into()));
+        }
+        let flags = (keying.reverse as u8) | (keying.center as u8) << 1 | (keying.unshift_on_space as u8) << 2;
+        let mut payload = vec![1, flags, 0, 0];
+        payload.extend_from_slice(&((keying.baud * 100.0).round() as u16).to_le_bytes());
+        payload.extend_from_slice(&keying.shift_hz.to_le_bytes());
+        payload.push((keying.stop_bits * 10.0).round() as u8);
+        self.transact(0x14, payload)?;
+        Ok(())
+    }
+
+    /// Queue text for the keyer; returns how many bytes fit. Text may be
+    /// sent before the keyer starts. In CW, `<SK>` sends a prosign.
+    pub fn keyer_send(&self, text: String) -> Result<u32, MiniHFError> {
+        let mut accepted = 0u32;
+        for chunk in text.as_bytes().chunks(KEYER_CHUNK) {
+            let mut payload = vec![0];
+            payload.extend_from_slice(chunk);
+            let resp = self.transact(0x15, payload)?;
+            if resp.is_empty() { return Err(MiniHFError::InvalidPacket); }
+            accepted += resp[0] as u32;
+            if (resp[0] as usize) < chunk.len() {
+                break;
+            }
+        }
+        Ok(accepted)
+    }
+
+    /// Stop transmitting once the queued text has been sent
+    pub fn keyer_finish(&self) -> Result<KeyerStatus, MiniHFError> {
+        let resp = self.transact(0x15, vec![0x01])?;
+        parse_keyer_status(resp.get(1..).unwrap_or_default()).ok_or(MiniHFError::InvalidPacket)
+    }
+
+    /// Stop transmitting now and drop queued text
+    pub fn keyer_abort(&self) -> Result<(), MiniHFError> {
+        self.transact(0x15, vec![0x02])?;
+        Ok(())
+    }
+
+    pub fn get_keyer_status(&self) -> Result<KeyerStatus, MiniHFError> {
+        let resp = self.transact(0x16, vec![])?;
+        parse_keyer_status(&resp).ok_or(MiniHFError::InvalidPacket)
+    }
+
+    /// Raised-cosine rise and fall of keyed CW elements; 0 keys hard
+    pub fn set_envelope_rise(&self, rise_us: u32) -> Result<(), MiniHFError> {
+        self.transact(0x17, rise_us.to_le_bytes().to_vec())?;
+        Ok(())
+    }
+
+    pub fn get_envelope_status(&self, reset: bool) -> Result<EnvelopeStatus, MiniHFError> {
+        let resp = self.transact(0x18, vec![if reset { 1 } else { 0 }])?;
+        if resp.len() < 25 { return Err(MiniHFError::InvalidPacket); }
+        let word = |i: usize| u32::from_le_bytes([resp[i], resp[i + 1], resp[i + 2], resp[i + 3]]);
+        Ok(EnvelopeStatus {
+            ready: resp[0] & 0x01 != 0,
+            rise_us: word(1),
+            ramps: word(5),
+            underruns: word(9),
+            last_cpu_ns: word(13),
+            max_cpu_ns: word(17),
+            avg_cpu_ns: word(21),
+        })
+    }
+
+    /// Encoded-sequence cache counters; reset clears them but keeps the entries
+    pub fn get_seq_cache_stats(&self, reset: bool) -> Result<SeqCacheStats, MiniHFError> {
+        let resp = self.transact(0x19, vec![if reset { 1 } else { 0 }])?;
+        if resp.len() < 30 { return Err(MiniHFError::InvalidPacket); }
+        let word = |i: usize| u32::from_le_bytes([resp[i], resp[i + 1], resp[i + 2], resp[i + 3]]);
+        Ok(SeqCacheStats {
+            hits: word(0),
+            misses: word(4),
+            evictions: word(8),
+            uncached: word(12),
+            spill_hits: word(16),
+            spill_writes: word(20),
+            spill_errors: word(24),
+            entries: resp[28],
+            capacity: resp[29],
+        })
+    }
+
+    /// Send text in CW at `wpm` from the base frequency
+    pub fn start_cw(&self, wpm: u8, text: String) -> Result<ModeStart, MiniHFError> {
+        if wpm == 0 {
+            return Err(MiniHFError::InvalidArgument("wpm must be greater than 0".into()));
+        }
+        let mut payload = vec![wpm];
+        payload.extend_from_slice(text.as_bytes());
+        self.start_mode(TxMode::Cw, false, payload)
+    }
+
+    /// Send text in RTTY, after `diddles` idle characters
+    pub fn start_rtty(&self, keying: RttyKeying, diddles: u8, text: String) -> Result<ModeStart, MiniHFError> {
+        if !(keying.baud > 0.0 && keying.baud < 655.0) {
+            return Err(MiniHFError::InvalidArgument("baud out of range".into()));
+        }
+        let flags = (keying.reverse as u8) | (keying.center as u8) << 1 | (keying.unshift_on_space as u8) << 2;
+        let mut payload = vec![flags];
+        payload.extend_from_slice(&((keying.baud * 100.0).round() as u16).to_le_bytes());
+        payload.extend_from_slice(&keying.shift_hz.to_le_bytes());
+        payload.push((keying.stop_bits * 10.0).round() as u8);
+        payload.push(diddles);
+        payload.extend_from_slice(text.as_bytes());
+        self.start_mode(TxMode::Rtty, false, payload)
+    }
+
+    pub fn start_bpsk31(&self, text: String) -> Result<ModeStart, MiniHFError> {
+        self.start_mode(TxMode::Bpsk31, false, text.into_bytes())
+    }
+
+    pub fn start_hell(&self, text: String) -> Result<ModeStart, MiniHFError> {
+        self.start_mode(TxMode::Hell, false, text.into_bytes())
+    }
+
+    /// Send a WSPR message in the next even minute, or at once with `now`
+    pub fn start_wspr(&self, callsign: String, grid: String, power_dbm: u8, now: bool) -> Result<ModeStart, MiniHFError> {
+        self.start_mode(TxMode::Wspr, now, wspr_payload(&callsign, &grid, power_dbm)?)
+    }
+
+    /// Send the WSPR message as FST4W in the next period of `mode`, or at
+    /// once with `now`
+    pub fn start_fst4w(&self, mode: TxMode, callsign: String, grid: String, power_dbm: u8, now: bool) -> Result<ModeStart, MiniHFError> {
+        if !matches!(mode, TxMode::Fst4w120 | TxMode::Fst4w300 | TxMode::Fst4w900 | TxMode::Fst4w1800) {
+            return Err(MiniHFError::InvalidArgument("mode must be an FST4W period".into()));
+        }
+        self.start_mode(mode, now, wspr_payload(&callsign, &grid, power_dbm)?)
+    }
+
+    /// Send an FT8 or FT4 message in the next slot, or at once with `now`
+    pub fn start_ftx(&self, mode: TxMode, message: FtxMessage, now: bool) -> Result<ModeStart, MiniHFError> {
+        if mode != TxMode::Ft8 && mode != TxMode::Ft4 {
+            return Err(MiniHFError::InvalidArgument("mode must be FT8 or FT4".into()));
+        }
+        let payload = match message {
+            FtxMessage::FreeText { text } => {
+                if text.is_empty() || text.len() > 13 {
+                    return Err(MiniHFError::InvalidArgument("free text is 1 to 13 characters".into()));
+                }
+                let mut payload = vec![0];
+                payload.extend_from_slice(text.as_bytes());
+                payload
+            }
+            FtxMessage::Packed { bits } => {
+                if bits.len() != 10 {
+                    return Err(MiniHFError::InvalidArgument("packed message is 10 bytes".into()));
+                }
+                let mut payload = vec![1];
+                payload.extend_from_slice(&bits);
+                payload
+            }
+        };
+        self.start_mode(mode, now, payload)
+    }
+
+    /// Encode latency of each mode built into the firmware
+    pub fn get_mode_stats(&self, reset: bool) -> Result<Vec<ModeStats>, MiniHFError> {
+        let resp = self.transact(0x1B, vec![if reset { 1 } else { 0 }])?;
+        if resp.len() % 21 != 0 { return Err(MiniHFError::InvalidPacket); }
+        resp.chunks(21)
+            .map(|b| {
+                let word = |i: usize| u32::from_le_bytes([b[i], b[i + 1], b[i + 2], b[i + 3]]);
+                Ok(ModeStats {
+                    mode: parse_tx_mode(b[0]).ok_or(MiniHFError::InvalidPacket)?,
+                    encodes: word(1),
+                    failures: word(5),
+                    last_us: word(9),
+                    max_us: word(13),
+                    avg_us: word(17),
+                })
+            })
+            .collect()
+    }
+
+    pub fn set_event_listener(&self, listener: Option<Box<dyn EventListener>>) {
+        if let Ok(mut guard) = self.events.lock() {
+            *guard = listener;
+        }
+    }
+
     pub fn reset(&self) -> Result<(), MiniHFError> {
         self.send_only(0xFD, vec![])?;
         Ok(())
@@ -383,6 +1231,9 @@ impl MiniHF {
         let port_arc = self.port.clone();
         let responses_arc = self.responses.clone();
         let is_running_arc = self.is_running.clone();
+        let events_arc = self.events.clone();
+        let telemetry_arc = self.telemetry.clone();
+        let fast_poll_arc = self.fast_poll.clone();
 
         thread::spawn(move || {
             let mut rx_buf = Vec::new();
@@ -416,6 +1267,20 @@ impl MiniHF {
                                 if pkt.ptype == DEBUG_MSG_CMD {
                                     let msg = String::from_utf8_lossy(&pkt.payload);
                                     debug_log(&format!("[device] {}", msg));
+                                } else if pkt.ptype == TELEMETRY_EVENT {
+                                    if let Some(frames) = parse_telemetry(&pkt.payload) {
+                                        if let Ok(guard) = telemetry_arc.lock() {
+                                            if let Some(ref subscriber) = *guard {
+                                                subscriber.on_batch(frames);
+                                            }
+                                        }
+                                    }
+                                } else if let Some(event) = parse_event(&pkt) {
+                                    if let Ok(guard) = events_arc.lock() {
+                                        if let Some(ref listener) = *guard {
+                                            listener.on_event(event);
+                                        }
+                                    }
                                 } else {
                                     // It's a response packet, route it to `transact`
                                     if let Ok(mut map) = responses_arc.lock() {
@@ -427,12 +1292,77 @@ impl MiniHF {
                     }
                 }
 
-                // Sleep briefly to yield CPU and allow `transact` to grab the port lock to write
-                thread::sleep(Duration::from_millis(5));
+                // Sleep briefly to yield CPU and allow `transact` to grab the port lock to write.
+                // Time sync needs tighter receive stamps than the usual poll gives.
+                if fast_poll_arc.load(Ordering::Relaxed) {
+                    thread::sleep(Duration::from_micros(200));
+                } else {
+                    thread::sleep(Duration::from_millis(5));
+                }
             }
         });
     }
 
+    /// NTP-style exchange: t1/t4 are host send/receive, t2/t3 the device's
+    /// receive (end of request frame) and transmit (start of reply) stamps.
+    /// UART wire time of both frames is removed so only link latency is
+    /// assumed symmetric.
+    fn measure_offset(&self, rounds: u8) -> Result<TimeSample, MiniHFError> {
+        let base_us = host_now_us()?;
+        let base = Instant::now();
+        let host_us = |t: Instant| base_us + t.saturating_duration_since(base).as_micros() as i64
+            - base.saturating_duration_since(t).as_micros() as i64;
+        let wire_us = |bytes: usize| (bytes as i64 * 10 * 1_000_000) / self.baud.max(1) as i64;
+
+        self.fast_poll.store(true, Ordering::Relaxed);
+        let mut best: Option<TimeSample> = None;
+        let mut result = Ok(());
+
+        for _ in 0..rounds {
+            let r = match self.transact_timed(0x12, vec![]) {
+                Ok(r) => r,
+                Err(MiniHFError::Timeout) => continue,
+                Err(e) => { result = Err(e); break; }
+            };
+            let p = &r.payload;
+            if p.len() < 17 {
+                result = Err(MiniHFError::InvalidPacket);
+                break;
+            }
+            let stamp = |i: usize| {
+                let mut b = [0u8; 8];
+                b.copy_from_slice(&p[i..i + 8]);
+                u64::from_le_bytes(b) as i64
+            };
+            let Some(state) = parse_timebase_state(p[0]) else {
+                result = Err(MiniHFError::InvalidPacket);
+                break;
+            };
+
+            let reply_len = max_encoding_length(HEADER_SIZE + p.len() + 2) + 1;
+            let t1 = host_us(r.sent);
+            let t2 = stamp(1) - wire_us(r.request_len);
+            let t3 = stamp(9);
+            let t4 = host_us(r.received) - wire_us(reply_len);
+
+            let sample = TimeSample {
+                offset_us: ((t2 - t1) + (t3 - t4)) / 2,
+                delay_us: ((t4 - t1) - (t3 - t2)).max(0),
+                state,
+            };
+            if best.as_ref().map_or(true, |b| sample.delay_us < b.delay_us) {
+                best = Some(sample);
+            }
+
+            // Spread the rounds over the reader's polling phase
+            thread::sleep(Duration::from_millis(7));
+        }
+
+        self.fast_poll.store(false, Ordering::Relaxed);
+        result?;
+        best.ok_or(MiniHFError::Timeout)
+    }
+
     fn send_only(&self, cmd_id: u8, payload: Vec<u8>) -> Result<(), MiniHFError> {
         if payload.len() > 255 {
             return Err(MiniHFError::InvalidArgument(
@@ -449,7 +1379,26 @@ impl MiniHF {
         Ok(())
     }
 
+    fn start_mode(&self, mode: TxMode, now: bool, payload: Vec<u8>) -> Result<ModeStart, MiniHFError> {
+        let mut request = vec![mode as u8, now as u8];
+        request.extend(payload);
+        let resp = self.transact(0x1A, request)?;
+        if resp.len() < 20 { return Err(MiniHFError::InvalidPacket); }
+        let word = |i: usize| u32::from_le_bytes([resp[i], resp[i + 1], resp[i + 2], resp[i + 3]]);
+        let start_utc_us = i64::from_le_bytes(resp[8..16].try_into().unwrap());
+        Ok(ModeStart {
+            symbols: word(0),
+            duration_ms: word(4),
+            start_utc_us: (start_utc_us != 0).then_some(start_utc_us),
+            encode_us: word(16),
+        })
+    }
+
     fn transact(&self, cmd_id: u8, payload: Vec<u8>) -> Result<Vec<u8>, MiniHFError> {
+        self.transact_timed(cmd_id, payload).map(|r| r.payload)
+    }
+
+    fn transact_timed(&self, cmd_id: u8, payload: Vec<u8>) -> Result<TimedResponse, MiniHFError> {
         if payload.len() > 255 {
             return Err(MiniHFError::InvalidArgument(
                 format!("payload too large: {} bytes (max 255)", payload.len()),
@@ -460,11 +1409,13 @@ impl MiniHF {
         let frame = frame_packet(cmd_id, current_id, &payload);
 
         // Scope the lock so the reader thread can continue
-        {
+        let sent = {
             let mut port_opt = self.port.lock().unwrap();
             let port = port_opt.as_mut().ok_or(MiniHFError::PortClosed)?;
+            let sent = Instant::now();
             port.write_all(&frame).map_err(|e| MiniHFError::Io(e.to_string()))?;
-        }
+            sent
+        };
 
         let deadline = Instant::now() + self.timeout;
 
@@ -481,7 +1432,12 @@ impl MiniHF {
                         return Err(MiniHFError::Nack);
                     }
                     debug_log(&format!("RX ACK cmd=0x{:02X} id={} payload_len={}", pkt.ptype, pkt.id, pkt.payload.len()));
-                    return Ok(pkt.payload);
+                    return Ok(TimedResponse {
+                        payload: pkt.payload,
+                        sent,
+                        received: pkt.received,
+                        request_len: frame.len(),
+                    });
                 }
             }
 
@@ -490,6 +1446,13 @@ impl MiniHF {
     }
 }
 
+fn host_now_us() -> Result<i64, MiniHFError> {
+    SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .map(|d| d.as_micros() as i64)
+        .map_err(|e| MiniHFError::Io(e.to_string()))
+}
+
 fn build_packet(cmd_id: u8, pkt_id: u16, payload: &[u8]) -> Vec<u8> {
     assert!(payload.len() <= 255, "payload too large for length field: {}", payload.len());
     let mut buf = Vec::new();
@@ -533,5 +1496,5 @@ fn parse_packet(raw: &[u8]) -> Option<ParsedPacket> {
     ]);
     
     if crc_calc != crc_recv { return None; }
-    Some(ParsedPacket { ptype, id, payload })
+    Some(ParsedPacket { ptype, id, payload, received: Instant::now() })
 }
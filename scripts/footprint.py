@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""Flash and RAM used per module, from the linker map of a build.
+
+Sources of this application are listed one by one; everything else is
+grouped by the Zephyr library it was linked from. Flash is code, constants
+and the load image of initialised data; RAM is initialised and zeroed data.
+
+    footprint.py build/zephyr/zephyr.map
+    footprint.py build/zephyr/zephyr.map --save footprint.txt
+    footprint.py build/zephyr/zephyr.map --baseline footprint.txt
+
+--save writes the figures in a form --baseline reads back, so a report can
+show the growth of each module since the saved build.
+"""
+
+import argparse
+import os
+import re
+import sys
+from collections import defaultdict
+
+FLASH_BUDGET = 112 * 1024   # slot0_partition
+RAM_BUDGET = 64 * 1024      # STM32L431 SRAM1 + SRAM2
+
+OUTPUT_SECTION = re.compile(r'^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(.*)$')
+OUTPUT_NAME_ONLY = re.compile(r'^(\S+)$')
+INPUT_SECTION = re.compile(r'^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+INPUT_NAME_ONLY = re.compile(r'^ (\S+)$')
+INPUT_CONTINUED = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+ARCHIVE_MEMBER = re.compile(r'(?:^|/)lib([^/()]+)\.a\(([^)]+)\)$')
+
+
+def module_of(path):
+    """Name the module an input file belongs to."""
+    m = ARCHIVE_MEMBER.search(path)
+    if not m:
+        return path.rsplit('/', 1)[-1]
+    lib, member = m.groups()
+    member = re.sub(r'\.obj$|\.o$', '', member)
+    if lib == 'app':
+        return 'app/' + member
+    return lib.replace('__', '/')
+
+
+def memory_regions(lines):
+    """(name, origin, length) of each region in the Memory Configuration."""
+    regions = []
+    inside = False
+    for line in lines:
+        if line.startswith('Memory Configuration'):
+            inside = True
+            continue
+        if inside:
+            if line.startswith('Linker script and memory map'):
+                break
+            fields = line.split()
+            if len(fields) >= 3 and fields[1].startswith('0x') and fields[0] != '*default*':
+                regions.append((fields[0], int(fields[1], 16), int(fields[2], 16)))
+    return regions
+
+
+def region_kind(regions, addr):
+    for name, origin, length in regions:
+        if origin <= addr < origin + length:
+            return 'ram' if 'RAM' in name.upper() else 'flash'
+    return None
+
+
+def parse_map(path):
+    with open(path, encoding='utf-8', errors='replace') as f:
+        lines = f.read().splitlines()
+
+    regions = memory_regions(lines)
+    usage = defaultdict(lambda: [0, 0])     # module: [flash, ram]
+
+    start = next((i for i, l in enumerate(lines) if l.startswith('Linker script and memory map')), 0)
+    out_name = None
+    out_loaded = False      # output section also has a load image in flash
+    pending = None
+
+    for line in lines[start + 1:]:
+        if line.startswith('/DISCARD/') or line.startswith('OUTPUT('):
+            out_name = None
+            continue
+
+        m = OUTPUT_SECTION.match(line)
+        if m:
+            out_name = m.group(1)
+            out_loaded = 'load address' in m.group(4)
+            pending = None
+            continue
+        m = OUTPUT_NAME_ONLY.match(line)
+        if m and not line.startswith(' '):
+            out_name = m.group(1)
+            out_loaded = False
+            continue
+        if out_name is None:
+            continue
+
+        m = INPUT_SECTION.match(line)
+        if m:
+            name, addr, size, obj = m.groups()
+        else:
+            m = INPUT_NAME_ONLY.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = INPUT_CONTINUED.match(line)
+            if not m or pending is None:
+                # a load address line belongs to the output section before it
+                if 'load address' in line:
+                    out_loaded = True
+                continue
+            name = pending
+            addr, size, obj = m.groups()
+        pending = None
+
+        if name.startswith('*') or name == '*fill*' or obj.startswith('load address'):
+            continue
+        addr, size = int(addr, 16), int(size, 16)
+        if size == 0 or addr == 0:
+            continue
+
+        kind = region_kind(regions, addr)
+        loaded = out_loaded
+        if kind is None:
+            # no memory regions (a host link): go by the output section
+            kind = 'ram' if re.search(r'bss|data|noinit', out_name) else 'flash'
+            loaded = 'data' in out_name
+
+        entry = usage[module_of(obj.strip())]
+        if kind == 'ram':
+            entry[1] += size
+            if loaded and not re.search(r'bss|noinit', name):
+                entry[0] += size
+        else:
+            entry[0] += size
+
+    return usage
+
+
+def load_baseline(path):
+    base = {}
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 3 and not line.startswith('#'):
+                base[fields[0]] = (int(fields[1]), int(fields[2]))
+    return base
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('map', help='linker map, e.g. build/zephyr/zephyr.map')
+    parser.add_argument('--baseline', help='figures saved by --save to compare with')
+    parser.add_argument('--save', help='write the figures here')
+    parser.add_argument('--top', type=int, default=0, help='list only the largest N modules')
+    args = parser.parse_args()
+
+    if not os.path.exists(args.map):
+        sys.exit(f'{args.map}: not found; build the application first')
+    usage = parse_map(args.map)
+    if not usage:
+        sys.exit(f'{args.map}: no input sections found')
+
+    base = None
+    if args.baseline:
+        if os.path.exists(args.baseline):
+            base = load_baseline(args.baseline)
+        else:
+            print(f'no baseline at {args.baseline}; save one with --save')
+
+    rows = sorted(usage.items(), key=lambda kv: (-kv[1][0], -kv[1][1], kv[0]))
+    shown = rows[:args.top] if args.top else rows
+    width = max(len('module'), max(len(name) for name, _ in shown))
+
+    header = f'{"module":<{width}} {"flash":>8} {"RAM":>8}'
+    if base is not None:
+        header += f' {"d flash":>8} {"d RAM":>8}'
+    print(header)
+    for name, (flash, ram) in shown:
+        line = f'{name:<{width}} {flash:>8} {ram:>8}'
+        if base is not None:
+            bf, br = base.get(name, (0, 0))
+            line += f' {flash - bf:>+8} {ram - br:>+8}'
+        print(line)
+
+    flash = sum(v[0] for v in usage.values())
+    ram = sum(v[1] for v in usage.values())
+    line = f'{"total":<{width}} {flash:>8} {ram:>8}'
+    if base is not None:
+        line += f' {flash - sum(v[0] for v in base.values()):>+8}' \
+                f' {ram - sum(v[1] for v in base.values()):>+8}'
+    print('-' * len(header))
+    print(line)
+    print(f'flash {100.0 * flash / FLASH_BUDGET:.1f}% of slot0_partition, '
+          f'RAM {100.0 * ram / RAM_BUDGET:.1f}% of SRAM')
+    if base is not None:
+        gone = sorted(set(base) - set(usage))
+        if gone:
+            print('no longer linked: ' + ', '.join(gone))
+
+    if args.save:
+        with open(args.save, 'w', encoding='utf-8') as f:
+            f.write('# module flash ram\n')
+            for name, (fl, rm) in sorted(usage.items()):
+                f.write(f'{name} {fl} {rm}\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""The LDPC(240,74) code of the FST4W encoder, and its generator table.
+
+FST4W protects 50 message bits and a 24-bit CRC with 166 parity bits.
+The WSJT-X generator matrix for the code is not available to this tree.
+This script builds a code with the same shape:
+- a parity-check matrix H of 166 checks over 240 bits;
+- every bit is in three checks, and the checks hold four or five bits;
+- no two checks share more than one bit, so there are no 4-cycles;
+- H is systematic in its first 74 bits, with H = [A | B] and B
+  invertible.
+The construction is deterministic: the seed is the first one, counting
+up from SEED, whose B is invertible.
+
+Run with no arguments, it prints the generator as the C table in
+src/modes/encoders/fst4w.c. Column j holds the 166 parity bits that
+message bit j feeds, which is B^-1 A e_j, packed MSB first. Other
+scripts import checks() to get H.
+"""
+
+import random
+import sys
+
+N = 240
+K = 74
+M = N - K
+COL_WEIGHT = 3
+SEED = 4740
+
+
+def _build(seed):
+    rng = random.Random(seed)
+    rows = [set() for _ in range(M)]
+    for col in range(N):
+        chosen = []
+        for _ in range(COL_WEIGHT):
+            # Lightest checks first; none that already shares a bit
+            # with a check this column is in
+            options = [r for r in range(M) if r not in chosen and
+                       all(not (rows[r] & rows[c]) for c in chosen)]
+            least = min(len(rows[r]) for r in options)
+            chosen.append(rng.choice([r for r in options if len(rows[r]) == least]))
+        for r in chosen:
+            rows[r].add(col)
+    return [sorted(r) for r in rows]
+
+
+def _row_bits(row, lo, hi):
+    return sum(1 << (c - lo) for c in row if lo <= c < hi)
+
+
+def _invert_parity(rows):
+    """B^-1 as row bitmasks, or None when B is singular"""
+    b = [_row_bits(r, K, N) for r in rows]
+    inv = [1 << i for i in range(M)]
+    for col in range(M):
+        pivot = next((r for r in range(col, M) if b[r] >> col & 1), None)
+        if pivot is None:
+            return None
+        b[col], b[pivot] = b[pivot], b[col]
+        inv[col], inv[pivot] = inv[pivot], inv[col]
+        for r in range(M):
+            if r != col and b[r] >> col & 1:
+                b[r] ^= b[col]
+                inv[r] ^= inv[col]
+    return inv
+
+
+def checks():
+    """Rows of H, each a sorted list of codeword bit indices"""
+    seed = SEED
+    while True:
+        rows = _build(seed)
+        if _invert_parity(rows) is not None:
+            return rows
+        seed += 1
+
+
+def parity(rows, msg):
+    """The 166 parity bits of message bits msg, solved from H"""
+    inv = _invert_parity(rows)
+    syndrome = [sum(msg[c] for c in r if c < K) & 1 for r in rows]
+    return [bin(sum(1 << i for i in range(M) if inv[p] >> i & 1 and syndrome[i])).count('1') & 1
+            for p in range(M)]
+
+
+def main():
+    rows = checks()
+    words = (M + 31) // 32
+    print('static const uint32_t ldpc_columns[FST4W_LDPC_K][%d] = {' % words)
+    for j in range(K):
+        bits = parity(rows, [int(i == j) for i in range(K)])
+        bits += [0] * (32 * words - M)
+        packed = [int(''.join(map(str, bits[32 * w:32 * w + 32])), 2) for w in range(words)]
+        print('    { ' + ', '.join('0x%08x' % w for w in packed) + ' },')
+    print('};')
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Reference channel symbols for the FST4W encoder tests.
+
+This is an encoder written from the FST4W description, sharing no code
+with src/modes:
+- it takes the same 50-bit message as WSPR, packed by wspr_vectors.py;
+- it appends the CRC-24, computed by bitwise long division with
+  polynomial 0x100065B over the message and 24 zero bits;
+- it adds the LDPC(240,74) parity;
+- it Gray maps each bit pair to one of four tones and places the 120
+  data symbols between five 8-symbol sync words.
+Each message is printed as a line of 160 tone digits. The FEC layer is
+then printed on its own: the 74 message and CRC bits and the 240-bit
+codeword, in hex, MSB first and zero padded to whole bytes:
+
+    fst4w_vectors.py
+
+The parity is not read from the encoder's generator table. It is solved
+from the parity-check matrix of fst4w_ldpc.py, by elimination for each
+message.
+"""
+
+import fst4w_ldpc
+from wspr_vectors import pack_call, pack_grid_power
+
+CRC24_POLY = 0x100065B
+
+SYNC1 = [0, 1, 3, 2, 1, 0, 2, 3]
+SYNC2 = [2, 3, 1, 0, 3, 2, 0, 1]
+GRAY = [0, 1, 3, 2]
+
+
+def crc24(bits):
+    reg = bits + [0] * 24
+    for i in range(len(bits)):
+        if reg[i]:
+            for j in range(25):
+                reg[i + j] ^= (CRC24_POLY >> (24 - j)) & 1
+    return reg[-24:]
+
+
+def message_bits(call, grid, dbm):
+    msg = pack_call(call) << 22 | pack_grid_power(grid, dbm)
+    bits = [(msg >> (49 - i)) & 1 for i in range(50)]
+    return bits + crc24(bits)
+
+
+def codeword(msg74, rows):
+    return msg74 + fst4w_ldpc.parity(rows, msg74)
+
+
+def tones(cw):
+    data = [GRAY[2 * cw[2 * i] + cw[2 * i + 1]] for i in range(120)]
+    return (SYNC1 + data[0:30] + SYNC2 + data[30:60] + SYNC1 +
+            data[60:90] + SYNC2 + data[90:120] + SYNC1)
+
+
+def to_hex(bits):
+    bits = bits + [0] * (-len(bits) % 8)
+    return ''.join('%02x' % int(''.join(map(str, bits[i:i + 8])), 2)
+                   for i in range(0, len(bits), 8))
+
+
+MESSAGES = [
+    ('K1ABC', 'FN42', 37),
+    ('G4JNT', 'IO90', 30),
+    ('KH6XYZ', 'BL11', 23),
+    ('W1AW', 'FN31', 0),
+]
+
+
+def main():
+    rows = fst4w_ldpc.checks()
+    words = []
+    for call, grid, dbm in MESSAGES:
+        name = '%s %s %d' % (call, grid, dbm)
+        msg = message_bits(call, grid, dbm)
+        cw = codeword(msg, rows)
+        assert all(sum(cw[c] for c in r) % 2 == 0 for r in rows)
+        print('%-16s %s' % (name, ''.join(map(str, tones(cw)))))
+        words.append((name, msg, cw))
+    for name, msg, cw in words:
+        print('LDPC %-16s %s %s' % (name, to_hex(msg), to_hex(cw)))
+    print('CRC24 123456789 %06x' % int(''.join(map(str, crc24(
+        [int(b) for c in b'123456789' for b in '{:08b}'.format(c)]))), 2))
+
+
+if __name__ == '__main__':
+    main()
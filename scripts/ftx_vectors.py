@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""Reference channel symbols for the FT8 and FT4 encoder tests.
+
+An independent encoder written from the protocol description (the QEX
+paper on FT4 and FT8 and the WSJT-X user guide), sharing no code with
+src/modes. It packs a message to 77 bits, appends the CRC-14, adds the
+LDPC(174,91) parity and maps the codeword to tones, and prints one line
+per message in the digit-string form WSJT-X's ft8code and ft4code show,
+then the FEC layer alone: each 77-bit payload and its 174-bit codeword
+in hex, MSB first and zero padded to whole bytes:
+
+    ftx_vectors.py [src/modes/ftx.c]
+
+The LDPC parity is not taken from the encoder's generator table. It is
+solved from the parity-check matrix the decoder uses (ldpc_checks, read
+from ftx.c): the code is systematic in its first 91 bits, so H = [A | B]
+gives parity = B^-1 A m over GF(2), which is the only generator that
+agrees with H.
+"""
+
+import os
+import re
+import sys
+
+NTOKENS = 2063592
+MAX22 = 4194304
+MAXGRID4 = 32400
+
+FT8_COSTAS = [3, 1, 4, 0, 6, 5, 2]
+FT8_GRAY = [0, 1, 3, 2, 5, 6, 4, 7]
+
+# FT4: a different Costas array ahead of each data block, and the
+# payload XORed with this sequence before the CRC
+FT4_COSTAS = [[0, 1, 3, 2], [1, 0, 2, 3], [2, 3, 1, 0], [3, 2, 0, 1]]
+FT4_GRAY = [0, 1, 3, 2]
+FT4_RVEC = [0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 0, 1, 1, 1, 1, 0, 1, 0, 0, 0,
+            1, 0, 0, 1, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 0, 0, 0,
+            1, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 1, 0, 1,
+            0, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0, 1]
+
+F71_CHARS = ' 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?'
+
+
+def bits(value, n):
+    return [(value >> (n - 1 - i)) & 1 for i in range(n)]
+
+
+def pack28(token):
+    """c28: CQ/DE/QRZ tokens or a standard callsign"""
+    specials = {'DE': 0, 'QRZ': 1, 'CQ': 2}
+    if token in specials:
+        return specials[token]
+
+    # The area digit goes third: K1ABC is sent as " K1ABC"
+    call = (' ' + token if token[1].isdigit() else token).ljust(6)
+
+    a1 = ' 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+    a2 = '0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+    a3 = '0123456789'
+    a4 = ' ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+    n = a1.index(call[0])
+    n = n * 36 + a2.index(call[1])
+    n = n * 10 + a3.index(call[2])
+    n = n * 27 + a4.index(call[3])
+    n = n * 27 + a4.index(call[4])
+    n = n * 27 + a4.index(call[5])
+    return NTOKENS + MAX22 + n
+
+
+def pack15(word):
+    """g15: a 4-character grid, a report, RRR, RR73, 73 or blank"""
+    fixed = {'': 1, 'RRR': 2, 'RR73': 3, '73': 4}
+    if word in fixed:
+        return MAXGRID4 + fixed[word]
+    if word[0] in '+-':
+        return MAXGRID4 + 35 + int(word)
+    return (((ord(word[0]) - 65) * 18 + ord(word[1]) - 65) * 10
+            + int(word[2])) * 10 + int(word[3])
+
+
+def msg_std(call1, call2, extra='', roger=False):
+    """Type 1: c28 r1 c28 r1 R1 g15 i3=1"""
+    return (bits(pack28(call1), 28) + [0] + bits(pack28(call2), 28) + [0]
+            + [1 if roger else 0] + bits(pack15(extra), 15) + bits(1, 3))
+
+
+def msg_text(text):
+    """Type 0.0: f71 n3=0 i3=0, right-aligned in 13 characters"""
+    n = 0
+    for c in text.rjust(13):
+        n = n * 42 + F71_CHARS.index(c)
+    return bits(n, 71) + bits(0, 3) + bits(0, 3)
+
+
+def msg_telemetry(hexdigits):
+    """Type 0.5: t71 n3=5 i3=0"""
+    return bits(int(hexdigits, 16), 71) + bits(5, 3) + bits(0, 3)
+
+
+def crc14(msg77):
+    """CRC-14 0x2757 over the message and five zero bits, MSB first"""
+    reg = 0
+    for b in msg77 + [0] * 5:
+        top = (reg >> 13) & 1
+        reg = ((reg << 1) & 0x3FFF) | b
+        if top:
+            reg ^= 0x2757
+    for _ in range(14):
+        top = (reg >> 13) & 1
+        reg = (reg << 1) & 0x3FFF
+        if top:
+            reg ^= 0x2757
+    return reg
+
+
+def read_checks(path):
+    src = open(path).read()
+    table = re.search(r'ldpc_checks\[FTX_LDPC_M\]\[7\] = \{(.*?)\n\};', src, re.S)
+    rows = re.findall(r'\{([^{}]*)\}', table.group(1))
+    return [[int(v) for v in row.split(',') if int(v) != 255] for row in rows]
+
+
+def parity_solver(checks, k=91, n=174):
+    """Rows of B^-1 A, from H = [A | B], by Gauss-Jordan over GF(2)"""
+    m = n - k
+    rows = []
+    for c in checks:
+        a = sum(1 << j for j in c if j < k)
+        b = sum(1 << (j - k) for j in c if j >= k)
+        rows.append([b, a])
+    for col in range(m):
+        pivot = next(r for r in range(col, m) if rows[r][0] >> col & 1)
+        rows[col], rows[pivot] = rows[pivot], rows[col]
+        for r in range(m):
+            if r != col and rows[r][0] >> col & 1:
+                rows[r][0] ^= rows[col][0]
+                rows[r][1] ^= rows[col][1]
+    return [a for _, a in rows]
+
+
+def codeword(msg77, solver):
+    msg91 = msg77 + bits(crc14(msg77), 14)
+    m = sum(b << j for j, b in enumerate(msg91))
+    return msg91 + [bin(row & m).count('1') & 1 for row in solver]
+
+
+def ft8_tones(cw):
+    data = [FT8_GRAY[cw[i] << 2 | cw[i + 1] << 1 | cw[i + 2]]
+            for i in range(0, 174, 3)]
+    return FT8_COSTAS + data[:29] + FT8_COSTAS + data[29:] + FT8_COSTAS
+
+
+assert len(FT4_RVEC) == 77
+
+
+def ft4_tones(cw):
+    """103 channel symbols, plus a ramp symbol at each end that repeats
+    its neighbour, as the waveform generator extends them"""
+    data = [FT4_GRAY[cw[i] << 1 | cw[i + 1]] for i in range(0, 174, 2)]
+    tones = []
+    for b in range(3):
+        tones += FT4_COSTAS[b] + data[29 * b:29 * (b + 1)]
+    tones += FT4_COSTAS[3]
+    return [tones[0]] + tones + [tones[-1]]
+
+
+MESSAGES = [
+    ('CQ K1ABC FN42', msg_std('CQ', 'K1ABC', 'FN42')),
+    ('K1ABC W9XYZ EN37', msg_std('K1ABC', 'W9XYZ', 'EN37')),
+    ('W9XYZ K1ABC -11', msg_std('W9XYZ', 'K1ABC', '-11')),
+    ('K1ABC W9XYZ R-09', msg_std('K1ABC', 'W9XYZ', '-09', roger=True)),
+    ('W9XYZ K1ABC RR73', msg_std('W9XYZ', 'K1ABC', 'RR73')),
+    ('free text TNX BOB 73 GL', msg_text('TNX BOB 73 GL')),
+    ('free text HELLO', msg_text('HELLO')),
+    ('telemetry 123456789ABCDEF012', msg_telemetry('123456789ABCDEF012')),
+    ('telemetry 7FFFFFFFFFFFFFFFFF', msg_telemetry('7FFFFFFFFFFFFFFFFF')),
+]
+
+
+def to_hex(bitlist):
+    bitlist = bitlist + [0] * (-len(bitlist) % 8)
+    return ''.join('%02x' % int(''.join(map(str, bitlist[i:i + 8])), 2)
+                   for i in range(0, len(bitlist), 8))
+
+
+def main():
+    root = os.path.join(os.path.dirname(__file__), '..')
+    path = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, 'src/modes/ftx.c')
+    solver = parity_solver(read_checks(path))
+
+    for name, msg in MESSAGES:
+        cw = codeword(msg, solver)
+        print('FT8 %-32s %s' % (name, ''.join(str(t) for t in ft8_tones(cw))))
+    for name, msg in MESSAGES:
+        cw = codeword([b ^ r for b, r in zip(msg, FT4_RVEC)], solver)
+        print('FT4 %-32s %s' % (name, ''.join(str(t) for t in ft4_tones(cw))))
+    for name, msg in MESSAGES:
+        print('LDPC %-31s %s %s' % (name, to_hex(msg), to_hex(codeword(msg, solver))))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Reference channel symbols for the WSPR encoder tests.
+
+An independent encoder written from the published description of the
+WSPR coding process (G4JNT), sharing no code with src/modes. It packs
+callsign, locator and power into 50 bits, runs the K=32 r=1/2
+convolutional encoder bit by bit over them and 31 flush zeros, applies
+the bit-reversal interleaver and adds the sync vector, then prints the
+162 symbols of each message as a digit string:
+
+    wspr_vectors.py
+"""
+
+POLY_A = 0xF2D05351
+POLY_B = 0xE4613C47
+
+SYNC = [
+    1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0,
+    0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1,
+    0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 0, 1,
+    1, 0, 1, 0, 0, 0, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 1,
+    0, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0, 1, 0, 1, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 1, 0, 1, 1, 0, 0, 1, 1,
+    0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 1, 1, 0, 0, 0, 1, 1, 0,
+    0, 0,
+]
+
+ALNUM = '0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ '
+
+
+def pack_call(call):
+    """28 bits; the third character must be the area digit"""
+    if not call[2].isdigit():
+        call = ' ' + call
+    call = call.ljust(6)
+    n = ALNUM.index(call[0])
+    n = n * 36 + ALNUM.index(call[1])
+    n = n * 10 + ALNUM.index(call[2])
+    for c in call[3:]:
+        n = n * 27 + ALNUM.index(c) - 10
+    return n
+
+
+def pack_grid_power(grid, dbm):
+    """22 bits: 15 of locator, 7 of power"""
+    lon = ord(grid[0]) - ord('A')
+    lat = ord(grid[1]) - ord('A')
+    m = (179 - 10 * lon - int(grid[2])) * 180 + 10 * lat + int(grid[3])
+    return m * 128 + dbm + 64
+
+
+def parity(v):
+    return bin(v).count('1') & 1
+
+
+def symbols(call, grid, dbm):
+    msg = pack_call(call) << 22 | pack_grid_power(grid, dbm)
+    bits = [(msg >> (49 - i)) & 1 for i in range(50)] + [0] * 31
+
+    coded = []
+    reg = 0
+    for b in bits:
+        reg = ((reg << 1) | b) & 0xFFFFFFFF
+        coded += [parity(reg & POLY_A), parity(reg & POLY_B)]
+
+    data = [0] * 162
+    p = 0
+    for i in range(256):
+        j = int('{:08b}'.format(i)[::-1], 2)
+        if j < 162:
+            data[j] = coded[p]
+            p += 1
+
+    return [SYNC[i] + 2 * data[i] for i in range(162)]
+
+
+MESSAGES = [
+    ('K1ABC', 'FN42', 37),
+    ('G4JNT', 'IO90', 30),
+    ('KH6XYZ', 'BL11', 23),
+    ('W1AW', 'FN31', 0),
+    ('VK2ZZZ', 'QF56', 60),
+]
+
+
+def main():
+    for call, grid, dbm in MESSAGES:
+        name = '%s %s %d' % (call, grid, dbm)
+        print('%-16s %s' % (name, ''.join(str(s) for s in symbols(call, grid, dbm))))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,165 @@
+#include "hardware/adc_sampler.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/irq.h>
+#include <stm32l4xx.h>
+
+/* ADC1 scans IN11/IN12 continuously and DMA1 channel 1 streams the results
+ * into a circular buffer. Each half is handed to listeners while the other
+ * fills. The Zephyr ADC driver is not enabled, so the peripheral is ours. */
+#define ADC_CH_FWD          11
+#define ADC_CH_REF          12
+#define ADC_SMP_640_5       7
+/* 640.5 sampling + 12.5 conversion cycles, two channels per frame */
+#define ADC_FRAME_CYCLES    1306
+/* CKMODE = HCLK/4, matching st,adc-prescaler in the devicetree */
+#define ADC_CLK_DIV         4
+#define ADC_DMA_IRQ_PRIO    2
+#define ADC_AWD_IRQ_PRIO    0
+
+static struct adc_frame adc_buf[2 * ADC_SAMPLER_BLOCK] __aligned(4);
+static sys_slist_t listeners;
+static adc_sampler_awd_handler_t awd_handler;
+
+static void adc_dma_isr(const void *arg) {
+    uint32_t isr = DMA1->ISR;
+    const struct adc_frame *half = NULL;
+
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+
+    if (isr & DMA_ISR_HTIF1) {
+        half = &adc_buf[0];
+    } else if (isr & DMA_ISR_TCIF1) {
+        half = &adc_buf[ADC_SAMPLER_BLOCK];
+    }
+    if (!half) {
+        return;
+    }
+
+    struct adc_sampler_listener *l;
+    SYS_SLIST_FOR_EACH_CONTAINER(&listeners, l, node) {
+        l->handler(half, ADC_SAMPLER_BLOCK);
+    }
+}
+
+static void adc_awd_isr(const void *arg) {
+    if (!(ADC1->ISR & ADC_ISR_AWD1)) {
+        return;
+    }
+
+    /* One shot: the caller re-arms once the fault is dealt with */
+    ADC1->IER &= ~ADC_IER_AWD1IE;
+    ADC1->ISR = ADC_ISR_AWD1;
+
+    if (awd_handler) {
+        awd_handler();
+    }
+}
+
+uint32_t adc_sampler_frame_hz(void) {
+    return sys_clock_hw_cycles_per_sec() / ADC_CLK_DIV / ADC_FRAME_CYCLES;
+}
+
+void adc_sampler_add_listener(struct adc_sampler_listener *listener) {
+    unsigned int key = irq_lock();
+    sys_slist_append(&listeners, &listener->node);
+    irq_unlock(key);
+}
+
+static int adc_wait(volatile uint32_t *reg, uint32_t mask, uint32_t want) {
+    for (int i = 0; i < 10000; i++) {
+        if ((*reg & mask) == want) {
+            return 0;
+        }
+        k_busy_wait(1);
+    }
+    return -ETIMEDOUT;
+}
+
+/* Restart DMA from the top of the buffer so frames stay channel-aligned */
+static void adc_dma_start(void) {
+    DMA1_Channel1->CCR &= ~DMA_CCR_EN;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    DMA1_Channel1->CMAR = (uint32_t)adc_buf;
+    DMA1_Channel1->CNDTR = 2 * ARRAY_SIZE(adc_buf);  /* half-word transfers */
+    DMA1_Channel1->CCR |= DMA_CCR_EN;
+}
+
+int adc_sampler_arm_watchdog(uint16_t high_raw, adc_sampler_awd_handler_t handler) {
+    if (high_raw > ADC_SAMPLER_FULL) {
+        return -EINVAL;
+    }
+
+    /* CFGR and TR1 are only writable with the scan stopped */
+    ADC1->IER &= ~ADC_IER_AWD1IE;
+    ADC1->CR |= ADC_CR_ADSTP;
+    if (adc_wait(&ADC1->CR, ADC_CR_ADSTART, 0)) {
+        return -ETIMEDOUT;
+    }
+
+    awd_handler = handler;
+    ADC1->TR1 = (high_raw << ADC_TR1_HT1_Pos) | (0u << ADC_TR1_LT1_Pos);
+    ADC1->CFGR = (ADC1->CFGR & ~ADC_CFGR_AWD1CH_Msk) |
+                 (ADC_CH_REF << ADC_CFGR_AWD1CH_Pos) |
+                 ADC_CFGR_AWD1SGL | ADC_CFGR_AWD1EN;
+    ADC1->ISR = ADC_ISR_AWD1;
+    ADC1->IER |= ADC_IER_AWD1IE;
+
+    adc_dma_start();
+    ADC1->CR |= ADC_CR_ADSTART;
+
+    return 0;
+}
+
+void adc_sampler_disarm_watchdog(void) {
+    ADC1->IER &= ~ADC_IER_AWD1IE;
+    ADC1->ISR = ADC_ISR_AWD1;
+}
+
+int adc_sampler_init(void) {
+    sys_slist_init(&listeners);
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    RCC->AHB2ENR |= RCC_AHB2ENR_ADCEN;
+
+    ADC1_COMMON->CCR = (ADC1_COMMON->CCR & ~ADC_CCR_CKMODE_Msk) | (3u << ADC_CCR_CKMODE_Pos);
+
+    /* Leave deep power-down, start the regulator, calibrate, enable */
+    ADC1->CR &= ~ADC_CR_DEEPPWD;
+    ADC1->CR |= ADC_CR_ADVREGEN;
+    k_busy_wait(20);
+
+    ADC1->CR |= ADC_CR_ADCAL;
+    if (adc_wait(&ADC1->CR, ADC_CR_ADCAL, 0)) {
+        return -ETIMEDOUT;
+    }
+
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC1->CR |= ADC_CR_ADEN;
+    if (adc_wait(&ADC1->ISR, ADC_ISR_ADRDY, ADC_ISR_ADRDY)) {
+        return -ETIMEDOUT;
+    }
+
+    ADC1->SMPR2 = (ADC_SMP_640_5 << ADC_SMPR2_SMP11_Pos) | (ADC_SMP_640_5 << ADC_SMPR2_SMP12_Pos);
+    ADC1->SQR1 = (1u << ADC_SQR1_L_Pos) |
+                 (ADC_CH_FWD << ADC_SQR1_SQ1_Pos) |
+                 (ADC_CH_REF << ADC_SQR1_SQ2_Pos);
+    ADC1->CFGR = ADC_CFGR_CONT | ADC_CFGR_OVRMOD | ADC_CFGR_DMACFG | ADC_CFGR_DMAEN;
+
+    /* DMA1 channel 1, request 0 = ADC1, 16-bit circular */
+    DMA1_CSELR->CSELR &= ~DMA_CSELR_C1S_Msk;
+    DMA1_Channel1->CCR = 0;
+    DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 |
+                         DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE;
+
+    IRQ_CONNECT(DMA1_Channel1_IRQn, ADC_DMA_IRQ_PRIO, adc_dma_isr, NULL, 0);
+    irq_enable(DMA1_Channel1_IRQn);
+    IRQ_CONNECT(ADC1_IRQn, ADC_AWD_IRQ_PRIO, adc_awd_isr, NULL, 0);
+    irq_enable(ADC1_IRQn);
+
+    adc_dma_start();
+    ADC1->CR |= ADC_CR_ADSTART;
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include "hardware/envelope.h"
+#include "config.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/irq.h>
+#include <zephyr/drivers/dac.h>
+#include <zephyr/sys/printk.h>
+#include <stm32l4xx.h>
+#include <string.h>
+
+/* DAC1 channel 1 (PA4) sets the PA envelope. The Zephyr driver brings the
+ * channel up; the trigger and DMA are then ours. TIM6 TRGO paces the
+ * conversions and DMA1 channel 3 feeds each one the next table entry. */
+#define ENVELOPE_CHANNEL     1
+#define ENVELOPE_RESOLUTION  12
+#define ENVELOPE_DMA_REQ     6      // DMA1 channel 3 request 6 = DAC_CH1
+#define ENVELOPE_TSEL_TIM6   0
+#define ENVELOPE_IRQ_PRIO    2
+
+#define ENVELOPE_FULL  envelope_rise[ENVELOPE_STEPS]
+
+static const struct device *const dac = DEVICE_DT_GET(DT_NODELABEL(dac1));
+static bool dac_ready;
+
+static struct k_spinlock envelope_lock;
+static uint32_t rise_us;
+
+/* The ramp on the DAC. Its last entry is written by the completion
+ * interrupt: the DAC only outputs what DMA loaded on the trigger after. */
+static const uint16_t *ramp;
+static uint32_t ramp_start_cycles;
+static volatile uint32_t null_cycles;
+
+/* The fall of a shaped symbol is started from a timer at its due time */
+static struct k_timer fall_timer;
+static uint32_t fall_us;
+
+static struct {
+    uint32_t ramps;
+    uint32_t underruns;
+    uint32_t last_cpu;
+    uint32_t max_cpu;
+    uint64_t sum_cpu;
+} ramp_stats;
+
+static void dac_set(uint16_t level) {
+    DAC1->CR &= ~DAC_CR_TEN1;
+    DAC1->DHR12R1 = level;
+}
+
+static void ramp_halt(void) {
+    TIM6->CR1 = 0;
+    DMA1_Channel3->CCR &= ~DMA_CCR_EN;
+    ramp = NULL;
+}
+
+/* Caller holds envelope_lock. table[0] goes out now, the rest at
+ * ramp_us / ENVELOPE_STEPS intervals. */
+static void ramp_start(const uint16_t *table, uint32_t ramp_us) {
+    uint32_t start = k_cycle_get_32();
+
+    ramp_halt();
+
+    uint32_t period = envelope_step_cycles(ramp_us);
+    if (period < 2) {
+        dac_set(table[ENVELOPE_STEPS]);
+        return;
+    }
+
+    dac_set(table[0]);
+    DMA1->IFCR = DMA_IFCR_CGIF3;
+    DMA1_Channel3->CMAR = (uint32_t)&table[1];
+    DMA1_Channel3->CNDTR = ENVELOPE_STEPS;
+    DMA1_Channel3->CCR |= DMA_CCR_EN;
+    DAC1->SR = DAC_SR_DMAUDR1;
+    DAC1->CR |= DAC_CR_TEN1;
+
+    TIM6->ARR = period - 1;
+    TIM6->CNT = 0;
+    TIM6->CR1 = TIM_CR1_CEN;
+
+    ramp = table;
+    ramp_start_cycles = k_cycle_get_32() - start;
+}
+
+/* Caller holds envelope_lock */
+static void ramp_finish(uint32_t entry_cycles) {
+    const uint16_t *table = ramp;
+
+    ramp_halt();
+    if (!table) {
+        return;
+    }
+    dac_set(table[ENVELOPE_STEPS]);
+    if (table == envelope_fall) {
+        null_cycles = k_cycle_get_32();
+    }
+
+    uint32_t cpu = ramp_start_cycles + (k_cycle_get_32() - entry_cycles);
+    ramp_stats.ramps++;
+    ramp_stats.last_cpu = cpu;
+    ramp_stats.max_cpu = MAX(ramp_stats.max_cpu, cpu);
+    ramp_stats.sum_cpu += cpu;
+}
+
+static void envelope_dma_isr(const void *arg) {
+    uint32_t entry = k_cycle_get_32();
+    uint32_t isr = DMA1->ISR;
+
+    DMA1->IFCR = DMA_IFCR_CGIF3;
+    if (!(isr & DMA_ISR_TCIF3)) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    ramp_finish(entry);
+    k_spin_unlock(&envelope_lock, key);
+}
+
+/* A trigger that found no fresh sample stops the DAC's DMA requests; land
+ * the ramp on its end value rather than leave it part way */
+static void envelope_underrun_isr(const void *arg) {
+    uint32_t entry = k_cycle_get_32();
+
+    if (!(DAC1->SR & DAC_SR_DMAUDR1)) {
+        return;
+    }
+    DAC1->SR = DAC_SR_DMAUDR1;
+
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    ramp_stats.underruns++;
+    ramp_finish(entry);
+    k_spin_unlock(&envelope_lock, key);
+}
+
+static void fall_timer_expiry(struct k_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    ramp_start(envelope_fall, fall_us);
+    k_spin_unlock(&envelope_lock, key);
+}
+
+int envelope_init(void) {
+    if (!device_is_ready(dac)) {
+        printk("envelope: DAC not ready\n");
+        return -ENODEV;
+    }
+
+    const struct dac_channel_cfg cfg = {
+        .channel_id = ENVELOPE_CHANNEL,
+        .resolution = ENVELOPE_RESOLUTION,
+        .buffered = true,
+    };
+    int ret = dac_channel_setup(dac, &cfg);
+    if (ret) {
+        printk("envelope: channel setup failed (%d)\n", ret);
+        return ret;
+    }
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    RCC->APB1ENR1 |= RCC_APB1ENR1_TIM6EN;
+
+    /* Load the prescaler before TRGO is routed anywhere */
+    TIM6->CR1 = 0;
+    TIM6->PSC = 0;
+    TIM6->EGR = TIM_EGR_UG;
+    TIM6->CR2 = TIM_CR2_MMS_1;
+
+    /* Half-word table entries into the word-wide holding register */
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C3S_Msk) |
+                        (ENVELOPE_DMA_REQ << DMA_CSELR_C3S_Pos);
+    DMA1_Channel3->CCR = 0;
+    DMA1_Channel3->CPAR = (uint32_t)&DAC1->DHR12R1;
+    DMA1_Channel3->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_PSIZE_1 |
+                         DMA_CCR_MSIZE_0 | DMA_CCR_TCIE;
+
+    dac_set(ENVELOPE_FULL);
+    DAC1->CR = (DAC1->CR & ~DAC_CR_TSEL1_Msk) |
+               (ENVELOPE_TSEL_TIM6 << DAC_CR_TSEL1_Pos) |
+               DAC_CR_DMAEN1 | DAC_CR_DMAUDRIE1;
+
+    IRQ_CONNECT(DMA1_Channel3_IRQn, ENVELOPE_IRQ_PRIO, envelope_dma_isr, NULL, 0);
+    irq_enable(DMA1_Channel3_IRQn);
+    IRQ_CONNECT(TIM6_DAC_IRQn, ENVELOPE_IRQ_PRIO, envelope_underrun_isr, NULL, 0);
+    irq_enable(TIM6_DAC_IRQn);
+
+    k_timer_init(&fall_timer, fall_timer_expiry, NULL);
+    rise_us = MIN(CONFIG_ENVELOPE_RISE_US, envelope_max_ramp_us());
+    dac_ready = true;
+    return 0;
+}
+
+bool envelope_ready(void) {
+    return dac_ready;
+}
+
+int envelope_set_rise_us(uint32_t us) {
+    if (us > envelope_max_ramp_us()) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    rise_us = us;
+    k_spin_unlock(&envelope_lock, key);
+    return 0;
+}
+
+void envelope_key(bool on, uint32_t duration_us) {
+    if (!dac_ready) {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    ramp_start(on ? envelope_rise : envelope_fall, MIN(rise_us, duration_us / 2));
+    k_spin_unlock(&envelope_lock, key);
+}
+
+void envelope_shape(int64_t start_ticks, int64_t end_ticks, uint8_t shape) {
+    if (!dac_ready) {
+        return;
+    }
+
+    k_timer_stop(&fall_timer);
+
+    struct envelope_plan plan;
+    envelope_plan_shape(start_ticks, end_ticks, &plan);
+
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    if (shape & TX_SHAPE_RAMP_UP) {
+        ramp_start(envelope_rise, plan.ramp_us);
+    }
+    fall_us = plan.ramp_us;
+    k_spin_unlock(&envelope_lock, key);
+
+    if (shape & TX_SHAPE_RAMP_DOWN) {
+        k_timer_start(&fall_timer, K_TIMEOUT_ABS_TICKS(plan.fall_ticks), K_NO_WAIT);
+    }
+}
+
+void envelope_stop(void) {
+    if (!dac_ready) {
+        return;
+    }
+
+    k_timer_stop(&fall_timer);
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    ramp_halt();
+    dac_set(ENVELOPE_FULL);
+    k_spin_unlock(&envelope_lock, key);
+}
+
+uint32_t envelope_null_cycles(void) {
+    return null_cycles;
+}
+
+void envelope_get_status(struct envelope_status *out) {
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+
+    out->ready = dac_ready;
+    out->rise_us = rise_us;
+    out->ramps = ramp_stats.ramps;
+    out->underruns = ramp_stats.underruns;
+    out->last_cpu_ns = (uint32_t)k_cyc_to_ns_floor64(ramp_stats.last_cpu);
+    out->max_cpu_ns = (uint32_t)k_cyc_to_ns_floor64(ramp_stats.max_cpu);
+    out->avg_cpu_ns = ramp_stats.ramps ?
+        (uint32_t)k_cyc_to_ns_floor64(ramp_stats.sum_cpu / ramp_stats.ramps) : 0;
+
+    k_spin_unlock(&envelope_lock, key);
+}
+
+void envelope_reset_stats(void) {
+    k_spinlock_key_t key = k_spin_lock(&envelope_lock);
+    memset(&ramp_stats, 0, sizeof(ramp_stats));
+    k_spin_unlock(&envelope_lock, key);
+}
@@ -0,0 +1,57 @@
+#include "hardware/envelope.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+/* The ramp tables and their timing, apart from the DAC and DMA driving
+ * them so they build anywhere, native_sim included */
+
+/* 2047.5 * (1 - cos(pi * i / 64)), i = 0..64 */
+const uint16_t envelope_rise[ENVELOPE_STEPS + 1] = {
+    0, 2, 10, 22, 39, 61, 88, 120, 156,
+    197, 242, 291, 345, 403, 465, 530, 600, 672,
+    749, 828, 910, 995, 1082, 1172, 1264, 1358, 1453,
+    1550, 1648, 1747, 1847, 1947, 2047, 2148, 2248, 2348,
+    2447, 2545, 2642, 2737, 2831, 2923, 3013, 3100, 3185,
+    3267, 3346, 3423, 3495, 3565, 3630, 3692, 3750, 3804,
+    3853, 3898, 3939, 3975, 4007, 4034, 4056, 4073, 4085,
+    4093, 4095,
+};
+
+/* DMA only walks memory upwards, so the fall is stored reversed */
+const uint16_t envelope_fall[ENVELOPE_STEPS + 1] = {
+    4095, 4093, 4085, 4073, 4056, 4034, 4007, 3975, 3939,
+    3898, 3853, 3804, 3750, 3692, 3630, 3565, 3495, 3423,
+    3346, 3267, 3185, 3100, 3013, 2923, 2831, 2737, 2642,
+    2545, 2447, 2348, 2248, 2148, 2047, 1947, 1847, 1747,
+    1648, 1550, 1453, 1358, 1264, 1172, 1082, 995, 910,
+    828, 749, 672, 600, 530, 465, 403, 345, 291,
+    242, 197, 156, 120, 88, 61, 39, 22, 10,
+    2, 0,
+};
+
+/* TIM6 counts the core clock and its period register is 16 bits */
+#define ENVELOPE_MAX_STEP_CYCLES    65536
+
+uint32_t envelope_max_ramp_us(void) {
+    return (uint32_t)((uint64_t)ENVELOPE_MAX_STEP_CYCLES * ENVELOPE_STEPS * USEC_PER_SEC /
+                      sys_clock_hw_cycles_per_sec());
+}
+
+uint32_t envelope_step_cycles(uint32_t ramp_us) {
+    uint32_t period = (uint32_t)((uint64_t)ramp_us * sys_clock_hw_cycles_per_sec() /
+                                 USEC_PER_SEC / ENVELOPE_STEPS);
+    return MIN(period, ENVELOPE_MAX_STEP_CYCLES);
+}
+
+void envelope_plan_shape(int64_t start_ticks, int64_t end_ticks, struct envelope_plan *plan) {
+    /* Half the span in whole ticks, so the fall, started on a tick, does
+     * not cut into the rise when the span is an odd number of ticks */
+    uint32_t half_us = (uint32_t)k_ticks_to_us_floor64((end_ticks - start_ticks) / 2);
+
+    plan->ramp_us = MIN(half_us, envelope_max_ramp_us());
+
+    /* Rounded so the null lands on the boundary or just before it: the
+     * ramp is a whole number of steps, never longer than ramp_us */
+    plan->fall_ticks = end_ticks - k_us_to_ticks_ceil64(plan->ramp_us);
+}
@@ -0,0 +1,63 @@
+#include "hardware/pa_monitor.h"
+#include "hardware/tr_switch.h"
+#include "radio/tx_engine.h"
+#include "protocol/packet_parser.h"
+#include "config.h"
+#include "drivers/regulator/regulator_tps55289.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/regulator.h>
+#include <zephyr/sys/printk.h>
+
+/* Polls run in their own thread so the STATUS read never lands on the
+ * workqueue that drives symbol changes. */
+#define PA_MONITOR_STACK_SIZE 768
+#define PA_MONITOR_PRIO       2
+
+#define PA_FAULT_EVENT        0xFB
+
+static K_SEM_DEFINE(pa_kick, 0, 1);
+static struct k_work pa_fault_work;
+static volatile uint8_t last_fault;
+
+static void pa_fault_handler(struct k_work *work) {
+    uint8_t status = last_fault;
+
+    /* Runs on the system workqueue, same context as the TX engine */
+    tx_engine_stop();
+    send_packet(PA_FAULT_EVENT, &status, sizeof(status), 0);
+    debug_printf("[PA] fault, STATUS=0x%02x, TX stopped", status);
+}
+
+static void pa_monitor_thread(void *p1, void *p2, void *p3) {
+    k_work_init(&pa_fault_work, pa_fault_handler);
+
+    while (1) {
+        k_sem_take(&pa_kick, K_FOREVER);
+
+        while (regulator_is_enabled(regulator)) {
+            uint8_t status;
+
+            if (tps55289_get_status(regulator, &status) == 0 &&
+                (status & TPS55289_STATUS_FAULT_MASK)) {
+                /* Cut the supply and the antenna path here, the rest of
+                 * the teardown follows on the workqueue. */
+                regulator_disable(regulator);
+                tr_set_rx();
+                last_fault = status & TPS55289_STATUS_FAULT_MASK;
+                k_work_submit(&pa_fault_work);
+                break;
+            }
+
+            k_sleep(K_MSEC(CONFIG_PA_FAULT_POLL_MS));
+        }
+    }
+}
+
+K_THREAD_DEFINE(pa_monitor_tid, PA_MONITOR_STACK_SIZE, pa_monitor_thread,
+                NULL, NULL, NULL, PA_MONITOR_PRIO, 0, 0);
+
+void pa_monitor_kick(void) {
+    last_fault = 0;
+    k_sem_give(&pa_kick);
+}
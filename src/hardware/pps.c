@@ -0,0 +1,165 @@
+#include "hardware/pps.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/irq.h>
+#include <stm32l4xx.h>
+
+/* PPS (pps0, PA0) feeds TIM2_CH1. TIM2 is the only 32-bit timer on the
+ * L431, so one capture register covers the whole second without overflow
+ * handling. */
+#define PPS_TIMER       TIM2
+#define PPS_IRQ_PRIO    1
+#define PPS_IC_FILTER   3   /* fCK_INT, N=8 */
+
+static sys_slist_t listeners;
+static pps_compare_handler_t compare_handler;
+static struct pps_event last_evt;
+static bool have_edge;
+static uint32_t last_edge_ms;
+
+static void pps_compare_isr(void) {
+    uint32_t now = PPS_TIMER->CNT;
+    uint32_t target = PPS_TIMER->CCR2;
+    PPS_TIMER->SR = ~TIM_SR_CC2IF;
+
+    /* One-shot: the handler may re-arm */
+    PPS_TIMER->DIER &= ~TIM_DIER_CC2IE;
+    pps_compare_handler_t handler = compare_handler;
+    compare_handler = NULL;
+    if (handler) {
+        handler(now - target);
+    }
+}
+
+static void pps_isr(const void *arg) {
+    uint32_t sr = PPS_TIMER->SR;
+
+    if ((sr & TIM_SR_CC2IF) && (PPS_TIMER->DIER & TIM_DIER_CC2IE)) {
+        pps_compare_isr();
+    }
+
+    if (!(sr & TIM_SR_CC1IF)) {
+        PPS_TIMER->SR = ~(sr & ~TIM_SR_CC2IF);
+        return;
+    }
+
+    /* Read counter and cycle counter back to back, then walk the cycle
+     * stamp back by the time elapsed since the hardware capture. */
+    uint32_t cycles_now = k_cycle_get_32();
+    uint32_t ticks_now = PPS_TIMER->CNT;
+    uint32_t ticks = PPS_TIMER->CCR1;
+    PPS_TIMER->SR = ~(TIM_SR_CC1IF | TIM_SR_CC1OF);
+
+    uint64_t since_edge = (uint64_t)(ticks_now - ticks) *
+                          sys_clock_hw_cycles_per_sec() / pps_timer_hz();
+    uint32_t cycles = cycles_now - (uint32_t)since_edge;
+
+    struct pps_event evt = {
+        .seq = last_evt.seq + 1,
+        .ticks = ticks,
+        .cycles = cycles,
+        .tick_interval = have_edge ? ticks - last_evt.ticks : 0,
+        .cycle_interval = have_edge ? cycles - last_evt.cycles : 0,
+    };
+
+    last_evt = evt;
+    last_edge_ms = k_uptime_get_32();
+    have_edge = true;
+
+    struct pps_listener *l;
+    SYS_SLIST_FOR_EACH_CONTAINER(&listeners, l, node) {
+        l->handler(&evt);
+    }
+}
+
+uint32_t pps_timer_hz(void) {
+#ifdef CONFIG_PPS_TIMER_CLK2
+    return CONFIG_PPS_TIMER_CLK2_HZ;
+#else
+    /* APB1 prescaler is 1, so TIM2 runs at the core clock */
+    return sys_clock_hw_cycles_per_sec();
+#endif
+}
+
+uint32_t pps_timer_now(void) {
+    return PPS_TIMER->CNT;
+}
+
+void pps_compare_arm(uint32_t ticks, pps_compare_handler_t handler) {
+    unsigned int key = irq_lock();
+
+    compare_handler = handler;
+    PPS_TIMER->CCR2 = ticks;
+    PPS_TIMER->SR = ~TIM_SR_CC2IF;
+    PPS_TIMER->DIER |= TIM_DIER_CC2IE;
+
+    /* A match only happens on equality; if the counter already went past
+     * the target, pend the interrupt by hand instead of waiting a wrap. */
+    if ((int32_t)(ticks - PPS_TIMER->CNT) <= 0 && !(PPS_TIMER->SR & TIM_SR_CC2IF)) {
+        PPS_TIMER->EGR = TIM_EGR_CC2G;
+    }
+
+    irq_unlock(key);
+}
+
+void pps_compare_cancel(void) {
+    unsigned int key = irq_lock();
+    PPS_TIMER->DIER &= ~TIM_DIER_CC2IE;
+    PPS_TIMER->SR = ~TIM_SR_CC2IF;
+    compare_handler = NULL;
+    irq_unlock(key);
+}
+
+uint32_t pps_last_cycles(void) {
+    return last_evt.cycles;
+}
+
+bool pps_present(void) {
+    return have_edge && (k_uptime_get_32() - last_edge_ms) < 1500;
+}
+
+void pps_add_listener(struct pps_listener *listener) {
+    unsigned int key = irq_lock();
+    sys_slist_append(&listeners, &listener->node);
+    irq_unlock(key);
+}
+
+int pps_init(void) {
+    sys_slist_init(&listeners);
+    have_edge = false;
+
+    RCC->AHB2ENR |= RCC_AHB2ENR_GPIOAEN;
+    RCC->APB1ENR1 |= RCC_APB1ENR1_TIM2EN;
+
+    /* PA0 -> AF1 (TIM2_CH1) */
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~GPIO_AFRL_AFSEL0_Msk) | (1u << GPIO_AFRL_AFSEL0_Pos);
+    GPIOA->MODER = (GPIOA->MODER & ~GPIO_MODER_MODE0_Msk) | (2u << GPIO_MODER_MODE0_Pos);
+
+    PPS_TIMER->CR1 = 0;
+    PPS_TIMER->PSC = 0;
+    PPS_TIMER->ARR = 0xFFFFFFFF;
+
+#ifdef CONFIG_PPS_TIMER_CLK2
+    /* PA15 -> AF1 (TIM2_ETR), external clock mode 2 */
+    GPIOA->AFR[1] = (GPIOA->AFR[1] & ~GPIO_AFRH_AFSEL15_Msk) | (1u << GPIO_AFRH_AFSEL15_Pos);
+    GPIOA->MODER = (GPIOA->MODER & ~GPIO_MODER_MODE15_Msk) | (2u << GPIO_MODER_MODE15_Pos);
+    PPS_TIMER->SMCR = TIM_SMCR_ECE;
+#else
+    PPS_TIMER->SMCR = 0;
+#endif
+
+    /* CH1 input capture on TI1, rising edge, filtered. CH2 is left as a
+     * frozen output compare for pps_compare_arm(). */
+    PPS_TIMER->CCMR1 = TIM_CCMR1_CC1S_0 | (PPS_IC_FILTER << TIM_CCMR1_IC1F_Pos);
+    PPS_TIMER->CCER = TIM_CCER_CC1E;
+    PPS_TIMER->DIER = TIM_DIER_CC1IE;
+    PPS_TIMER->EGR = TIM_EGR_UG;
+    PPS_TIMER->SR = 0;
+
+    IRQ_CONNECT(TIM2_IRQn, PPS_IRQ_PRIO, pps_isr, NULL, 0);
+    irq_enable(TIM2_IRQn);
+
+    PPS_TIMER->CR1 = TIM_CR1_CEN;
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "hardware/swr_guard.h"
+#include "hardware/adc_sampler.h"
+#include "hardware/tr_switch.h"
+#include "radio/tx_engine.h"
+#include "protocol/packet_parser.h"
+#include "protocol/payload_utils.h"
+#include "config.h"
+
+#include <zephyr/kernel.h>
+
+/* The ISR can only do what needs no bus: it drops the T/R relay to receive
+ * and wakes a cooperative thread for the I2C part. */
+#define SWR_STACK_SIZE  768
+#define SWR_PRIO        K_PRIO_COOP(1)
+
+#define SWR_TRIP_EVENT  0xF9
+
+static K_SEM_DEFINE(swr_sem, 0, 1);
+static struct k_work swr_work;
+
+static volatile bool armed;
+static volatile bool tripped;
+static uint16_t threshold_mv;
+
+static volatile uint32_t trip_cycles;
+static volatile uint32_t rx_cycles;
+static volatile uint32_t off_cycles;
+
+static void swr_trip_isr(void) {
+    trip_cycles = k_cycle_get_32();
+    tr_set_rx();
+    rx_cycles = k_cycle_get_32();
+    off_cycles = trip_cycles;
+
+    armed = false;
+    tripped = true;
+    k_sem_give(&swr_sem);
+}
+
+static void swr_put_status(payload_writer_t *w) {
+    struct swr_guard_status st;
+    swr_guard_get_status(&st);
+
+    writer_put_u8(w, (st.armed ? 0x01 : 0) | (st.tripped ? 0x02 : 0));
+    writer_put_u16(w, st.threshold_mv);
+    writer_put_u32(w, st.rx_latency_ns);
+    writer_put_u32(w, st.off_latency_us);
+}
+
+static void swr_work_handler(struct k_work *work) {
+    uint8_t buffer[11];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    /* Workqueue context, same as the TX engine */
+    tx_engine_stop();
+
+    swr_put_status(&writer);
+    send_packet(SWR_TRIP_EVENT, buffer, writer.ptr - buffer, 0);
+    debug_printf("[SWR] trip at %u mV, RX in %u ns, RF off in %u us",
+                 threshold_mv, (unsigned)k_cyc_to_ns_floor64(rx_cycles - trip_cycles),
+                 k_cyc_to_us_floor32(off_cycles - trip_cycles));
+}
+
+static void swr_thread(void *p1, void *p2, void *p3) {
+    k_work_init(&swr_work, swr_work_handler);
+
+    while (1) {
+        k_sem_take(&swr_sem, K_FOREVER);
+
+        tx_engine_rf_off();
+        off_cycles = k_cycle_get_32();
+        k_work_submit(&swr_work);
+    }
+}
+
+K_THREAD_DEFINE(swr_tid, SWR_STACK_SIZE, swr_thread, NULL, NULL, NULL, SWR_PRIO, 0, 0);
+
+int swr_guard_set_threshold(uint16_t mv) {
+    if (mv > ADC_SAMPLER_VREF_MV) {
+        return -EINVAL;
+    }
+
+    tripped = false;
+
+    if (mv == 0) {
+        armed = false;
+        threshold_mv = 0;
+        adc_sampler_disarm_watchdog();
+        return 0;
+    }
+
+    int ret = adc_sampler_arm_watchdog(adc_sampler_from_mv(mv), swr_trip_isr);
+    if (ret) {
+        return ret;
+    }
+    threshold_mv = mv;
+    armed = true;
+
+    return 0;
+}
+
+bool swr_guard_tripped(void) {
+    return tripped;
+}
+
+void swr_guard_get_status(struct swr_guard_status *out) {
+    out->armed = armed;
+    out->tripped = tripped;
+    out->threshold_mv = threshold_mv;
+    out->rx_latency_ns = tripped ? (uint32_t)k_cyc_to_ns_floor64(rx_cycles - trip_cycles) : 0;
+    out->off_latency_us = tripped ? k_cyc_to_us_floor32(off_cycles - trip_cycles) : 0;
+}
@@ -15,6 +15,14 @@
 #include <zephyr/drivers/display.h>
 #include <zephyr/display/cfb.h>
 #include "hardware/oled.h"
+#include "hardware/pps.h"
+#include "radio/freq_cal.h"
+#include "radio/alc.h"
+#include "radio/telemetry.h"
+#include "radio/timebase.h"
+#include "hardware/adc_sampler.h"
+#include "hardware/envelope.h"
+#include <zephyr/settings/settings.h>
 
 const struct device *regulator = DEVICE_DT_GET(DT_NODELABEL(tps55289));
 const struct device *si5351a = DEVICE_DT_GET(DT_NODELABEL(si5351a));
@@ -45,8 +53,10 @@ static int regulator_init() {
             return -1;
         }
     }
-    debug_printf("[REG] Regulator ready, setting voltage to 1.2V");
-    int ret = regulator_set_voltage(regulator, 1200000, 1200000);
+    /* Lowest V_PA the devicetree allows; requests outside
+     * regulator-min/max-microvolt are rejected by the regulator API */
+    debug_printf("[REG] Regulator ready, setting voltage to 5V");
+    int ret = regulator_set_voltage(regulator, 5000000, 5000000);
     debug_printf("[REG] set_voltage returned %d", ret);
     ret = regulator_disable(regulator);
     debug_printf("[REG] disable returned %d", ret);
@@ -76,7 +86,7 @@ static int init_si5351a() {
         return ret;
     }
     k_msleep(500);
-    ret = si5351a_set_ms_freq(si5351a, 0, 500000, 0, 'A');
+    ret = si5351a_set_ms_freq(si5351a, 0, 500000ULL * 1000000, 'A');
     if (ret) {
         debug_printf("[SI5351A] Failed to set multisynth registers");
         return ret;
@@ -132,6 +142,17 @@ int main(void) {
         return -1;
     }
 
+    if (settings_subsys_init() == 0) {
+        settings_load();
+    } else {
+        debug_printf("[MAIN] Settings init failed, continuing without it");
+    }
+
+    pps_init();
+    if (freq_cal_init() < 0) {
+        debug_printf("[MAIN] Frequency calibration init failed, continuing without it");
+    }
+
     if (regulator_init() < 0) {
         debug_printf("[MAIN] Regulator init failed, continuing without it");
     }
@@ -141,6 +162,8 @@ int main(void) {
         return -1;
     }
 
+    timebase_init();
+
     if (tr_switch_init() < 0) {
         debug_printf("[MAIN] TR switch init failed, aborting");
         return -1;
@@ -150,6 +173,17 @@ int main(void) {
         debug_printf("[MAIN] OLED init failed, continuing without it");
     }
 
+    if (adc_sampler_init() < 0) {
+        debug_printf("[MAIN] ADC sampler init failed, continuing without it");
+    } else {
+        alc_init();
+        telemetry_init();
+    }
+
+    if (envelope_init() < 0) {
+        debug_printf("[MAIN] Envelope DAC init failed, continuing without it");
+    }
+
     debug_printf("[MAIN] Initializing TX engine");
     tx_engine_init();
 
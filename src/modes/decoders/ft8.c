@@ -0,0 +1,500 @@
+#include "modes/decoders/ft8.h"
+#include "modes/ftx.h"
+#include "modes/fec.h"
+#include "modes/ftx_callhash.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <arm_math.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FT8_SYMBOL_COUNT    79
+
+/* Front end: mix to complex baseband, then decimate 12000 -> 2400 -> 800.
+ * Both filters pass 350 Hz and are 57 dB down wherever they would alias
+ * into the window. */
+#define RX_BLOCK            120                 // input samples per pass
+#define RX_MID_BLOCK        (RX_BLOCK / 5)
+#define RX_OUT_BLOCK        (RX_MID_BLOCK / 3)
+#define RX_S1_TAPS          31
+#define RX_S2_TAPS          87
+#define RX_DELAY_MS         19                  // group delay of the pair
+
+/* One FFT per half symbol over a whole symbol of 800 Hz samples, zero
+ * padded to twice that so columns fall every half tone (3.125 Hz) and
+ * no signal sits further than a quarter tone from one */
+#define RX_WINDOW           128
+#define RX_FFT_LEN          (2 * RX_WINDOW)
+#define RX_HOP              (RX_WINDOW / 2)
+#define RX_ROWS             ((FT8_RX_SLOT_SAMPLES / 15 - RX_WINDOW) / RX_HOP + 1)
+#define RX_COLS             (2 * CONFIG_FT8_DECODE_BINS)
+#define RX_ROW_MS           80
+#define RX_COL_MHZ          3125
+
+/* Waterfall cells are 0.5 dB steps of FFT bin power above this floor,
+ * 20 log10 scale: a full-scale tone reaches about 145 and input noise
+ * of a few LSB about -75 */
+#define RX_FLOOR_HALF_DB    (-90)
+
+#define RX_CANDIDATES       24
+#define RX_MIN_SCORE        10
+#define RX_MIN_ROW          (-10)               // up to five symbols early
+#define RX_LDPC_ITERATIONS  25
+#define RX_LLR_SCALE        8
+
+#define FT8_NOISE_BW_HALF_DB    52              // 2500 Hz over a 6.25 Hz bin
+
+/* Kaiser windowed sinc, beta 5.65 */
+static const q15_t s1_coeffs[RX_S1_TAPS] = {
+        5,    30,    69,    97,    64,   -75,  -321,  -594,  -728,  -516,
+      204,  1451,  3052,  4656,  5847,  6287,  5847,  4656,  3052,  1451,
+      204,  -516,  -728,  -594,  -321,   -75,    64,    97,    69,    30,
+        5,
+};
+
+static const q15_t s2_coeffs[RX_S2_TAPS] = {
+        4,     0,    -8,   -11,     0,    18,    22,     0,   -32,   -39,
+        0,    54,    63,     0,   -84,   -96,     0,   124,   141,     0,
+     -179,  -201,     0,   252,   282,     0,  -351,  -391,     0,   489,
+      547,     0,  -693,  -785,     0,  1033,  1205,     0, -1745, -2209,
+        0,  4492,  9021, 10924,  9021,  4492,     0, -2209, -1745,     0,
+     1205,  1033,     0,  -785,  -693,     0,   547,   489,     0,  -391,
+     -351,     0,   282,   252,     0,  -201,  -179,     0,   141,   124,
+        0,   -96,   -84,     0,    63,    54,     0,   -39,   -32,     0,
+       22,    18,     0,   -11,    -8,     0,     4,
+};
+
+/* First half of a periodic Hann window; the second mirrors it */
+static const q15_t hann[RX_WINDOW / 2 + 1] = {
+        0,    20,    79,   177,   315,   491,   705,   958,  1247,  1573,
+     1935,  2331,  2761,  3224,  3719,  4244,  4799,  5381,  5990,  6624,
+     7281,  7961,  8660,  9379, 10114, 10864, 11628, 12403, 13187, 13980,
+    14778, 15580, 16383, 17187, 17989, 18787, 19580, 20364, 21139, 21903,
+    22653, 23388, 24107, 24806, 25486, 26143, 26777, 27386, 27968, 28523,
+    29048, 29543, 30006, 30436, 30832, 31194, 31520, 31809, 32062, 32276,
+    32452, 32590, 32688, 32747, 32767,
+};
+
+/* log2(1 + i/16) in Q15 */
+static const uint16_t log2_frac[17] = {
+        0,  2866,  5568,  8124, 10549, 12855, 15055, 17156, 19168, 21098,
+    22952, 24736, 26455, 28114, 29717, 31267, 32768,
+};
+
+static const uint8_t costas[7] = { 3, 1, 4, 0, 6, 5, 2 };
+/* Three code bits for each tone, undoing the encoder's Gray map */
+static const uint8_t tone_bits[8] = { 0, 1, 3, 2, 6, 4, 5, 7 };
+
+struct candidate {
+    int16_t score;
+    int16_t row;
+    uint8_t col;            // of tone 0
+};
+
+static arm_fir_decimate_instance_q15 s1_i, s1_q, s2_i, s2_q;
+static q15_t s1_state_i[RX_S1_TAPS + RX_BLOCK - 1];
+static q15_t s1_state_q[RX_S1_TAPS + RX_BLOCK - 1];
+static q15_t s2_state_i[RX_S2_TAPS + RX_MID_BLOCK - 1];
+static q15_t s2_state_q[RX_S2_TAPS + RX_MID_BLOCK - 1];
+static q15_t in_i[RX_BLOCK], in_q[RX_BLOCK];
+static q15_t mid_i[RX_MID_BLOCK], mid_q[RX_MID_BLOCK];
+static q15_t out_i[RX_OUT_BLOCK], out_q[RX_OUT_BLOCK];
+
+static q15_t overlap[2 * RX_WINDOW];        // interleaved I/Q
+static q15_t fft_buf[2 * RX_FFT_LEN];
+
+static uint8_t waterfall[RX_ROWS][RX_COLS];
+
+static struct candidate candidates[RX_CANDIDATES];
+static int16_t llr[FTX_LDPC_N];
+static uint8_t decoded[RX_CANDIDATES][10];  // payloads so far this slot
+
+static uint32_t nco_phase;
+static uint32_t nco_step;
+static uint32_t center_hz;
+static int in_fill;
+static int overlap_fill;
+static int rows;
+static uint64_t feed_cycles;
+
+static struct ft8_rx_stats stats;
+
+/* 20 log10(power), in 0.5 dB steps above the floor. shift is the block
+ * gain applied to the samples before the FFT, taken back out here. */
+static uint8_t power_half_db(uint32_t power, int shift) {
+    if (power == 0) {
+        return 0;
+    }
+
+    int e = 31;
+    while (!(power & 0x80000000u)) {
+        power <<= 1;
+        e--;
+    }
+
+    uint32_t idx = (power >> 27) & 0x0F;
+    uint32_t frac = (power >> 11) & 0xFFFF;
+    int32_t log2_q15 = ((e - 2 * shift) << 15) + log2_frac[idx] +
+                       (int32_t)(((log2_frac[idx + 1] - log2_frac[idx]) * frac) >> 16);
+
+    /* 6.0206 half-dB per octave of power */
+    int32_t half_db = (int32_t)(((int64_t)log2_q15 * 197283) >> 30) - RX_FLOOR_HALF_DB;
+    if (half_db < 0) return 0;
+    if (half_db > UINT8_MAX) return UINT8_MAX;
+    return (uint8_t)half_db;
+}
+
+/* Window the last symbol of baseband, normalise it into the top of the
+ * Q15 range and keep the bins of the window as one waterfall row */
+static void waterfall_row(void) {
+    q15_t peak = 0;
+
+    for (int n = 0; n < RX_WINDOW; n++) {
+        q15_t w = hann[n <= RX_WINDOW / 2 ? n : RX_WINDOW - n];
+        for (int c = 0; c < 2; c++) {
+            q15_t v = (q15_t)(((int32_t)overlap[2 * n + c] * w) >> 15);
+            fft_buf[2 * n + c] = v;
+            q15_t mag = v < 0 ? -v : v;
+            if (mag > peak) peak = mag;
+        }
+    }
+
+    int shift = 0;
+    while (peak && peak < 0x4000) {
+        peak <<= 1;
+        shift++;
+    }
+    if (shift) {
+        arm_shift_q15(fft_buf, shift, fft_buf, 2 * RX_WINDOW);
+    }
+    memset(&fft_buf[2 * RX_WINDOW], 0, sizeof(fft_buf) / 2);
+
+    arm_cfft_q15(&arm_cfft_sR_q15_len256, fft_buf, 0, 1);
+
+    uint8_t *row = waterfall[rows];
+    for (int c = 0; c < RX_COLS; c++) {
+        int k = (c - RX_COLS / 2) & (RX_FFT_LEN - 1);
+        int32_t re = fft_buf[2 * k];
+        int32_t im = fft_buf[2 * k + 1];
+        row[c] = power_half_db((uint32_t)(re * re) + (uint32_t)(im * im), shift);
+    }
+    rows++;
+}
+
+static void process_block(void) {
+    arm_fir_decimate_q15(&s1_i, in_i, mid_i, RX_BLOCK);
+    arm_fir_decimate_q15(&s1_q, in_q, mid_q, RX_BLOCK);
+    arm_fir_decimate_q15(&s2_i, mid_i, out_i, RX_MID_BLOCK);
+    arm_fir_decimate_q15(&s2_q, mid_q, out_q, RX_MID_BLOCK);
+
+    for (int n = 0; n < RX_OUT_BLOCK && rows < RX_ROWS; n++) {
+        overlap[2 * overlap_fill] = out_i[n];
+        overlap[2 * overlap_fill + 1] = out_q[n];
+        if (++overlap_fill < RX_WINDOW) {
+            continue;
+        }
+
+        waterfall_row();
+        memmove(overlap, overlap + 2 * RX_HOP, sizeof(overlap) / 2);
+        overlap_fill = RX_WINDOW - RX_HOP;
+    }
+}
+
+int ft8_rx_start(uint32_t center) {
+    /* The window must sit inside the 6 kHz audio band */
+    uint32_t half_width = RX_COLS * RX_COL_MHZ / 2000;
+    if (center < half_width || center + half_width > FT8_RX_SAMPLE_HZ / 2) {
+        return -EINVAL;
+    }
+
+    if (arm_fir_decimate_init_q15(&s1_i, RX_S1_TAPS, 5, s1_coeffs, s1_state_i, RX_BLOCK) != ARM_MATH_SUCCESS ||
+        arm_fir_decimate_init_q15(&s1_q, RX_S1_TAPS, 5, s1_coeffs, s1_state_q, RX_BLOCK) != ARM_MATH_SUCCESS ||
+        arm_fir_decimate_init_q15(&s2_i, RX_S2_TAPS, 3, s2_coeffs, s2_state_i, RX_MID_BLOCK) != ARM_MATH_SUCCESS ||
+        arm_fir_decimate_init_q15(&s2_q, RX_S2_TAPS, 3, s2_coeffs, s2_state_q, RX_MID_BLOCK) != ARM_MATH_SUCCESS) {
+        return -EINVAL;
+    }
+
+    center_hz = center;
+    nco_phase = 0;
+    nco_step = (uint32_t)(((uint64_t)center << 32) / FT8_RX_SAMPLE_HZ);
+    in_fill = 0;
+    overlap_fill = 0;
+    rows = 0;
+    feed_cycles = 0;
+    return 0;
+}
+
+int ft8_rx_feed(const int16_t *samples, size_t count) {
+    uint32_t start = k_cycle_get_32();
+    size_t n = 0;
+
+    for (; n < count && rows < RX_ROWS; n++) {
+        /* x e^-jwt; the sine and cosine take a Q15 fraction of a turn */
+        q15_t phase = (q15_t)(nco_phase >> 17);
+        in_i[in_fill] = (q15_t)(((int32_t)samples[n] * arm_cos_q15(phase)) >> 15);
+        in_q[in_fill] = (q15_t)(-((int32_t)samples[n] * arm_sin_q15(phase)) >> 15);
+        nco_phase += nco_step;
+
+        if (++in_fill == RX_BLOCK) {
+            process_block();
+            in_fill = 0;
+        }
+    }
+
+    feed_cycles += k_cycle_get_32() - start;
+    return (int)n;
+}
+
+/* Mean margin of each Costas tone over the tones beside it and over the
+ * same column a symbol either side. Tones are two columns apart. */
+static int sync_score(int row0, int col0) {
+    int32_t sum = 0;
+    int count = 0;
+
+    for (int block = 0; block < 3; block++) {
+        for (int k = 0; k < 7; k++) {
+            int row = row0 + 2 * (36 * block + k);
+            if (row < 0) continue;
+            if (row >= rows) break;
+
+            int col = col0 + 2 * costas[k];
+            const uint8_t *p = &waterfall[row][col];
+            int s = *p;
+
+            if (costas[k] > 0) {
+                sum += s - p[-2];
+                count++;
+            }
+            if (costas[k] < 7) {
+                sum += s - p[2];
+                count++;
+            }
+            if (k > 0 && row >= 2) {
+                sum += s - waterfall[row - 2][col];
+                count++;
+            }
+            if (k < 6 && row + 2 < rows) {
+                sum += s - waterfall[row + 2][col];
+                count++;
+            }
+        }
+    }
+    return count ? sum / count : 0;
+}
+
+/* Keep the best scores, sorted descending. A signal also scores on the
+ * rows and columns beside it, so only its peak is kept. */
+static int find_candidates(void) {
+    int found = 0;
+    int last_row = rows - 2 * (FT8_SYMBOL_COUNT - 1);
+
+    for (int row = RX_MIN_ROW; row < last_row; row++) {
+        for (int col = 0; col + 15 <= RX_COLS; col++) {
+            int score = sync_score(row, col);
+            if (score < RX_MIN_SCORE) continue;
+            if (found == RX_CANDIDATES && score <= candidates[found - 1].score) continue;
+
+            int i = 0;
+            while (i < found && (abs(candidates[i].row - row) > 2 ||
+                                 abs(candidates[i].col - col) > 1)) {
+                i++;
+            }
+            if (i < found) {
+                if (candidates[i].score >= score) continue;
+                found--;
+                memmove(&candidates[i], &candidates[i + 1], (found - i) * sizeof(candidates[0]));
+            }
+
+            i = found < RX_CANDIDATES ? found++ : found - 1;
+            while (i > 0 && candidates[i - 1].score < score) {
+                candidates[i] = candidates[i - 1];
+                i--;
+            }
+            candidates[i] = (struct candidate){ .score = score, .row = row, .col = col };
+        }
+    }
+    return found;
+}
+
+/* Max-log soft bits from the eight tone powers of each data symbol;
+ * symbols outside the slot are erasures */
+static void soft_bits(const struct candidate *cand) {
+    int bit = 0;
+
+    for (int sym = 0; sym < FT8_SYMBOL_COUNT; sym++) {
+        if (sym % 36 < 7) continue;
+
+        int row = cand->row + 2 * sym;
+        if (row < 0 || row >= rows) {
+            for (int b = 0; b < 3; b++) llr[bit++] = 0;
+            continue;
+        }
+
+        const uint8_t *p = &waterfall[row][cand->col];
+        for (int b = 0; b < 3; b++) {
+            int max1 = 0;
+            int max0 = 0;
+            for (int tone = 0; tone < 8; tone++) {
+                int v = p[2 * tone];
+                if ((tone_bits[tone] >> (2 - b)) & 1) {
+                    if (v > max1) max1 = v;
+                } else {
+                    if (v > max0) max0 = v;
+                }
+            }
+            llr[bit++] = (int16_t)((max1 - max0) * RX_LLR_SCALE);
+        }
+    }
+}
+
+static bool codeword_valid(const uint8_t *codeword) {
+    bool zero = true;
+    for (int i = 0; i < FTX_CODEWORD_BYTES; i++) {
+        if (codeword[i]) zero = false;
+    }
+    /* All zeros satisfies every check and the CRC, and is what erasures
+     * decode to */
+    if (zero) {
+        return false;
+    }
+
+    uint16_t crc = 0;
+    for (int i = 0; i < FTX_CRC_BITS; i++) {
+        crc = (crc << 1) | fec_get_bit(codeword, FTX_PAYLOAD_BITS + i);
+    }
+    return crc == ftx_crc14(codeword);
+}
+
+/* Signal on the sent tone against the other seven, averaged over the
+ * data symbols */
+static int8_t estimate_snr(const struct candidate *cand, const uint8_t *codeword) {
+    int32_t signal = 0;
+    int32_t noise = 0;
+    int symbols = 0;
+    int bit = 0;
+
+    for (int sym = 0; sym < FT8_SYMBOL_COUNT; sym++) {
+        if (sym % 36 < 7) continue;
+
+        int bits = 0;
+        for (int b = 0; b < 3; b++) {
+            bits = (bits << 1) | fec_get_bit(codeword, bit++);
+        }
+
+        int row = cand->row + 2 * sym;
+        if (row < 0 || row >= rows) continue;
+
+        const uint8_t *p = &waterfall[row][cand->col];
+        for (int tone = 0; tone < 8; tone++) {
+            if (tone_bits[tone] == bits) {
+                signal += 7 * p[2 * tone];
+            } else {
+                noise += p[2 * tone];
+            }
+        }
+        symbols++;
+    }
+
+    if (!symbols) {
+        return 0;
+    }
+    int snr = ((signal - noise) / (7 * symbols) - FT8_NOISE_BW_HALF_DB) / 2;
+    return (int8_t)CLAMP(snr, -30, 60);
+}
+
+int ft8_rx_decode(struct ft8_decode *out, int max_decodes) {
+    uint32_t start = k_cycle_get_32();
+    uint8_t codeword[FTX_CODEWORD_BYTES];
+    int decodes = 0;
+
+    stats.slots++;
+    stats.ldpc_failures = 0;
+    stats.crc_failures = 0;
+    stats.candidates = find_candidates();
+
+    for (uint32_t c = 0; c < stats.candidates && decodes < max_decodes; c++) {
+        const struct candidate *cand = &candidates[c];
+
+        soft_bits(cand);
+        if (ftx_ldpc_decode(llr, RX_LDPC_ITERATIONS, codeword) != 0) {
+            stats.ldpc_failures++;
+            continue;
+        }
+        if (!codeword_valid(codeword)) {
+            stats.crc_failures++;
+            continue;
+        }
+
+        /* Neighbouring candidates often hold the same signal */
+        codeword[9] &= 0xF8;
+        bool repeat = false;
+        for (int d = 0; d < decodes; d++) {
+            if (memcmp(decoded[d], codeword, 10) == 0) repeat = true;
+        }
+        if (repeat || decode_ftx_payload(codeword, &out[decodes].payload) != 0) {
+            continue;
+        }
+
+        memcpy(decoded[decodes], codeword, 10);
+        ftx_callhash_learn(&out[decodes].payload);
+        out[decodes].freq_hz = (uint16_t)(center_hz +
+            (cand->col - RX_COLS / 2) * RX_COL_MHZ / 1000);
+        out[decodes].dt_ms = (int16_t)(cand->row * RX_ROW_MS - 500 - RX_DELAY_MS);
+        out[decodes].snr_db = estimate_snr(cand, codeword);
+        out[decodes].sync_score = cand->score;
+        decodes++;
+    }
+
+    uint32_t decode_us = (uint32_t)k_cyc_to_us_floor64(k_cycle_get_32() - start);
+    stats.decodes = decodes;
+    stats.total_decodes += decodes;
+    stats.feed_cpu_us = (uint32_t)k_cyc_to_us_floor64(feed_cycles);
+    stats.decode_cpu_us = decode_us;
+    if (decode_us > stats.max_decode_cpu_us) {
+        stats.max_decode_cpu_us = decode_us;
+    }
+    return decodes;
+}
+
+void ft8_rx_get_stats(struct ft8_rx_stats *out) {
+    *out = stats;
+}
+
+void ft8_rx_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+int ft8_wav_samples(const uint8_t *wav, size_t len, const int16_t **samples, size_t *count) {
+    if (len < 12 || memcmp(wav, "RIFF", 4) != 0 || memcmp(wav + 8, "WAVE", 4) != 0) {
+        return -EINVAL;
+    }
+
+    bool format_ok = false;
+    size_t pos = 12;
+    while (pos + 8 <= len) {
+        const uint8_t *chunk = wav + pos;
+        uint32_t size = sys_get_le32(chunk + 4);
+        if (size > len - pos - 8) {
+            return -EINVAL;
+        }
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            format_ok = sys_get_le16(chunk + 8) == 1 &&                 // PCM
+                        sys_get_le16(chunk + 10) == 1 &&                // mono
+                        sys_get_le32(chunk + 12) == FT8_RX_SAMPLE_HZ &&
+                        sys_get_le16(chunk + 22) == 16;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!format_ok || ((uintptr_t)(chunk + 8) & 1)) {
+                return -EINVAL;
+            }
+            *samples = (const int16_t *)(chunk + 8);
+            *count = size / 2;
+            return 0;
+        }
+
+        pos += 8 + size + (size & 1);
+    }
+    return -EINVAL;
+}
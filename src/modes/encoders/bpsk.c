@@ -0,0 +1,140 @@
+#include "modes/encoders/bpsk.h"
+#include "modes/fec.h"
+#include "radio_core.h"
+
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+/* PSK31 varicode for ASCII 0-127, each code sent MSB first from its top
+ * set bit. No code contains "00", which separates characters. */
+static const uint16_t varicode[128] = {
+    0x2ab, 0x2db, 0x2ed, 0x377, 0x2eb, 0x35f, 0x2ef, 0x2fd,
+    0x2ff, 0x0ef, 0x01d, 0x36f, 0x2dd, 0x01f, 0x375, 0x3ab,
+    0x2f7, 0x2f5, 0x3ad, 0x3af, 0x35b, 0x36b, 0x36d, 0x357,
+    0x37b, 0x37d, 0x3b7, 0x355, 0x35d, 0x3bb, 0x2fb, 0x37f,
+    0x001, 0x1ff, 0x15f, 0x1f5, 0x1db, 0x2d5, 0x2bb, 0x17f,
+    0x0fb, 0x0f7, 0x16f, 0x1df, 0x075, 0x035, 0x057, 0x1af,
+    0x0b7, 0x0bd, 0x0ed, 0x0ff, 0x177, 0x15b, 0x16b, 0x1ad,
+    0x1ab, 0x1b7, 0x0f5, 0x1bd, 0x1ed, 0x055, 0x1d7, 0x2af,
+    0x2bd, 0x07d, 0x0eb, 0x0ad, 0x0b5, 0x077, 0x0db, 0x0fd,
+    0x155, 0x07f, 0x1fd, 0x17d, 0x0d7, 0x0bb, 0x0dd, 0x0ab,
+    0x0d5, 0x1dd, 0x0af, 0x06f, 0x06d, 0x157, 0x1b5, 0x15d,
+    0x175, 0x17b, 0x2ad, 0x1f7, 0x1ef, 0x1fb, 0x2bf, 0x16d,
+    0x2df, 0x00b, 0x05f, 0x02f, 0x02d, 0x003, 0x03d, 0x05b,
+    0x02b, 0x00d, 0x1eb, 0x0bf, 0x01b, 0x03b, 0x00f, 0x007,
+    0x03f, 0x1bf, 0x015, 0x017, 0x005, 0x037, 0x07b, 0x06b,
+    0x0df, 0x05d, 0x1d5, 0x2b7, 0x1bb, 0x2b5, 0x2d7, 0x3b5,
+};
+
+#define VARICODE_MAX_BITS  10
+
+struct bpsk_stream {
+    size_t  bits;
+    uint8_t phase[];    // carrier inverted during symbol i, MSB first
+};
+
+/* Owned by the encoder and replaced by the next call */
+static struct bpsk_stream *bpsk_stream;
+
+static int bpsk_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    const struct bpsk_stream *st = seq->source_ctx;
+
+    if (index >= st->bits) {
+        return -EINVAL;
+    }
+
+    /* The envelope dips to zero across every reversal and at either end */
+    bool phase = fec_get_bit(st->phase, index);
+    uint8_t shape = 0;
+    if (index == 0 || fec_get_bit(st->phase, index - 1) != phase) {
+        shape |= TX_SHAPE_RAMP_UP;
+    }
+    if (index == st->bits - 1 || fec_get_bit(st->phase, index + 1) != phase) {
+        shape |= TX_SHAPE_RAMP_DOWN;
+    }
+
+    *out = (tx_symbol_t){0, BPSK31_SYMBOL_US, true, phase, shape};
+    return 0;
+}
+
+/* Bits of a varicode code, from its top set bit down */
+static int varicode_bits(uint16_t code) {
+    int bits = VARICODE_MAX_BITS;
+    while (!(code >> (bits - 1))) {
+        bits--;
+    }
+    return bits;
+}
+
+size_t bpsk31_symbol_count(const char* text) {
+    size_t bits = BPSK31_PREAMBLE + BPSK31_POSTAMBLE;
+
+    for (; *text; text++) {
+        unsigned char c = (unsigned char)*text;
+        if (c < 128) {
+            bits += varicode_bits(varicode[c]) + 2;
+        }
+    }
+    return bits;
+}
+
+/* A 0 reverses the phase, a 1 holds it */
+static void put_bit(struct bpsk_stream *st, bool *phase, bool bit) {
+    *phase ^= !bit;
+    if (*phase) {
+        st->phase[st->bits / 8] |= 0x80 >> (st->bits % 8);
+    }
+    st->bits++;
+}
+
+int generate_bpsk31_sequence(const char* text, tx_sequence_t* tx_sequence) {
+    if (!text || !tx_sequence) {
+        return -1;
+    }
+    tx_sequence->mode_name = "BPSK31";
+
+    size_t text_len = strlen(text);
+    size_t capacity = bpsk31_symbol_count(text);
+
+    k_free(bpsk_stream);
+    bpsk_stream = k_malloc(sizeof(*bpsk_stream) + (capacity + 7) / 8);
+    if (!bpsk_stream) return -2;
+
+    struct bpsk_stream *st = bpsk_stream;
+    memset(st->phase, 0, (capacity + 7) / 8);
+    st->bits = 0;
+
+    bool phase = false;
+
+    for (int i = 0; i < BPSK31_PREAMBLE; i++) {
+        put_bit(st, &phase, 0);
+    }
+
+    for (size_t i = 0; i < text_len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 128) {
+            continue;
+        }
+
+        uint16_t code = varicode[c];
+        for (int b = varicode_bits(code) - 1; b >= 0; b--) {
+            put_bit(st, &phase, (code >> b) & 1);
+        }
+        put_bit(st, &phase, 0);
+        put_bit(st, &phase, 0);
+    }
+
+    for (int i = 0; i < BPSK31_POSTAMBLE; i++) {
+        put_bit(st, &phase, 1);
+    }
+
+    tx_sequence->symbols = NULL;
+    tx_sequence->source = bpsk_symbol;
+    tx_sequence->source_ctx = st;
+    tx_sequence->total_symbols = st->bits;
+    tx_sequence->current_index = 0;
+
+    return 0;
+}
@@ -7,50 +7,55 @@
 #include <zephyr/kernel.h>
 
 
-static const char* MORSE_TABLE[128] = {
-    ['A'] = ".-",
-    ['B'] = "-...",
-    ['C'] = "-.-.",
-    ['D'] = "-..",
-    ['E'] = ".",
-    ['F'] = "..-.",
-    ['G'] = "--.",
-    ['H'] = "....",
-    ['I'] = "..",
-    ['J'] = ".---",
-    ['K'] = "-.-",
-    ['L'] = ".-..",
-    ['M'] = "--",
-    ['N'] = "-.",
-    ['O'] = "---",
-    ['P'] = ".--.",
-    ['Q'] = "--.-",
-    ['R'] = ".-.",
-    ['S'] = "...",
-    ['T'] = "-",
-    ['U'] = "..-",
-    ['V'] = "...-",
-    ['W'] = ".--",
-    ['X'] = "-..-",
-    ['Y'] = "-.--",
-    ['Z'] = "--..",
-
-    ['0'] = "-----",
-    ['1'] = ".----",
-    ['2'] = "..---",
-    ['3'] = "...--",
-    ['4'] = "....-",
-    ['5'] = ".....",
-    ['6'] = "-....",
-    ['7'] = "--...",
-    ['8'] = "---..",
-    ['9'] = "----.",
+/* Morse for '+' to 'Z', one byte each as cw_code describes; 0 where
+ * there is none */
+#define MORSE_FIRST '+'
+#define MORSE_LAST  'Z'
+
+static const uint8_t morse_table[MORSE_LAST - MORSE_FIRST + 1] = {
+    0x2A, 0x73, 0x61, 0x6A, 0x29, 0x3F, 0x3E, 0x3C,   // + , - . / 0 1 2
+    0x38, 0x30, 0x20, 0x21, 0x23, 0x27, 0x2F, 0x00,   // 3 4 5 6 7 8 9 :
+    0x00, 0x00, 0x31, 0x00, 0x4C, 0x56, 0x06, 0x11,   // ; < = > ? @ A B
+    0x15, 0x09, 0x02, 0x14, 0x0B, 0x10, 0x04, 0x1E,   // C D E F G H I J
+    0x0D, 0x12, 0x07, 0x05, 0x0F, 0x16, 0x1B, 0x0A,   // K L M N O P Q R
+    0x08, 0x03, 0x0C, 0x18, 0x0E, 0x19, 0x1D, 0x13,   // S T U V W X Y Z
 };
 
 static uint32_t calculate_dot_duration_us(uint32_t wpm) {
     return 1200000 / wpm;
 }
 
+void cw_timing(uint32_t wpm, uint32_t effective_wpm, cw_timing_t* timing) {
+    timing->dot_us = calculate_dot_duration_us(wpm);
+    timing->char_gap_us = 3 * timing->dot_us;
+    timing->word_gap_us = 7 * timing->dot_us;
+
+    if (effective_wpm == 0 || effective_wpm >= wpm) {
+        return;
+    }
+
+    /* ARRL Farnsworth: the delay added to a PARIS word at the effective
+     * speed is spread over its 19 units of character and word gap */
+    uint64_t delay_us = (60000000ULL * wpm - 37200000ULL * effective_wpm) /
+                        ((uint64_t)wpm * effective_wpm);
+    timing->char_gap_us = (uint32_t)(3 * delay_us / 19);
+    timing->word_gap_us = (uint32_t)(7 * delay_us / 19);
+}
+
+uint8_t cw_code(char c) {
+    c = toupper((unsigned char)c);
+    return (c >= MORSE_FIRST && c <= MORSE_LAST) ? morse_table[c - MORSE_FIRST] : 0;
+}
+
+int cw_code_length(uint8_t code) {
+    int len = 0;
+    while (code > 1) {
+        code >>= 1;
+        len++;
+    }
+    return len;
+}
+
 void generate_cw_sequence(const char* text, uint32_t wpm, tx_sequence_t* tx_sequence) {
     tx_sequence->mode_name = "CW";
 
@@ -61,12 +66,7 @@ void generate_cw_sequence(const char* text, uint32_t wpm, tx_sequence_t* tx_sequ
     size_t len = strlen(text);
 
     for (size_t i = 0; i < len; i++) {
-        char c = toupper((unsigned char)text[i]);
-        if (c == ' ') {
-            continue;
-        } else if (c < 128 && MORSE_TABLE[(int)c]) {
-            estimated_capacity += strlen(MORSE_TABLE[(int)c]) * 2;
-        }
+        estimated_capacity += cw_code_length(cw_code(text[i])) * 2;
     }
 
     tx_symbol_t* sym_array = (tx_symbol_t*)k_malloc(estimated_capacity * sizeof(tx_symbol_t));
@@ -79,39 +79,24 @@ void generate_cw_sequence(const char* text, uint32_t wpm, tx_sequence_t* tx_sequ
     size_t sym_idx = 0;
 
     for (size_t i = 0; i < len; i++) {
-        char c = toupper((unsigned char)text[i]);
-
-        if (c == ' ') {
+        if (text[i] == ' ') {
             if (sym_idx > 0 && !sym_array[sym_idx - 1].tx_on) {
                 sym_array[sym_idx - 1].duration_us += (6 * dot_us);
             }
             continue;
         }
 
-        const char* code = (c < 128) ? MORSE_TABLE[(int)c] : NULL;
+        uint8_t code = cw_code(text[i]);
 
         if (code) {
             if (sym_idx > 0 && !sym_array[sym_idx - 1].tx_on) {
                 sym_array[sym_idx - 1].duration_us += (2 * dot_us);
             }
 
-            while (*code) {
-                sym_array[sym_idx].tx_on = true;
-                sym_array[sym_idx].freq_offset_hz = 0;
-                
-                if (*code == '.') {
-                    sym_array[sym_idx].duration_us = dot_us;
-                } else {
-                    sym_array[sym_idx].duration_us = dash_us;
-                }
-                sym_idx++;
-
-                sym_array[sym_idx].tx_on = false;
-                sym_array[sym_idx].freq_offset_hz = 0;
-                sym_array[sym_idx].duration_us = dot_us;
-                sym_idx++;
-
-                code++;
+            for (; code > 1; code >>= 1) {
+                uint32_t element_us = (code & 1) ? dash_us : dot_us;
+                sym_array[sym_idx++] = (tx_symbol_t){0, element_us, true, false, TX_SHAPE_KEYED};
+                sym_array[sym_idx++] = (tx_symbol_t){0, dot_us, false, false, TX_SHAPE_KEYED};
             }
         }
     }
@@ -0,0 +1,197 @@
+#include "modes/encoders/fst4w.h"
+#include "modes/fec.h"
+
+#include <string.h>
+#include <errno.h>
+
+#define FST4W_SAMPLE_HZ     12000U
+#define FST4W_DATA_SYMBOLS  120
+#define FST4W_SYNC_LEN      8
+/* A sync word and the 30 data symbols after it */
+#define FST4W_BLOCK_LEN     (FST4W_SYNC_LEN + FST4W_DATA_SYMBOLS / 4)
+
+static const uint8_t sync_words[2][FST4W_SYNC_LEN] = {
+    { 0, 1, 3, 2, 1, 0, 2, 3 },
+    { 2, 3, 1, 0, 3, 2, 0, 1 },
+};
+static const uint8_t gray_map[4] = { 0, 1, 3, 2 };
+
+static const uint32_t period_s[FST4W_PERIOD_COUNT] = { 120, 300, 900, 1800 };
+static const uint32_t symbol_samples[FST4W_PERIOD_COUNT] = { 8200, 21504, 66560, 134400 };
+
+/* Generator of the LDPC(240,74) code from scripts/fst4w_ldpc.py: row j
+ * holds the 166 parity bits message bit j feeds, MSB first. This is not
+ * the WSJT-X matrix, which this tree does not have; an FST4W receiver
+ * will not decode the parity until that table replaces this one. */
+static const uint32_t ldpc_columns[FST4W_LDPC_K][6] = {
+    { 0x740cde33, 0x41e2bbc8, 0x894f330b, 0x2ccd4428, 0x8ba21bdc, 0xd0000000 },
+    { 0x09759c1b, 0xb70c9fda, 0xb82c97fe, 0xe630fef4, 0x737e4130, 0xe4000000 },
+    { 0x059cb27b, 0xc97738eb, 0xa8263ede, 0xa91968bf, 0xd6753781, 0x7c000000 },
+    { 0xfc197ad8, 0x6297eb12, 0x8c730701, 0x32baeca4, 0x89f21779, 0xc0000000 },
+    { 0xf510169b, 0x58a31551, 0x7c418745, 0xf0c935f8, 0x00d01286, 0xb4000000 },
+    { 0x5eb39458, 0xe2d55477, 0xa8f3f6b9, 0xfb529676, 0xb9fdadb8, 0xa8000000 },
+    { 0x091d1f4c, 0x8c64f1d8, 0x67d6ba46, 0xc02719bd, 0xaf004c87, 0x6c000000 },
+    { 0x2a446ac3, 0x67e8e189, 0x99d76d4f, 0x396fa629, 0x86a0dfc1, 0x9c000000 },
+    { 0x8ea8e269, 0x53322840, 0x780e2b8a, 0xe429edb9, 0xce081569, 0x70000000 },
+    { 0xaf2a8c46, 0x12af1bb2, 0x5e64e077, 0x3371f506, 0x7adff83e, 0x64000000 },
+    { 0xb4aa2897, 0xe13e4173, 0x7d7a9c55, 0xcd9e151f, 0xf5157c06, 0xe0000000 },
+    { 0xd07e42d1, 0x101ab185, 0x244872cd, 0xd5200cb8, 0x0940d943, 0x8c000000 },
+    { 0xb5ca50f6, 0xf9210155, 0x3b03b264, 0xaa851230, 0xc8580c10, 0x04000000 },
+    { 0x8b32bb39, 0xd4af5c36, 0x60988e11, 0xc5c371f7, 0x5dd57bb2, 0x18000000 },
+    { 0x385028e4, 0x9ccae731, 0x2fd407ff, 0xf3e60efa, 0x0b9f76c8, 0xfc000000 },
+    { 0x8d4e2923, 0xa5028e69, 0xe2e68af6, 0xd2505ff3, 0xae6f3d2b, 0xd8000000 },
+    { 0xf6339387, 0x53444af2, 0x3b998a19, 0xa58ed2bf, 0x7c17250e, 0xb4000000 },
+    { 0xb94cd0c1, 0x278258b9, 0x9e5e95b3, 0x6fe2fc0a, 0x9aef3f8b, 0xdc000000 },
+    { 0x9fa29a26, 0xaa1ae578, 0xac991d5c, 0xbc8280db, 0x3f35707c, 0x2c000000 },
+    { 0xec1e2667, 0x173aaccd, 0xa14b26cc, 0xcc8decf8, 0xe0205128, 0x78000000 },
+    { 0x0d292542, 0x966de346, 0x321312c5, 0xc18baefc, 0xe0524eee, 0x04000000 },
+    { 0xbc1f5003, 0x1fcb143b, 0x55e4c93b, 0x0bd49d47, 0x27d9f73c, 0x08000000 },
+    { 0x8d7f6a86, 0x7cc3d661, 0x8d971f3a, 0x7a4e2ae3, 0xe7ff34c1, 0x20000000 },
+    { 0x75d32876, 0x2b2d738e, 0x5d30b420, 0x333f990c, 0x614a6cbc, 0xfc000000 },
+    { 0xdb1da44a, 0xad4da1fe, 0xf16d5533, 0xc70c071e, 0x736de7e0, 0xc4000000 },
+    { 0xf227f189, 0x5e8a74d9, 0xb933da21, 0xebde90f9, 0xadb8d163, 0xa0000000 },
+    { 0x90b01882, 0xda1f91fb, 0x49280a90, 0x3cbc872f, 0x51447ccb, 0x44000000 },
+    { 0x40417cd8, 0x65680e2d, 0xb1ccb97f, 0xdf85565b, 0x276f657b, 0x50000000 },
+    { 0x90d61db0, 0x99b4a616, 0x288ef3cf, 0xad4d1a7c, 0xbac28fc5, 0x18000000 },
+    { 0x94915684, 0x756c3e97, 0xea691745, 0xfd116ff4, 0x783241f3, 0x68000000 },
+    { 0x664d4a93, 0xd225863e, 0xcc2892fc, 0x7e9191ee, 0xd93f204b, 0x90000000 },
+    { 0x682774db, 0x2d6c007b, 0x06ec241b, 0x1d310c8e, 0x32456ab8, 0x00000000 },
+    { 0xd8c779e4, 0xe4fda3e7, 0x43efe212, 0x545535a6, 0xe2d7e83e, 0x60000000 },
+    { 0x08cf807a, 0xdea21ab4, 0xf4c31bb9, 0x82c1c72b, 0xbcbf33bd, 0xd4000000 },
+    { 0x1a685b39, 0xccf95699, 0xb571d380, 0x85df3e78, 0x78b2c13b, 0x50000000 },
+    { 0x8fceec3a, 0x888eea2e, 0x3df87799, 0xacfe643e, 0x3007fcf7, 0x44000000 },
+    { 0x9b20913d, 0x15b08c8d, 0x26ab6ca1, 0xde794851, 0xbdc88656, 0x08000000 },
+    { 0xa1eb843c, 0xb3b94784, 0x42985988, 0x1dcb2949, 0x4dc2c3c0, 0x40000000 },
+    { 0xb4451bca, 0x14b4568e, 0x5f436a08, 0x296f3d6d, 0xf4d28f2e, 0xec000000 },
+    { 0xff7bd25b, 0x21771693, 0x836cc84f, 0x05b53ecd, 0x7f329de1, 0x60000000 },
+    { 0x6f5fdb98, 0x393e1d96, 0x524de44e, 0x0489574c, 0x1a00d698, 0xc8000000 },
+    { 0xb03a6e41, 0xd2a5030a, 0x66e56067, 0x9bf9af14, 0x229a81a6, 0xac000000 },
+    { 0x50807086, 0xc4bc20a7, 0x73eca9ff, 0x87551f17, 0x26dde554, 0xc0000000 },
+    { 0xf820ea5e, 0xe7ebe7d9, 0x44d31081, 0x51cb8748, 0x91825641, 0x34000000 },
+    { 0xe9ddf461, 0x19fd4072, 0x46757d9b, 0x11730f87, 0x2fc5e969, 0xa4000000 },
+    { 0xc191f6ef, 0x61fdd9ba, 0x9bb09218, 0x207f7226, 0x30b56bcb, 0xdc000000 },
+    { 0x3d34ce79, 0x32996b48, 0xccd02809, 0x71c2e389, 0x05e247c8, 0x00000000 },
+    { 0x2eaed7df, 0xdb83cfb0, 0x04ba34d5, 0x4c5ae242, 0xb0b73792, 0x04000000 },
+    { 0xa6179ecb, 0xa6c3ed64, 0x5993c8f4, 0xa2eedb4b, 0x9ccdbad2, 0x20000000 },
+    { 0x272e89c6, 0xc95b6a74, 0x74fab388, 0xcc927838, 0xb9137147, 0x84000000 },
+    { 0x7eecaa6b, 0x8b730750, 0xc54f94e7, 0x0fa59540, 0x933a14b5, 0xd0000000 },
+    { 0xa5c16b2e, 0xc7bc8696, 0x5b435608, 0x30c5a7ec, 0xe8d2c38e, 0x2c000000 },
+    { 0x04de7906, 0x446b0ae1, 0xec64f454, 0xe9795d13, 0x0a67fa40, 0x9c000000 },
+    { 0xc27d1a25, 0x034849a9, 0x2d18d3b8, 0xa606d2ba, 0x004de4fe, 0xac000000 },
+    { 0xb60a6d5b, 0xa556263e, 0x5ddf8a5e, 0x340e7fe7, 0xb717363f, 0x8c000000 },
+    { 0xdb9e8648, 0x355b579e, 0xdc5eb3c3, 0x7d2a3de0, 0xa2665405, 0x0c000000 },
+    { 0xe6e29b55, 0x1969da69, 0x71bbc801, 0x95175d91, 0xcc13e887, 0x74000000 },
+    { 0xe94de709, 0x0d45b33b, 0x660c6393, 0x8d0021ae, 0x1f47a9f0, 0xfc000000 },
+    { 0xbac09de9, 0x071f1f7f, 0x6156c012, 0x580cf7d6, 0xe217fa27, 0xc0000000 },
+    { 0xcf9c045e, 0x49cfe35a, 0x8d32becc, 0x657e1a2d, 0xe4e25c92, 0x74000000 },
+    { 0xe2c7286d, 0x8d8f63eb, 0x9c7109f5, 0x63723c07, 0x75ad5a92, 0x88000000 },
+    { 0x097e8795, 0x50cf36ee, 0x3c0c60cf, 0xb4e02cd6, 0x6373f323, 0xe4000000 },
+    { 0x25f7cb65, 0xb00c94d6, 0x37ca67cc, 0xfcac2c74, 0xe210c3cb, 0x74000000 },
+    { 0x0421f11b, 0xf699d295, 0x14ba7a29, 0x57d6a221, 0x958acd1c, 0x0c000000 },
+    { 0x8b52baa6, 0x2ed9e31c, 0xb355a12f, 0xdaee94d8, 0x13ba4869, 0xd0000000 },
+    { 0x0096b2df, 0x482f95a3, 0x0c2c3412, 0x74192046, 0x22457f8a, 0xb0000000 },
+    { 0x5533ea90, 0xb5b9b670, 0x3804a176, 0xb2e030da, 0x5bcfe387, 0x24000000 },
+    { 0x7a914a01, 0x4057d99b, 0x9d7a6ded, 0x37ae0c85, 0x8c78d2a4, 0x2c000000 },
+    { 0x1a03d215, 0x896c1107, 0xdbe9894d, 0x2c1d1da5, 0x24604258, 0x80000000 },
+    { 0x1a211708, 0x9add548b, 0xdd52f96c, 0x7bc61f44, 0xf5a8cd18, 0x28000000 },
+    { 0x06a8d03f, 0x8d39e049, 0xe311838a, 0xd3471b38, 0x887042b4, 0xec000000 },
+    { 0xa1bac1e3, 0x3a76f9a3, 0xb39176fd, 0x9307c636, 0x512cb62d, 0x24000000 },
+    { 0xc4dd5626, 0x029ce379, 0x3c87bc76, 0xa260ba13, 0xa6d76cb6, 0x60000000 },
+    { 0xb80354c5, 0x2703bb28, 0xb7489bd5, 0xcc84dfb3, 0x7c672b10, 0x94000000 },
+};
+
+struct fst4w_source {
+    uint8_t codeword[FST4W_CODEWORD_BYTES];
+    enum fst4w_period period;
+};
+
+static struct fst4w_source fst4w_source;
+
+uint32_t fst4w_period_us(enum fst4w_period period) {
+    return period_s[period] * 1000000U;
+}
+
+uint32_t fst4w_symbol_samples(enum fst4w_period period) {
+    return symbol_samples[period];
+}
+
+uint64_t fst4w_symbol_start_us(enum fst4w_period period, size_t k) {
+    uint64_t num = (uint64_t)k * symbol_samples[period] * 1000000U;
+    return (num + FST4W_SAMPLE_HZ / 2) / FST4W_SAMPLE_HZ;
+}
+
+void fst4w_encode_codeword(const uint8_t message[WSPR_MESSAGE_BYTES],
+                           uint8_t codeword[FST4W_CODEWORD_BYTES]) {
+    memset(codeword, 0, FST4W_CODEWORD_BYTES);
+    memcpy(codeword, message, WSPR_MESSAGE_BYTES);
+    codeword[WSPR_MESSAGE_BYTES - 1] &= 0xC0;
+
+    uint32_t crc = fec_crc(&fec_crc24, codeword, WSPR_MESSAGE_BITS) << 8;
+    fec_put_bits(codeword, WSPR_MESSAGE_BITS, &crc, 24);
+
+    uint32_t parity[6];
+    fec_block_parity(&ldpc_columns[0][0], 6, codeword, FST4W_LDPC_K, parity);
+    fec_put_bits(codeword, FST4W_LDPC_K, parity, FST4W_LDPC_M);
+}
+
+/* Symbols are S1 D30 S2 D30 S1 D30 S2 D30 S1, each data symbol two
+ * codeword bits through the Gray map */
+static uint8_t fst4w_tone(const uint8_t *codeword, size_t i) {
+    size_t block = i / FST4W_BLOCK_LEN;
+    size_t pos = i % FST4W_BLOCK_LEN;
+
+    if (pos < FST4W_SYNC_LEN) {
+        return sync_words[block & 1][pos];
+    }
+
+    size_t bit = 2 * (block * (FST4W_BLOCK_LEN - FST4W_SYNC_LEN) + pos - FST4W_SYNC_LEN);
+    return gray_map[fec_get_bit(codeword, bit) * 2 + fec_get_bit(codeword, bit + 1)];
+}
+
+static int fst4w_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    const struct fst4w_source *src = seq->source_ctx;
+    uint32_t nsps = symbol_samples[src->period];
+
+    if (index >= FST4W_SYMBOL_COUNT) {
+        return -EINVAL;
+    }
+
+    *out = (tx_symbol_t){
+        .freq_offset_uhz = FREQ_RATIO(fst4w_tone(src->codeword, index) * FST4W_SAMPLE_HZ, nsps),
+        .duration_us     = (uint32_t)(fst4w_symbol_start_us(src->period, index + 1) -
+                                      fst4w_symbol_start_us(src->period, index)),
+        .tx_on           = true,
+    };
+    if (index == 0) {
+        out->shape = TX_SHAPE_RAMP_UP;
+    } else if (index == FST4W_SYMBOL_COUNT - 1) {
+        out->shape = TX_SHAPE_RAMP_DOWN;
+    }
+    return 0;
+}
+
+int generate_fst4w_sequence(const wspr_payload_t *payload, enum fst4w_period period,
+                            tx_sequence_t *tx_sequence) {
+    uint8_t message[WSPR_MESSAGE_BYTES];
+
+    if (!payload || !tx_sequence || period >= FST4W_PERIOD_COUNT) {
+        return -1;
+    }
+
+    tx_sequence->mode_name = "FST4W";
+
+    if (wspr_pack_message(payload, message)) {
+        return -1;
+    }
+
+    fst4w_encode_codeword(message, fst4w_source.codeword);
+    fst4w_source.period = period;
+
+    tx_sequence->symbols = NULL;
+    tx_sequence->source = fst4w_symbol;
+    tx_sequence->source_ctx = &fst4w_source;
+    tx_sequence->total_symbols = FST4W_SYMBOL_COUNT;
+    tx_sequence->current_index = 0;
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "modes/encoders/ft4.h"
+#include "modes/ftx.h"
+
+#include <stdint.h>
+
+#define FT4_SYMBOL_COUNT    105
+#define FT4_SYMBOL_US       48000U
+#define FT4_TONE_OFFSET(t)  FREQ_RATIO((t) * 12000, 576)      // 20.833 Hz
+
+/* Four different 4x4 Costas arrays, one ahead of each 29-symbol data block */
+static const uint8_t costas[4][4] = {
+    { 0, 1, 3, 2 },
+    { 1, 0, 2, 3 },
+    { 2, 3, 1, 0 },
+    { 3, 2, 0, 1 },
+};
+static const uint8_t gray_map[4] = { 0, 1, 3, 2 };
+
+/* Payload whitening, XORed over the 77 bits before the CRC */
+static const uint8_t scramble[10] = {
+    0x4A, 0x5E, 0x89, 0xB4, 0xB0, 0x8A, 0x79, 0x55, 0xBE, 0x28
+};
+
+static tx_symbol_t ft4_symbols[FT4_SYMBOL_COUNT];
+
+static void ft4_tones(const uint8_t codeword[FTX_CODEWORD_BYTES],
+                      uint8_t tones[FT4_SYMBOL_COUNT]) {
+    int out = 0;
+
+    /* Symbols 1..103 are S4 D29 S4 D29 S4 D29 S4 */
+    for (int i = 1; i < FT4_SYMBOL_COUNT - 1; i++) {
+        int block = (i - 1) % 33;
+        if (block < 4) {
+            tones[i] = costas[(i - 1) / 33][block];
+            continue;
+        }
+
+        uint8_t bits = 0;
+        for (int b = 0; b < 2; b++, out++) {
+            bits = (bits << 1) | ((codeword[out / 8] >> (7 - (out % 8))) & 1);
+        }
+        tones[i] = gray_map[bits];
+    }
+
+    /* Ramp symbols hold the neighbouring tone so the phase stays continuous */
+    tones[0] = tones[1];
+    tones[FT4_SYMBOL_COUNT - 1] = tones[FT4_SYMBOL_COUNT - 2];
+}
+
+int generate_ft4_sequence(const ftx_payload_t* payload, tx_sequence_t* tx_sequence) {
+    if (!payload || !tx_sequence) {
+        return -1;
+    }
+
+    tx_sequence->mode_name = "FT4";
+
+    uint8_t packed[10];
+    encode_ftx_payload(payload, packed);
+    for (int i = 0; i < 10; i++) {
+        packed[i] ^= scramble[i];
+    }
+
+    uint8_t codeword[FTX_CODEWORD_BYTES];
+    ftx_encode_codeword(packed, codeword);
+
+    uint8_t tones[FT4_SYMBOL_COUNT];
+    ft4_tones(codeword, tones);
+
+    for (int i = 0; i < FT4_SYMBOL_COUNT; i++) {
+        ft4_symbols[i] = (tx_symbol_t){
+            .freq_offset_uhz = FT4_TONE_OFFSET(tones[i]),
+            .duration_us     = FT4_SYMBOL_US,
+            .tx_on           = true,
+        };
+    }
+    /* The ramp symbols are there for the envelope to rise and fall in */
+    ft4_symbols[0].shape = TX_SHAPE_RAMP_UP;
+    ft4_symbols[FT4_SYMBOL_COUNT - 1].shape = TX_SHAPE_RAMP_DOWN;
+
+    tx_sequence->symbols = ft4_symbols;
+    tx_sequence->total_symbols = FT4_SYMBOL_COUNT;
+    tx_sequence->current_index = 0;
+
+    return 0;
+}
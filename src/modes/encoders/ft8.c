@@ -2,3 +2,65 @@
 #include "modes/ftx.h"
 
 #include <stdint.h>
+
+#define FT8_SYMBOL_COUNT    79
+#define FT8_DATA_SYMBOLS    58
+#define FT8_SYMBOL_US       160000U
+#define FT8_TONE_OFFSET(t)  FREQ_RATIO((t) * 12000, 1920)     // 6.25 Hz
+
+/* 7x7 Costas array, sent at symbols 0, 36 and 72 */
+static const uint8_t costas[7] = { 3, 1, 4, 0, 6, 5, 2 };
+static const uint8_t gray_map[8] = { 0, 1, 3, 2, 5, 6, 4, 7 };
+
+/* One transmission at a time, so the sequence is built in place */
+static tx_symbol_t ft8_symbols[FT8_SYMBOL_COUNT];
+
+static void ft8_tones(const uint8_t codeword[FTX_CODEWORD_BYTES],
+                      uint8_t tones[FT8_SYMBOL_COUNT]) {
+    int out = 0;
+
+    for (int i = 0; i < FT8_SYMBOL_COUNT; i++) {
+        /* Sync blocks start every 36 symbols */
+        if (i % 36 < 7) {
+            tones[i] = costas[i % 36];
+            continue;
+        }
+
+        uint8_t bits = 0;
+        for (int b = 0; b < 3; b++, out++) {
+            bits = (bits << 1) | ((codeword[out / 8] >> (7 - (out % 8))) & 1);
+        }
+        tones[i] = gray_map[bits];
+    }
+}
+
+int generate_ft8_sequence(const ftx_payload_t* payload, tx_sequence_t* tx_sequence) {
+    if (!payload || !tx_sequence) {
+        return -1;
+    }
+
+    tx_sequence->mode_name = "FT8";
+
+    uint8_t packed[10];
+    encode_ftx_payload(payload, packed);
+
+    uint8_t codeword[FTX_CODEWORD_BYTES];
+    ftx_encode_codeword(packed, codeword);
+
+    uint8_t tones[FT8_SYMBOL_COUNT];
+    ft8_tones(codeword, tones);
+
+    for (int i = 0; i < FT8_SYMBOL_COUNT; i++) {
+        ft8_symbols[i] = (tx_symbol_t){
+            .freq_offset_uhz = FT8_TONE_OFFSET(tones[i]),
+            .duration_us     = FT8_SYMBOL_US,
+            .tx_on           = true,
+        };
+    }
+
+    tx_sequence->symbols = ft8_symbols;
+    tx_sequence->total_symbols = FT8_SYMBOL_COUNT;
+    tx_sequence->current_index = 0;
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "modes/encoders/hell.h"
+#include "modes/fec.h"
+#include "radio_core.h"
+
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#define HELL_FIRST_CHAR     ' '
+#define HELL_LAST_CHAR      'Z'
+#define HELL_GLYPH_COLUMNS  5       // inked columns, centred in the cell
+#define HELL_GLYPH_BITS     (HELL_GLYPH_COLUMNS * HELL_PIXELS)
+
+/* 5x7 glyphs for ' ' to 'Z', HELL_GLYPH_BITS each, packed MSB first in
+ * transmit order: column by column, bottom pixel first */
+static const uint8_t hell_font[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0x00, 0x00, 0x00, 0x70, 0x01,
+    0xc0, 0x14, 0xfe, 0x53, 0xf9, 0x44, 0x8a, 0xbf, 0xaa, 0x24, 0x8c, 0x98,
+    0x8c, 0x98, 0x9b, 0x49, 0xaa, 0x8a, 0x80, 0x00, 0xa0, 0xc0, 0x00, 0x00,
+    0x71, 0x14, 0x10, 0x00, 0x20, 0xa2, 0x38, 0x00, 0x42, 0xa3, 0x8a, 0x84,
+    0x08, 0x10, 0xf8, 0x40, 0x80, 0x14, 0x18, 0x00, 0x00, 0x20, 0x40, 0x81,
+    0x02, 0x00, 0x60, 0xc0, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x7d, 0x46,
+    0x4c, 0x57, 0xc0, 0x21, 0x7f, 0x80, 0x02, 0x16, 0x1a, 0x32, 0x63, 0x21,
+    0x83, 0x16, 0x5b, 0x13, 0x05, 0x09, 0x7f, 0x20, 0x9e, 0x2c, 0x58, 0xae,
+    0x5e, 0x4a, 0x93, 0x25, 0x80, 0x1e, 0x22, 0x42, 0x83, 0x6d, 0x26, 0x4c,
+    0x96, 0xc1, 0xa4, 0xc9, 0x52, 0x78, 0x03, 0x66, 0xc0, 0x00, 0x00, 0xac,
+    0xd8, 0x00, 0x01, 0x05, 0x11, 0x41, 0x00, 0x50, 0xa1, 0x42, 0x85, 0x00,
+    0x41, 0x44, 0x50, 0x40, 0x20, 0x34, 0x44, 0x86, 0x65, 0x27, 0xcc, 0x17,
+    0xdf, 0x88, 0x91, 0x23, 0xfb, 0xfc, 0x99, 0x32, 0x5b, 0x3e, 0x83, 0x06,
+    0x0a, 0x2f, 0xf0, 0x60, 0xa2, 0x39, 0xfe, 0x4c, 0x99, 0x30, 0x7f, 0x89,
+    0x12, 0x04, 0x0b, 0xe8, 0x30, 0x68, 0xb2, 0xfe, 0x20, 0x40, 0x8f, 0xe0,
+    0x20, 0xff, 0x82, 0x01, 0x04, 0x08, 0x2f, 0xc0, 0xff, 0x10, 0x51, 0x14,
+    0x1f, 0xf0, 0x20, 0x40, 0x81, 0xfc, 0x10, 0x40, 0x5f, 0xff, 0x84, 0x10,
+    0x43, 0xfb, 0xe8, 0x30, 0x60, 0xbe, 0xfe, 0x24, 0x48, 0x90, 0xcf, 0xa0,
+    0xd1, 0x43, 0x7b, 0xf8, 0x93, 0x2a, 0x63, 0x46, 0x93, 0x26, 0x4b, 0x10,
+    0x20, 0x7f, 0x81, 0x02, 0xfe, 0x04, 0x08, 0x0f, 0xcf, 0xa0, 0x80, 0x80,
+    0xff, 0xf4, 0x06, 0x10, 0x7f, 0xc6, 0x50, 0x41, 0x4c, 0x60, 0xc2, 0x78,
+    0x08, 0x0f, 0x0d, 0x19, 0x31, 0x61, 0x80,
+};
+
+struct hell_stream {
+    size_t   pixel;         // next pixel to scan
+    size_t   pixels;
+    size_t   produced;
+    tx_symbol_t last_sym;
+    char     text[];
+};
+
+/* Owned by the encoder and replaced by the next call */
+static struct hell_stream *hell_stream;
+
+static bool hell_pixel(const struct hell_stream *st, size_t pixel) {
+    char c = st->text[pixel / HELL_CELL_PIXELS];
+    size_t pos = pixel % HELL_CELL_PIXELS;
+
+    /* One blank column either side of the glyph */
+    if (pos < HELL_PIXELS || pos >= HELL_PIXELS + HELL_GLYPH_BITS) {
+        return false;
+    }
+    if (c >= 'a' && c <= 'z') c -= 32;
+    if (c < HELL_FIRST_CHAR || c > HELL_LAST_CHAR) {
+        return false;
+    }
+    return fec_get_bit(hell_font, (size_t)(c - HELL_FIRST_CHAR) * HELL_GLYPH_BITS +
+                                  pos - HELL_PIXELS);
+}
+
+static uint64_t pixel_start_us(size_t pixel) {
+    return ((uint64_t)pixel * HELL_CELL_US + HELL_CELL_PIXELS / 2) / HELL_CELL_PIXELS;
+}
+
+/* The engine reads each symbol twice, once ahead to prepare and again at
+ * its boundary, so the last run is kept */
+static int hell_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    struct hell_stream *st = seq->source_ctx;
+
+    if (st->produced && index == st->produced - 1) {
+        *out = st->last_sym;
+        return 0;
+    }
+    if (index != st->produced) {
+        return -EINVAL;
+    }
+    if (st->pixel >= st->pixels) {
+        return -ENODATA;
+    }
+
+    size_t start = st->pixel;
+    bool on = hell_pixel(st, start);
+    do {
+        st->pixel++;
+    } while (st->pixel < st->pixels && hell_pixel(st, st->pixel) == on);
+
+    *out = (tx_symbol_t){0, (uint32_t)(pixel_start_us(st->pixel) - pixel_start_us(start)),
+                         on, false, TX_SHAPE_KEYED};
+    st->last_sym = *out;
+    st->produced++;
+    return 0;
+}
+
+int generate_hell_sequence(const char* text, tx_sequence_t* tx_sequence) {
+    if (!text || !tx_sequence) {
+        return -1;
+    }
+    tx_sequence->mode_name = "Feld-Hell";
+
+    size_t text_len = strlen(text);
+    if (text_len == 0) {
+        return -1;
+    }
+
+    k_free(hell_stream);
+    hell_stream = k_malloc(sizeof(*hell_stream) + text_len + 1);
+    if (!hell_stream) return -2;
+
+    struct hell_stream *st = hell_stream;
+    memcpy(st->text, text, text_len + 1);
+    st->pixel = 0;
+    st->pixels = text_len * HELL_CELL_PIXELS;
+    st->produced = 0;
+
+    tx_sequence->symbols = NULL;
+    tx_sequence->source = hell_symbol;
+    tx_sequence->source_ctx = st;
+    tx_sequence->total_symbols = SIZE_MAX;
+    tx_sequence->current_index = 0;
+    tx_sequence->repeat = false;
+
+    return 0;
+}
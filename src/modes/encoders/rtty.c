@@ -2,152 +2,215 @@
 #include "radio_core.h"
 
 #include <stdint.h>
-#include <ctype.h>
+#include <errno.h>
 #include <string.h>
 #include <zephyr/kernel.h>
 
-#define BAUDOT_LTRS_SHIFT 0x1F
+#define BAUDOT_LTRS_SHIFT RTTY_BAUDOT_LTRS
 #define BAUDOT_FIGS_SHIFT 0x1B
 #define BAUDOT_SPACE      0x04
 #define BAUDOT_CR         0x08
 #define BAUDOT_LF         0x02
 
-const char ITA2_LTRS[32] = {
-    '\0', 'E', '\n', 'A', ' ', 'S', 'I', 'U',
-    '\r', 'D', 'R', 'J', 'N', 'F', 'C', 'K',
-    'T', 'Z', 'L', 'W', 'H', 'Y', 'P', 'Q', 'O',
-    'B', 'G', '\0', 'M', 'X', 'V', '\0'
+typedef enum { SHIFT_ANY, SHIFT_LTRS, SHIFT_FIGS } shift_state_t;
+
+/* Table entries are the 5-bit code plus the shift the character needs */
+#define RTTY_CODE_MASK          0x1F
+#define RTTY_SHIFT_POS          5
+#define RTTY_PACK(code, shift)  ((uint8_t)((code) | ((shift) << RTTY_SHIFT_POS)))
+
+#define ANY(code)   RTTY_PACK(code, SHIFT_ANY)
+#define LTR(code)   RTTY_PACK(code, SHIFT_LTRS)
+#define FIG(code)   RTTY_PACK(code, SHIFT_FIGS)
+
+/* Upper-case ASCII from ' ' to 'Z' to ITA2; 0 where there is no ITA2
+ * character. Codes are never 0 for a mapped character, so 0 also covers
+ * SHIFT_ANY. The four control characters are in ascii_to_ita2. */
+#define ITA2_FIRST  ' '
+#define ITA2_LAST   'Z'
+
+#define A(c) [(c) - ITA2_FIRST]
+
+static const uint8_t ita2_from_ascii[ITA2_LAST - ITA2_FIRST + 1] = {
+    A(' ') = ANY(0x04),
+    A('!') = FIG(0x0D),
+    A('#') = FIG(0x14),
+    A('&') = FIG(0x1A),
+    A('\'') = FIG(0x05),
+    A('(') = FIG(0x0F),
+    A(')') = FIG(0x12),
+    A('+') = FIG(0x11),
+    A(',') = FIG(0x0C),
+    A('-') = FIG(0x03),
+    A('.') = FIG(0x1C),
+    A('/') = FIG(0x1D),
+    A('0') = FIG(0x16),
+    A('1') = FIG(0x17),
+    A('2') = FIG(0x13),
+    A('3') = FIG(0x01),
+    A('4') = FIG(0x0A),
+    A('5') = FIG(0x10),
+    A('6') = FIG(0x15),
+    A('7') = FIG(0x07),
+    A('8') = FIG(0x06),
+    A('9') = FIG(0x18),
+    A(':') = FIG(0x0E),
+    A('=') = FIG(0x1E),
+    A('?') = FIG(0x19),
+    A('A') = LTR(0x03),
+    A('B') = LTR(0x19),
+    A('C') = LTR(0x0E),
+    A('D') = LTR(0x09),
+    A('E') = LTR(0x01),
+    A('F') = LTR(0x0D),
+    A('G') = LTR(0x1A),
+    A('H') = LTR(0x14),
+    A('I') = LTR(0x06),
+    A('J') = LTR(0x0B),
+    A('K') = LTR(0x0F),
+    A('L') = LTR(0x12),
+    A('M') = LTR(0x1C),
+    A('N') = LTR(0x0C),
+    A('O') = LTR(0x18),
+    A('P') = LTR(0x16),
+    A('Q') = LTR(0x17),
+    A('R') = LTR(0x0A),
+    A('S') = LTR(0x05),
+    A('T') = LTR(0x10),
+    A('U') = LTR(0x07),
+    A('V') = LTR(0x1E),
+    A('W') = LTR(0x13),
+    A('X') = LTR(0x1D),
+    A('Y') = LTR(0x15),
+    A('Z') = LTR(0x11),
 };
 
-const char ITA2_FIGS[32] = {
-    '\0', '3', '\n', '-', ' ', '\'', '8', '7',
-    '\r', '\x05', '4', '\a', ',', '!', ':', '(',
-    '5', '+', ')', '2', '#' , '6', '0', '1', '9',
-    '?', '&', '\0', '.', '/', '=', '\0'
+#undef A
+
+struct rtty_stream {
+    rtty_keying_t keying;
+    size_t   chars;
+    uint8_t  codes[];
 };
 
-typedef enum { SHIFT_ANY, SHIFT_LTRS, SHIFT_FIGS } shift_state_t;
+/* Owned by the encoder and replaced by the next call */
+static struct rtty_stream *rtty_stream;
 
-static bool ascii_to_ita2(char c, uint8_t* code, shift_state_t* shift_state) {
-    c = toupper((unsigned char)c);
+static uint8_t ascii_to_ita2(char c) {
+    if (c >= 'a' && c <= 'z') c -= 32;
 
-    if (c == ' ') {
-        *code = BAUDOT_SPACE;
-        *shift_state = SHIFT_ANY;
-        return true;
+    switch (c) {
+        case '\x05': return FIG(0x09);     // WRU
+        case '\a':   return FIG(0x0B);
+        case '\n':   return ANY(0x02);
+        case '\r':   return ANY(0x08);
+        default:
+            break;
     }
+    return (c >= ITA2_FIRST && c <= ITA2_LAST) ? ita2_from_ascii[c - ITA2_FIRST] : 0;
+}
+
+void rtty_keying(const rtty_config_t* config, rtty_keying_t* keying) {
+    keying->bit_us = (uint32_t)(1000000.0f / config->baud_rate);
+    keying->stop_us = (uint32_t)(keying->bit_us * config->stop_bits);
 
-    if (c == '\r') {
-        *code = BAUDOT_CR;
-        *shift_state = SHIFT_ANY;
-        return true;
+    if (config->use_center_freq) {
+        freq_uhz_t half_shift = FREQ_RATIO(config->shift_hz, 2);
+        keying->mark_offset  = config->reverse_shift ? -half_shift : half_shift;
+        keying->space_offset = config->reverse_shift ? half_shift : -half_shift;
+    } else {
+        keying->mark_offset  = config->reverse_shift ? FREQ_HZ(config->shift_hz) : 0;
+        keying->space_offset = config->reverse_shift ? 0 : FREQ_HZ(config->shift_hz);
     }
+}
 
-    if (c == '\n') {
-        *code = BAUDOT_LF;
-        *shift_state = SHIFT_ANY;
-        return true;
+int rtty_encode_char(char c, bool* figs, bool unshift_on_space, uint8_t out[2]) {
+    uint8_t entry = ascii_to_ita2(c);
+    if (!entry) {
+        return 0;
     }
 
-    for (int i = 0; i < 32; i++) {
-        if (ITA2_LTRS[i] == c) {
-            *code = (uint8_t)i;
-            *shift_state = SHIFT_LTRS;
-            return true;
-        }
+    shift_state_t req_shift = entry >> RTTY_SHIFT_POS;
+    uint8_t code = entry & RTTY_CODE_MASK;
+    int n = 0;
+
+    if (req_shift != SHIFT_ANY && (req_shift == SHIFT_FIGS) != *figs) {
+        out[n++] = (req_shift == SHIFT_LTRS) ? BAUDOT_LTRS_SHIFT : BAUDOT_FIGS_SHIFT;
+        *figs = (req_shift == SHIFT_FIGS);
     }
 
-    for (int i = 0; i < 32; i++) {
-        if (ITA2_FIGS[i] == c) {
-            *code = (uint8_t)i;
-            *shift_state = SHIFT_FIGS;
-            return true;
-        }
+    out[n++] = code;
+
+    /* The receiver drops back to letters on a space */
+    if (code == BAUDOT_SPACE && unshift_on_space) {
+        *figs = false;
     }
+    return n;
+}
 
-    return false;
+void rtty_code_symbol(const rtty_keying_t* keying, uint8_t code, int pos, tx_symbol_t* out) {
+    if (pos == 0) {
+        *out = (tx_symbol_t){keying->space_offset, keying->bit_us, true};
+    } else if (pos == RTTY_SYMBOLS_PER_CHAR - 1) {
+        *out = (tx_symbol_t){keying->mark_offset, keying->stop_us, true};
+    } else {
+        /* Data bits go out LSB first */
+        bool is_mark = (code >> (pos - 1)) & 0x01;
+        *out = (tx_symbol_t){is_mark ? keying->mark_offset : keying->space_offset,
+                             keying->bit_us, true};
+    }
 }
 
-static void push_baudot(uint8_t baudot_code, tx_symbol_t* symbols, size_t* index,
-                        uint32_t bit_usec, uint32_t stop_usec, float mark_offset, 
-                        float space_offset) {
-    symbols[*index] = (tx_symbol_t){space_offset, bit_usec, true};
-    (*index)++;
+static int rtty_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    const struct rtty_stream *st = seq->source_ctx;
+    size_t ch = index / RTTY_SYMBOLS_PER_CHAR;
 
-    for (int b = 0; b < 5; b++) {
-        bool is_mark = (baudot_code >> b) & 0x01;
-        symbols[*index] = (tx_symbol_t){is_mark ? mark_offset : space_offset, bit_usec, true};
-        (*index)++;
+    if (ch >= st->chars) {
+        return -EINVAL;
     }
 
-    symbols[*index] = (tx_symbol_t){mark_offset, stop_usec, true};
-    (*index)++;
+    rtty_code_symbol(&st->keying, st->codes[ch], index % RTTY_SYMBOLS_PER_CHAR, out);
+    return 0;
 }
 
 int generate_rtty_sequence(const char* text, const rtty_config_t* config, 
                             tx_sequence_t* tx_sequence) {
-    tx_sequence->mode_name = "RTTY";
     if (!text || !config || !tx_sequence) {
         return -1;
     }
+    tx_sequence->mode_name = "RTTY";
 
-    uint32_t bit_usec = (uint32_t)(1000000.0f / config->baud_rate);
-    uint32_t stop_us = (uint32_t)(bit_usec * config->stop_bits);
-
-    float mark_offset, space_offset;
-    
-    if (config->use_center_freq) {
-        float half_shift = config->shift_hz / 2.0f;
-        mark_offset  = config->reverse_shift ? -half_shift : half_shift;
-        space_offset = config->reverse_shift ? half_shift : -half_shift;
-    } else {
-        mark_offset  = config->reverse_shift ? config->shift_hz : 0;
-        space_offset = config->reverse_shift ? 0 : config->shift_hz;
-    }
-
-    size_t baudot_char_count = 0;
-    shift_state_t current_state = SHIFT_LTRS;
     size_t text_len = strlen(text);
 
-    for (size_t i = 0; i < text_len; i++) {
-        uint8_t code;
-        shift_state_t req_shift;
-        
-        if (ascii_to_ita2(text[i], &code, &req_shift)) {
-            if (req_shift != SHIFT_ANY && req_shift != current_state) {
-                baudot_char_count++; 
-                current_state = req_shift;
-            }
-            baudot_char_count++; 
-        }
-    }
+    /* Worst case every character needs a shift ahead of it */
+    size_t capacity = config->diddles + 2 * text_len;
 
-    size_t required_symbols = baudot_char_count * 7;
+    k_free(rtty_stream);
+    rtty_stream = k_malloc(sizeof(*rtty_stream) + capacity);
+    if (!rtty_stream) return -2;
 
-    tx_sequence->symbols = (tx_symbol_t*)k_malloc(required_symbols * sizeof(tx_symbol_t));
-    if (!tx_sequence->symbols) return -2; 
+    struct rtty_stream *st = rtty_stream;
+    rtty_keying(config, &st->keying);
 
-    tx_sequence->total_symbols = required_symbols;
-    tx_sequence->current_index = 0;
+    /* The receiver is assumed to start in LTRS; diddles keep it there */
+    bool figs = false;
+    size_t n = 0;
 
-    size_t sym_idx = 0;
-    current_state = SHIFT_LTRS;
+    for (uint8_t i = 0; i < config->diddles; i++) {
+        st->codes[n++] = BAUDOT_LTRS_SHIFT;
+    }
 
     for (size_t i = 0; i < text_len; i++) {
-        uint8_t code;
-        shift_state_t req_shift;
-        
-        if (ascii_to_ita2(text[i], &code, &req_shift)) {
-            
-            if (req_shift != SHIFT_ANY && req_shift != current_state) {
-                uint8_t shift_code = (req_shift == SHIFT_LTRS) ? BAUDOT_LTRS_SHIFT : BAUDOT_FIGS_SHIFT;
-                push_baudot(shift_code, tx_sequence->symbols, &sym_idx, bit_usec, stop_us, mark_offset, space_offset);
-                current_state = req_shift;
-            }
-            
-            push_baudot(code, tx_sequence->symbols, &sym_idx, bit_usec, stop_us, mark_offset, space_offset);
-        }
+        n += rtty_encode_char(text[i], &figs, config->unshift_on_space, &st->codes[n]);
     }
 
+    st->chars = n;
+
+    tx_sequence->symbols = NULL;
+    tx_sequence->source = rtty_symbol;
+    tx_sequence->source_ctx = st;
+    tx_sequence->total_symbols = n * RTTY_SYMBOLS_PER_CHAR;
+    tx_sequence->current_index = 0;
+
     return 0;
 }
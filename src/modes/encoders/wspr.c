@@ -1,28 +1,48 @@
 #include "modes/encoders/wspr.h"
 #include "radio_core.h"
+#include "modes/fec.h"
 
 #include <string.h>
 #include <ctype.h>
 #include <stdint.h>
+#include <errno.h>
 #include <zephyr/kernel.h>
 
 #define WSPR_SYMBOL_COUNT   162
-#define WSPR_MSG_BYTES      11
-
-static const uint8_t sync_vector[WSPR_SYMBOL_COUNT] = {
-    1,1,0,0,0,0,0,0,1,0,0,0,1,1,1,0,0,0,1,0,
-    0,1,0,1,1,1,1,0,0,0,0,0,0,0,1,0,0,1,0,1,
-    0,0,0,0,0,0,1,0,1,1,0,0,1,1,0,1,0,0,0,1,
-    1,0,1,0,0,0,0,1,1,0,1,0,1,0,1,0,1,0,0,1,
-    0,0,1,0,1,1,0,0,0,1,1,0,1,0,1,0,0,0,1,0,
-    0,0,0,0,1,0,0,1,0,0,1,1,1,0,1,1,0,0,1,1,
-    0,1,0,0,0,1,1,1,0,0,0,0,0,1,0,1,0,0,1,1,
-    0,0,0,0,0,0,0,1,1,0,1,0,1,1,0,0,0,1,1,0,
-    0,0
+
+/* Convolutional code K=32, r=1/2: the 50 message bits followed by 31 zero
+ * bits give 162 coded bits, two per input bit. */
+static const uint32_t wspr_polys[2] = { 0xF2D05351u, 0xE4613C47u };
+static const struct fec_conv wspr_code = { 32, 2, wspr_polys };
+
+/* Sync bit of each channel symbol, MSB first */
+static const uint8_t sync_bits[21] = {
+    0xC0, 0x8E, 0x25, 0xE0, 0x25, 0x02, 0xCD, 0x1A, 0x1A, 0xA9, 0x2C,
+    0x6A, 0x20, 0x93, 0xB3, 0x47, 0x05, 0x30, 0x1A, 0xC6, 0x00
+};
+
+/* Bit-reversal interleaver: channel symbol i carries coded bit
+ * interleave_src[i] */
+static const uint8_t interleave_src[WSPR_SYMBOL_COUNT] = {
+      0,  81,  41, 122,  21, 102,  61, 142,  11,  92,  51, 132,  31, 112,  71, 152,
+      6,  87,  46, 127,  26, 107,  66, 147,  16,  97,  56, 137,  36, 117,  76, 157,
+      3,  84,  44, 125,  24, 105,  64, 145,  14,  95,  54, 135,  34, 115,  74, 155,
+      9,  90,  49, 130,  29, 110,  69, 150,  19, 100,  59, 140,  39, 120,  79, 160,
+      2,  83,  43, 124,  23, 104,  63, 144,  13,  94,  53, 134,  33, 114,  73, 154,
+      8,  89,  48, 129,  28, 109,  68, 149,  18,  99,  58, 139,  38, 119,  78, 159,
+      5,  86,  45, 126,  25, 106,  65, 146,  15,  96,  55, 136,  35, 116,  75, 156,
+     10,  91,  50, 131,  30, 111,  70, 151,  20, 101,  60, 141,  40, 121,  80, 161,
+      1,  82,  42, 123,  22, 103,  62, 143,  12,  93,  52, 133,  32, 113,  72, 153,
+      7,  88,  47, 128,  27, 108,  67, 148,  17,  98,  57, 138,  37, 118,  77, 158,
+      4,  85,
 };
 
+/* The message as sent, MSB first from the callsign MSB */
+static uint8_t wspr_message[WSPR_MESSAGE_BYTES];
+
 #define WSPR_SYMBOL_US      682667U
-#define WSPR_TONE_SPACING   1.4648f
+/* Tones are 12000/8192 Hz apart, one FFT bin of the receiver */
+#define WSPR_TONE_OFFSET(t) FREQ_RATIO((t) * 12000, 8192)
 
 static const int valid_powers[] = {
     0, 3, 7, 10, 13, 17, 20, 23, 27, 30, 33, 37, 40, 43, 47, 50, 53, 57, 60
@@ -56,22 +76,6 @@ static int callsign_char_value(char c) {
     return 36;
 }
 
-static uint8_t parity(uint32_t v) {
-    v ^= v >> 16;
-    v ^= v >> 8;
-    v ^= v >> 4;
-    v ^= v >> 2;
-    v ^= v >> 1;
-    return (uint8_t)(v & 1);
-}
-
-static uint8_t bit_reverse8(uint8_t v) {
-    v = ((v & 0xF0) >> 4) | ((v & 0x0F) << 4);
-    v = ((v & 0xCC) >> 2) | ((v & 0x33) << 2);
-    v = ((v & 0xAA) >> 1) | ((v & 0x55) << 1);
-    return v;
-}
-
 static bool validate_callsign(const char* callsign) {
     size_t len = strlen(callsign);
     if (len < 2 || len > 6) {
@@ -150,115 +154,74 @@ static int32_t encode_grid_power(const char* grid, int power) {
     return M;
 }
 
-static void pack_message(uint32_t N, int32_t M, uint8_t packed[WSPR_MSG_BYTES]) {
-    memset(packed, 0, WSPR_MSG_BYTES);
+/* Channel symbol i straight from the message: the coded bit the
+ * interleaver puts there, times two, plus the sync bit */
+static uint8_t wspr_channel_symbol(const uint8_t *message, size_t i) {
+    uint8_t src = interleave_src[i];
+    uint32_t state = fec_conv_state(&wspr_code, message, WSPR_MESSAGE_BITS, src >> 1);
+    uint8_t data = fec_conv_output(&wspr_code, state, src & 1);
+    uint8_t sync = (sync_bits[i / 8] >> (7 - (i % 8))) & 1;
 
-    packed[0] = (N >> 20) & 0xFF;
-    packed[1] = (N >> 12) & 0xFF;
-    packed[2] = (N >>  4) & 0xFF;
-    packed[3] = ((N & 0x0F) << 4) | ((M >> 18) & 0x0F);
-    packed[4] = (M >> 10) & 0xFF;
-    packed[5] = (M >>  2) & 0xFF;
-    packed[6] = (M & 0x03) << 6;
+    return data * 2 + sync;
 }
 
-static void convolve(const uint8_t packed[WSPR_MSG_BYTES],
-                     uint8_t convolved[WSPR_SYMBOL_COUNT]) {
-    uint32_t shift_reg = 0;
-    int out_idx = 0;
+static int wspr_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    const uint8_t *message = seq->source_ctx;
 
-    for (int i = 0; i < WSPR_MSG_BYTES && out_idx < WSPR_SYMBOL_COUNT; i++) {
-        for (int j = 7; j >= 0 && out_idx < WSPR_SYMBOL_COUNT; j--) {
-            uint8_t input_bit = (packed[i] >> j) & 1;
-            shift_reg = (shift_reg << 1) | input_bit;
-
-            convolved[out_idx++] = parity(shift_reg & 0xF2D05351);
-            convolved[out_idx++] = parity(shift_reg & 0xE4613C47);
-        }
+    if (index >= WSPR_SYMBOL_COUNT) {
+        return -EINVAL;
     }
-}
 
-static void interleave(const uint8_t convolved[WSPR_SYMBOL_COUNT],
-                       uint8_t interleaved[WSPR_SYMBOL_COUNT]) {
-    int src = 0;
+    *out = (tx_symbol_t){
+        .freq_offset_uhz = WSPR_TONE_OFFSET(wspr_channel_symbol(message, index)),
+        .duration_us     = WSPR_SYMBOL_US,
+        .tx_on           = true,
+    };
+    return 0;
+}
 
-    for (int j = 0; j < 256 && src < WSPR_SYMBOL_COUNT; j++) {
-        uint8_t rev = bit_reverse8((uint8_t)j);
-        if (rev < WSPR_SYMBOL_COUNT) {
-            interleaved[rev] = convolved[src++];
-        }
+int wspr_pack_message(const wspr_payload_t *payload, uint8_t message[WSPR_MESSAGE_BYTES]) {
+    if (!validate_callsign(payload->callsign)) {
+        return -1;
     }
-}
 
-static void merge_sync(const uint8_t interleaved[WSPR_SYMBOL_COUNT],
-                       uint8_t symbols[WSPR_SYMBOL_COUNT]) {
-    for (int i = 0; i < WSPR_SYMBOL_COUNT; i++) {
-        symbols[i] = interleaved[i] * 2 + sync_vector[i];
+    if (!validate_grid(payload->grid)) {
+        return -1;
     }
-}
 
-static int wspr_encode(const char* callsign, const char* grid, int power,
-                       uint8_t symbols[WSPR_SYMBOL_COUNT]) {
-    uint32_t N = encode_callsign(callsign);
-    int32_t  M = encode_grid_power(grid, power);
+    if (!is_valid_power(payload->power_dbm)) {
+        return -1;
+    }
 
+    uint32_t N = encode_callsign(payload->callsign);
+    int32_t  M = encode_grid_power(payload->grid, payload->power_dbm);
     if (M < 0) {
         return -1;
     }
 
-    uint8_t packed[WSPR_MSG_BYTES];
-    pack_message(N, M, packed);
-
-    uint8_t convolved[WSPR_SYMBOL_COUNT];
-    convolve(packed, convolved);
-
-    uint8_t interleaved[WSPR_SYMBOL_COUNT];
-    interleave(convolved, interleaved);
-
-    merge_sync(interleaved, symbols);
+    /* 28-bit callsign then 22-bit locator and power */
+    uint64_t packed = ((uint64_t)N << 36) | ((uint64_t)M << 14);
+    for (int i = 0; i < WSPR_MESSAGE_BYTES; i++) {
+        message[i] = (uint8_t)(packed >> (56 - 8 * i));
+    }
 
     return 0;
 }
 
 int generate_wspr_sequence(const wspr_payload_t* payload, tx_sequence_t* tx_sequence) {
-    tx_sequence->mode_name = "WSPR";
-
     if (!payload || !tx_sequence) {
         return -1;
     }
 
-    if (!validate_callsign(payload->callsign)) {
-        return -1;
-    }
-
-    if (!validate_grid(payload->grid)) {
-        return -1;
-    }
-
-    if (!is_valid_power(payload->power_dbm)) {
-        return -1;
-    }
+    tx_sequence->mode_name = "WSPR";
 
-    uint8_t channel_symbols[WSPR_SYMBOL_COUNT];
-    if (wspr_encode(payload->callsign, payload->grid,
-                    payload->power_dbm, channel_symbols) != 0) {
+    if (wspr_pack_message(payload, wspr_message)) {
         return -1;
     }
 
-    tx_sequence->symbols = (tx_symbol_t *)k_malloc(
-        WSPR_SYMBOL_COUNT * sizeof(tx_symbol_t));
-    if (!tx_sequence->symbols) {
-        return -2;
-    }
-
-    for (int i = 0; i < WSPR_SYMBOL_COUNT; i++) {
-        tx_sequence->symbols[i] = (tx_symbol_t){
-            .freq_offset_hz = channel_symbols[i] * WSPR_TONE_SPACING,
-            .duration_us    = WSPR_SYMBOL_US,
-            .tx_on          = true,
-        };
-    }
-
+    tx_sequence->symbols = NULL;
+    tx_sequence->source = wspr_symbol;
+    tx_sequence->source_ctx = wspr_message;
     tx_sequence->total_symbols = WSPR_SYMBOL_COUNT;
     tx_sequence->current_index = 0;
 
@@ -0,0 +1,186 @@
+#include "modes/fec.h"
+
+#include <string.h>
+
+static const uint32_t crc14_table[256] = {
+    0x0000, 0x2757, 0x29f9, 0x0eae, 0x34a5, 0x13f2, 0x1d5c, 0x3a0b,
+    0x0e1d, 0x294a, 0x27e4, 0x00b3, 0x3ab8, 0x1def, 0x1341, 0x3416,
+    0x1c3a, 0x3b6d, 0x35c3, 0x1294, 0x289f, 0x0fc8, 0x0166, 0x2631,
+    0x1227, 0x3570, 0x3bde, 0x1c89, 0x2682, 0x01d5, 0x0f7b, 0x282c,
+    0x3874, 0x1f23, 0x118d, 0x36da, 0x0cd1, 0x2b86, 0x2528, 0x027f,
+    0x3669, 0x113e, 0x1f90, 0x38c7, 0x02cc, 0x259b, 0x2b35, 0x0c62,
+    0x244e, 0x0319, 0x0db7, 0x2ae0, 0x10eb, 0x37bc, 0x3912, 0x1e45,
+    0x2a53, 0x0d04, 0x03aa, 0x24fd, 0x1ef6, 0x39a1, 0x370f, 0x1058,
+    0x17bf, 0x30e8, 0x3e46, 0x1911, 0x231a, 0x044d, 0x0ae3, 0x2db4,
+    0x19a2, 0x3ef5, 0x305b, 0x170c, 0x2d07, 0x0a50, 0x04fe, 0x23a9,
+    0x0b85, 0x2cd2, 0x227c, 0x052b, 0x3f20, 0x1877, 0x16d9, 0x318e,
+    0x0598, 0x22cf, 0x2c61, 0x0b36, 0x313d, 0x166a, 0x18c4, 0x3f93,
+    0x2fcb, 0x089c, 0x0632, 0x2165, 0x1b6e, 0x3c39, 0x3297, 0x15c0,
+    0x21d6, 0x0681, 0x082f, 0x2f78, 0x1573, 0x3224, 0x3c8a, 0x1bdd,
+    0x33f1, 0x14a6, 0x1a08, 0x3d5f, 0x0754, 0x2003, 0x2ead, 0x09fa,
+    0x3dec, 0x1abb, 0x1415, 0x3342, 0x0949, 0x2e1e, 0x20b0, 0x07e7,
+    0x2f7e, 0x0829, 0x0687, 0x21d0, 0x1bdb, 0x3c8c, 0x3222, 0x1575,
+    0x2163, 0x0634, 0x089a, 0x2fcd, 0x15c6, 0x3291, 0x3c3f, 0x1b68,
+    0x3344, 0x1413, 0x1abd, 0x3dea, 0x07e1, 0x20b6, 0x2e18, 0x094f,
+    0x3d59, 0x1a0e, 0x14a0, 0x33f7, 0x09fc, 0x2eab, 0x2005, 0x0752,
+    0x170a, 0x305d, 0x3ef3, 0x19a4, 0x23af, 0x04f8, 0x0a56, 0x2d01,
+    0x1917, 0x3e40, 0x30ee, 0x17b9, 0x2db2, 0x0ae5, 0x044b, 0x231c,
+    0x0b30, 0x2c67, 0x22c9, 0x059e, 0x3f95, 0x18c2, 0x166c, 0x313b,
+    0x052d, 0x227a, 0x2cd4, 0x0b83, 0x3188, 0x16df, 0x1871, 0x3f26,
+    0x38c1, 0x1f96, 0x1138, 0x366f, 0x0c64, 0x2b33, 0x259d, 0x02ca,
+    0x36dc, 0x118b, 0x1f25, 0x3872, 0x0279, 0x252e, 0x2b80, 0x0cd7,
+    0x24fb, 0x03ac, 0x0d02, 0x2a55, 0x105e, 0x3709, 0x39a7, 0x1ef0,
+    0x2ae6, 0x0db1, 0x031f, 0x2448, 0x1e43, 0x3914, 0x37ba, 0x10ed,
+    0x00b5, 0x27e2, 0x294c, 0x0e1b, 0x3410, 0x1347, 0x1de9, 0x3abe,
+    0x0ea8, 0x29ff, 0x2751, 0x0006, 0x3a0d, 0x1d5a, 0x13f4, 0x34a3,
+    0x1c8f, 0x3bd8, 0x3576, 0x1221, 0x282a, 0x0f7d, 0x01d3, 0x2684,
+    0x1292, 0x35c5, 0x3b6b, 0x1c3c, 0x2637, 0x0160, 0x0fce, 0x2899,
+};
+
+const struct fec_crc fec_crc14 = { 14, 0x2757, crc14_table };
+
+static const uint32_t crc24_table[256] = {
+    0x000000, 0x00065b, 0x000cb6, 0x000aed, 0x00196c, 0x001f37, 0x0015da, 0x001381,
+    0x0032d8, 0x003483, 0x003e6e, 0x003835, 0x002bb4, 0x002def, 0x002702, 0x002159,
+    0x0065b0, 0x0063eb, 0x006906, 0x006f5d, 0x007cdc, 0x007a87, 0x00706a, 0x007631,
+    0x005768, 0x005133, 0x005bde, 0x005d85, 0x004e04, 0x00485f, 0x0042b2, 0x0044e9,
+    0x00cb60, 0x00cd3b, 0x00c7d6, 0x00c18d, 0x00d20c, 0x00d457, 0x00deba, 0x00d8e1,
+    0x00f9b8, 0x00ffe3, 0x00f50e, 0x00f355, 0x00e0d4, 0x00e68f, 0x00ec62, 0x00ea39,
+    0x00aed0, 0x00a88b, 0x00a266, 0x00a43d, 0x00b7bc, 0x00b1e7, 0x00bb0a, 0x00bd51,
+    0x009c08, 0x009a53, 0x0090be, 0x0096e5, 0x008564, 0x00833f, 0x0089d2, 0x008f89,
+    0x0196c0, 0x01909b, 0x019a76, 0x019c2d, 0x018fac, 0x0189f7, 0x01831a, 0x018541,
+    0x01a418, 0x01a243, 0x01a8ae, 0x01aef5, 0x01bd74, 0x01bb2f, 0x01b1c2, 0x01b799,
+    0x01f370, 0x01f52b, 0x01ffc6, 0x01f99d, 0x01ea1c, 0x01ec47, 0x01e6aa, 0x01e0f1,
+    0x01c1a8, 0x01c7f3, 0x01cd1e, 0x01cb45, 0x01d8c4, 0x01de9f, 0x01d472, 0x01d229,
+    0x015da0, 0x015bfb, 0x015116, 0x01574d, 0x0144cc, 0x014297, 0x01487a, 0x014e21,
+    0x016f78, 0x016923, 0x0163ce, 0x016595, 0x017614, 0x01704f, 0x017aa2, 0x017cf9,
+    0x013810, 0x013e4b, 0x0134a6, 0x0132fd, 0x01217c, 0x012727, 0x012dca, 0x012b91,
+    0x010ac8, 0x010c93, 0x01067e, 0x010025, 0x0113a4, 0x0115ff, 0x011f12, 0x011949,
+    0x032d80, 0x032bdb, 0x032136, 0x03276d, 0x0334ec, 0x0332b7, 0x03385a, 0x033e01,
+    0x031f58, 0x031903, 0x0313ee, 0x0315b5, 0x030634, 0x03006f, 0x030a82, 0x030cd9,
+    0x034830, 0x034e6b, 0x034486, 0x0342dd, 0x03515c, 0x035707, 0x035dea, 0x035bb1,
+    0x037ae8, 0x037cb3, 0x03765e, 0x037005, 0x036384, 0x0365df, 0x036f32, 0x036969,
+    0x03e6e0, 0x03e0bb, 0x03ea56, 0x03ec0d, 0x03ff8c, 0x03f9d7, 0x03f33a, 0x03f561,
+    0x03d438, 0x03d263, 0x03d88e, 0x03ded5, 0x03cd54, 0x03cb0f, 0x03c1e2, 0x03c7b9,
+    0x038350, 0x03850b, 0x038fe6, 0x0389bd, 0x039a3c, 0x039c67, 0x03968a, 0x0390d1,
+    0x03b188, 0x03b7d3, 0x03bd3e, 0x03bb65, 0x03a8e4, 0x03aebf, 0x03a452, 0x03a209,
+    0x02bb40, 0x02bd1b, 0x02b7f6, 0x02b1ad, 0x02a22c, 0x02a477, 0x02ae9a, 0x02a8c1,
+    0x028998, 0x028fc3, 0x02852e, 0x028375, 0x0290f4, 0x0296af, 0x029c42, 0x029a19,
+    0x02def0, 0x02d8ab, 0x02d246, 0x02d41d, 0x02c79c, 0x02c1c7, 0x02cb2a, 0x02cd71,
+    0x02ec28, 0x02ea73, 0x02e09e, 0x02e6c5, 0x02f544, 0x02f31f, 0x02f9f2, 0x02ffa9,
+    0x027020, 0x02767b, 0x027c96, 0x027acd, 0x02694c, 0x026f17, 0x0265fa, 0x0263a1,
+    0x0242f8, 0x0244a3, 0x024e4e, 0x024815, 0x025b94, 0x025dcf, 0x025722, 0x025179,
+    0x021590, 0x0213cb, 0x021926, 0x021f7d, 0x020cfc, 0x020aa7, 0x02004a, 0x020611,
+    0x022748, 0x022113, 0x022bfe, 0x022da5, 0x023e24, 0x02387f, 0x023292, 0x0234c9,
+};
+
+const struct fec_crc fec_crc24 = { 24, 0x00065B, crc24_table };
+
+void fec_put_bits(uint8_t *dst, size_t pos, const uint32_t *words, size_t nbits) {
+    for (size_t i = 0; i < nbits; i += 8) {
+        /* Next eight source bits, which may straddle two words */
+        size_t w = i / 32, sh = i % 32;
+        uint32_t top = words[w] << sh;
+        if (sh > 24 && (w + 1) * 32 < nbits) {
+            top |= words[w + 1] >> (32 - sh);
+        }
+        uint8_t byte = top >> 24;
+        if (nbits - i < 8) {
+            byte &= 0xFF << (8 - (nbits - i));
+        }
+
+        size_t d = pos + i;
+        dst[d / 8] |= byte >> (d % 8);
+        uint8_t spill = (uint8_t)(byte << (8 - d % 8));
+        if (d % 8 && spill) {
+            dst[d / 8 + 1] |= spill;
+        }
+    }
+}
+
+uint32_t fec_crc(const struct fec_crc *crc, const uint8_t *bits, size_t nbits) {
+    int top = crc->width - 8;
+    uint32_t mask = (uint32_t)((1ULL << crc->width) - 1);
+    uint32_t reg = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= nbits; i += 8) {
+        reg = ((reg << 8) ^ crc->table[((reg >> top) ^ bits[i / 8]) & 0xFF]) & mask;
+    }
+
+    /* Trailing bits one at a time */
+    for (; i < nbits; i++) {
+        uint32_t fb = ((reg >> (crc->width - 1)) ^ fec_get_bit(bits, i)) & 1;
+        reg = ((reg << 1) ^ (fb ? crc->poly : 0)) & mask;
+    }
+
+    return reg;
+}
+
+void fec_crc_make_table(uint8_t width, uint32_t poly, uint32_t table[256]) {
+    uint32_t mask = (uint32_t)((1ULL << width) - 1);
+
+    for (uint32_t b = 0; b < 256; b++) {
+        uint32_t reg = b << (width - 8);
+        for (int i = 0; i < 8; i++) {
+            reg = ((reg << 1) ^ ((reg >> (width - 1)) & 1 ? poly : 0)) & mask;
+        }
+        table[b] = reg;
+    }
+}
+
+void fec_block_parity(const uint32_t *columns, size_t parity_words,
+                      const uint8_t *msg, size_t k, uint32_t *parity) {
+    memset(parity, 0, parity_words * sizeof(*parity));
+
+    /* Branch-free: a clear message bit masks its column to zero */
+    for (size_t j = 0; j < k; j++) {
+        uint32_t sel = -(uint32_t)fec_get_bit(msg, j);
+        const uint32_t *col = &columns[j * parity_words];
+        for (size_t w = 0; w < parity_words; w++) {
+            parity[w] ^= col[w] & sel;
+        }
+    }
+}
+
+uint32_t fec_conv_state(const struct fec_conv *code, const uint8_t *msg,
+                        size_t nbits, size_t k) {
+    if (nbits == 0) {
+        return 0;
+    }
+
+    /* The register is a window of the message, read from the five bytes
+     * up to the one holding its newest message bit rather than a bit at
+     * a time; in the tail it is that window shifted up by the flushed
+     * zeros. Bits before the message read as zero. */
+    size_t last = k < nbits ? k : nbits - 1;
+    size_t tail = k - last;
+    if (tail >= code->constraint) {
+        return 0;
+    }
+
+    uint64_t window = 0;
+    size_t byte = last / 8;
+    for (size_t b = 5; b-- > 0;) {
+        window = (window << 8) | (byte >= b ? msg[byte - b] : 0);
+    }
+    window = (window >> (7 - last % 8)) << tail;
+
+    uint32_t mask = code->constraint < 32 ? (1u << code->constraint) - 1 : UINT32_MAX;
+    return (uint32_t)window & mask;
+}
+
+void fec_conv_encode(const struct fec_conv *code, const uint8_t *msg, size_t nbits,
+                     uint8_t *out) {
+    uint32_t state = 0;
+    size_t pos = 0;
+
+    for (size_t k = 0; k < nbits + code->constraint - 1; k++) {
+        state = (state << 1) | (k < nbits ? fec_get_bit(msg, k) : 0);
+        for (int j = 0; j < code->rate; j++, pos++) {
+            if (fec_conv_output(code, state, j)) {
+                out[pos / 8] |= 0x80 >> (pos % 8);
+            }
+        }
+    }
+}
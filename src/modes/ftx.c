@@ -1,49 +1,57 @@
 #include "modes/ftx.h"
+#include "modes/fec.h"
+#include "modes/ftx_callhash.h"
 
+#include <errno.h>
 #include <stdint.h>
+#include <string.h>
 
 #define C28_OFFSET_CQ_DIGITS 3
 #define C28_OFFSET_CQ_CHAR  1004
 #define MAXGRID4 32400
 
+/* Byte-aligned chunks of up to eight bits per step, MSB first */
 static void pack_bits(uint8_t *buf, int bit_pos, uint64_t value, int nbits) {
-    for (int i = nbits - 1; i >= 0; i--) {
-        int pos = bit_pos + (nbits - 1 - i);
-        int byte_idx = pos / 8;
-        int bit_idx = 7 - (pos % 8);
-        if (value & (1ULL << i)) {
-            buf[byte_idx] |= (1 << bit_idx);
-        } else {
-            buf[byte_idx] &= ~(1 << bit_idx);
-        }
+    while (nbits > 0) {
+        int byte_idx = bit_pos / 8;
+        int room = 8 - (bit_pos % 8);
+        int n = nbits < room ? nbits : room;
+        uint8_t chunk = (uint8_t)(value >> (nbits - n)) & ((1u << n) - 1);
+        uint8_t mask = (uint8_t)(((1u << n) - 1) << (room - n));
+
+        buf[byte_idx] = (buf[byte_idx] & ~mask) | (chunk << (room - n));
+        bit_pos += n;
+        nbits -= n;
     }
 }
 
 static uint64_t unpack_bits(const uint8_t *buf, int bit_pos, int nbits) {
     uint64_t value = 0;
-    for (int i = 0; i < nbits; i++) {
-        int pos = bit_pos + i;
-        int byte_idx = pos / 8;
-        int bit_idx = 7 - (pos % 8);
-        if (buf[byte_idx] & (1 << bit_idx)) {
-            value |= (1ULL << (nbits - 1 - i));
-        }
+    while (nbits > 0) {
+        int room = 8 - (bit_pos % 8);
+        int n = nbits < room ? nbits : room;
+        uint8_t chunk = (buf[bit_pos / 8] >> (room - n)) & ((1u << n) - 1);
+
+        value = (value << n) | chunk;
+        bit_pos += n;
+        nbits -= n;
     }
     return value;
 }
 
+/* Source bits are loaded 64 at a time and written with pack_bits */
 static void pack_bytes(uint8_t *buf, int bit_pos, const uint8_t *src, int nbits) {
-    for (int i = 0; i < nbits; i++) {
-        int src_byte = i / 8;
-        int src_bit = 7 - (i % 8);
-        int dst_pos = bit_pos + i;
-        int dst_byte = dst_pos / 8;
-        int dst_bit = 7 - (dst_pos % 8);
-        if (src[src_byte] & (1 << src_bit)) {
-            buf[dst_byte] |= (1 << dst_bit);
-        } else {
-            buf[dst_byte] &= ~(1 << dst_bit);
+    while (nbits > 0) {
+        int n = nbits < 64 ? nbits : 64;
+        int nbytes = (n + 7) / 8;
+        uint64_t acc = 0;
+        for (int i = 0; i < nbytes; i++) {
+            acc = (acc << 8) | src[i];
         }
+        pack_bits(buf, bit_pos, acc >> (nbytes * 8 - n), n);
+        src += nbytes;
+        bit_pos += n;
+        nbits -= n;
     }
 }
 
@@ -59,6 +67,158 @@ static void payload_set_n3(uint8_t *buf, uint8_t n3) {
     pack_bits(buf, 71, n3 & 0x07, 3);
 }
 
+/* ASCII to alphabet index, lower case folded; characters outside the
+ * alphabet map to 0 (blank). f71: " 0-9A-Z+-./?", c58: " 0-9A-Z/".
+ * Both share " 0-9A-Z" and differ only in the punctuation after it. */
+static uint8_t alnum_index(char c) {
+    if (c >= '0' && c <= '9') return c - '0' + 1;
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 11;
+    if (c >= 'a' && c <= 'z') return c - 'a' + 11;
+    return 0;
+}
+
+static uint8_t f71_index(char c) {
+    switch (c) {
+        case '+': return 37;
+        case '-': return 38;
+        case '.': return 39;
+        case '/': return 40;
+        case '?': return 41;
+        default:  return alnum_index(c);
+    }
+}
+
+static uint8_t c58_index(char c) {
+    return c == '/' ? 37 : alnum_index(c);
+}
+
+/* The c28 alphabets are slices of the c58 one */
+static inline uint32_t c28_a1(char c) {      // " 0-9A-Z"
+    uint8_t v = c58_index(c);
+    return v <= 36 ? v : 0;
+}
+
+static inline uint32_t c28_a2(char c) {      // "0-9A-Z"
+    uint8_t v = c58_index(c);
+    return (v >= 1 && v <= 36) ? v - 1 : 0;
+}
+
+static inline uint32_t c28_a3(char c) {      // "0-9"
+    uint8_t v = c58_index(c);
+    return (v >= 1 && v <= 10) ? v - 1 : 0;
+}
+
+static inline uint32_t c28_a4(char c) {      // " A-Z"
+    uint8_t v = c58_index(c);
+    return (v >= 11 && v <= 36) ? v - 10 : 0;
+}
+
+/* ARRL sections and states/provinces as up to three letters, 5 bits each,
+ * found through a multiplicative perfect hash into 256 slots. A slot
+ * holds index + 1 and the key is compared to reject non-members. */
+#define LETTERS(a, b, c) ((uint16_t)((((a) - '@') << 10) | (((b) - '@') << 5) | \
+                                     ((c) ? (c) - '@' : 0)))
+
+#define S7_HASH_MULT    1820472881u
+#define S13_HASH_MULT   1195809357u
+
+static const uint16_t s7_keys[84] = {
+    LETTERS('A', 'B', 0), LETTERS('A', 'K', 0), LETTERS('A', 'L', 0), LETTERS('A', 'R', 0), LETTERS('A', 'Z', 0),
+    LETTERS('B', 'C', 0), LETTERS('C', 'O', 0), LETTERS('C', 'T', 0), LETTERS('D', 'E', 0), LETTERS('E', 'B', 0),
+    LETTERS('E', 'M', 'A'), LETTERS('E', 'N', 'Y'), LETTERS('E', 'P', 'A'), LETTERS('E', 'W', 'A'), LETTERS('G', 'A', 0),
+    LETTERS('G', 'T', 'A'), LETTERS('I', 'A', 0), LETTERS('I', 'D', 0), LETTERS('I', 'L', 0), LETTERS('I', 'N', 0),
+    LETTERS('K', 'S', 0), LETTERS('K', 'Y', 0), LETTERS('L', 'A', 0), LETTERS('L', 'A', 'X'), LETTERS('M', 'A', 'R'),
+    LETTERS('M', 'B', 0), LETTERS('M', 'D', 'C'), LETTERS('M', 'E', 0), LETTERS('M', 'I', 0), LETTERS('M', 'N', 0),
+    LETTERS('M', 'O', 0), LETTERS('M', 'S', 0), LETTERS('M', 'T', 0), LETTERS('N', 'C', 0), LETTERS('N', 'D', 0),
+    LETTERS('N', 'E', 0), LETTERS('N', 'F', 'L'), LETTERS('N', 'H', 0), LETTERS('N', 'L', 0), LETTERS('N', 'L', 'I'),
+    LETTERS('N', 'M', 0), LETTERS('N', 'N', 'J'), LETTERS('N', 'N', 'Y'), LETTERS('N', 'T', 0), LETTERS('N', 'T', 'X'),
+    LETTERS('N', 'V', 0), LETTERS('O', 'H', 0), LETTERS('O', 'K', 0), LETTERS('O', 'N', 'E'), LETTERS('O', 'N', 'N'),
+    LETTERS('O', 'N', 'S'), LETTERS('O', 'R', 0), LETTERS('O', 'R', 'G'), LETTERS('P', 'A', 'C'), LETTERS('P', 'R', 0),
+    LETTERS('Q', 'C', 0), LETTERS('R', 'I', 0), LETTERS('S', 'B', 0), LETTERS('S', 'C', 0), LETTERS('S', 'C', 'V'),
+    LETTERS('S', 'D', 0), LETTERS('S', 'D', 'G'), LETTERS('S', 'F', 0), LETTERS('S', 'F', 'L'), LETTERS('S', 'J', 'V'),
+    LETTERS('S', 'K', 0), LETTERS('S', 'N', 'J'), LETTERS('S', 'T', 'X'), LETTERS('S', 'V', 0), LETTERS('T', 'N', 0),
+    LETTERS('U', 'T', 0), LETTERS('V', 'A', 0), LETTERS('V', 'I', 0), LETTERS('V', 'T', 0), LETTERS('W', 'C', 'F'),
+    LETTERS('W', 'I', 0), LETTERS('W', 'M', 'A'), LETTERS('W', 'N', 'Y'), LETTERS('W', 'P', 'A'), LETTERS('W', 'T', 'X'),
+    LETTERS('W', 'V', 0), LETTERS('W', 'W', 'A'), LETTERS('W', 'Y', 0), LETTERS('D', 'X', 0),
+};
+
+static const uint8_t s7_slots[256] = {
+     0,  0,  0,  0,  0,  0, 47, 75, 74, 63,  0,  0,  0,  0, 69, 40,
+     0,  0, 19,  0,  0,  0, 21,  0,  0, 68,  0,  0,  0,  0,  0, 64,
+     0,  0,  0,  0,  0,  0, 24,  0, 32,  1,  0,  0, 34,  4, 82,  0,
+     0, 81,  0, 20,  0,  0,  0,  0,  0,  0,  0,  2, 79, 80,  0, 39,
+     0,  0,  0,  0, 28,  0,  0, 56, 78,  0,  0,  0, 10, 36,  0,  0,
+     0,  0, 72,  0,  0,  0, 30, 50, 59,  0,  0,  0,  0,  0,  0,  0,
+     8,  0,  0, 54,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0, 51,  0, 22,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0, 29,  0, 49,  0,  0,  0, 77,  0,  0,  7, 14,
+    18,  0,  0, 26, 70,  0,  0,  0,  0,  0,  0,  0, 42, 13, 65,  0,
+     0, 53,  0,  0, 25,  0,  0,  0, 12, 52, 84,  0, 60,  0,  0,  0,
+     5, 57, 55,  0,  0,  0,  0, 48, 33,  0,  0,  0, 35,  0,  0,  0,
+     0, 44,  6,  0,  0,  0,  0,  0, 58, 67,  0,  0,  3,  0, 15, 41,
+     0,  0,  0,  0,  0, 73,  0,  0,  0,  0,  0, 66,  0, 76,  0, 17,
+    62, 46, 83,  0,  0,  0,  0, 31,  0, 61,  0,  0, 11, 45,  0, 16,
+     0,  0,  0, 37,  9,  0,  0,  0, 43, 27, 23,  0,  0,  0, 38, 71,
+};
+
+static const uint16_t s13_keys[65] = {
+    LETTERS('A', 'L', 0), LETTERS('A', 'K', 0), LETTERS('A', 'Z', 0), LETTERS('A', 'R', 0), LETTERS('C', 'A', 0),
+    LETTERS('C', 'O', 0), LETTERS('C', 'T', 0), LETTERS('D', 'E', 0), LETTERS('F', 'L', 0), LETTERS('G', 'A', 0),
+    LETTERS('H', 'I', 0), LETTERS('I', 'D', 0), LETTERS('I', 'L', 0), LETTERS('I', 'N', 0), LETTERS('I', 'A', 0),
+    LETTERS('K', 'S', 0), LETTERS('K', 'Y', 0), LETTERS('L', 'A', 0), LETTERS('M', 'E', 0), LETTERS('M', 'D', 0),
+    LETTERS('M', 'A', 0), LETTERS('M', 'I', 0), LETTERS('M', 'N', 0), LETTERS('M', 'S', 0), LETTERS('M', 'O', 0),
+    LETTERS('M', 'T', 0), LETTERS('N', 'E', 0), LETTERS('N', 'V', 0), LETTERS('N', 'H', 0), LETTERS('N', 'J', 0),
+    LETTERS('N', 'M', 0), LETTERS('N', 'Y', 0), LETTERS('N', 'C', 0), LETTERS('N', 'D', 0), LETTERS('O', 'H', 0),
+    LETTERS('O', 'K', 0), LETTERS('O', 'R', 0), LETTERS('P', 'A', 0), LETTERS('R', 'I', 0), LETTERS('S', 'C', 0),
+    LETTERS('S', 'D', 0), LETTERS('T', 'N', 0), LETTERS('T', 'X', 0), LETTERS('U', 'T', 0), LETTERS('V', 'T', 0),
+    LETTERS('V', 'A', 0), LETTERS('W', 'A', 0), LETTERS('W', 'V', 0), LETTERS('W', 'I', 0), LETTERS('W', 'Y', 0),
+    LETTERS('N', 'B', 0), LETTERS('N', 'S', 0), LETTERS('Q', 'C', 0), LETTERS('O', 'N', 0), LETTERS('M', 'B', 0),
+    LETTERS('S', 'K', 0), LETTERS('A', 'B', 0), LETTERS('B', 'C', 0), LETTERS('N', 'W', 'T'), LETTERS('N', 'F', 0),
+    LETTERS('L', 'B', 0), LETTERS('N', 'U', 0), LETTERS('Y', 'T', 0), LETTERS('P', 'E', 'I'), LETTERS('D', 'C', 0),
+};
+
+static const uint8_t s13_slots[256] = {
+     0,  0, 11,  0,  1,  0,  0,  0,  0,  0, 39,  0,  0,  0, 61,  0,
+     0,  0, 23,  0,  0, 34,  0,  0,  0,  0,  0,  2, 50,  0,  0,  0,
+     0,  0,  0,  0, 65, 18,  0,  0, 55,  0,  0,  0, 33, 46, 32,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  5,  0,  0,  0,  0,  0,  0,  0,
+    21,  0,  0, 51, 31,  0,  0, 54, 47,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 44,  0,  0,  0,  0,
+     0, 48,  0,  0,  0,  0,  0,  0,  0,  0, 16,  0,  0,  0,  0,  0,
+     0,  0,  0, 28,  0, 45,  0,  0,  0,  4,  0, 53,  0,  0,  0,  7,
+     0,  0,  0,  0,  0,  0, 22, 26,  9,  0, 30, 62,  0, 36, 49, 38,
+    12,  0,  0,  0,  0,  0,  0,  0,  0, 41,  0,  0,  0,  0,  0, 24,
+     0, 10,  0,  0,  0,  0,  0,  0,  0, 14,  0,  0,  0,  0,  0,  0,
+    40,  0,  0,  0, 64,  0,  0,  0, 29, 52,  0,  0,  0,  0,  0,  3,
+     0,  0,  0,  0, 63,  0,  0,  0,  0,  0,  0, 42,  0,  0,  0,  0,
+     0,  0, 35,  0,  0,  0, 15, 13,  0,  0,  0,  0,  0,  0,  0, 17,
+     0,  0,  0, 19, 43,  0, 60,  0,  0,  0,  0, 37, 57,  0, 59, 58,
+     0,  0,  0,  6,  0,  8, 56,  0,  0,  0, 20, 25,  0, 27,  0,  0,
+};
+
+static int letters_key(const char *s) {
+    int key = 0;
+    int len = 0;
+    for (; s[len]; len++) {
+        char c = s[len];
+        if (c >= 'a' && c <= 'z') c -= 32;
+        if (len == 3 || c < 'A' || c > 'Z') return -1;
+        key = (key << 5) | (c - '@');
+    }
+    if (len < 2) return -1;
+    return len == 2 ? key << 5 : key;
+}
+
+static int perfect_lookup(const char *s, uint32_t mult, const uint8_t slots[256],
+                          const uint16_t *keys) {
+    int key = letters_key(s);
+    if (key < 0) return -1;
+
+    uint8_t idx = slots[((uint32_t)key * mult) >> 24];
+    if (idx == 0 || keys[idx - 1] != key) return -1;
+    return idx - 1;
+}
+
 uint32_t encode_c28(const c28_t *c28) {
     switch (c28->type) {
         case C28_TYPE_DE:
@@ -131,18 +291,12 @@ uint32_t encode_c28(const c28_t *c28) {
                 }
             }
 
-            const char* a1 = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-            const char* a2 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-            const char* a3 = "0123456789";
-            const char* a4 = " ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
-            char *ptr;
-            uint32_t i1 = (ptr = strchr(a1, std6[0])) ? (ptr - a1) : 0;
-            uint32_t i2 = (ptr = strchr(a2, std6[1])) ? (ptr - a2) : 0;
-            uint32_t i3 = (ptr = strchr(a3, std6[2])) ? (ptr - a3) : 0;
-            uint32_t i4 = (ptr = strchr(a4, std6[3])) ? (ptr - a4) : 0;
-            uint32_t i5 = (ptr = strchr(a4, std6[4])) ? (ptr - a4) : 0;
-            uint32_t i6 = (ptr = strchr(a4, std6[5])) ? (ptr - a4) : 0;
+            uint32_t i1 = c28_a1(std6[0]);
+            uint32_t i2 = c28_a2(std6[1]);
+            uint32_t i3 = c28_a3(std6[2]);
+            uint32_t i4 = c28_a4(std6[3]);
+            uint32_t i5 = c28_a4(std6[4]);
+            uint32_t i6 = c28_a4(std6[5]);
 
             uint32_t n28 = 6257896; 
             n28 += i1 * 7085880;    
@@ -238,28 +392,15 @@ uint32_t encode_g25(const char *grid) {
 }
 
 void encode_f71(const char *text, uint8_t *output) {
-    const char *charset = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?";
-
-    char buf[14];
-    memset(buf, ' ', 13);
-    buf[13] = '\0';
-
     int len = text ? strlen(text) : 0;
     if (len > 13) len = 13;
     int offset = 13 - len;
-    for (int i = 0; i < len; i++) {
-        char c = text[i];
-        if (c >= 'a' && c <= 'z') c -= 32;
-        buf[offset + i] = c;
-    }
 
     uint8_t result[9] = {0};
 
-    for (int i = 0; i < 13; i++) {
-        const char *ptr = strchr(charset, buf[i]);
-        uint8_t char_val = ptr ? (uint8_t)(ptr - charset) : 0;
-
-        uint16_t carry = char_val;
+    /* Right-aligned in 13 blanks; leading blanks are zero digits */
+    for (int i = offset; i < 13; i++) {
+        uint16_t carry = f71_index(text[i - offset]);
         for (int j = 8; j >= 0; j--) {
             uint16_t prod = (uint16_t)result[j] * 42 + carry;
             result[j] = (uint8_t)(prod & 0xFF);
@@ -270,62 +411,25 @@ void encode_f71(const char *text, uint8_t *output) {
     memcpy(output, result, 9);
 }
 
-uint64_t encode_c58(const char *callsign) {
-    const char *charset = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/";
-
-    char buf[12];
-    memset(buf, ' ', 11);
-    buf[11] = '\0';
-
+/* 11 characters, left-aligned and blank padded, in base 38 */
+static uint64_t base38_call(const char *callsign) {
     int len = callsign ? strlen(callsign) : 0;
     if (len > 11) len = 11;
-    for (int i = 0; i < len; i++) {
-        char c = callsign[i];
-        if (c >= 'a' && c <= 'z') c -= 32;
-        buf[i] = c;
-    }
 
-    uint64_t n58 = 0;
+    uint64_t n = 0;
     for (int i = 0; i < 11; i++) {
-        const char *ptr = strchr(charset, buf[i]);
-        int char_val = ptr ? (int)(ptr - charset) : 0;
-        n58 = n58 * 38 + char_val;
+        n = n * 38 + (i < len ? c58_index(callsign[i]) : 0);
     }
+    return n;
+}
 
-    return n58;
+uint64_t encode_c58(const char *callsign) {
+    return base38_call(callsign);
 }
 
 int8_t encode_S7(const char *section) {
-    static const char *sections[84] = {
-        "AB",  "AK",  "AL",  "AR",  "AZ",  "BC",  "CO",  "CT",  "DE",  "EB",
-        "EMA", "ENY", "EPA", "EWA", "GA",  "GTA", "IA",  "ID",  "IL",  "IN",
-        "KS",  "KY",  "LA",  "LAX", "MAR", "MB",  "MDC", "ME",  "MI",  "MN",
-        "MO",  "MS",  "MT",  "NC",  "ND",  "NE",  "NFL", "NH",  "NL",  "NLI",
-        "NM",  "NNJ", "NNY", "NT",  "NTX", "NV",  "OH",  "OK",  "ONE", "ONN",
-        "ONS", "OR",  "ORG", "PAC", "PR",  "QC",  "RI",  "SB",  "SC",  "SCV",
-        "SD",  "SDG", "SF",  "SFL", "SJV", "SK",  "SNJ", "STX", "SV",  "TN",
-        "UT",  "VA",  "VI",  "VT",  "WCF", "WI",  "WMA", "WNY", "WPA", "WTX",
-        "WV",  "WWA", "WY",  "DX"
-    };
-
     if (!section) return -1;
-
-    char upper[4] = {0};
-    int len = strlen(section);
-    if (len > 3) return -1;
-    for (int i = 0; i < len; i++) {
-        char c = section[i];
-        if (c >= 'a' && c <= 'z') c -= 32;
-        upper[i] = c;
-    }
-
-    for (int i = 0; i < 84; i++) {
-        if (strcmp(upper, sections[i]) == 0) {
-            return (int8_t)i;
-        }
-    }
-
-    return -1;
+    return (int8_t)perfect_lookup(section, S7_HASH_MULT, s7_slots, s7_keys);
 }
 
 uint16_t encode_s13(const s13_t *s13) {
@@ -336,31 +440,8 @@ uint16_t encode_s13(const s13_t *s13) {
             return (s13->payload.serial <= 7999) ? s13->payload.serial : 0;
 
         case S13_TYPE_STATE: {
-            static const char *states[65] = {
-                "AL",  "AK",  "AZ",  "AR",  "CA",  "CO",  "CT",  "DE",  "FL",  "GA",
-                "HI",  "ID",  "IL",  "IN",  "IA",  "KS",  "KY",  "LA",  "ME",  "MD",
-                "MA",  "MI",  "MN",  "MS",  "MO",  "MT",  "NE",  "NV",  "NH",  "NJ",
-                "NM",  "NY",  "NC",  "ND",  "OH",  "OK",  "OR",  "PA",  "RI",  "SC",
-                "SD",  "TN",  "TX",  "UT",  "VT",  "VA",  "WA",  "WV",  "WI",  "WY",
-                "NB",  "NS",  "QC",  "ON",  "MB",  "SK",  "AB",  "BC",  "NWT", "NF",
-                "LB",  "NU",  "YT",  "PEI", "DC"
-            };
-
-            char upper[4] = {0};
-            int len = strlen(s13->payload.state);
-            if (len > 3) return 0;
-            for (int i = 0; i < len; i++) {
-                char c = s13->payload.state[i];
-                if (c >= 'a' && c <= 'z') c -= 32;
-                upper[i] = c;
-            }
-
-            for (int i = 0; i < 65; i++) {
-                if (strcmp(upper, states[i]) == 0) {
-                    return 8001 + i;
-                }
-            }
-            return 0;
+            int idx = perfect_lookup(s13->payload.state, S13_HASH_MULT, s13_slots, s13_keys);
+            return idx < 0 ? 0 : 8001 + idx;
         }
 
         default:
@@ -369,31 +450,11 @@ uint16_t encode_s13(const s13_t *s13) {
 }
 
 uint32_t hash_callsign(const char *callsign, int nbits) {
-    const char *charset = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/";
     const uint64_t nprime = 47055833459ULL;
 
     if (!callsign || (nbits != 10 && nbits != 12 && nbits != 22)) return 0;
 
-    char buf[12];
-    memset(buf, ' ', 11);
-    buf[11] = '\0';
-
-    int len = strlen(callsign);
-    if (len > 11) len = 11;
-    for (int i = 0; i < len; i++) {
-        char c = callsign[i];
-        if (c >= 'a' && c <= 'z') c -= 32;
-        buf[i] = c;
-    }
-
-    uint64_t n = 0;
-    for (int i = 0; i < 11; i++) {
-        const char *ptr = strchr(charset, buf[i]);
-        int j = ptr ? (int)(ptr - charset) : 0;
-        n = n * 38 + j;
-    }
-
-    return (uint32_t)((nprime * n) >> (64 - nbits));
+    return (uint32_t)((nprime * base38_call(callsign)) >> (64 - nbits));
 }
 
 uint8_t encode_r2(r2_t r2) {
@@ -471,13 +532,26 @@ void encode_t71(const char *hex, uint8_t *output) {
     memcpy(output, temp, 9);
 }
 
+/* f71 and t71 are 71-bit numbers held right-aligned in nine bytes, as
+ * encode_f71 and encode_t71 leave them. The low 71 bits go out, as
+ * WSJT-X sends them; the top bit of the first byte is always clear. */
+static void pack_b71(uint8_t *buf, const uint8_t *src) {
+    pack_bits(buf, 0, src[0] & 0x7F, 7);
+    pack_bytes(buf, 7, src + 1, 64);
+}
+
+/* A hash field from its callsign through the table when one is given */
+static uint32_t field_hash(const char *call, uint32_t hash, int nbits) {
+    return call[0] ? ftx_callhash_add(call) >> (22 - nbits) : hash;
+}
+
 void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output) {
     payload_clear(output);
     switch (payload->type) {
         case FTX_MODE_FREE_TEXT: {
             uint8_t text_encoded[9] = {0};
             encode_f71(payload->data.free_text.text, text_encoded);
-            pack_bytes(output, 0, text_encoded, 71);
+            pack_b71(output, text_encoded);
             payload_set_i3(output, 0);
             payload_set_n3(output, 0);
             break;
@@ -485,7 +559,8 @@ void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output) {
         case FTX_MODE_DXPEDITION: {
             uint32_t c28_0_encoded = encode_c28(&payload->data.dxpedition.c28_0);
             uint32_t c28_1_encoded = encode_c28(&payload->data.dxpedition.c28_1);
-            uint16_t h10_encoded = payload->data.dxpedition.h10 & 0x3FF;
+            uint16_t h10_encoded = field_hash(payload->data.dxpedition.h10_call,
+                                              payload->data.dxpedition.h10, 10) & 0x3FF;
             uint8_t r5_encoded = encode_r5(payload->data.dxpedition.r5);
 
             pack_bits(output, 0, c28_0_encoded, 28);
@@ -515,7 +590,7 @@ void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output) {
             break;
         }
         case FTX_MODE_TELEMETRY: {
-            pack_bytes(output, 0, payload->data.telemetry.data, 71);
+            pack_b71(output, payload->data.telemetry.data);
             payload_set_i3(output, 0);
             payload_set_n3(output, 5);
             break;
@@ -566,7 +641,8 @@ void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output) {
         }
         case FTX_MODE_NONSTD: {
             // Type 4: h12 c58 h1 r2 c1 i3
-            uint16_t h12_encoded = payload->data.nonstd.h12 & 0x0FFF;
+            uint16_t h12_encoded = field_hash(payload->data.nonstd.h12_call,
+                                              payload->data.nonstd.h12, 12) & 0x0FFF;
             uint64_t c58_encoded = encode_c58(payload->data.nonstd.c58);
             uint8_t r2_encoded = encode_r2(payload->data.nonstd.r2);
 
@@ -580,8 +656,10 @@ void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output) {
         }
         case FTX_MODE_EU_VHF_5: {
             // Type 5: h12 h22 R1 r3 s11 g25 i3
-            uint16_t h12_encoded = payload->data.eu_vhf_5.h12 & 0x0FFF;
-            uint32_t h22_encoded = payload->data.eu_vhf_5.h22 & 0x3FFFFF;
+            uint16_t h12_encoded = field_hash(payload->data.eu_vhf_5.h12_call,
+                                              payload->data.eu_vhf_5.h12, 12) & 0x0FFF;
+            uint32_t h22_encoded = field_hash(payload->data.eu_vhf_5.h22_call,
+                                              payload->data.eu_vhf_5.h22, 22) & 0x3FFFFF;
             uint8_t r3_encoded = encode_r3(payload->data.eu_vhf_5.r3);
             uint16_t s11_encoded = encode_s11(payload->data.eu_vhf_5.s11);
             uint32_t g25_encoded = encode_g25(payload->data.eu_vhf_5.g25);
@@ -599,3 +677,556 @@ void encode_ftx_payload(const ftx_payload_t *payload, uint8_t *output) {
             break;
     }
 }
+
+static const char f71_chars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?";
+static const char c58_chars[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/";
+
+/* Drop the blanks either side of s, in place */
+static void trim_blanks(char *s) {
+    int start = 0;
+    while (s[start] == ' ') start++;
+
+    int len = strlen(s + start);
+    while (len > 0 && s[start + len - 1] == ' ') len--;
+
+    memmove(s, s + start, len);
+    s[len] = '\0';
+}
+
+static void letters_text(uint16_t key, char *out) {
+    out[0] = '@' + ((key >> 10) & 0x1F);
+    out[1] = '@' + ((key >> 5) & 0x1F);
+    out[2] = (key & 0x1F) ? '@' + (key & 0x1F) : '\0';
+    out[3] = '\0';
+}
+
+int decode_c28(uint32_t n28, c28_t *c28) {
+    memset(c28, 0, sizeof(*c28));
+
+    if (n28 < 3) {
+        static const c28_type_t tokens[3] = { C28_TYPE_DE, C28_TYPE_QRZ, C28_TYPE_CQ };
+        c28->type = tokens[n28];
+        return 0;
+    }
+
+    if (n28 < 1003) {
+        uint32_t val = n28 - 3;
+        c28->type = C28_TYPE_CQ_MOD;
+        c28->payload.cq_modifier[0] = '0' + val / 100;
+        c28->payload.cq_modifier[1] = '0' + (val / 10) % 10;
+        c28->payload.cq_modifier[2] = '0' + val % 10;
+        return 0;
+    }
+
+    /* Up to four letters in base 27, blank as zero */
+    if (n28 < 1003 + 27 * 27 * 27 * 27) {
+        uint32_t val = n28 - 1003;
+        char letters[4];
+        for (int i = 3; i >= 0; i--) {
+            letters[i] = val % 27;
+            val /= 27;
+        }
+
+        int len = 0;
+        for (int i = 0; i < 4; i++) {
+            if (letters[i]) {
+                c28->payload.cq_modifier[len++] = 'A' + letters[i] - 1;
+            }
+        }
+        c28->type = C28_TYPE_CQ_MOD;
+        return 0;
+    }
+
+    if (n28 >= 2063592 && n28 < 2063592 + (1u << 22)) {
+        c28->type = C28_TYPE_HASH_22;
+        c28->payload.hash = n28 - 2063592;
+        return 0;
+    }
+
+    if (n28 < 6257896) {
+        return -EINVAL;
+    }
+
+    uint32_t n = n28 - 6257896;
+    char *call = c28->payload.callsign;
+    for (int i = 5; i >= 3; i--) {
+        uint32_t v = n % 27;
+        call[i] = v ? 'A' + v - 1 : ' ';
+        n /= 27;
+    }
+    call[2] = '0' + n % 10;
+    n /= 10;
+    call[1] = c58_chars[n % 36 + 1];
+    n /= 36;
+    call[0] = c58_chars[n];
+    call[6] = '\0';
+
+    trim_blanks(call);
+    c28->type = C28_TYPE_CALLSIGN;
+    return 0;
+}
+
+void decode_g15(uint16_t n15, g15_t *g15) {
+    memset(g15, 0, sizeof(*g15));
+
+    if (n15 < MAXGRID4) {
+        g15->type = G15_TYPE_GRID;
+        g15->payload.grid[0] = 'A' + n15 / 1800;
+        g15->payload.grid[1] = 'A' + (n15 / 100) % 18;
+        g15->payload.grid[2] = '0' + (n15 / 10) % 10;
+        g15->payload.grid[3] = '0' + n15 % 10;
+        return;
+    }
+
+    switch (n15 - MAXGRID4) {
+        case 1:
+            g15->type = G15_TYPE_BLANK;
+            break;
+        case 2:
+            g15->type = G15_TYPE_RRR;
+            break;
+        case 3:
+            g15->type = G15_TYPE_RR73;
+            break;
+        case 4:
+            g15->type = G15_TYPE_73;
+            break;
+        default:
+            g15->type = G15_TYPE_REPORT;
+            g15->payload.report = (int8_t)(n15 - MAXGRID4 - 35);
+            break;
+    }
+}
+
+/* Back into nine right-aligned bytes, as pack_b71 took them */
+static void unpack_b71(const uint8_t *buf, uint8_t *dst) {
+    dst[0] = (uint8_t)unpack_bits(buf, 0, 7);
+    for (int i = 1; i < 9; i++) {
+        dst[i] = (uint8_t)unpack_bits(buf, 7 + (i - 1) * 8, 8);
+    }
+}
+
+void decode_f71(const uint8_t *input, char *text) {
+    uint8_t value[9];
+    memcpy(value, input, 9);
+
+    /* Long division by 42, least significant character first */
+    for (int i = 12; i >= 0; i--) {
+        uint16_t rem = 0;
+        for (int j = 0; j < 9; j++) {
+            uint16_t cur = (rem << 8) | value[j];
+            value[j] = (uint8_t)(cur / 42);
+            rem = cur % 42;
+        }
+        text[i] = f71_chars[rem];
+    }
+    text[13] = '\0';
+    trim_blanks(text);
+}
+
+void decode_c58(uint64_t n58, char *callsign) {
+    for (int i = 10; i >= 0; i--) {
+        callsign[i] = c58_chars[n58 % 38];
+        n58 /= 38;
+    }
+    callsign[11] = '\0';
+    trim_blanks(callsign);
+}
+
+static void decode_g25(uint32_t n25, char *grid) {
+    grid[5] = 'A' + n25 % 24;
+    n25 /= 24;
+    grid[4] = 'A' + n25 % 24;
+    n25 /= 24;
+    grid[3] = '0' + n25 % 10;
+    n25 /= 10;
+    grid[2] = '0' + n25 % 10;
+    n25 /= 10;
+    grid[1] = 'A' + n25 % 18;
+    grid[0] = 'A' + n25 / 18;
+    grid[6] = '\0';
+}
+
+static int decode_s13(uint16_t n13, s13_t *s13) {
+    memset(s13, 0, sizeof(*s13));
+
+    if (n13 <= 7999) {
+        s13->type = S13_TYPE_SERIAL;
+        s13->payload.serial = n13;
+        return 0;
+    }
+    if (n13 < 8001 || n13 - 8001 >= ARRAY_SIZE(s13_keys)) {
+        return -EINVAL;
+    }
+
+    char letters[4];
+    letters_text(s13_keys[n13 - 8001], letters);
+    s13->type = S13_TYPE_STATE;
+    memcpy(s13->payload.state, letters, sizeof(s13->payload.state) - 1);
+    return 0;
+}
+
+static r2_t decode_r2(uint8_t n2) {
+    static const r2_t r2[4] = { R2_TYPE_BLANK, R2_TYPE_RRR, R2_TYPE_RR73, R2_TYPE_73 };
+    return r2[n2 & 0x03];
+}
+
+/* Two c28 fields with their one-bit suffix flags and R1, then g15, as
+ * types 1 and 2 share */
+static int decode_std_fields(const uint8_t *packed, c28_t *c28_0, bool *suffix_0,
+                             c28_t *c28_1, bool *suffix_1, bool *R1, g15_t *g15) {
+    int ret = decode_c28((uint32_t)unpack_bits(packed, 0, 28), c28_0);
+    *suffix_0 = unpack_bits(packed, 28, 1);
+    ret |= decode_c28((uint32_t)unpack_bits(packed, 29, 28), c28_1);
+    *suffix_1 = unpack_bits(packed, 57, 1);
+    *R1 = unpack_bits(packed, 58, 1);
+    decode_g15((uint16_t)unpack_bits(packed, 59, 15), g15);
+    return ret ? -EINVAL : 0;
+}
+
+int decode_ftx_payload(const uint8_t *packed, ftx_payload_t *payload) {
+    uint8_t i3 = (uint8_t)unpack_bits(packed, 74, 3);
+    uint8_t n3 = (uint8_t)unpack_bits(packed, 71, 3);
+    int ret = 0;
+
+    memset(payload, 0, sizeof(*payload));
+
+    switch (i3) {
+        case 0:
+            switch (n3) {
+                case 0: {
+                    uint8_t text_encoded[9];
+                    unpack_b71(packed, text_encoded);
+                    decode_f71(text_encoded, payload->data.free_text.text);
+                    payload->type = FTX_MODE_FREE_TEXT;
+                    break;
+                }
+                case 1:
+                    ret |= decode_c28((uint32_t)unpack_bits(packed, 0, 28),
+                                      &payload->data.dxpedition.c28_0);
+                    ret |= decode_c28((uint32_t)unpack_bits(packed, 28, 28),
+                                      &payload->data.dxpedition.c28_1);
+                    payload->data.dxpedition.h10 = (uint16_t)unpack_bits(packed, 56, 10);
+                    ftx_callhash_find(payload->data.dxpedition.h10, 10,
+                                      payload->data.dxpedition.h10_call);
+                    payload->data.dxpedition.r5 = (int8_t)(unpack_bits(packed, 66, 5) * 2 - 30);
+                    payload->type = FTX_MODE_DXPEDITION;
+                    break;
+                case 3:
+                case 4: {
+                    uint8_t k3 = (uint8_t)unpack_bits(packed, 61, 3);
+                    uint8_t s7 = (uint8_t)unpack_bits(packed, 64, 7);
+                    if (k3 > FD_CLASS_F || s7 >= ARRAY_SIZE(s7_keys)) {
+                        return -EINVAL;
+                    }
+
+                    ret |= decode_c28((uint32_t)unpack_bits(packed, 0, 28),
+                                      &payload->data.field_day.c28_0);
+                    ret |= decode_c28((uint32_t)unpack_bits(packed, 28, 28),
+                                      &payload->data.field_day.c28_1);
+                    payload->data.field_day.R1 = unpack_bits(packed, 56, 1);
+                    payload->data.field_day.n4 = (uint8_t)unpack_bits(packed, 57, 4);
+                    payload->data.field_day.k3 = (k3_fd_class_t)k3;
+                    letters_text(s7_keys[s7], payload->data.field_day.S7);
+                    payload->data.field_day.transmitter_count =
+                        payload->data.field_day.n4 + (n3 == 4 ? 17 : 1);
+                    payload->type = FTX_MODE_FIELD_DAY;
+                    break;
+                }
+                case 5:
+                    unpack_b71(packed, payload->data.telemetry.data);
+                    payload->type = FTX_MODE_TELEMETRY;
+                    break;
+                default:
+                    return -EINVAL;
+            }
+            break;
+
+        case 1:
+            ret = decode_std_fields(packed, &payload->data.std.c28_0,
+                                    &payload->data.std.rover_suffix_0,
+                                    &payload->data.std.c28_1,
+                                    &payload->data.std.rover_suffix_1,
+                                    &payload->data.std.R1, &payload->data.std.g15);
+            payload->type = FTX_MODE_STD;
+            break;
+
+        case 2:
+            ret = decode_std_fields(packed, &payload->data.eu_vhf_2.c28_0,
+                                    &payload->data.eu_vhf_2.p_suffix_0,
+                                    &payload->data.eu_vhf_2.c28_1,
+                                    &payload->data.eu_vhf_2.p_suffix_1,
+                                    &payload->data.eu_vhf_2.R1, &payload->data.eu_vhf_2.g15);
+            payload->type = FTX_MODE_EU_VHF_2;
+            break;
+
+        case 3:
+            payload->data.rtty_ru.t1 = unpack_bits(packed, 0, 1);
+            ret |= decode_c28((uint32_t)unpack_bits(packed, 1, 28), &payload->data.rtty_ru.c28_0);
+            ret |= decode_c28((uint32_t)unpack_bits(packed, 29, 28), &payload->data.rtty_ru.c28_1);
+            payload->data.rtty_ru.R1 = unpack_bits(packed, 57, 1);
+            payload->data.rtty_ru.r3 = (uint8_t)unpack_bits(packed, 58, 3) + 2;
+            ret |= decode_s13((uint16_t)unpack_bits(packed, 61, 13), &payload->data.rtty_ru.s13);
+            payload->type = FTX_MODE_RTTY_RU;
+            break;
+
+        case 4:
+            payload->data.nonstd.h12 = (uint16_t)unpack_bits(packed, 0, 12);
+            ftx_callhash_find(payload->data.nonstd.h12, 12, payload->data.nonstd.h12_call);
+            decode_c58(unpack_bits(packed, 12, 58), payload->data.nonstd.c58);
+            payload->data.nonstd.h1 = unpack_bits(packed, 70, 1);
+            payload->data.nonstd.r2 = decode_r2((uint8_t)unpack_bits(packed, 71, 2));
+            payload->data.nonstd.c1 = unpack_bits(packed, 73, 1);
+            payload->type = FTX_MODE_NONSTD;
+            break;
+
+        case 5:
+            payload->data.eu_vhf_5.h12 = (uint16_t)unpack_bits(packed, 0, 12);
+            payload->data.eu_vhf_5.h22 = (uint32_t)unpack_bits(packed, 12, 22);
+            ftx_callhash_find(payload->data.eu_vhf_5.h12, 12, payload->data.eu_vhf_5.h12_call);
+            ftx_callhash_find(payload->data.eu_vhf_5.h22, 22, payload->data.eu_vhf_5.h22_call);
+            payload->data.eu_vhf_5.R1 = unpack_bits(packed, 34, 1);
+            payload->data.eu_vhf_5.r3 = (uint8_t)unpack_bits(packed, 35, 3) + 2;
+            payload->data.eu_vhf_5.s11 = (uint16_t)unpack_bits(packed, 38, 11);
+            decode_g25((uint32_t)unpack_bits(packed, 49, 25), payload->data.eu_vhf_5.g25);
+            payload->type = FTX_MODE_EU_VHF_5;
+            break;
+
+        default:
+            return -EINVAL;
+    }
+
+    return ret ? -EINVAL : 0;
+}
+
+/* LDPC(174,91) generator as in WSJT-X, stored by column: entry j holds
+ * the 83 parity bits that message bit j (77 payload + 14 CRC) feeds,
+ * packed MSB first */
+static const uint32_t ldpc_columns[FTX_LDPC_K][3] = {
+    { 0xa0a508d8, 0xc720297e, 0x87570000 },
+    { 0x61cf1114, 0x17994c9b, 0x19b5a000 },
+    { 0x43ee2065, 0x6b22efe2, 0x6bd6e000 },
+    { 0x707c4c05, 0xcf3517bc, 0x173c8000 },
+    { 0x3a14bf69, 0xce7ccdbd, 0x92ad8000 },
+    { 0x644fd01e, 0x7e830f93, 0x1dee4000 },
+    { 0xd4ce10eb, 0xbc11cfb5, 0xc848c000 },
+    { 0x9e44fe65, 0x080ee92b, 0xb49b8000 },
+    { 0x0a36eb4a, 0x1e78b79e, 0xdeada000 },
+    { 0x0d488af2, 0xb23550d4, 0x02004000 },
+    { 0xbe37e0df, 0x793809e8, 0x29ee8000 },
+    { 0x5f64d6bf, 0x1ab24f17, 0x317e8000 },
+    { 0xdc64a70e, 0xc072a410, 0xaa1d2000 },
+    { 0x7fcfc993, 0x077fcc4d, 0x02526000 },
+    { 0x328a930b, 0xbf7bb36a, 0xfbd88000 },
+    { 0x988a8743, 0x664b42b8, 0xed198000 },
+    { 0x8dd46552, 0x6a743bd1, 0x2061e000 },
+    { 0xb5149905, 0xce66b375, 0x9c2f6000 },
+    { 0x4b039c90, 0x70321a24, 0x18c44000 },
+    { 0x21e9ae48, 0xd1a52033, 0xc9f90000 },
+    { 0xa7de7038, 0xae01c557, 0x5de5e000 },
+    { 0xcc493464, 0x6b111f02, 0x41400000 },
+    { 0xc30f9ffa, 0xa85361f5, 0x328ec000 },
+    { 0x303495c3, 0x10f99258, 0x398fc000 },
+    { 0x0f8d82c2, 0x1a373115, 0x68c54000 },
+    { 0x5f8006f5, 0x7388472e, 0x9d3d2000 },
+    { 0x1b905987, 0xf23a82de, 0x95fac000 },
+    { 0x9b02df19, 0x06e00ea2, 0xc8422000 },
+    { 0x5a4129a1, 0xb4da286c, 0xf770c000 },
+    { 0x4b82b3c4, 0x7d773546, 0x7bcde000 },
+    { 0x6a3812bc, 0x1729927b, 0xa025a000 },
+    { 0x851b3f3e, 0x7d47a156, 0x3105e000 },
+    { 0xa9671978, 0xb95ec3fa, 0xfa094000 },
+    { 0x394559bb, 0xb15aa2cd, 0xf3596000 },
+    { 0xebc17304, 0xdf64d570, 0x6eca4000 },
+    { 0xb791bf1d, 0x62e49e34, 0xda482000 },
+    { 0xb677340d, 0xaf943174, 0x045e6000 },
+    { 0xc233a152, 0xb25e68fc, 0x95a00000 },
+    { 0xa51f501c, 0xa80ded1f, 0x396d4000 },
+    { 0xe592661a, 0x29000bc4, 0x546be000 },
+    { 0x561faae3, 0x68519bd1, 0x28ab8000 },
+    { 0x5910fe63, 0x1b2ccf3c, 0x86376000 },
+    { 0xa22867ac, 0x0e716b57, 0xa6d20000 },
+    { 0x81029f88, 0xd0f8860c, 0x5df50000 },
+    { 0x15e06b61, 0x6fc4de41, 0x3aba2000 },
+    { 0x31d145a5, 0xd474fa72, 0xfd28c000 },
+    { 0x60f607de, 0xb07e6ce8, 0xf923a000 },
+    { 0xb927994e, 0xbbfae3ea, 0x92a92000 },
+    { 0x89a1d308, 0xca4837eb, 0xce47e000 },
+    { 0xe4ac1ee6, 0xa29de2ec, 0xaae6a000 },
+    { 0xb6eb8bc7, 0x0aff330d, 0x08296000 },
+    { 0x6f292dfe, 0x6e5db505, 0xe081e000 },
+    { 0xf0b07b35, 0xa3f634f5, 0x149d6000 },
+    { 0x3bc22fc1, 0x65ce66be, 0xe9788000 },
+    { 0x87585620, 0xd29b680e, 0x0f102000 },
+    { 0x5ca7f981, 0x54f6c046, 0x03f66000 },
+    { 0x9f77d189, 0xabf4a3c8, 0x295d2000 },
+    { 0xbf5531f1, 0x7868c3f9, 0xf9f7c000 },
+    { 0xee86bdfe, 0x65749047, 0x4fc0a000 },
+    { 0xdb7cc8db, 0xc6b96c7a, 0x144e2000 },
+    { 0x0c5c4b2c, 0xd73f12bd, 0x077a0000 },
+    { 0xaef939fe, 0xd89b47e9, 0xc80be000 },
+    { 0x51beb391, 0x686bb928, 0x6a62c000 },
+    { 0xddf1c6eb, 0x0ea04f73, 0x71db2000 },
+    { 0x03c64f06, 0x63dee619, 0x7c700000 },
+    { 0x4614a0cc, 0x058ec2ab, 0x0759e000 },
+    { 0x1366056b, 0xaf423b52, 0x42de4000 },
+    { 0x771734d1, 0xb614da90, 0x8fab6000 },
+    { 0x96d6d421, 0x7ab8592f, 0xe4556000 },
+    { 0x56522b9f, 0x09def9fa, 0xed116000 },
+    { 0x1a4796b9, 0xaa2645c5, 0x23ce8000 },
+    { 0x882fd46a, 0x669a9c9a, 0xdd89e000 },
+    { 0xf1083ba3, 0x06dd78ac, 0xb0f08000 },
+    { 0x99d75ff3, 0xc1cc26fb, 0xa5d52000 },
+    { 0xa42b0994, 0x6741ae57, 0xb643a000 },
+    { 0xc6789228, 0x1193ea87, 0x83154000 },
+    { 0x0790e7b8, 0xa05c060a, 0x0ebee000 },
+    { 0x1c769640, 0x19a6e5e6, 0xf0dfc000 },
+    { 0xdad717a1, 0x08e0ad01, 0xa3c2c000 },
+    { 0x7c0f66b3, 0x62b9c30f, 0xa8bd6000 },
+    { 0x3bb53969, 0x0d70ebb4, 0x5eb08000 },
+    { 0x958043a9, 0xbb44fb24, 0x99486000 },
+    { 0xb0ddf353, 0x0c559b87, 0xdf622000 },
+    { 0xf2467db5, 0x084491d7, 0xe7cb8000 },
+    { 0xa68817e8, 0x6975ab36, 0x24c80000 },
+    { 0xb2228cbb, 0x012c1027, 0x49c28000 },
+    { 0xd93ec79f, 0xcd49c958, 0x446dc000 },
+    { 0xebfb93e0, 0x1add1939, 0x1a4d0000 },
+    { 0xaf6d66ce, 0xbd011180, 0xc4da4000 },
+    { 0xa124718c, 0xcd48635c, 0x8b464000 },
+    { 0x5f1460c5, 0x0e8a436b, 0x9d588000 },
+};
+
+/* The CRC runs over the payload padded with five zero bits to 82 */
+#define FTX_CRC_SPAN        82
+
+uint16_t ftx_crc14(const uint8_t *payload) {
+    uint8_t padded[11] = { 0 };
+    memcpy(padded, payload, 10);
+    padded[9] &= 0xF8;
+    return (uint16_t)fec_crc(&fec_crc14, padded, FTX_CRC_SPAN);
+}
+
+void ftx_encode_codeword(const uint8_t *payload, uint8_t *codeword) {
+    memset(codeword, 0, FTX_CODEWORD_BYTES);
+    memcpy(codeword, payload, 10);
+    codeword[9] &= 0xF8;
+
+    uint32_t crc = (uint32_t)ftx_crc14(payload) << (32 - FTX_CRC_BITS);
+    fec_put_bits(codeword, FTX_PAYLOAD_BITS, &crc, FTX_CRC_BITS);
+
+    uint32_t parity[3];
+    fec_block_parity(&ldpc_columns[0][0], 3, codeword, FTX_LDPC_K, parity);
+    fec_put_bits(codeword, FTX_LDPC_K, parity, FTX_LDPC_M);
+}
+
+/* The same code as sparse parity checks for decoding: the rows of H are
+ * its lowest-weight dual codewords, each listing the six or seven
+ * codeword bits it covers, LDPC_NONE padded. Every bit is in three. */
+#define LDPC_NONE   255
+
+static const uint8_t ldpc_checks[FTX_LDPC_M][7] = {
+    {   0,   3,  51,  56,  85, 135, 151 }, {   0,  25,  44,  79, 127, 146, 255 }, {   0,  32,  71, 105, 106, 156, 255 },
+    {   1,  26,  40,  60,  61, 114, 132 }, {   1,  47,  73, 112, 127, 159, 255 }, {   1,  53,  85, 100, 134, 163, 255 },
+    {   2,  12,  47,  77,  94, 122, 255 }, {   2,  23,  29,  71, 103, 138, 255 }, {   2,  43,  79, 123, 126, 168, 255 },
+    {   3,  28,  67, 119, 133, 172, 255 }, {   3,  30,  58,  90,  91,  95, 152 }, {   4,  31,  59,  92, 114, 145, 255 },
+    {   4,  33,  64,  77,  97, 106, 153 }, {   4,  38,  74, 101, 135, 166, 255 }, {   5,  23,  60,  93, 121, 150, 255 },
+    {   5,  31,  63,  96, 125, 137, 255 }, {   5,  32,  84, 107, 115, 155, 255 }, {   6,  32,  61,  94,  95, 142, 255 },
+    {   6,  48,  57,  89,  99, 104, 167 }, {   6,  49,  80,  98, 131, 172, 255 }, {   7,  24,  62,  82,  92,  95, 147 },
+    {   7,  39,  69,  81, 103, 113, 144 }, {   7,  45,  70, 111, 118, 165, 255 }, {   8,  34,  65,  98, 138, 145, 255 },
+    {   8,  39,  89, 105, 133, 150, 255 }, {   8,  53,  62, 130, 146, 154, 255 }, {   9,  35,  66,  99, 106, 125, 255 },
+    {   9,  43,  81,  90, 110, 143, 148 }, {   9,  52,  65,  83, 111, 127, 164 }, {  10,  36,  66,  86, 100, 138, 157 },
+    {  10,  43,  74, 109, 120, 165, 255 }, {  10,  48,  87,  91, 141, 156, 255 }, {  11,  37,  67, 101, 104, 154, 255 },
+    {  11,  42,  65,  88,  96, 134, 158 }, {  11,  49,  60, 117, 118, 143, 255 }, {  12,  38,  68, 102, 148, 161, 255 },
+    {  12,  50,  63, 113, 117, 156, 255 }, {  13,  29,  82, 112, 124, 169, 255 }, {  13,  30,  78,  97, 131, 163, 255 },
+    {  13,  40,  70,  87, 101, 122, 155 }, {  14,  41,  58, 105, 122, 158, 255 }, {  14,  55,  86, 107, 118, 170, 255 },
+    {  14,  57,  59,  73, 110, 149, 162 }, {  15,  38,  61, 111, 133, 157, 255 }, {  15,  42,  72, 107, 140, 159, 255 },
+    {  15,  46,  75, 129, 136, 153, 255 }, {  16,  26,  88, 102, 115, 152, 255 }, {  16,  36,  73,  80, 108, 130, 153 },
+    {  16,  41,  74, 128, 169, 171, 255 }, {  17,  35,  75,  88, 112, 113, 142 }, {  17,  41,  78, 143, 145, 151, 255 },
+    {  17,  48,  54, 123, 140, 166, 255 }, {  18,  34,  58,  72, 109, 124, 160 }, {  18,  37,  76, 103, 115, 162, 255 },
+    {  18,  45,  80, 116, 134, 166, 255 }, {  19,  35,  62,  93, 135, 160, 255 }, {  19,  45,  64,  79, 119, 139, 169 },
+    {  19,  46,  69,  91, 137, 164, 255 }, {  20,  36,  72, 137, 151, 168, 255 }, {  20,  44,  77,  82, 116, 120, 150 },
+    {  20,  53,  76,  99, 139, 170, 255 }, {  21,  46,  57, 117, 126, 163, 255 }, {  21,  52,  67, 108, 120, 173, 255 },
+    {  21,  56,  84,  92, 139, 158, 255 }, {  22,  33,  70,  93, 126, 152, 255 }, {  22,  42,  78, 119, 130, 144, 255 },
+    {  22,  54,  66,  94, 171, 173, 255 }, {  23,  51,  75, 128, 147, 148, 255 }, {  24,  37,  64,  98, 121, 159, 255 },
+    {  24,  52,  68,  89, 100, 129, 155 }, {  25,  40,  76, 108, 140, 147, 255 }, {  25,  50,  55,  90, 121, 136, 167 },
+    {  26,  39,  55, 123, 124, 125, 255 }, {  27,  28,  83,  87, 116, 142, 149 }, {  27,  31,  71, 102, 131, 165, 255 },
+    {  27,  47,  69,  84, 104, 128, 157 }, {  28,  33,  86,  96, 146, 161, 255 }, {  29,  49,  59,  85, 136, 141, 161 },
+    {  30,  68, 132, 149, 154, 168, 255 }, {  34,  81, 132, 141, 170, 173, 255 }, {  44,  54,  63, 110, 129, 160, 172 },
+    {  50,  56,  97, 162, 164, 171, 255 }, {  51,  83, 109, 114, 144, 167, 255 },
+};
+
+/* Check-to-bit messages and bit totals between iterations */
+static int16_t ldpc_c2b[FTX_LDPC_M][7];
+static int32_t ldpc_total[FTX_LDPC_N];
+
+static int ldpc_update_totals(const int16_t *llr) {
+    for (int n = 0; n < FTX_LDPC_N; n++) {
+        ldpc_total[n] = llr[n];
+    }
+    for (int m = 0; m < FTX_LDPC_M; m++) {
+        for (int j = 0; j < 7 && ldpc_checks[m][j] != LDPC_NONE; j++) {
+            ldpc_total[ldpc_checks[m][j]] += ldpc_c2b[m][j];
+        }
+    }
+
+    int errors = 0;
+    for (int m = 0; m < FTX_LDPC_M; m++) {
+        int parity = 0;
+        for (int j = 0; j < 7 && ldpc_checks[m][j] != LDPC_NONE; j++) {
+            parity ^= ldpc_total[ldpc_checks[m][j]] > 0;
+        }
+        errors += parity;
+    }
+    return errors;
+}
+
+/* Normalised min-sum: each check answers every bit with the smallest
+ * magnitude among its other bits, scaled by 3/4, and the sign that
+ * would make the check's parity even: positive when the others hold an
+ * odd number of ones */
+static void ldpc_update_checks(void) {
+    for (int m = 0; m < FTX_LDPC_M; m++) {
+        int32_t min1 = INT32_MAX;
+        int32_t min2 = INT32_MAX;
+        int min_j = 0;
+        int ones = 0;
+
+        for (int j = 0; j < 7 && ldpc_checks[m][j] != LDPC_NONE; j++) {
+            int32_t v = ldpc_total[ldpc_checks[m][j]] - ldpc_c2b[m][j];
+            int32_t mag = v < 0 ? -v : v;
+            ones ^= v > 0;
+            if (mag < min1) {
+                min2 = min1;
+                min1 = mag;
+                min_j = j;
+            } else if (mag < min2) {
+                min2 = mag;
+            }
+        }
+
+        for (int j = 0; j < 7 && ldpc_checks[m][j] != LDPC_NONE; j++) {
+            int32_t v = ldpc_total[ldpc_checks[m][j]] - ldpc_c2b[m][j];
+            int32_t out = (j == min_j ? min2 : min1) * 3 / 4;
+            if (out > INT16_MAX) out = INT16_MAX;
+            ldpc_c2b[m][j] = (int16_t)((ones ^ (v > 0)) ? out : -out);
+        }
+    }
+}
+
+int ftx_ldpc_decode(const int16_t *llr, int max_iterations, uint8_t *codeword) {
+    memset(ldpc_c2b, 0, sizeof(ldpc_c2b));
+
+    int errors = ldpc_update_totals(llr);
+    for (int iter = 0; iter < max_iterations && errors > 0; iter++) {
+        ldpc_update_checks();
+        errors = ldpc_update_totals(llr);
+    }
+
+    memset(codeword, 0, FTX_CODEWORD_BYTES);
+    for (int n = 0; n < FTX_LDPC_N; n++) {
+        if (ldpc_total[n] > 0) {
+            codeword[n / 8] |= 0x80 >> (n % 8);
+        }
+    }
+    return errors;
+}
@@ -0,0 +1,219 @@
+#include "modes/ftx_callhash.h"
+#include "modes/ftx.h"
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#ifdef CONFIG_FTX_CALLHASH_PERSIST
+#include <zephyr/settings/settings.h>
+#endif
+
+struct callhash_entry {
+    char call[FTX_CALL_LEN];
+    uint32_t h22;
+    uint32_t used;          // LRU stamp, 0 for an empty entry
+};
+
+static struct callhash_entry entries[CONFIG_FTX_CALLHASH_ENTRIES];
+static uint32_t use_clock;
+
+K_MUTEX_DEFINE(callhash_lock);
+
+/* Trim blanks and the <> of a hashed call, and fold to upper case */
+static void call_normalise(const char *in, char *out) {
+    int n = 0;
+
+    for (; *in && n < FTX_CALL_LEN - 1; in++) {
+        char c = *in;
+        if (c == ' ' || c == '<' || c == '>') {
+            continue;
+        }
+        out[n++] = (c >= 'a' && c <= 'z') ? c - 32 : c;
+    }
+    out[n] = '\0';
+}
+
+/* Caller holds callhash_lock */
+static struct callhash_entry *entry_find(const char *call) {
+    for (int i = 0; i < CONFIG_FTX_CALLHASH_ENTRIES; i++) {
+        if (entries[i].used && strcmp(entries[i].call, call) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+/* Caller holds callhash_lock. A new call takes an empty entry, or else
+ * the least recently used; *added says which. */
+static struct callhash_entry *entry_add(const char *call, bool *added) {
+    struct callhash_entry *e = entry_find(call);
+
+    *added = e == NULL;
+    if (*added) {
+        e = &entries[0];
+        for (int i = 1; i < CONFIG_FTX_CALLHASH_ENTRIES; i++) {
+            if (entries[i].used < e->used) {
+                e = &entries[i];
+            }
+        }
+        strcpy(e->call, call);
+        e->h22 = hash_callsign(call, 22);
+    }
+    /* Stamps are 32 bits: a new call every second would take 136 years */
+    e->used = ++use_clock;
+    return e;
+}
+
+#ifdef CONFIG_FTX_CALLHASH_PERSIST
+static void callhash_save_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(callhash_save_work, callhash_save_handler);
+
+/* Saved as the calls alone, most recent first; hashes are recomputed */
+static void callhash_save_handler(struct k_work *work) {
+    static char calls[CONFIG_FTX_CALLHASH_ENTRIES][FTX_CALL_LEN];
+    int n = 0;
+
+    k_mutex_lock(&callhash_lock, K_FOREVER);
+    uint32_t after = UINT32_MAX;
+    for (; n < CONFIG_FTX_CALLHASH_ENTRIES; n++) {
+        const struct callhash_entry *next = NULL;
+        for (int i = 0; i < CONFIG_FTX_CALLHASH_ENTRIES; i++) {
+            if (entries[i].used && entries[i].used < after &&
+                (!next || entries[i].used > next->used)) {
+                next = &entries[i];
+            }
+        }
+        if (!next) {
+            break;
+        }
+        memcpy(calls[n], next->call, FTX_CALL_LEN);
+        after = next->used;
+    }
+    k_mutex_unlock(&callhash_lock);
+
+    int ret = settings_save_one("chash/calls", calls, n * FTX_CALL_LEN);
+    if (ret) {
+        printk("ftx_callhash: save failed (%d)\n", ret);
+    }
+}
+
+static int callhash_settings_set(const char *name, size_t len,
+                                 settings_read_cb read_cb, void *cb_arg) {
+    static char calls[CONFIG_FTX_CALLHASH_ENTRIES][FTX_CALL_LEN];
+    const char *next;
+
+    if (settings_name_steq(name, "calls", &next) && !next) {
+        if (len % FTX_CALL_LEN) {
+            return -EINVAL;
+        }
+        if (len > sizeof(calls)) {
+            len = sizeof(calls);    // saved by a build with a bigger table
+        }
+        int ret = read_cb(cb_arg, calls, len);
+        if (ret < 0) {
+            return ret;
+        }
+
+        k_mutex_lock(&callhash_lock, K_FOREVER);
+        /* Oldest first, so the most recent ends up with the newest stamp */
+        for (int i = len / FTX_CALL_LEN - 1; i >= 0; i--) {
+            calls[i][FTX_CALL_LEN - 1] = '\0';
+            if (calls[i][0]) {
+                bool added;
+                entry_add(calls[i], &added);
+            }
+        }
+        k_mutex_unlock(&callhash_lock);
+        return 0;
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(ftx_callhash, "chash", NULL, callhash_settings_set, NULL, NULL);
+#endif
+
+uint32_t ftx_callhash_add(const char *call) {
+    char key[FTX_CALL_LEN];
+
+    if (!call) {
+        return 0;
+    }
+    call_normalise(call, key);
+    if (!key[0]) {
+        return 0;
+    }
+
+    bool added;
+    k_mutex_lock(&callhash_lock, K_FOREVER);
+    uint32_t h22 = entry_add(key, &added)->h22;
+    k_mutex_unlock(&callhash_lock);
+
+#ifdef CONFIG_FTX_CALLHASH_PERSIST
+    if (added) {
+        k_work_schedule(&callhash_save_work, K_SECONDS(CONFIG_FTX_CALLHASH_SAVE_DELAY_S));
+    }
+#else
+    (void)added;
+#endif
+    return h22;
+}
+
+int ftx_callhash_find(uint32_t hash, int nbits, char *call) {
+    const struct callhash_entry *best = NULL;
+
+    call[0] = '\0';
+    if (nbits != 10 && nbits != 12 && nbits != 22) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&callhash_lock, K_FOREVER);
+    for (int i = 0; i < CONFIG_FTX_CALLHASH_ENTRIES; i++) {
+        if (entries[i].used && (entries[i].h22 >> (22 - nbits)) == hash &&
+            (!best || entries[i].used > best->used)) {
+            best = &entries[i];
+        }
+    }
+    if (best) {
+        strcpy(call, best->call);
+    }
+    k_mutex_unlock(&callhash_lock);
+
+    return best ? 0 : -ENOENT;
+}
+
+static void learn_c28(const c28_t *c28) {
+    if (c28->type == C28_TYPE_CALLSIGN) {
+        ftx_callhash_add(c28->payload.callsign);
+    }
+}
+
+void ftx_callhash_learn(const ftx_payload_t *payload) {
+    switch (payload->type) {
+        case FTX_MODE_DXPEDITION:
+            learn_c28(&payload->data.dxpedition.c28_0);
+            learn_c28(&payload->data.dxpedition.c28_1);
+            break;
+        case FTX_MODE_FIELD_DAY:
+            learn_c28(&payload->data.field_day.c28_0);
+            learn_c28(&payload->data.field_day.c28_1);
+            break;
+        case FTX_MODE_STD:
+            learn_c28(&payload->data.std.c28_0);
+            learn_c28(&payload->data.std.c28_1);
+            break;
+        case FTX_MODE_EU_VHF_2:
+            learn_c28(&payload->data.eu_vhf_2.c28_0);
+            learn_c28(&payload->data.eu_vhf_2.c28_1);
+            break;
+        case FTX_MODE_RTTY_RU:
+            learn_c28(&payload->data.rtty_ru.c28_0);
+            learn_c28(&payload->data.rtty_ru.c28_1);
+            break;
+        case FTX_MODE_NONSTD:
+            ftx_callhash_add(payload->data.nonstd.c58);
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,250 @@
+#include "modes/keyer.h"
+#include "modes/encoders/cw.h"
+#include "modes/encoders/rtty.h"
+#include "radio/tx_engine.h"
+#include "radio_core.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/sys/printk.h>
+
+/* Written by the command handler, drained by the symbol source on the
+ * system workqueue */
+RING_BUF_DECLARE(keyer_fifo, CONFIG_KEYER_FIFO_SIZE);
+static struct k_spinlock keyer_lock;
+
+static struct keyer_config config;
+static tx_sequence_t keyer_seq;
+static volatile bool running;
+static volatile bool finishing;
+static uint32_t chars_sent;
+static uint32_t idle_sent;
+
+/* The engine reads each symbol twice, once ahead to prepare the tone and
+ * again at its boundary, so the last one is kept. */
+static size_t produced;
+static tx_symbol_t last_sym;
+
+static cw_timing_t cw;
+static uint8_t cw_elems;        // rest of the character being keyed, as cw_code packs it
+static bool cw_in_gap;          // element sent, its key-up is next
+static bool cw_prosign;
+static uint32_t cw_owed_us;     // key-up still due before the next character
+
+static rtty_keying_t rtty;
+static uint8_t rtty_codes[2];
+static int rtty_ncodes;
+static int rtty_code;
+static int rtty_pos;
+static bool rtty_figs;
+
+static bool fifo_get(uint8_t *c) {
+    k_spinlock_key_t key = k_spin_lock(&keyer_lock);
+    bool got = ring_buf_get(&keyer_fifo, c, 1) == 1;
+    if (got) {
+        chars_sent++;
+    }
+    k_spin_unlock(&keyer_lock, key);
+    return got;
+}
+
+static void count_idle(void) {
+    k_spinlock_key_t key = k_spin_lock(&keyer_lock);
+    idle_sent++;
+    k_spin_unlock(&keyer_lock, key);
+}
+
+static void key_up(tx_symbol_t *out, uint32_t duration_us) {
+    *out = (tx_symbol_t){0, duration_us, false, false, TX_SHAPE_KEYED};
+}
+
+/* Gaps are sent as they fall due rather than merged into the previous
+ * key-up, so a character typed during a gap starts as soon as the gap
+ * has run; idle time counts towards it. */
+static int cw_next(tx_symbol_t *out) {
+    for (;;) {
+        if (cw_elems) {
+            if (!cw_in_gap) {
+                *out = (tx_symbol_t){0, (cw_elems & 1) ? 3 * cw.dot_us : cw.dot_us, true,
+                                     false, TX_SHAPE_KEYED};
+                cw_in_gap = true;
+                return 0;
+            }
+
+            cw_in_gap = false;
+            if ((cw_elems >>= 1) == 1) {
+                cw_elems = 0;
+                cw_owed_us = cw_prosign ? 0 : cw.char_gap_us - cw.dot_us;
+            }
+            key_up(out, cw.dot_us);
+            return 0;
+        }
+
+        uint8_t c;
+        if (!fifo_get(&c)) {
+            if (finishing) {
+                return -ENODATA;
+            }
+            key_up(out, cw.dot_us);
+            cw_owed_us = cw_owed_us > cw.dot_us ? cw_owed_us - cw.dot_us : 0;
+            count_idle();
+            return 0;
+        }
+
+        if (c == '<') {
+            cw_prosign = true;
+        } else if (c == '>') {
+            cw_prosign = false;
+            cw_owed_us = cw.char_gap_us - cw.dot_us;
+        } else if (c == ' ') {
+            /* The character gap still owed completes the word gap */
+            key_up(out, cw.word_gap_us - cw.char_gap_us);
+            return 0;
+        } else if ((cw_elems = cw_code(c)) != 0) {
+            if (cw_owed_us) {
+                key_up(out, cw_owed_us);
+                cw_owed_us = 0;
+                return 0;
+            }
+        }
+    }
+}
+
+static int rtty_next(tx_symbol_t *out) {
+    if (rtty_code >= rtty_ncodes) {
+        rtty_code = 0;
+        rtty_ncodes = 0;
+
+        while (!rtty_ncodes) {
+            uint8_t c;
+            if (!fifo_get(&c)) {
+                if (finishing) {
+                    return -ENODATA;
+                }
+                rtty_codes[0] = RTTY_BAUDOT_LTRS;
+                rtty_ncodes = 1;
+                rtty_figs = false;
+                count_idle();
+                break;
+            }
+            rtty_ncodes = rtty_encode_char(c, &rtty_figs, config.rtty.unshift_on_space,
+                                           rtty_codes);
+        }
+    }
+
+    rtty_code_symbol(&rtty, rtty_codes[rtty_code], rtty_pos, out);
+    if (++rtty_pos == RTTY_SYMBOLS_PER_CHAR) {
+        rtty_pos = 0;
+        rtty_code++;
+    }
+    return 0;
+}
+
+static int keyer_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    if (produced && index == produced - 1) {
+        *out = last_sym;
+        return 0;
+    }
+    if (index != produced) {
+        return -EINVAL;
+    }
+
+    int ret = config.mode == KEYER_CW ? cw_next(out) : rtty_next(out);
+    if (ret) {
+        if (ret == -ENODATA) {
+            running = false;
+        }
+        return ret;
+    }
+
+    last_sym = *out;
+    produced++;
+    return 0;
+}
+
+int keyer_start(const struct keyer_config *cfg) {
+    if (cfg->mode == KEYER_CW) {
+        if (cfg->wpm == 0) {
+            return -EINVAL;
+        }
+        cw_timing(cfg->wpm, cfg->effective_wpm, &cw);
+    } else if (cfg->mode == KEYER_RTTY) {
+        if (cfg->rtty.baud_rate <= 0.0f) {
+            return -EINVAL;
+        }
+        rtty_keying(&cfg->rtty, &rtty);
+    } else {
+        return -EINVAL;
+    }
+
+    tx_engine_stop();
+
+    config = *cfg;
+    produced = 0;
+    finishing = false;
+    cw_elems = 0;
+    cw_in_gap = false;
+    cw_prosign = false;
+    cw_owed_us = 0;
+    rtty_ncodes = 0;
+    rtty_code = 0;
+    rtty_pos = 0;
+    rtty_figs = false;
+
+    k_spinlock_key_t key = k_spin_lock(&keyer_lock);
+    chars_sent = 0;
+    idle_sent = 0;
+    k_spin_unlock(&keyer_lock, key);
+
+    keyer_seq = (tx_sequence_t){
+        .mode_name = cfg->mode == KEYER_CW ? "CW keyer" : "RTTY keyer",
+        .base_freq_uhz = cfg->base_freq_uhz,
+        .source = keyer_symbol,
+        .total_symbols = SIZE_MAX,
+    };
+
+    running = true;
+    tx_engine_start(&keyer_seq);
+    if (!tx_engine_is_active()) {
+        running = false;
+        return -EIO;
+    }
+    return 0;
+}
+
+size_t keyer_write(const uint8_t *text, size_t len) {
+    k_spinlock_key_t key = k_spin_lock(&keyer_lock);
+    size_t n = ring_buf_put(&keyer_fifo, text, len);
+    k_spin_unlock(&keyer_lock, key);
+    return n;
+}
+
+void keyer_finish(void) {
+    finishing = true;
+}
+
+void keyer_abort(void) {
+    if (running) {
+        running = false;
+        tx_engine_stop();
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&keyer_lock);
+    ring_buf_reset(&keyer_fifo);
+    k_spin_unlock(&keyer_lock, key);
+}
+
+void keyer_get_status(struct keyer_status *out) {
+    k_spinlock_key_t key = k_spin_lock(&keyer_lock);
+
+    out->active = running && tx_engine_is_active();
+    out->finishing = finishing;
+    out->fill = ring_buf_size_get(&keyer_fifo);
+    out->capacity = ring_buf_capacity_get(&keyer_fifo);
+    out->chars = chars_sent;
+    out->idle = idle_sent;
+
+    k_spin_unlock(&keyer_lock, key);
+}
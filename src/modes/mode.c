@@ -0,0 +1,113 @@
+#include "modes/mode.h"
+#include "radio/tx_engine.h"
+#include "radio/timebase.h"
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+/* Room between encoding and the first symbol of a slotted start, for the
+ * timebase alarm and the engine to get going */
+#define START_LEAD_US   100000
+
+struct mode_timing {
+    struct tx_mode_stats stats;
+    uint64_t total_us;
+};
+
+static struct mode_timing timing[TX_MODE_COUNT];
+static tx_sequence_t mode_seq;
+static char text_buf[256];
+
+const struct tx_mode *tx_mode_find(uint8_t id) {
+    STRUCT_SECTION_FOREACH(tx_mode, mode) {
+        if (mode->id == id) {
+            return mode;
+        }
+    }
+    return NULL;
+}
+
+const char *tx_mode_text(const uint8_t *payload, size_t len) {
+    len = MIN(len, sizeof(text_buf) - 1);
+    memcpy(text_buf, payload, len);
+    text_buf[len] = '\0';
+    return text_buf;
+}
+
+int64_t tx_mode_next_slot_us(int64_t now_us, int64_t lead_us, uint32_t slot_us,
+                             uint32_t delay_us) {
+    int64_t earliest = now_us + lead_us - delay_us;
+    int64_t slot = earliest / slot_us;
+    if (earliest % slot_us > 0) {
+        slot++;
+    }
+    return slot * slot_us + delay_us;
+}
+
+static void record_encode(const struct tx_mode *mode, uint32_t cycles, bool ok) {
+    struct mode_timing *t = &timing[mode->id];
+
+    if (!ok) {
+        t->stats.failures++;
+        return;
+    }
+
+    uint32_t us = k_cyc_to_us_floor32(cycles);
+    t->stats.encodes++;
+    t->stats.last_us = us;
+    t->stats.max_us = MAX(t->stats.max_us, us);
+    t->total_us += us;
+    t->stats.avg_us = (uint32_t)(t->total_us / t->stats.encodes);
+}
+
+int tx_mode_start(uint8_t id, const uint8_t *payload, size_t len, freq_uhz_t base,
+                  bool now, struct tx_mode_start *out) {
+    const struct tx_mode *mode = tx_mode_find(id);
+    if (!mode) {
+        return -ENOTSUP;
+    }
+
+    uint32_t start = k_cycle_get_32();
+    int ret = mode->parse(payload, len);
+    if (ret) {
+        record_encode(mode, 0, false);
+        return ret;
+    }
+
+    memset(out, 0, sizeof(*out));
+    mode->estimate(&out->est);
+
+    /* The previous sequence may stream from buffers open replaces */
+    tx_engine_stop();
+
+    mode_seq = (tx_sequence_t){ .base_freq_uhz = base };
+    ret = mode->open(&mode_seq);
+    if (ret == 0 && mode_seq.total_symbols == 0) {
+        ret = -EINVAL;      // nothing in the message the mode can send
+    }
+    uint32_t cycles = k_cycle_get_32() - start;
+    record_encode(mode, cycles, ret == 0);
+    if (ret) {
+        printk("tx_mode: %s encode failed (%d)\n", mode->name, ret);
+        return ret;
+    }
+    out->encode_us = k_cyc_to_us_floor32(cycles);
+
+    if (now || mode->slot_us == 0) {
+        tx_engine_start(&mode_seq);
+        return tx_engine_is_active() ? 0 : -EIO;
+    }
+
+    out->start_utc_us = tx_mode_next_slot_us(timebase_now_us(), START_LEAD_US,
+                                             mode->slot_us, mode->slot_delay_us);
+    return tx_engine_start_at(&mode_seq, out->start_utc_us);
+}
+
+void tx_mode_get_stats(const struct tx_mode *mode, struct tx_mode_stats *out) {
+    *out = timing[mode->id].stats;
+}
+
+void tx_mode_reset_stats(void) {
+    memset(timing, 0, sizeof(timing));
+}
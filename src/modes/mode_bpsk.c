@@ -0,0 +1,36 @@
+#include "modes/mode.h"
+#include "modes/encoders/bpsk.h"
+
+#include <errno.h>
+
+/* Payload: the text */
+static const char *bpsk_text;
+
+static int bpsk_parse(const uint8_t *payload, size_t len) {
+    if (len == 0) {
+        return -EINVAL;
+    }
+    bpsk_text = tx_mode_text(payload, len);
+    return 0;
+}
+
+static void bpsk_estimate(struct tx_mode_estimate *est) {
+    est->symbols = bpsk31_symbol_count(bpsk_text);
+    est->duration_ms = est->symbols * (BPSK31_SYMBOL_US / 1000);
+}
+
+static int bpsk_open(tx_sequence_t *seq) {
+    int ret = generate_bpsk31_sequence(bpsk_text, seq);
+    if (ret) {
+        return ret == -2 ? -ENOMEM : -EINVAL;
+    }
+    return 0;
+}
+
+TX_MODE_DEFINE(tx_mode_bpsk31,
+    .name = "BPSK31",
+    .id = TX_MODE_BPSK31,
+    .parse = bpsk_parse,
+    .estimate = bpsk_estimate,
+    .open = bpsk_open,
+);
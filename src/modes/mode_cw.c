@@ -0,0 +1,69 @@
+#include "modes/mode.h"
+#include "modes/encoders/cw.h"
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+/* Payload: wpm, then the text */
+static const char *cw_text;
+static uint8_t cw_wpm;
+static tx_symbol_t *cw_symbols;     // allocated by the encoder, freed here
+
+static int cw_parse(const uint8_t *payload, size_t len) {
+    if (len < 2 || payload[0] == 0) {
+        return -EINVAL;
+    }
+    cw_wpm = payload[0];
+    cw_text = tx_mode_text(payload + 1, len - 1);
+
+    for (const char *p = cw_text; *p; p++) {
+        if (cw_code(*p)) {
+            return 0;
+        }
+    }
+    return -EINVAL;     // nothing to key
+}
+
+/* Units as generate_cw_sequence keys them: an element and the gap after
+ * it, two more between characters and six more for a space */
+static void cw_estimate(struct tx_mode_estimate *est) {
+    cw_timing_t timing;
+    uint32_t units = 0;
+    bool started = false;
+
+    cw_timing(cw_wpm, 0, &timing);
+    est->symbols = 0;
+
+    for (const char *p = cw_text; *p; p++) {
+        if (*p == ' ') {
+            units += started ? 6 : 0;
+            continue;
+        }
+        uint8_t code = cw_code(*p);
+        if (!code) {
+            continue;
+        }
+        units += started ? 2 : 0;
+        for (; code > 1; code >>= 1) {
+            units += (code & 1) ? 4 : 2;
+            est->symbols += 2;
+        }
+        started = true;
+    }
+    est->duration_ms = (uint32_t)((uint64_t)units * timing.dot_us / 1000);
+}
+
+static int cw_open(tx_sequence_t *seq) {
+    k_free(cw_symbols);
+    generate_cw_sequence(cw_text, cw_wpm, seq);
+    cw_symbols = seq->symbols;
+    return seq->total_symbols ? 0 : -ENOMEM;
+}
+
+TX_MODE_DEFINE(tx_mode_cw,
+    .name = "CW",
+    .id = TX_MODE_CW,
+    .parse = cw_parse,
+    .estimate = cw_estimate,
+    .open = cw_open,
+);
@@ -0,0 +1,53 @@
+#include "modes/mode.h"
+#include "modes/encoders/fst4w.h"
+
+#include <errno.h>
+#include <string.h>
+
+/* Payload as WSPR: power dBm, the 4-character grid, then the callsign.
+ * The four T/R periods share it and differ only in the symbol length. */
+static wspr_payload_t fst4w_msg;
+
+static int fst4w_parse(const uint8_t *payload, size_t len) {
+    if (len < 1 + 4 + 1 || len > 1 + 4 + sizeof(fst4w_msg.callsign) - 1) {
+        return -EINVAL;
+    }
+
+    memset(&fst4w_msg, 0, sizeof(fst4w_msg));
+    fst4w_msg.power_dbm = payload[0];
+    memcpy(fst4w_msg.grid, payload + 1, 4);
+    memcpy(fst4w_msg.callsign, payload + 5, len - 5);
+    return 0;
+}
+
+static void fst4w_estimate(enum fst4w_period period, struct tx_mode_estimate *est) {
+    est->symbols = FST4W_SYMBOL_COUNT;
+    est->duration_ms = (uint32_t)(fst4w_symbol_start_us(period, FST4W_SYMBOL_COUNT) / 1000);
+}
+
+/* Streamed straight from the encoder: the codeword is all it keeps */
+static int fst4w_open(enum fst4w_period period, tx_sequence_t *seq) {
+    return generate_fst4w_sequence(&fst4w_msg, period, seq) ? -EINVAL : 0;
+}
+
+#define FST4W_MODE(secs)                                                    \
+    static void fst4w_##secs##_estimate(struct tx_mode_estimate *est) {     \
+        fst4w_estimate(FST4W_##secs, est);                                  \
+    }                                                                       \
+    static int fst4w_##secs##_open(tx_sequence_t *seq) {                    \
+        return fst4w_open(FST4W_##secs, seq);                               \
+    }                                                                       \
+    TX_MODE_DEFINE(tx_mode_fst4w_##secs,                                    \
+        .name = "FST4W-" #secs,                                             \
+        .id = TX_MODE_FST4W_##secs,                                         \
+        .slot_us = secs * 1000000U,                                         \
+        .slot_delay_us = FST4W_TX_DELAY_US,                                 \
+        .parse = fst4w_parse,                                               \
+        .estimate = fst4w_##secs##_estimate,                                \
+        .open = fst4w_##secs##_open,                                        \
+    )
+
+FST4W_MODE(120);
+FST4W_MODE(300);
+FST4W_MODE(900);
+FST4W_MODE(1800);
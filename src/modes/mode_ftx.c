@@ -0,0 +1,88 @@
+#include "modes/mode.h"
+#include "modes/ftx.h"
+#include "modes/seq_cache.h"
+#include "modes/encoders/ft8.h"
+#include "modes/encoders/ft4.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+
+/* Payload: a kind byte, then free text of up to 13 characters, or the
+ * 77-bit message as packed by encode_ftx_payload (10 bytes) for any
+ * other type. FT8 and FT4 share the parsed message. */
+#define FTX_MSG_TEXT        0
+#define FTX_MSG_PACKED      1
+
+#define FT8_SYMBOLS         79
+#define FT4_SYMBOLS         105
+
+static ftx_payload_t ftx_msg;
+
+static int ftx_parse(const uint8_t *payload, size_t len) {
+    if (len < 1) {
+        return -EINVAL;
+    }
+
+    switch (payload[0]) {
+        case FTX_MSG_TEXT:
+            if (len < 2 || len > 1 + sizeof(ftx_msg.data.free_text.text) - 1) {
+                return -EINVAL;
+            }
+            memset(&ftx_msg, 0, sizeof(ftx_msg));
+            ftx_msg.type = FTX_MODE_FREE_TEXT;
+            for (size_t i = 1; i < len; i++) {
+                ftx_msg.data.free_text.text[i - 1] = toupper(payload[i]);
+            }
+            return 0;
+        case FTX_MSG_PACKED:
+            if (len != 1 + 10) {
+                return -EINVAL;
+            }
+            return decode_ftx_payload(payload + 1, &ftx_msg) ? -EINVAL : 0;
+        default:
+            return -EINVAL;
+    }
+}
+
+#ifdef CONFIG_MODE_FT8
+static void ft8_estimate(struct tx_mode_estimate *est) {
+    est->symbols = FT8_SYMBOLS;
+    est->duration_ms = FT8_SYMBOLS * 160;
+}
+
+static int ft8_open(tx_sequence_t *seq) {
+    return seq_cache_ft8(&ftx_msg, seq);
+}
+
+TX_MODE_DEFINE(tx_mode_ft8,
+    .name = "FT8",
+    .id = TX_MODE_FT8,
+    .slot_us = FT8_SLOT_US,
+    .slot_delay_us = FT8_TX_DELAY_US,
+    .parse = ftx_parse,
+    .estimate = ft8_estimate,
+    .open = ft8_open,
+);
+#endif
+
+#ifdef CONFIG_MODE_FT4
+static void ft4_estimate(struct tx_mode_estimate *est) {
+    est->symbols = FT4_SYMBOLS;
+    est->duration_ms = FT4_SYMBOLS * 48;
+}
+
+static int ft4_open(tx_sequence_t *seq) {
+    return seq_cache_ft4(&ftx_msg, seq);
+}
+
+TX_MODE_DEFINE(tx_mode_ft4,
+    .name = "FT4",
+    .id = TX_MODE_FT4,
+    .slot_us = FT4_SLOT_US,
+    .slot_delay_us = FT4_TX_DELAY_US,
+    .parse = ftx_parse,
+    .estimate = ft4_estimate,
+    .open = ft4_open,
+);
+#endif
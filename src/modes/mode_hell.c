@@ -0,0 +1,40 @@
+#include "modes/mode.h"
+#include "modes/encoders/hell.h"
+
+#include <errno.h>
+#include <string.h>
+
+/* Payload: the text */
+static const char *hell_text;
+
+static int hell_parse(const uint8_t *payload, size_t len) {
+    if (len == 0) {
+        return -EINVAL;
+    }
+    hell_text = tx_mode_text(payload, len);
+    return 0;
+}
+
+/* Every pixel a symbol of its own at worst; runs merge most of them */
+static void hell_estimate(struct tx_mode_estimate *est) {
+    uint32_t cells = strlen(hell_text);
+
+    est->symbols = cells * HELL_CELL_PIXELS;
+    est->duration_ms = cells * (HELL_CELL_US / 1000);
+}
+
+static int hell_open(tx_sequence_t *seq) {
+    int ret = generate_hell_sequence(hell_text, seq);
+    if (ret) {
+        return ret == -2 ? -ENOMEM : -EINVAL;
+    }
+    return 0;
+}
+
+TX_MODE_DEFINE(tx_mode_hell,
+    .name = "Feld-Hell",
+    .id = TX_MODE_HELL,
+    .parse = hell_parse,
+    .estimate = hell_estimate,
+    .open = hell_open,
+);
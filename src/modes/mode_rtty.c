@@ -0,0 +1,73 @@
+#include "modes/mode.h"
+#include "modes/encoders/rtty.h"
+#include "protocol/payload_utils.h"
+
+#include <errno.h>
+
+/* Payload: flags, baud x100 (u16), shift Hz (u16), stop bits x10,
+ * diddles, then the text. Flags are those of the keyer. */
+#define RTTY_FLAG_REVERSE   (1u << 0)
+#define RTTY_FLAG_CENTER    (1u << 1)
+#define RTTY_FLAG_USOS      (1u << 2)
+
+static rtty_config_t rtty_cfg;
+static const char *rtty_text;
+
+static int rtty_parse(const uint8_t *payload, size_t len) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, len);
+
+    uint8_t flags = cursor_get_u8(&cursor);
+    uint16_t baud_x100 = cursor_get_u16(&cursor);
+    uint16_t shift_hz = cursor_get_u16(&cursor);
+    uint8_t stop_bits_x10 = cursor_get_u8(&cursor);
+    uint8_t diddles = cursor_get_u8(&cursor);
+
+    if (cursor.error || cursor.remaining == 0 || baud_x100 == 0 || stop_bits_x10 == 0) {
+        return -EINVAL;
+    }
+
+    rtty_cfg = (rtty_config_t){
+        .baud_rate = baud_x100 / 100.0f,
+        .shift_hz = shift_hz,
+        .stop_bits = stop_bits_x10 / 10.0f,
+        .reverse_shift = flags & RTTY_FLAG_REVERSE,
+        .use_center_freq = flags & RTTY_FLAG_CENTER,
+        .unshift_on_space = flags & RTTY_FLAG_USOS,
+        .diddles = diddles,
+    };
+    rtty_text = tx_mode_text(cursor.ptr, cursor.remaining);
+    return 0;
+}
+
+static void rtty_estimate(struct tx_mode_estimate *est) {
+    rtty_keying_t keying;
+    uint32_t chars = rtty_cfg.diddles;
+    bool figs = false;
+
+    rtty_keying(&rtty_cfg, &keying);
+    for (const char *p = rtty_text; *p; p++) {
+        uint8_t codes[2];
+        chars += rtty_encode_char(*p, &figs, rtty_cfg.unshift_on_space, codes);
+    }
+
+    uint64_t char_us = (RTTY_SYMBOLS_PER_CHAR - 1) * (uint64_t)keying.bit_us + keying.stop_us;
+    est->symbols = chars * RTTY_SYMBOLS_PER_CHAR;
+    est->duration_ms = (uint32_t)(chars * char_us / 1000);
+}
+
+static int rtty_open(tx_sequence_t *seq) {
+    int ret = generate_rtty_sequence(rtty_text, &rtty_cfg, seq);
+    if (ret) {
+        return ret == -2 ? -ENOMEM : -EINVAL;
+    }
+    return 0;
+}
+
+TX_MODE_DEFINE(tx_mode_rtty,
+    .name = "RTTY",
+    .id = TX_MODE_RTTY,
+    .parse = rtty_parse,
+    .estimate = rtty_estimate,
+    .open = rtty_open,
+);
@@ -0,0 +1,47 @@
+#include "modes/mode.h"
+#include "modes/encoders/wspr.h"
+#include "modes/seq_cache.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define WSPR_SYMBOLS        162
+#define WSPR_DURATION_MS    110592      // 162 symbols of 8192/12000 s
+#define WSPR_SLOT_US        120000000U
+#define WSPR_TX_DELAY_US    1000000U    // into the even minute
+
+/* Payload: power dBm, the 4-character grid, then the callsign */
+static wspr_payload_t wspr_msg;
+
+static int wspr_parse(const uint8_t *payload, size_t len) {
+    if (len < 1 + 4 + 1 || len > 1 + 4 + sizeof(wspr_msg.callsign) - 1) {
+        return -EINVAL;
+    }
+
+    memset(&wspr_msg, 0, sizeof(wspr_msg));
+    wspr_msg.power_dbm = payload[0];
+    memcpy(wspr_msg.grid, payload + 1, 4);
+    memcpy(wspr_msg.callsign, payload + 5, len - 5);
+    return 0;
+}
+
+static void wspr_estimate(struct tx_mode_estimate *est) {
+    est->symbols = WSPR_SYMBOLS;
+    est->duration_ms = WSPR_DURATION_MS;
+}
+
+/* Through the cache: a beacon sends the same message over and over */
+static int wspr_open(tx_sequence_t *seq) {
+    int ret = seq_cache_wspr(&wspr_msg, seq);
+    return ret == -1 ? -EINVAL : ret;   // the encoder's -1 is a bad message
+}
+
+TX_MODE_DEFINE(tx_mode_wspr,
+    .name = "WSPR",
+    .id = TX_MODE_WSPR,
+    .slot_us = WSPR_SLOT_US,
+    .slot_delay_us = WSPR_TX_DELAY_US,
+    .parse = wspr_parse,
+    .estimate = wspr_estimate,
+    .open = wspr_open,
+);
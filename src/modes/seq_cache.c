@@ -0,0 +1,375 @@
+#include "modes/seq_cache.h"
+#ifdef CONFIG_MODE_WSPR
+#include "modes/encoders/wspr.h"
+#endif
+#ifdef CONFIG_MODE_FT8
+#include "modes/encoders/ft8.h"
+#endif
+#ifdef CONFIG_MODE_FT4
+#include "modes/encoders/ft4.h"
+#endif
+
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#ifdef CONFIG_SEQ_CACHE_SPILL
+#include <zephyr/settings/settings.h>
+#endif
+
+enum {
+    SEQ_MODE_WSPR = 0,
+    SEQ_MODE_FT8,
+    SEQ_MODE_FT4,
+};
+
+static char *const mode_names[] = { "WSPR", "FT8", "FT4" };
+
+#define SEQ_KEY_MAX         12      // WSPR callsign, grid and power
+#define SEQ_PALETTE_MAX     8
+#define SEQ_SYMBOLS_MAX     162     // WSPR, the longest
+#define SEQ_PACKED_MAX      ((SEQ_SYMBOLS_MAX * 3 + 7) / 8 + 1)  // indices read in pairs of bytes
+
+/* One sequence as its distinct symbols and an index into them per symbol,
+ * index_bits wide and LSB first. Zeroed before it is filled so that the
+ * same sequence always stores as the same bytes. */
+struct seq_record {
+    uint32_t hash;
+    uint8_t mode;
+    uint8_t key_len;
+    uint8_t key[SEQ_KEY_MAX];
+    uint8_t palette_len;
+    uint8_t index_bits;
+    uint16_t count;
+    tx_symbol_t palette[SEQ_PALETTE_MAX];
+    uint8_t packed[SEQ_PACKED_MAX];
+};
+
+struct seq_slot {
+    struct seq_record rec;
+    uint32_t used;          // LRU stamp, 0 for an empty slot
+};
+
+typedef int (*seq_encoder_t)(const void *payload, tx_sequence_t *tx_sequence);
+
+static struct seq_slot slots[CONFIG_SEQ_CACHE_ENTRIES];
+static uint32_t use_clock;
+
+/* What the last sequence handed out streams from */
+static struct seq_record current;
+
+/* A record being read from storage or built from the encoder */
+static struct seq_record scratch;
+
+static struct seq_cache_stats stats;
+
+K_MUTEX_DEFINE(seq_cache_lock);
+
+/* FNV-1a over the mode and key */
+static uint32_t seq_hash(uint8_t mode, const uint8_t *key, size_t key_len) {
+    uint32_t h = 2166136261u;
+
+    h = (h ^ mode) * 16777619u;
+    for (size_t i = 0; i < key_len; i++) {
+        h = (h ^ key[i]) * 16777619u;
+    }
+    return h;
+}
+
+static bool record_matches(const struct seq_record *rec, uint32_t hash, uint8_t mode,
+                           const uint8_t *key, size_t key_len) {
+    return rec->hash == hash && rec->mode == mode && rec->key_len == key_len &&
+           memcmp(rec->key, key, key_len) == 0;
+}
+
+static bool symbol_equal(const tx_symbol_t *a, const tx_symbol_t *b) {
+    return a->freq_offset_uhz == b->freq_offset_uhz && a->duration_us == b->duration_us &&
+           a->tx_on == b->tx_on && a->invert == b->invert && a->shape == b->shape;
+}
+
+static unsigned int record_index(const struct seq_record *rec, size_t i) {
+    size_t bit = i * rec->index_bits;
+    unsigned int v = rec->packed[bit / 8] | ((unsigned int)rec->packed[bit / 8 + 1] << 8);
+
+    return (v >> (bit % 8)) & ((1u << rec->index_bits) - 1);
+}
+
+static int cache_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    const struct seq_record *rec = seq->source_ctx;
+
+    if (index >= rec->count) {
+        return -EINVAL;
+    }
+
+    *out = rec->palette[record_index(rec, index)];
+    return 0;
+}
+
+/* Read the sequence the encoder produced into rec. -ENOTSUP when it does
+ * not fit a record. */
+static int record_build(struct seq_record *rec, const tx_sequence_t *seq) {
+    static uint8_t index[SEQ_SYMBOLS_MAX];
+    size_t count = seq->total_symbols;
+
+    if (count == 0 || count > SEQ_SYMBOLS_MAX) {
+        return -ENOTSUP;
+    }
+
+    rec->palette_len = 0;
+    for (size_t i = 0; i < count; i++) {
+        tx_symbol_t sym;
+        if (seq->symbols) {
+            sym = seq->symbols[i];
+        } else if (seq->source(seq, i, &sym) != 0) {
+            return -ENOTSUP;
+        }
+
+        uint8_t p = 0;
+        while (p < rec->palette_len && !symbol_equal(&rec->palette[p], &sym)) {
+            p++;
+        }
+        if (p == rec->palette_len) {
+            if (p == SEQ_PALETTE_MAX) {
+                return -ENOTSUP;
+            }
+            /* Field by field, so padding stays zero */
+            rec->palette[p].freq_offset_uhz = sym.freq_offset_uhz;
+            rec->palette[p].duration_us = sym.duration_us;
+            rec->palette[p].tx_on = sym.tx_on;
+            rec->palette[p].invert = sym.invert;
+            rec->palette[p].shape = sym.shape;
+            rec->palette_len++;
+        }
+        index[i] = p;
+    }
+
+    rec->index_bits = rec->palette_len <= 2 ? 1 : rec->palette_len <= 4 ? 2 : 3;
+    rec->count = count;
+    for (size_t i = 0; i < count; i++) {
+        size_t bit = i * rec->index_bits;
+        rec->packed[bit / 8] |= index[i] << (bit % 8);
+        if (bit % 8 + rec->index_bits > 8) {
+            rec->packed[bit / 8 + 1] |= index[i] >> (8 - bit % 8);
+        }
+    }
+    return 0;
+}
+
+#ifdef CONFIG_SEQ_CACHE_SPILL
+struct spill_load {
+    struct seq_record *rec;
+    bool found;
+};
+
+static void spill_name(char *name, size_t len, uint32_t hash) {
+    snprintk(name, len, "seqc/%u", (unsigned int)(hash % CONFIG_SEQ_CACHE_SPILL_SLOTS));
+}
+
+static int spill_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+                         void *cb_arg, void *param) {
+    struct spill_load *load = param;
+
+    if (key != NULL || len != sizeof(*load->rec)) {
+        return 0;
+    }
+    if (read_cb(cb_arg, load->rec, sizeof(*load->rec)) == sizeof(*load->rec)) {
+        load->found = true;
+    }
+    return 0;
+}
+
+/* Look for the record in storage; a slot holding another message, or a
+ * record from an older layout, does not match */
+static bool spill_find(struct seq_record *rec, uint32_t hash, uint8_t mode,
+                       const uint8_t *key, size_t key_len) {
+    char name[16];
+    struct spill_load load = { .rec = rec };
+
+    spill_name(name, sizeof(name), hash);
+    if (settings_load_subtree_direct(name, spill_load_cb, &load) != 0 || !load.found) {
+        return false;
+    }
+    return record_matches(rec, hash, mode, key, key_len) && rec->count <= SEQ_SYMBOLS_MAX &&
+           rec->palette_len >= 1 && rec->palette_len <= SEQ_PALETTE_MAX &&
+           rec->index_bits >= 1 && rec->index_bits <= 3 &&
+           (1u << rec->index_bits) >= rec->palette_len;
+}
+
+static void spill_store(const struct seq_record *rec) {
+    char name[16];
+
+    spill_name(name, sizeof(name), rec->hash);
+    int ret = settings_save_one(name, rec, sizeof(*rec));
+    if (ret) {
+        printk("seq_cache: spill failed (%d)\n", ret);
+        stats.spill_errors++;
+        return;
+    }
+    stats.spill_writes++;
+}
+#endif
+
+/* The slot for a new entry: an empty one, else the least recently used */
+static struct seq_slot *slot_claim(void) {
+    struct seq_slot *victim = &slots[0];
+
+    for (int i = 0; i < CONFIG_SEQ_CACHE_ENTRIES; i++) {
+        if (slots[i].used == 0) {
+            return &slots[i];
+        }
+        if (slots[i].used < victim->used) {
+            victim = &slots[i];
+        }
+    }
+    stats.evictions++;
+    return victim;
+}
+
+/* Stamps are 32 bits: one a second would take 136 years to wrap */
+static void slot_store(const struct seq_record *rec) {
+    struct seq_slot *slot = slot_claim();
+
+    slot->rec = *rec;
+    slot->used = ++use_clock;
+}
+
+static void sequence_from(tx_sequence_t *tx_sequence, const struct seq_record *rec) {
+    current = *rec;
+
+    tx_sequence->mode_name = mode_names[current.mode];
+    tx_sequence->symbols = NULL;
+    tx_sequence->source = cache_symbol;
+    tx_sequence->source_ctx = &current;
+    tx_sequence->total_symbols = current.count;
+    tx_sequence->current_index = 0;
+}
+
+static int seq_cache_get(uint8_t mode, const uint8_t *key, size_t key_len,
+                         seq_encoder_t encode, const void *payload,
+                         tx_sequence_t *tx_sequence) {
+    uint32_t hash = seq_hash(mode, key, key_len);
+    int ret = 0;
+
+    k_mutex_lock(&seq_cache_lock, K_FOREVER);
+
+    for (int i = 0; i < CONFIG_SEQ_CACHE_ENTRIES; i++) {
+        if (slots[i].used && record_matches(&slots[i].rec, hash, mode, key, key_len)) {
+            stats.hits++;
+            slots[i].used = ++use_clock;
+            sequence_from(tx_sequence, &slots[i].rec);
+            goto out;
+        }
+    }
+
+    memset(&scratch, 0, sizeof(scratch));
+#ifdef CONFIG_SEQ_CACHE_SPILL
+    if (spill_find(&scratch, hash, mode, key, key_len)) {
+        stats.spill_hits++;
+        slot_store(&scratch);
+        sequence_from(tx_sequence, &scratch);
+        goto out;
+    }
+    memset(&scratch, 0, sizeof(scratch));
+#endif
+
+    stats.misses++;
+    ret = encode(payload, tx_sequence);
+    if (ret) {
+        goto out;
+    }
+
+    scratch.hash = hash;
+    scratch.mode = mode;
+    scratch.key_len = key_len;
+    memcpy(scratch.key, key, key_len);
+    if (record_build(&scratch, tx_sequence) != 0) {
+        /* The encoder's own sequence goes out as it is */
+        stats.uncached++;
+        goto out;
+    }
+
+#ifdef CONFIG_SEQ_CACHE_SPILL
+    spill_store(&scratch);
+#endif
+    slot_store(&scratch);
+    sequence_from(tx_sequence, &scratch);
+
+out:
+    k_mutex_unlock(&seq_cache_lock);
+    return ret;
+}
+
+#ifdef CONFIG_MODE_WSPR
+static int encode_wspr(const void *payload, tx_sequence_t *tx_sequence) {
+    return generate_wspr_sequence(payload, tx_sequence);
+}
+
+int seq_cache_wspr(const wspr_payload_t *payload, tx_sequence_t *tx_sequence) {
+    if (!payload || !tx_sequence) {
+        return -EINVAL;
+    }
+
+    /* Case does not change the message, so it does not change the key */
+    uint8_t key[SEQ_KEY_MAX] = { 0 };
+    for (size_t i = 0; i < sizeof(payload->callsign) && payload->callsign[i]; i++) {
+        key[i] = toupper((unsigned char)payload->callsign[i]);
+    }
+    for (size_t i = 0; i < 4 && payload->grid[i]; i++) {
+        key[7 + i] = toupper((unsigned char)payload->grid[i]);
+    }
+    key[11] = (uint8_t)payload->power_dbm;
+
+    return seq_cache_get(SEQ_MODE_WSPR, key, sizeof(key), encode_wspr, payload, tx_sequence);
+}
+#endif
+
+#ifdef CONFIG_MODE_FT8
+static int encode_ft8(const void *payload, tx_sequence_t *tx_sequence) {
+    return generate_ft8_sequence(payload, tx_sequence);
+}
+
+int seq_cache_ft8(const ftx_payload_t *payload, tx_sequence_t *tx_sequence) {
+    if (!payload || !tx_sequence) {
+        return -EINVAL;
+    }
+
+    uint8_t key[10];
+    encode_ftx_payload(payload, key);
+    return seq_cache_get(SEQ_MODE_FT8, key, sizeof(key), encode_ft8, payload, tx_sequence);
+}
+#endif
+
+#ifdef CONFIG_MODE_FT4
+static int encode_ft4(const void *payload, tx_sequence_t *tx_sequence) {
+    return generate_ft4_sequence(payload, tx_sequence);
+}
+
+int seq_cache_ft4(const ftx_payload_t *payload, tx_sequence_t *tx_sequence) {
+    if (!payload || !tx_sequence) {
+        return -EINVAL;
+    }
+
+    uint8_t key[10];
+    encode_ftx_payload(payload, key);
+    return seq_cache_get(SEQ_MODE_FT4, key, sizeof(key), encode_ft4, payload, tx_sequence);
+}
+#endif
+
+void seq_cache_get_stats(struct seq_cache_stats *out) {
+    k_mutex_lock(&seq_cache_lock, K_FOREVER);
+    *out = stats;
+    out->entries = 0;
+    for (int i = 0; i < CONFIG_SEQ_CACHE_ENTRIES; i++) {
+        if (slots[i].used) {
+            out->entries++;
+        }
+    }
+    out->capacity = CONFIG_SEQ_CACHE_ENTRIES;
+    k_mutex_unlock(&seq_cache_lock);
+}
+
+void seq_cache_reset_stats(void) {
+    k_mutex_lock(&seq_cache_lock, K_FOREVER);
+    memset(&stats, 0, sizeof(stats));
+    k_mutex_unlock(&seq_cache_lock);
+}
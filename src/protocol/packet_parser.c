@@ -18,6 +18,29 @@ static const cmd_entry_t cmd_table[] = {
     {0x06, handle_get_buck_boost_regulator},
     {0x07, handle_tx_test_signal},
     {0x08, handle_tr_switch},
+    {0x09, handle_get_tx_stats},
+    {0x0A, handle_get_calibration},
+    {0x0B, handle_set_calibration},
+    {0x0C, handle_set_alc},
+    {0x0D, handle_get_alc},
+    {0x0E, handle_set_telemetry},
+    {0x0F, handle_set_swr_trip},
+    {0x10, handle_get_swr_trip},
+    {0x11, handle_get_timebase},
+    {0x12, handle_time_probe},
+    {0x13, handle_time_adjust},
+#ifdef CONFIG_KEYER
+    {0x14, handle_keyer_start},
+    {0x15, handle_keyer_text},
+    {0x16, handle_get_keyer},
+#endif
+    {0x17, handle_set_envelope},
+    {0x18, handle_get_envelope},
+#ifdef CONFIG_SEQ_CACHE
+    {0x19, handle_get_seq_cache},
+#endif
+    {0x1A, handle_mode_start},
+    {0x1B, handle_get_mode_stats},
     {0xFD, handle_reset},
 };
 
@@ -0,0 +1,174 @@
+#include "radio/alc.h"
+#include "hardware/adc_sampler.h"
+#include "config.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/regulator.h>
+#include <zephyr/sys/printk.h>
+
+#define ALC_STACK_SIZE  1024
+#define ALC_PRIO        12
+
+/* Single-pole smoothing applied to each decimated loop sample */
+#define ALC_FILTER_ALPHA 0.3f
+
+static K_SEM_DEFINE(alc_sem, 0, 1);
+static struct adc_sampler_listener alc_listener;
+static struct k_spinlock alc_lock;
+
+/* Decimator: block sums from the DMA ISR, drained once per loop period */
+static uint32_t acc_sum;
+static uint32_t acc_count;
+
+static volatile bool alc_enabled;
+static volatile bool gate_open = true;
+static struct alc_status status;
+
+static float fwd_filt;
+static float integ_uv;
+
+static void alc_adc_handler(const struct adc_frame *frames, size_t count) {
+    uint32_t sum = 0;
+
+    if (!gate_open) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        sum += frames[i].fwd;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&alc_lock);
+    acc_sum += sum;
+    acc_count += count;
+    k_spin_unlock(&alc_lock, key);
+}
+
+static bool alc_take_mean(uint32_t *mean) {
+    k_spinlock_key_t key = k_spin_lock(&alc_lock);
+    uint32_t sum = acc_sum;
+    uint32_t count = acc_count;
+    acc_sum = 0;
+    acc_count = 0;
+    k_spin_unlock(&alc_lock, key);
+
+    if (count == 0) {
+        return false;
+    }
+    *mean = sum / count;
+    return true;
+}
+
+static void alc_loop_start(void) {
+    int32_t uv = CONFIG_ALC_MIN_UV;
+    uint32_t dummy;
+
+    /* Bumpless start from whatever the host or last loop left behind */
+    regulator_get_voltage(regulator, &uv);
+    integ_uv = (float)uv;
+    fwd_filt = -1.0f;
+    alc_take_mean(&dummy);
+
+    k_spinlock_key_t key = k_spin_lock(&alc_lock);
+    status.active = true;
+    status.supply_uv = uv;
+    k_spin_unlock(&alc_lock, key);
+}
+
+static void alc_step(void) {
+    const float dt = 1.0f / CONFIG_ALC_LOOP_HZ;
+    uint32_t mean;
+
+    if (!alc_take_mean(&mean)) {
+        return;
+    }
+
+    float mv = (float)adc_sampler_to_mv(mean);
+    if (fwd_filt < 0.0f) {
+        fwd_filt = mv;
+    } else {
+        fwd_filt += ALC_FILTER_ALPHA * (mv - fwd_filt);
+    }
+
+    float err = (float)status.target_mv - fwd_filt;
+    float next_integ = integ_uv + CONFIG_ALC_KI * err * dt;
+    float out = next_integ + CONFIG_ALC_KP * err;
+    bool saturated = false;
+
+    if (out > CONFIG_ALC_MAX_UV) {
+        out = CONFIG_ALC_MAX_UV;
+        saturated = true;
+    } else if (out < CONFIG_ALC_MIN_UV) {
+        out = CONFIG_ALC_MIN_UV;
+        saturated = true;
+    }
+
+    /* Conditional integration: hold the integrator while clamped */
+    if (!saturated) {
+        integ_uv = next_integ;
+    }
+
+    /* The driver quantises to its REF step and skips unchanged writes */
+    int32_t uv = (int32_t)out;
+    regulator_set_voltage(regulator, uv, uv);
+    regulator_get_voltage(regulator, &uv);
+
+    k_spinlock_key_t key = k_spin_lock(&alc_lock);
+    status.fwd_mv = (uint16_t)fwd_filt;
+    status.saturated = saturated;
+    status.supply_uv = uv;
+    k_spin_unlock(&alc_lock, key);
+}
+
+static void alc_thread(void *p1, void *p2, void *p3) {
+    while (1) {
+        k_sem_take(&alc_sem, K_FOREVER);
+
+        alc_loop_start();
+        while (alc_enabled && regulator_is_enabled(regulator)) {
+            k_sleep(K_USEC(USEC_PER_SEC / CONFIG_ALC_LOOP_HZ));
+            alc_step();
+        }
+
+        k_spinlock_key_t key = k_spin_lock(&alc_lock);
+        status.active = false;
+        k_spin_unlock(&alc_lock, key);
+    }
+}
+
+K_THREAD_DEFINE(alc_tid, ALC_STACK_SIZE, alc_thread, NULL, NULL, NULL, ALC_PRIO, 0, 0);
+
+void alc_init(void) {
+    alc_enabled = false;
+    status = (struct alc_status){ 0 };
+    alc_listener.handler = alc_adc_handler;
+    adc_sampler_add_listener(&alc_listener);
+}
+
+void alc_set_target(bool enable, uint16_t target_mv) {
+    k_spinlock_key_t key = k_spin_lock(&alc_lock);
+    status.enabled = enable;
+    status.target_mv = target_mv;
+    k_spin_unlock(&alc_lock, key);
+
+    alc_enabled = enable;
+    if (enable) {
+        alc_kick();
+    }
+}
+
+void alc_get_status(struct alc_status *out) {
+    k_spinlock_key_t key = k_spin_lock(&alc_lock);
+    *out = status;
+    k_spin_unlock(&alc_lock, key);
+}
+
+void alc_kick(void) {
+    if (alc_enabled) {
+        k_sem_give(&alc_sem);
+    }
+}
+
+void alc_set_gate(bool open) {
+    gate_open = open;
+}
@@ -0,0 +1,261 @@
+#include "radio/freq_cal.h"
+#include "hardware/pps.h"
+#include "config.h"
+#include "drivers/clock_control/clock_si5351a.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/printk.h>
+#include <stdlib.h>
+
+/* The TX synthesizer runs from PLLA; PLLB is left uncorrected so that CLK2
+ * keeps reporting the raw crystal error. */
+#define CAL_PLL             'A'
+#define CAL_REF_OUTPUT      2
+#define CAL_REF_PLL_FREQ    800000000
+
+/* A single interval this far from nominal is a missed or doubled edge */
+#define CAL_INTERVAL_MAX_PPB 100000
+/* Consecutive outlier windows before the estimate is re-seeded */
+#define CAL_REJECT_LIMIT    4
+/* Running estimate moves 1/CAL_IIR_DIV of the way to each new window */
+#define CAL_IIR_DIV         4
+
+struct cal_est {
+    uint32_t nominal;
+    int64_t sum;
+    uint32_t count;
+    int32_t ppb;
+    bool valid;
+    uint8_t rejects;
+};
+
+K_MSGQ_DEFINE(pps_msgq, sizeof(struct pps_event), 4, 4);
+
+static struct k_work cal_work;
+static struct pps_listener cal_listener;
+static struct k_spinlock cal_lock;
+
+static struct cal_est mcu_est;
+static struct cal_est ref_est;
+static struct freq_cal_status status;
+
+static int32_t saved_ppb;
+static bool have_saved;
+
+static void cal_pps_handler(const struct pps_event *evt) {
+    if (k_msgq_put(&pps_msgq, evt, K_NO_WAIT) == 0) {
+        k_work_submit(&cal_work);
+    }
+}
+
+/* Returns true when a window completed and the estimate was updated */
+static bool est_add(struct cal_est *e, uint32_t interval) {
+    if (interval == 0) {
+        return false;
+    }
+
+    int64_t err = (int64_t)interval - e->nominal;
+    if (llabs(err) * 1000000000LL > (int64_t)CAL_INTERVAL_MAX_PPB * e->nominal) {
+        status.rejected++;
+        return false;
+    }
+
+    e->sum += err;
+    e->count++;
+    if (e->count < CONFIG_FREQ_CAL_WINDOW_S) {
+        return false;
+    }
+
+    int32_t ppb = (int32_t)(e->sum * 1000000000LL / ((int64_t)e->nominal * e->count));
+    e->sum = 0;
+    e->count = 0;
+    status.windows++;
+
+    if (e->valid && abs(ppb - e->ppb) > CONFIG_FREQ_CAL_OUTLIER_PPB &&
+        e->rejects < CAL_REJECT_LIMIT) {
+        e->rejects++;
+        status.rejected++;
+        return false;
+    }
+
+    if (!e->valid || e->rejects >= CAL_REJECT_LIMIT) {
+        e->ppb = ppb;
+        e->valid = true;
+    } else {
+        e->ppb += (ppb - e->ppb) / CAL_IIR_DIV;
+    }
+    e->rejects = 0;
+
+    return true;
+}
+
+static void cal_save(int32_t ppb) {
+    int ret = settings_save_one("cal/ppb", &ppb, sizeof(ppb));
+    if (ret) {
+        printk("freq_cal: save failed (%d)\n", ret);
+        return;
+    }
+    saved_ppb = ppb;
+    have_saved = true;
+}
+
+static int cal_apply(int32_t ppb, bool force) {
+    if (!force && abs(ppb - status.applied_ppb) < CONFIG_FREQ_CAL_DEADBAND_PPB) {
+        return 0;
+    }
+
+    int ret = si5351a_set_pll_correction(si5351a, CAL_PLL, ppb);
+    if (ret) {
+        printk("freq_cal: correction %d ppb failed (%d)\n", ppb, ret);
+        return ret;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&cal_lock);
+    status.applied_ppb = ppb;
+    status.flags &= ~FREQ_CAL_WARM_START;
+    k_spin_unlock(&cal_lock, key);
+
+    if (!have_saved || abs(ppb - saved_ppb) >= CONFIG_FREQ_CAL_SAVE_DELTA_PPB) {
+        cal_save(ppb);
+    }
+
+    return 0;
+}
+
+static void cal_work_handler(struct k_work *work) {
+    struct pps_event evt;
+
+    while (k_msgq_get(&pps_msgq, &evt, K_NO_WAIT) == 0) {
+        k_spinlock_key_t key = k_spin_lock(&cal_lock);
+        status.edges++;
+        est_add(&mcu_est, evt.cycle_interval);
+#ifdef CONFIG_PPS_TIMER_CLK2
+        bool ref_updated = est_add(&ref_est, evt.tick_interval);
+#else
+        bool ref_updated = false;
+#endif
+        int32_t ref_ppb = ref_est.ppb;
+        k_spin_unlock(&cal_lock, key);
+
+        if (ref_updated) {
+            cal_apply(ref_ppb, false);
+        }
+    }
+}
+
+#ifdef CONFIG_PPS_TIMER_CLK2
+/* CLK2 = PLLB / 80, looped back into TIM2_ETR so the capture timer counts
+ * crystal-derived ticks between PPS edges. */
+static int cal_ref_output_init(void) {
+    int ret = si5351a_set_pll_freq(si5351a, 'B', CAL_REF_PLL_FREQ);
+    if (ret) {
+        return ret;
+    }
+    ret = si5351a_set_ms_freq(si5351a, CAL_REF_OUTPUT,
+                              (uint64_t)CONFIG_PPS_TIMER_CLK2_HZ * 1000000, 'B');
+    if (ret) {
+        return ret;
+    }
+    ret = si5351a_reset_pll(si5351a, false, true);
+    if (ret) {
+        return ret;
+    }
+    return si5351a_enable_output(si5351a, CAL_REF_OUTPUT, true);
+}
+#endif
+
+static int cal_settings_set(const char *name, size_t len,
+                            settings_read_cb read_cb, void *cb_arg) {
+    const char *next;
+
+    if (settings_name_steq(name, "ppb", &next) && !next) {
+        int32_t ppb;
+        if (len != sizeof(ppb)) {
+            return -EINVAL;
+        }
+        int ret = read_cb(cb_arg, &ppb, sizeof(ppb));
+        if (ret < 0) {
+            return ret;
+        }
+        saved_ppb = ppb;
+        have_saved = true;
+        return 0;
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(freq_cal, "cal", NULL, cal_settings_set, NULL, NULL);
+
+int freq_cal_init(void) {
+    k_work_init(&cal_work, cal_work_handler);
+
+    mcu_est = (struct cal_est){ .nominal = sys_clock_hw_cycles_per_sec() };
+    ref_est = (struct cal_est){ .nominal = pps_timer_hz() };
+    status = (struct freq_cal_status){ 0 };
+
+#ifdef CONFIG_PPS_TIMER_CLK2
+    int ret = cal_ref_output_init();
+    if (ret) {
+        printk("freq_cal: CLK2 reference output failed (%d)\n", ret);
+        return ret;
+    }
+#endif
+
+    /* Warm start from the last stored value; it also seeds the estimate so
+     * the first window is checked against it. */
+    if (have_saved && si5351a_set_pll_correction(si5351a, CAL_PLL, saved_ppb) == 0) {
+        status.applied_ppb = saved_ppb;
+        status.flags |= FREQ_CAL_WARM_START;
+        ref_est.ppb = saved_ppb;
+        ref_est.valid = true;
+        printk("freq_cal: warm start at %d ppb\n", saved_ppb);
+    }
+
+    cal_listener.handler = cal_pps_handler;
+    pps_add_listener(&cal_listener);
+
+    return 0;
+}
+
+void freq_cal_get_status(struct freq_cal_status *out) {
+    k_spinlock_key_t key = k_spin_lock(&cal_lock);
+
+    *out = status;
+    out->mcu_ppb = mcu_est.ppb;
+    out->ref_ppb = ref_est.ppb;
+    if (pps_present()) {
+        out->flags |= FREQ_CAL_PPS_PRESENT;
+    }
+    if (mcu_est.valid) {
+        out->flags |= FREQ_CAL_MCU_VALID;
+    }
+    if (ref_est.valid) {
+        out->flags |= FREQ_CAL_REF_VALID;
+    }
+#ifdef CONFIG_PPS_TIMER_CLK2
+    out->flags |= FREQ_CAL_REF_MEASURED;
+#endif
+
+    k_spin_unlock(&cal_lock, key);
+}
+
+int freq_cal_set_ppb(int32_t ppb) {
+    int ret = cal_apply(ppb, true);
+    if (ret) {
+        return ret;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&cal_lock);
+    ref_est.ppb = ppb;
+    ref_est.valid = true;
+    ref_est.rejects = 0;
+    k_spin_unlock(&cal_lock, key);
+
+    if (!have_saved || saved_ppb != ppb) {
+        cal_save(ppb);
+    }
+
+    return 0;
+}
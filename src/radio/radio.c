@@ -1,5 +1,5 @@
 #include "radio/radio.h"
 #include <stdbool.h>
 
-uint64_t base_frequency = 10136000 * 100; // 100 to avoid floating point issues
+freq_uhz_t base_frequency = FREQ_HZ(10136000);
 bool tx_active = false;
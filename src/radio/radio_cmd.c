@@ -7,6 +7,21 @@
 #include "config.h"
 #include "zephyr/drivers/regulator.h"
 #include "hardware/tr_switch.h"
+#include "radio/freq_cal.h"
+#include "hardware/pa_monitor.h"
+#include "radio/alc.h"
+#include "hardware/adc_sampler.h"
+#include "radio/telemetry.h"
+#include "hardware/swr_guard.h"
+#include "radio/timebase.h"
+#ifdef CONFIG_KEYER
+#include "modes/keyer.h"
+#endif
+#include "hardware/envelope.h"
+#ifdef CONFIG_SEQ_CACHE
+#include "modes/seq_cache.h"
+#endif
+#include "modes/mode.h"
 
 #include <zephyr/sys/reboot.h>
 #include <zephyr/drivers/rtc.h>
@@ -84,7 +99,7 @@ void handle_rtc_get_time(const uint8_t *payload, uint8_t length, uint16_t id) {
     }
 }
 
-// base freq is 100 times the actual frequency to avoid floating point issues
+// base freq is in microhertz, see freq_uhz_t
 void handle_set_base_freq(const uint8_t *payload, uint8_t length, uint16_t id) {
     payload_cursor_t cursor;
     cursor_init(&cursor, payload, length);
@@ -94,7 +109,7 @@ void handle_set_base_freq(const uint8_t *payload, uint8_t length, uint16_t id) {
         return;
     }
 
-    uint64_t freq = cursor_get_u64(&cursor);
+    freq_uhz_t freq = (freq_uhz_t)cursor_get_u64(&cursor);
     base_frequency = clamp_frequency(freq);
 
     if (cursor.error) {
@@ -109,7 +124,7 @@ void handle_get_base_freq(const uint8_t *payload, uint8_t length, uint16_t id) {
     payload_writer_t writer;
     writer_init(&writer, buffer, sizeof(buffer));
 
-    writer_put_u64(&writer, base_frequency);
+    writer_put_u64(&writer, (uint64_t)base_frequency);
 
     if (writer.error) {
         send_nack(id);
@@ -134,9 +149,12 @@ void handle_set_buck_boost_regulator(const uint8_t *payload, uint8_t length, uin
 
     regulator_set_voltage(regulator, voltage_level * 1000000, voltage_level * 1000000);
 
-    if (buck_boost_regulator_enabled) {
+    bool was_enabled = regulator_is_enabled(regulator);
+    if (buck_boost_regulator_enabled && !was_enabled) {
         regulator_enable(regulator);
-    } else {
+        pa_monitor_kick();
+        alc_kick();
+    } else if (!buck_boost_regulator_enabled && was_enabled) {
         regulator_disable(regulator);
     }
 
@@ -220,14 +238,12 @@ void handle_tx_test_signal(const uint8_t *payload, uint8_t length, uint16_t id)
         return;
     }
 
-    test_signal_symbol.freq_offset_hz = 0.0f;
+    test_signal_symbol.freq_offset_uhz = 0;
     test_signal_symbol.duration_us = duration_ms * 1000U;
     test_signal_symbol.tx_on = true;
 
-    uint64_t clamped = clamp_frequency(base_frequency);
-
     test_signal_seq.mode_name = "test";
-    test_signal_seq.base_freq_hz = (uint32_t)(clamped / 100U);
+    test_signal_seq.base_freq_uhz = clamp_frequency(base_frequency);
     test_signal_seq.symbols = &test_signal_symbol;
     test_signal_seq.total_symbols = 1;
     test_signal_seq.current_index = 0;
@@ -236,3 +252,516 @@ void handle_tx_test_signal(const uint8_t *payload, uint8_t length, uint16_t id)
     tx_engine_start(&test_signal_seq);
     send_ack(id);
 }
+
+void handle_get_tx_stats(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct tx_engine_stats stats;
+    tx_engine_get_stats(&stats);
+
+    uint8_t buffer[76];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u32(&writer, stats.symbols);
+    writer_put_u32(&writer, stats.overruns);
+    writer_put_u32(&writer, stats.errors);
+    writer_put_u32(&writer, stats.last_bus_us);
+    writer_put_u32(&writer, stats.min_bus_us);
+    writer_put_u32(&writer, stats.max_bus_us);
+    writer_put_u32(&writer, stats.avg_bus_us);
+    writer_put_u32(&writer, stats.last_lag_us);
+    writer_put_u32(&writer, stats.max_lag_us);
+    writer_put_u32(&writer, stats.starts);
+    writer_put_u32(&writer, stats.last_start_late_us);
+    writer_put_u32(&writer, stats.max_start_late_us);
+    writer_put_u32(&writer, stats.flips);
+    writer_put_u32(&writer, stats.last_flip_lag_us);
+    writer_put_u32(&writer, stats.max_flip_lag_us);
+    writer_put_u32(&writer, (uint32_t)stats.last_sym_err_us);
+    writer_put_u32(&writer, stats.max_sym_err_us);
+    writer_put_u32(&writer, (uint32_t)stats.drift_us);
+    writer_put_u32(&writer, stats.max_drift_us);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (length >= 1 && payload[0] != 0) {
+        tx_engine_reset_stats();
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x09, buffer, payload_len, id);
+}
+
+void handle_get_calibration(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct freq_cal_status cal;
+    freq_cal_get_status(&cal);
+
+    uint8_t buffer[25];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u32(&writer, (uint32_t)cal.mcu_ppb);
+    writer_put_u32(&writer, (uint32_t)cal.ref_ppb);
+    writer_put_u32(&writer, (uint32_t)cal.applied_ppb);
+    writer_put_u32(&writer, cal.edges);
+    writer_put_u32(&writer, cal.windows);
+    writer_put_u32(&writer, cal.rejected);
+    writer_put_u8(&writer, cal.flags);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x0A, buffer, payload_len, id);
+}
+
+void handle_set_calibration(const uint8_t *payload, uint8_t length, uint16_t id) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    int32_t ppb = (int32_t)cursor_get_u32(&cursor);
+    if (cursor.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (freq_cal_set_ppb(ppb) == 0) {
+        send_ack(id);
+    } else {
+        send_nack(id);
+    }
+}
+
+void handle_set_alc(const uint8_t *payload, uint8_t length, uint16_t id) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    uint8_t enable = cursor_get_u8(&cursor);
+    uint16_t target_mv = cursor_get_u16(&cursor);
+    if (cursor.error || target_mv > ADC_SAMPLER_VREF_MV) {
+        send_nack(id);
+        return;
+    }
+
+    alc_set_target(enable != 0, target_mv);
+    send_ack(id);
+}
+
+void handle_get_alc(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct alc_status alc;
+    alc_get_status(&alc);
+
+    uint8_t buffer[9];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    uint8_t flags = (alc.enabled ? 0x01 : 0) | (alc.active ? 0x02 : 0) | (alc.saturated ? 0x04 : 0);
+    writer_put_u8(&writer, flags);
+    writer_put_u16(&writer, alc.target_mv);
+    writer_put_u16(&writer, alc.fwd_mv);
+    writer_put_u32(&writer, (uint32_t)alc.supply_uv);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x0D, buffer, payload_len, id);
+}
+
+void handle_set_telemetry(const uint8_t *payload, uint8_t length, uint16_t id) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    uint16_t rate_hz = cursor_get_u16(&cursor);
+    uint8_t batch_len = cursor_get_u8(&cursor);
+    if (cursor.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (telemetry_configure(rate_hz, batch_len) == 0) {
+        send_ack(id);
+    } else {
+        send_nack(id);
+    }
+}
+
+void handle_set_swr_trip(const uint8_t *payload, uint8_t length, uint16_t id) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    uint16_t threshold_mv = cursor_get_u16(&cursor);
+    if (cursor.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (swr_guard_set_threshold(threshold_mv) == 0) {
+        send_ack(id);
+    } else {
+        send_nack(id);
+    }
+}
+
+void handle_get_swr_trip(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct swr_guard_status swr;
+    swr_guard_get_status(&swr);
+
+    uint8_t buffer[11];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u8(&writer, (swr.armed ? 0x01 : 0) | (swr.tripped ? 0x02 : 0));
+    writer_put_u16(&writer, swr.threshold_mv);
+    writer_put_u32(&writer, swr.rx_latency_ns);
+    writer_put_u32(&writer, swr.off_latency_us);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x10, buffer, payload_len, id);
+}
+
+void handle_get_timebase(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct timebase_status tb;
+    timebase_get_status(&tb);
+    int64_t now_us = timebase_now_us();
+
+    uint8_t buffer[51];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u8(&writer, tb.state);
+    writer_put_u8(&writer, tb.flags);
+    writer_put_u8(&writer, tb.fit_edges);
+    writer_put_u64(&writer, (uint64_t)now_us);
+    writer_put_u32(&writer, (uint32_t)tb.rate_ppb);
+    writer_put_u32(&writer, (uint32_t)tb.last_residual_ns);
+    writer_put_u32(&writer, tb.rms_residual_ns);
+    writer_put_u32(&writer, tb.max_residual_ns);
+    writer_put_u32(&writer, tb.edges);
+    writer_put_u32(&writer, tb.rejected);
+    writer_put_u32(&writer, tb.restarts);
+    writer_put_u32(&writer, tb.alarms);
+    writer_put_u32(&writer, tb.late_alarms);
+    writer_put_u32(&writer, tb.max_alarm_latency_ns);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x11, buffer, payload_len, id);
+}
+
+void handle_time_probe(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct timebase_status tb;
+    timebase_get_status(&tb);
+
+    uint8_t buffer[17];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u8(&writer, tb.state);
+    writer_put_u64(&writer, (uint64_t)uart_handler_rx_time_us());
+
+    /* Stamped last so it sits as close to the reply's first byte as we can get */
+    writer_put_u64(&writer, (uint64_t)timebase_now_us());
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x12, buffer, payload_len, id);
+}
+
+void handle_time_adjust(const uint8_t *payload, uint8_t length, uint16_t id) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    int64_t step_us = (int64_t)cursor_get_u64(&cursor);
+    int32_t rate_ppb = (int32_t)cursor_get_u32(&cursor);
+    if (cursor.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (timebase_host_adjust(step_us, rate_ppb) == 0) {
+        send_ack(id);
+    } else {
+        send_nack(id);
+    }
+}
+
+#ifdef CONFIG_KEYER
+#define KEYER_FLAG_REVERSE   (1u << 0)
+#define KEYER_FLAG_CENTER    (1u << 1)
+#define KEYER_FLAG_USOS      (1u << 2)
+
+#define KEYER_TEXT_FINISH    (1u << 0)
+#define KEYER_TEXT_ABORT     (1u << 1)
+
+void handle_keyer_start(const uint8_t *payload, uint8_t length, uint16_t id) {
+    if (!tx_active) {
+        send_debug_message("Cannot start keyer: TX engine is not active");
+        send_nack(id);
+        return;
+    }
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    struct keyer_config cfg = { 0 };
+    cfg.mode = cursor_get_u8(&cursor);
+    uint8_t flags = cursor_get_u8(&cursor);
+    cfg.wpm = cursor_get_u8(&cursor);
+    cfg.effective_wpm = cursor_get_u8(&cursor);
+    uint16_t baud_x100 = cursor_get_u16(&cursor);
+    cfg.rtty.shift_hz = cursor_get_u16(&cursor);
+    uint8_t stop_bits_x10 = cursor_get_u8(&cursor);
+
+    if (cursor.error) {
+        send_nack(id);
+        return;
+    }
+
+    cfg.rtty.baud_rate = baud_x100 / 100.0f;
+    cfg.rtty.stop_bits = stop_bits_x10 / 10.0f;
+    cfg.rtty.reverse_shift = flags & KEYER_FLAG_REVERSE;
+    cfg.rtty.use_center_freq = flags & KEYER_FLAG_CENTER;
+    cfg.rtty.unshift_on_space = flags & KEYER_FLAG_USOS;
+    cfg.base_freq_uhz = clamp_frequency(base_frequency);
+
+    if (keyer_start(&cfg) == 0) {
+        send_ack(id);
+    } else {
+        send_nack(id);
+    }
+}
+
+static void put_keyer_status(payload_writer_t *writer) {
+    struct keyer_status ks;
+    keyer_get_status(&ks);
+
+    writer_put_u8(writer, (ks.active ? 0x01 : 0) | (ks.finishing ? 0x02 : 0));
+    writer_put_u16(writer, ks.fill);
+    writer_put_u16(writer, ks.capacity);
+    writer_put_u32(writer, ks.chars);
+    writer_put_u32(writer, ks.idle);
+}
+
+void handle_keyer_text(const uint8_t *payload, uint8_t length, uint16_t id) {
+    if (length < 1) {
+        send_nack(id);
+        return;
+    }
+
+    uint8_t control = payload[0];
+    size_t accepted = 0;
+
+    if (control & KEYER_TEXT_ABORT) {
+        keyer_abort();
+    } else {
+        accepted = keyer_write(payload + 1, length - 1);
+        if (control & KEYER_TEXT_FINISH) {
+            keyer_finish();
+        }
+    }
+
+    uint8_t buffer[14];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u8(&writer, (uint8_t)accepted);
+    put_keyer_status(&writer);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x15, buffer, payload_len, id);
+}
+
+void handle_get_keyer(const uint8_t *payload, uint8_t length, uint16_t id) {
+    uint8_t buffer[13];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    put_keyer_status(&writer);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x16, buffer, payload_len, id);
+}
+#endif
+
+void handle_set_envelope(const uint8_t *payload, uint8_t length, uint16_t id) {
+    payload_cursor_t cursor;
+    cursor_init(&cursor, payload, length);
+
+    uint32_t rise_us = cursor_get_u32(&cursor);
+    if (cursor.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (envelope_set_rise_us(rise_us) == 0) {
+        send_ack(id);
+    } else {
+        send_nack(id);
+    }
+}
+
+void handle_get_envelope(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct envelope_status env;
+    envelope_get_status(&env);
+
+    uint8_t buffer[25];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u8(&writer, env.ready ? 0x01 : 0);
+    writer_put_u32(&writer, env.rise_us);
+    writer_put_u32(&writer, env.ramps);
+    writer_put_u32(&writer, env.underruns);
+    writer_put_u32(&writer, env.last_cpu_ns);
+    writer_put_u32(&writer, env.max_cpu_ns);
+    writer_put_u32(&writer, env.avg_cpu_ns);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (length >= 1 && payload[0] != 0) {
+        envelope_reset_stats();
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x18, buffer, payload_len, id);
+}
+
+#ifdef CONFIG_SEQ_CACHE
+void handle_get_seq_cache(const uint8_t *payload, uint8_t length, uint16_t id) {
+    struct seq_cache_stats cache;
+    seq_cache_get_stats(&cache);
+
+    uint8_t buffer[30];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u32(&writer, cache.hits);
+    writer_put_u32(&writer, cache.misses);
+    writer_put_u32(&writer, cache.evictions);
+    writer_put_u32(&writer, cache.uncached);
+    writer_put_u32(&writer, cache.spill_hits);
+    writer_put_u32(&writer, cache.spill_writes);
+    writer_put_u32(&writer, cache.spill_errors);
+    writer_put_u8(&writer, cache.entries);
+    writer_put_u8(&writer, cache.capacity);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (length >= 1 && payload[0] != 0) {
+        seq_cache_reset_stats();
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x19, buffer, payload_len, id);
+}
+#endif
+
+#define MODE_START_NOW      (1u << 0)
+
+void handle_mode_start(const uint8_t *payload, uint8_t length, uint16_t id) {
+    if (!tx_active) {
+        send_debug_message("Cannot start mode: TX engine is not active");
+        send_nack(id);
+        return;
+    }
+    if (length < 2) {
+        send_nack(id);
+        return;
+    }
+
+    struct tx_mode_start start;
+    int ret = tx_mode_start(payload[0], payload + 2, length - 2,
+                            clamp_frequency(base_frequency),
+                            payload[1] & MODE_START_NOW, &start);
+    if (ret) {
+        send_nack(id);
+        return;
+    }
+
+    uint8_t buffer[20];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    writer_put_u32(&writer, start.est.symbols);
+    writer_put_u32(&writer, start.est.duration_ms);
+    writer_put_u64(&writer, (uint64_t)start.start_utc_us);
+    writer_put_u32(&writer, start.encode_us);
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x1A, buffer, payload_len, id);
+}
+
+void handle_get_mode_stats(const uint8_t *payload, uint8_t length, uint16_t id) {
+    uint8_t buffer[21 * TX_MODE_COUNT];
+    payload_writer_t writer;
+    writer_init(&writer, buffer, sizeof(buffer));
+
+    /* Built-in modes only, in id order */
+    for (uint8_t mode_id = 0; mode_id < TX_MODE_COUNT; mode_id++) {
+        const struct tx_mode *mode = tx_mode_find(mode_id);
+        if (!mode) {
+            continue;
+        }
+
+        struct tx_mode_stats ms;
+        tx_mode_get_stats(mode, &ms);
+        writer_put_u8(&writer, mode_id);
+        writer_put_u32(&writer, ms.encodes);
+        writer_put_u32(&writer, ms.failures);
+        writer_put_u32(&writer, ms.last_us);
+        writer_put_u32(&writer, ms.max_us);
+        writer_put_u32(&writer, ms.avg_us);
+    }
+
+    if (writer.error) {
+        send_nack(id);
+        return;
+    }
+
+    if (length >= 1 && payload[0] != 0) {
+        tx_mode_reset_stats();
+    }
+
+    size_t payload_len = writer.ptr - buffer;
+    send_packet(0x1B, buffer, payload_len, id);
+}
@@ -0,0 +1,170 @@
+#include "radio/telemetry.h"
+#include "radio/tx_engine.h"
+#include "hardware/adc_sampler.h"
+#include "protocol/packet_parser.h"
+#include "protocol/payload_utils.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#define TELEMETRY_EVENT         0xFA
+#define TELEMETRY_WINDOW_BYTES  20
+#define TELEMETRY_QUEUE_DEPTH   16
+
+struct chan_acc {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    uint64_t sum_sq;
+};
+
+struct telem_window {
+    uint16_t seq;
+    int16_t symbol;
+    uint32_t count;
+    struct chan_acc fwd;
+    struct chan_acc ref;
+};
+
+K_MSGQ_DEFINE(telem_msgq, sizeof(struct telem_window), TELEMETRY_QUEUE_DEPTH, 4);
+
+static struct adc_sampler_listener telem_listener;
+static struct k_work telem_work;
+
+/* Written by telemetry_configure() with the ISR masked */
+static uint32_t window_frames;
+static uint8_t batch_len;
+
+/* ISR-owned accumulation state */
+static struct telem_window cur;
+static uint16_t next_seq;
+
+/* Batch state, touched only from the system workqueue (the telemetry
+ * work item and command dispatch) */
+static uint8_t batch_buf[1 + TELEMETRY_MAX_BATCH * TELEMETRY_WINDOW_BYTES];
+static uint8_t batch_count;
+
+static inline void acc_reset(struct chan_acc *a) {
+    a->min = UINT16_MAX;
+    a->max = 0;
+    a->sum = 0;
+    a->sum_sq = 0;
+}
+
+static void window_reset(void) {
+    cur.count = 0;
+    acc_reset(&cur.fwd);
+    acc_reset(&cur.ref);
+}
+
+static void telem_adc_handler(const struct adc_frame *frames, size_t count) {
+    if (window_frames == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint16_t f = frames[i].fwd;
+        uint16_t r = frames[i].ref;
+
+        cur.fwd.min = MIN(cur.fwd.min, f);
+        cur.fwd.max = MAX(cur.fwd.max, f);
+        cur.fwd.sum += f;
+        cur.fwd.sum_sq += (uint32_t)f * f;
+
+        cur.ref.min = MIN(cur.ref.min, r);
+        cur.ref.max = MAX(cur.ref.max, r);
+        cur.ref.sum += r;
+        cur.ref.sum_sq += (uint32_t)r * r;
+
+        if (++cur.count >= window_frames) {
+            cur.seq = next_seq++;
+            cur.symbol = (int16_t)tx_engine_current_symbol();
+            /* A full queue drops the window; the host sees a seq gap */
+            if (k_msgq_put(&telem_msgq, &cur, K_NO_WAIT) == 0) {
+                k_work_submit(&telem_work);
+            }
+            window_reset();
+        }
+    }
+}
+
+static uint16_t isqrt64(uint64_t v) {
+    uint64_t res = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)res;
+}
+
+static void put_chan(payload_writer_t *w, const struct chan_acc *a, uint32_t count) {
+    writer_put_u16(w, a->min);
+    writer_put_u16(w, a->max);
+    writer_put_u16(w, (uint16_t)(a->sum / count));
+    writer_put_u16(w, isqrt64(a->sum_sq / count));
+}
+
+static void telem_work_handler(struct k_work *work) {
+    struct telem_window win;
+
+    while (k_msgq_get(&telem_msgq, &win, K_NO_WAIT) == 0) {
+        if (batch_len == 0 || win.count == 0) {
+            continue;
+        }
+
+        payload_writer_t writer;
+        writer_init(&writer, &batch_buf[1 + batch_count * TELEMETRY_WINDOW_BYTES],
+                    TELEMETRY_WINDOW_BYTES);
+        writer_put_u16(&writer, win.seq);
+        writer_put_u16(&writer, (uint16_t)win.symbol);
+        put_chan(&writer, &win.fwd, win.count);
+        put_chan(&writer, &win.ref, win.count);
+
+        if (++batch_count >= batch_len) {
+            batch_buf[0] = batch_count;
+            send_packet(TELEMETRY_EVENT, batch_buf,
+                        1 + batch_count * TELEMETRY_WINDOW_BYTES, 0);
+            batch_count = 0;
+        }
+    }
+}
+
+void telemetry_init(void) {
+    k_work_init(&telem_work, telem_work_handler);
+    window_frames = 0;
+    batch_len = 0;
+    window_reset();
+    telem_listener.handler = telem_adc_handler;
+    adc_sampler_add_listener(&telem_listener);
+}
+
+int telemetry_configure(uint16_t rate_hz, uint8_t len) {
+    if (rate_hz > TELEMETRY_MAX_HZ || len > TELEMETRY_MAX_BATCH) {
+        return -EINVAL;
+    }
+    if (rate_hz != 0 && len == 0) {
+        return -EINVAL;
+    }
+
+    unsigned int key = irq_lock();
+    window_frames = rate_hz ? adc_sampler_frame_hz() / rate_hz : 0;
+    batch_len = len;
+    batch_count = 0;
+    next_seq = 0;
+    window_reset();
+    irq_unlock(key);
+
+    k_msgq_purge(&telem_msgq);
+
+    return 0;
+}
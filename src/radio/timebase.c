@@ -0,0 +1,625 @@
+#include "radio/timebase.h"
+#include "radio/freq_cal.h"
+#include "hardware/pps.h"
+#include "config.h"
+
+#ifdef CONFIG_GNSS_UBLOX_M10_I2C
+#include "drivers/gnss/gnss_ublox_m10.h"
+#endif
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/rtc.h>
+#include <zephyr/sys/timeutil.h>
+#include <zephyr/sys/printk.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* UTC is modelled against the free-running 32-bit PPS capture timer:
+ *
+ *     utc_us = anchor_us + (ticks - anchor_ticks) * 1e6 / rate
+ *
+ * PPS edges are captured in hardware, so interrupt latency never reaches
+ * the fit. Every edge re-anchors the model; between edges (and in
+ * holdover) the maintenance work moves the anchor forward often enough
+ * that the signed tick delta never wraps. */
+#define TIMEBASE_MAINT_MS       5000
+/* An edge this far from the model's prediction is a glitch while tracking */
+#define TIMEBASE_GLITCH_NS      100000
+/* Consecutive glitches before the edge is taken as a real phase step */
+#define TIMEBASE_GLITCH_LIMIT   4
+/* Fit points before the fitted rate and phase replace the prior */
+#define TIMEBASE_MIN_FIT        3
+/* Alarms that run later than this are counted as late */
+#define TIMEBASE_LATE_NS        10000
+/* Largest accumulated host rate trim */
+#define TIMEBASE_HOST_PPB_MAX   200000
+
+struct tb_edge {
+    struct pps_event evt;
+    int64_t uptime_ms;
+};
+
+struct tb_model {
+    uint32_t anchor_ticks;
+    int64_t anchor_us;
+    uint64_t rate_q8;       /* timer ticks per second, Q8 */
+    uint64_t scale_q32;     /* microseconds per timer tick, Q32 */
+};
+
+K_MSGQ_DEFINE(tb_msgq, sizeof(struct tb_edge), 4, 4);
+
+static struct k_spinlock model_lock;
+static struct tb_model model;
+static struct timebase_status status;
+static uint64_t nominal_q8;
+static int32_t host_ppb;
+
+static struct pps_listener tb_listener;
+static struct k_work edge_work;
+static struct k_work_delayable maint_work;
+
+/* Fit state, touched only from the system workqueue */
+static uint32_t fit_ticks[CONFIG_TIMEBASE_FIT_EDGES];
+static uint8_t fit_head;
+static uint8_t fit_n;
+static int64_t last_label_s;
+static bool have_label;
+static uint8_t glitches;
+
+static sys_slist_t alarms;
+static struct k_spinlock alarm_lock;
+static struct k_timer alarm_timer;
+static bool alarm_overdue;
+
+#ifdef CONFIG_GNSS_UBLOX_M10_I2C
+static const struct device *gnss = DEVICE_DT_GET(DT_NODELABEL(gnss));
+#endif
+
+static void alarm_arm_locked(void);
+
+static void model_set_rate(struct tb_model *m, uint64_t rate_q8) {
+    m->rate_q8 = rate_q8;
+    m->scale_q32 = ((uint64_t)USEC_PER_SEC << 40) / rate_q8;
+}
+
+static int64_t model_to_us(const struct tb_model *m, uint32_t ticks) {
+    int32_t delta = (int32_t)(ticks - m->anchor_ticks);
+    return m->anchor_us + ((int64_t)delta * (int64_t)m->scale_q32) / ((int64_t)1 << 32);
+}
+
+/* Only meaningful within a few seconds of the anchor */
+static uint32_t model_to_ticks(const struct tb_model *m, int64_t utc_us) {
+    int64_t delta = utc_us - m->anchor_us;
+    return m->anchor_ticks +
+           (uint32_t)(delta * (int64_t)m->rate_q8 / ((int64_t)USEC_PER_SEC * 256));
+}
+
+static int32_t ticks_to_ns(int64_t ticks) {
+    return (int32_t)CLAMP(ticks * NSEC_PER_SEC / pps_timer_hz(), -INT32_MAX, INT32_MAX);
+}
+
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t res = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+static uint64_t rate_trim(uint64_t rate_q8, int32_t ppb) {
+    return rate_q8 + (int64_t)rate_q8 * ppb / 1000000000LL;
+}
+
+/* Nominal timer rate corrected by whatever freq_cal knows about the
+ * clock that drives the timer */
+static uint64_t calibrated_rate(void) {
+    struct freq_cal_status cal;
+    freq_cal_get_status(&cal);
+
+#ifdef CONFIG_PPS_TIMER_CLK2
+    bool valid = cal.flags & FREQ_CAL_REF_VALID;
+    int32_t ppb = cal.ref_ppb;
+#else
+    bool valid = cal.flags & FREQ_CAL_MCU_VALID;
+    int32_t ppb = cal.mcu_ppb;
+#endif
+
+    return valid ? rate_trim(nominal_q8, ppb) : nominal_q8;
+}
+
+static int rtc_seconds(int64_t *out) {
+    struct rtc_time tm;
+
+    int ret = rtc_get_time(rtc_dev, &tm);
+    if (ret) {
+        return ret;
+    }
+    *out = timeutil_timegm64(rtc_time_to_tm(&tm));
+    return 0;
+}
+
+static void rtc_sync(int64_t utc_s) {
+    time_t t = (time_t)utc_s;
+    struct tm tm;
+    struct rtc_time rtc;
+
+    gmtime_r(&t, &tm);
+    rtc = (struct rtc_time){
+        .tm_sec = tm.tm_sec,
+        .tm_min = tm.tm_min,
+        .tm_hour = tm.tm_hour,
+        .tm_mday = tm.tm_mday,
+        .tm_mon = tm.tm_mon,
+        .tm_year = tm.tm_year,
+        .tm_wday = tm.tm_wday,
+        .tm_yday = tm.tm_yday,
+        .tm_isdst = -1,
+    };
+
+    if (rtc_set_time(rtc_dev, &rtc) == 0) {
+        k_spinlock_key_t key = k_spin_lock(&model_lock);
+        status.flags |= TIMEBASE_RTC_SYNCED;
+        k_spin_unlock(&model_lock, key);
+    }
+}
+
+#ifdef CONFIG_GNSS_UBLOX_M10_I2C
+/* The receiver reports each epoch some hundreds of ms after its PPS edge,
+ * so the newest fix belongs to the edge before this one when it arrived
+ * within the last second, and so on back. */
+static bool gnss_label(int64_t edge_ms, int64_t *label_s) {
+    struct m10_fix fix;
+
+    if (m10_get_fix(gnss, &fix) || !fix.time_valid) {
+        return false;
+    }
+
+    int64_t since_fix = edge_ms - fix.updated_ms;
+    if (since_fix < 0 || since_fix >= 2 * MSEC_PER_SEC) {
+        return false;
+    }
+
+    struct tm tm = {
+        .tm_year = fix.year - 1900,
+        .tm_mon = fix.month - 1,
+        .tm_mday = fix.day,
+        .tm_hour = fix.hour,
+        .tm_min = fix.min,
+        .tm_sec = fix.sec,
+    };
+    int64_t epoch_s = timeutil_timegm64(&tm);
+    if (fix.nano >= 500000000) {
+        epoch_s++;
+    } else if (fix.nano < -500000000) {
+        epoch_s--;
+    }
+
+    *label_s = epoch_s + since_fix / MSEC_PER_SEC + 1;
+    return true;
+}
+#endif
+
+/* Least-squares line through the ring, x in whole seconds. Returns the
+ * fitted rate, the fitted capture of the newest edge, and the RMS of the
+ * points about the line in ticks. */
+static void fit_line(uint64_t *rate_q8, uint32_t *last_ticks, uint32_t *rms_ticks_q4) {
+    uint32_t base = fit_ticks[fit_head];
+    int64_t n = fit_n;
+    int64_t sum_y = 0;
+    int64_t sum_cy = 0;
+
+    /* c = 2x - (n - 1) centres x without fractions */
+    for (int i = 0; i < fit_n; i++) {
+        uint32_t y = fit_ticks[(fit_head + i) % CONFIG_TIMEBASE_FIT_EDGES] - base;
+        sum_y += y;
+        sum_cy += (int64_t)(2 * i - (fit_n - 1)) * y;
+    }
+
+    int64_t sum_cc = n * (n * n - 1) / 3;
+    int64_t rate = 512 * sum_cy / sum_cc;
+    int64_t mean_q8 = sum_y * 256 / n;
+
+    uint64_t sq = 0;
+    for (int i = 0; i < fit_n; i++) {
+        uint32_t y = fit_ticks[(fit_head + i) % CONFIG_TIMEBASE_FIT_EDGES] - base;
+        int64_t r_q4 = ((int64_t)y * 256 - mean_q8 - rate * (2 * i - (fit_n - 1)) / 2) / 16;
+        sq += r_q4 * r_q4;
+    }
+
+    *rate_q8 = rate;
+    *last_ticks = base + (uint32_t)((mean_q8 + rate * (n - 1) / 2 + 128) >> 8);
+    *rms_ticks_q4 = isqrt64(sq / n);
+}
+
+static void fit_push(uint32_t ticks) {
+    if (fit_n < CONFIG_TIMEBASE_FIT_EDGES) {
+        fit_ticks[(fit_head + fit_n) % CONFIG_TIMEBASE_FIT_EDGES] = ticks;
+        fit_n++;
+    } else {
+        fit_ticks[fit_head] = ticks;
+        fit_head = (fit_head + 1) % CONFIG_TIMEBASE_FIT_EDGES;
+    }
+}
+
+static void edge_process(const struct tb_edge *e) {
+    uint32_t ticks = e->evt.ticks;
+
+    k_spinlock_key_t key = k_spin_lock(&model_lock);
+    struct tb_model m = model;
+    uint8_t state = status.state;
+    k_spin_unlock(&model_lock, key);
+
+    /* Label the edge with the nearest whole second of the current model
+     * and measure how far off the prediction was */
+    int64_t predicted_us = model_to_us(&m, ticks);
+    int64_t label_s = (predicted_us + USEC_PER_SEC / 2) / USEC_PER_SEC;
+    int32_t residual_ns = ticks_to_ns((int32_t)(ticks - model_to_ticks(&m, label_s * USEC_PER_SEC)));
+    bool tracking = state == TIMEBASE_ACQUIRING || state == TIMEBASE_LOCKED;
+    /* Coming out of holdover close to the prediction is not a step */
+    bool step = !tracking &&
+                !(state == TIMEBASE_HOLDOVER && abs(residual_ns) <= TIMEBASE_GLITCH_NS);
+
+    if (tracking && abs(residual_ns) > TIMEBASE_GLITCH_NS) {
+        if (++glitches < TIMEBASE_GLITCH_LIMIT) {
+            key = k_spin_lock(&model_lock);
+            status.edges++;
+            status.rejected++;
+            k_spin_unlock(&model_lock, key);
+            return;
+        }
+        step = true;
+    }
+    glitches = 0;
+
+    uint8_t utc_flag = 0;
+#ifdef CONFIG_GNSS_UBLOX_M10_I2C
+    int64_t gnss_s;
+    if (gnss_label(e->uptime_ms, &gnss_s)) {
+        utc_flag = TIMEBASE_UTC_GNSS;
+        if (gnss_s != label_s) {
+            printk("timebase: GNSS moves label by %lld s\n", gnss_s - label_s);
+            label_s = gnss_s;
+            step = true;
+        }
+    }
+#endif
+
+    if (step || !have_label || label_s != last_label_s + 1) {
+        fit_n = 0;
+        fit_head = 0;
+    }
+    fit_push(ticks);
+    last_label_s = label_s;
+    have_label = true;
+
+    uint64_t rate_q8 = m.rate_q8;
+    uint32_t anchor_ticks = ticks;
+    uint32_t rms_q4 = 0;
+    if (fit_n >= TIMEBASE_MIN_FIT) {
+        fit_line(&rate_q8, &anchor_ticks, &rms_q4);
+    }
+
+    key = k_spin_lock(&model_lock);
+
+    model.anchor_ticks = anchor_ticks;
+    model.anchor_us = label_s * USEC_PER_SEC;
+    model_set_rate(&model, rate_q8);
+
+    bool was_locked = status.state == TIMEBASE_LOCKED;
+    if (step) {
+        status.state = TIMEBASE_ACQUIRING;
+        status.restarts++;
+        status.flags &= ~(TIMEBASE_UTC_GNSS | TIMEBASE_RTC_SYNCED);
+    } else if (fit_n > TIMEBASE_MIN_FIT && abs(residual_ns) <= CONFIG_TIMEBASE_LOCK_NS) {
+        status.state = TIMEBASE_LOCKED;
+    } else if (was_locked && abs(residual_ns) > 4 * CONFIG_TIMEBASE_LOCK_NS) {
+        status.state = TIMEBASE_ACQUIRING;
+    }
+    status.flags |= utc_flag;
+    status.edges++;
+    status.fit_edges = fit_n;
+    status.last_residual_ns = residual_ns;
+    status.rms_residual_ns = (uint32_t)ticks_to_ns(rms_q4) / 16;
+    if (status.state == TIMEBASE_LOCKED) {
+        status.max_residual_ns = MAX(status.max_residual_ns, (uint32_t)abs(residual_ns));
+    }
+    bool sync_rtc = status.state == TIMEBASE_LOCKED && (status.flags & TIMEBASE_UTC_GNSS) &&
+                    !(status.flags & TIMEBASE_RTC_SYNCED);
+
+    k_spin_unlock(&model_lock, key);
+
+    if (!was_locked && status.state == TIMEBASE_LOCKED) {
+        printk("timebase: locked, residual %d ns\n", residual_ns);
+    }
+    if (sync_rtc) {
+        rtc_sync(label_s);
+    }
+    if (step) {
+        key = k_spin_lock(&alarm_lock);
+        alarm_arm_locked();
+        k_spin_unlock(&alarm_lock, key);
+    }
+}
+
+static void edge_work_handler(struct k_work *work) {
+    struct tb_edge e;
+
+    while (k_msgq_get(&tb_msgq, &e, K_NO_WAIT) == 0) {
+        edge_process(&e);
+    }
+}
+
+static void tb_pps_handler(const struct pps_event *evt) {
+    struct tb_edge e = {
+        .evt = *evt,
+        .uptime_ms = k_uptime_get(),
+    };
+
+    if (k_msgq_put(&tb_msgq, &e, K_NO_WAIT) == 0) {
+        k_work_submit(&edge_work);
+    }
+}
+
+static void maint_work_handler(struct k_work *work) {
+    bool stepped = false;
+    int64_t rtc_s;
+    bool have_rtc = false;
+
+    k_spinlock_key_t key = k_spin_lock(&model_lock);
+    uint8_t state = status.state;
+    k_spin_unlock(&model_lock, key);
+
+    if (state == TIMEBASE_FREE || state == TIMEBASE_RTC) {
+        have_rtc = rtc_seconds(&rtc_s) == 0;
+    }
+    uint64_t rate_q8 = calibrated_rate();
+
+    key = k_spin_lock(&model_lock);
+
+    uint32_t now = pps_timer_now();
+    model.anchor_us = model_to_us(&model, now);
+    model.anchor_ticks = now;
+
+    switch (status.state) {
+    case TIMEBASE_ACQUIRING:
+    case TIMEBASE_LOCKED:
+        if (!pps_present()) {
+            status.state = fit_n >= TIMEBASE_MIN_FIT ? TIMEBASE_HOLDOVER : TIMEBASE_RTC;
+        }
+        break;
+    case TIMEBASE_HOST:
+        model_set_rate(&model, rate_trim(rate_q8, host_ppb));
+        break;
+    case TIMEBASE_FREE:
+    case TIMEBASE_RTC:
+        /* Without PPS the RTC owns the second; the timer only interpolates */
+        model_set_rate(&model, rate_q8);
+        if (have_rtc) {
+            int64_t model_s = model.anchor_us / USEC_PER_SEC;
+            if (status.state == TIMEBASE_FREE || llabs(rtc_s - model_s) >= 2) {
+                model.anchor_us = rtc_s * USEC_PER_SEC;
+                status.state = TIMEBASE_RTC;
+                stepped = true;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    k_spin_unlock(&model_lock, key);
+
+    if (stepped) {
+        key = k_spin_lock(&alarm_lock);
+        alarm_arm_locked();
+        k_spin_unlock(&alarm_lock, key);
+    }
+
+    k_work_schedule(&maint_work, K_MSEC(TIMEBASE_MAINT_MS));
+}
+
+static void alarm_compare_handler(uint32_t late_ticks) {
+    k_spinlock_key_t key = k_spin_lock(&alarm_lock);
+
+    sys_snode_t *node = sys_slist_get(&alarms);
+    if (!node) {
+        k_spin_unlock(&alarm_lock, key);
+        return;
+    }
+
+    struct timebase_alarm *alarm = CONTAINER_OF(node, struct timebase_alarm, node);
+    uint32_t late_ns = alarm_overdue ? UINT32_MAX : (uint32_t)ticks_to_ns(late_ticks);
+
+    status.alarms++;
+    if (late_ns > TIMEBASE_LATE_NS) {
+        status.late_alarms++;
+    }
+    if (!alarm_overdue) {
+        status.max_alarm_latency_ns = MAX(status.max_alarm_latency_ns, late_ns);
+    }
+
+    alarm_arm_locked();
+    k_spin_unlock(&alarm_lock, key);
+
+    alarm->handler(alarm, late_ns);
+}
+
+/* Far alarms wait on a kernel timer; within the lead time the head alarm
+ * is handed to the capture timer's compare channel for the exact tick. */
+static void alarm_arm_locked(void) {
+    struct timebase_alarm *head = SYS_SLIST_PEEK_HEAD_CONTAINER(&alarms, head, node);
+
+    if (!head) {
+        k_timer_stop(&alarm_timer);
+        pps_compare_cancel();
+        return;
+    }
+
+    int64_t delta = head->utc_us - timebase_now_us();
+    if (delta > CONFIG_TIMEBASE_ALARM_LEAD_US) {
+        pps_compare_cancel();
+        k_timer_start(&alarm_timer, K_USEC(delta - CONFIG_TIMEBASE_ALARM_LEAD_US), K_NO_WAIT);
+        return;
+    }
+
+    k_timer_stop(&alarm_timer);
+
+    uint32_t target;
+    alarm_overdue = delta < -(int64_t)USEC_PER_SEC;
+    if (alarm_overdue) {
+        target = pps_timer_now();
+    } else {
+        k_spinlock_key_t key = k_spin_lock(&model_lock);
+        target = model_to_ticks(&model, head->utc_us);
+        k_spin_unlock(&model_lock, key);
+    }
+    pps_compare_arm(target, alarm_compare_handler);
+}
+
+static void alarm_timer_expiry(struct k_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&alarm_lock);
+    alarm_arm_locked();
+    k_spin_unlock(&alarm_lock, key);
+}
+
+int timebase_init(void) {
+    nominal_q8 = (uint64_t)pps_timer_hz() << 8;
+
+    sys_slist_init(&alarms);
+    k_timer_init(&alarm_timer, alarm_timer_expiry, NULL);
+    k_work_init(&edge_work, edge_work_handler);
+    k_work_init_delayable(&maint_work, maint_work_handler);
+
+    fit_n = 0;
+    fit_head = 0;
+    have_label = false;
+    status = (struct timebase_status){ .state = TIMEBASE_FREE };
+
+    model.anchor_ticks = pps_timer_now();
+    model.anchor_us = k_uptime_get() * USEC_PER_MSEC;
+    model_set_rate(&model, calibrated_rate());
+
+    int64_t rtc_s;
+    if (rtc_seconds(&rtc_s) == 0) {
+        model.anchor_us = rtc_s * USEC_PER_SEC;
+        status.state = TIMEBASE_RTC;
+    } else {
+        printk("timebase: RTC not set, counting from boot\n");
+    }
+
+    tb_listener.handler = tb_pps_handler;
+    pps_add_listener(&tb_listener);
+
+    k_work_schedule(&maint_work, K_MSEC(TIMEBASE_MAINT_MS));
+
+    return 0;
+}
+
+int64_t timebase_now_us(void) {
+    k_spinlock_key_t key = k_spin_lock(&model_lock);
+    int64_t us = model_to_us(&model, pps_timer_now());
+    k_spin_unlock(&model_lock, key);
+    return us;
+}
+
+int timebase_alarm_start(struct timebase_alarm *alarm, int64_t utc_us) {
+    if (!alarm || !alarm->handler) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&alarm_lock);
+
+    sys_slist_find_and_remove(&alarms, &alarm->node);
+    alarm->utc_us = utc_us;
+
+    struct timebase_alarm *it, *prev = NULL;
+    SYS_SLIST_FOR_EACH_CONTAINER(&alarms, it, node) {
+        if (it->utc_us > utc_us) {
+            break;
+        }
+        prev = it;
+    }
+    if (prev) {
+        sys_slist_insert(&alarms, &prev->node, &alarm->node);
+    } else {
+        sys_slist_prepend(&alarms, &alarm->node);
+    }
+
+    alarm_arm_locked();
+    k_spin_unlock(&alarm_lock, key);
+
+    return 0;
+}
+
+void timebase_alarm_cancel(struct timebase_alarm *alarm) {
+    k_spinlock_key_t key = k_spin_lock(&alarm_lock);
+    if (sys_slist_find_and_remove(&alarms, &alarm->node)) {
+        alarm_arm_locked();
+    }
+    k_spin_unlock(&alarm_lock, key);
+}
+
+int timebase_host_adjust(int64_t step_us, int32_t rate_ppb) {
+    uint64_t rate_q8 = calibrated_rate();
+
+    k_spinlock_key_t key = k_spin_lock(&model_lock);
+
+    if (status.flags & TIMEBASE_UTC_GNSS) {
+        k_spin_unlock(&model_lock, key);
+        return -EPERM;
+    }
+
+    uint32_t now = pps_timer_now();
+    model.anchor_us = model_to_us(&model, now);
+    model.anchor_ticks = now;
+
+    if (status.state == TIMEBASE_ACQUIRING || status.state == TIMEBASE_LOCKED) {
+        int64_t whole_s = (llabs(step_us) + USEC_PER_SEC / 2) / USEC_PER_SEC;
+        step_us = step_us < 0 ? -whole_s * USEC_PER_SEC : whole_s * USEC_PER_SEC;
+        model.anchor_us += step_us;
+        last_label_s += step_us / USEC_PER_SEC;
+    } else {
+        host_ppb = CLAMP(host_ppb + rate_ppb, -TIMEBASE_HOST_PPB_MAX, TIMEBASE_HOST_PPB_MAX);
+        model.anchor_us += step_us;
+        model_set_rate(&model, rate_trim(rate_q8, host_ppb));
+        status.state = TIMEBASE_HOST;
+    }
+    status.flags &= ~TIMEBASE_RTC_SYNCED;
+    int64_t now_s = model.anchor_us / USEC_PER_SEC;
+
+    k_spin_unlock(&model_lock, key);
+
+    if (step_us) {
+        rtc_sync(now_s);
+        key = k_spin_lock(&alarm_lock);
+        alarm_arm_locked();
+        k_spin_unlock(&alarm_lock, key);
+    }
+
+    return 0;
+}
+
+void timebase_get_status(struct timebase_status *out) {
+    k_spinlock_key_t key = k_spin_lock(&model_lock);
+    *out = status;
+    out->rate_ppb = (int32_t)(((int64_t)model.rate_q8 - (int64_t)nominal_q8) * 1000000000LL /
+                              (int64_t)nominal_q8);
+    k_spin_unlock(&model_lock, key);
+
+    key = k_spin_lock(&alarm_lock);
+    out->alarms = status.alarms;
+    out->late_alarms = status.late_alarms;
+    out->max_alarm_latency_ns = status.max_alarm_latency_ns;
+    k_spin_unlock(&alarm_lock, key);
+}
@@ -2,58 +2,210 @@
 #include "config.h"
 #include "radio/radio.h"
 #include "drivers/clock_control/clock_si5351a.h"
+#include "hardware/pa_monitor.h"
+#include "radio/alc.h"
+#include "hardware/swr_guard.h"
+#include "hardware/envelope.h"
+#include "radio/timebase.h"
 
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/regulator.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/printk.h>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 static tx_sequence_t *active_seq;
 static volatile bool  engine_active;
+static volatile int32_t current_symbol = -1;
 static struct k_timer tx_timer;
 static struct k_work  tx_work;
+static struct k_work  tx_retry_work;
+
+/* Symbol boundaries are scheduled from the sequence start so timer and
+ * workqueue latency does not accumulate across symbols. */
+static int64_t seq_start_ticks;
+static uint64_t seq_elapsed_us;
+
+/* Span of the symbol on air, for the envelope ramps */
+static int64_t sym_start_ticks;
+static int64_t sym_end_ticks;
+
+/* Where each symbol was applied, against the duration of the one before:
+ * the error of every on-air symbol and its running sum */
+static uint32_t applied_cycles;
+static uint32_t applied_duration_us;
+static int64_t drift_cycles;
+
+/* Scheduled start: the timebase alarm fires in ISR context and hands the
+ * sequence to the workqueue, where the synthesizer can be programmed. */
+static struct timebase_alarm start_alarm;
+static struct k_work start_work;
+static tx_sequence_t *pending_seq;
+static uint32_t start_alarm_cycles;
+static uint32_t start_alarm_late_ns;
 
 #define TX_CLK_OUTPUT  0
+#define TX_CLK_PLL     'A'
+
+/* Double-buffered multisynth register blocks: one may be on the bus while
+ * the next symbol is prepared into the other. */
+static struct si5351a_ms_regs ms_regs[2];
+static uint8_t next_buf;
+static bool    next_valid;
+static size_t  next_index;          // symbol the prepared block is for
+static bool    output_on;
+static bool    output_inverted;
+static bool    keyed_down;          // envelope keyed on, TX_SHAPE_KEYED
+static freq_uhz_t applied_offset;   // tone on the output while output_on
+
+#define TX_FLAG_RETRY 0
+static atomic_t tx_flags;
+
+static struct k_spinlock stats_lock;
+static uint32_t boundary_cycles;
+static uint32_t submit_cycles;
+static struct {
+    uint32_t symbols;
+    uint32_t overruns;
+    uint32_t errors;
+    uint32_t last_bus;
+    uint32_t min_bus;
+    uint32_t max_bus;
+    uint64_t sum_bus;
+    uint32_t last_lag;
+    uint32_t max_lag;
+    uint32_t starts;
+    uint32_t last_start_late_us;
+    uint32_t max_start_late_us;
+    uint32_t flips;
+    uint32_t last_flip_lag;
+    uint32_t max_flip_lag;
+    int32_t  last_sym_err_us;
+    uint32_t max_sym_err_us;
+    int32_t  drift_us;
+    uint32_t max_drift_us;
+} bus_stats;
 
 static void tx_timer_expiry(struct k_timer *timer);
+static int seq_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out);
 static void tx_work_handler(struct k_work *work);
+static void tx_retry_handler(struct k_work *work);
+static void tx_start_alarm(struct timebase_alarm *alarm, uint32_t late_ns);
+static void tx_start_work_handler(struct k_work *work);
 static void apply_symbol(const tx_symbol_t *sym);
+static void prepare_next(tx_sequence_t *seq);
+static void arm_boundary(const tx_symbol_t *sym);
+static void time_symbol(const tx_symbol_t *sym, bool first);
 static void tx_off();
 
 void tx_engine_init() {
     k_timer_init(&tx_timer, tx_timer_expiry, NULL);
     k_work_init(&tx_work, tx_work_handler);
+    k_work_init(&tx_retry_work, tx_retry_handler);
+    k_work_init(&start_work, tx_start_work_handler);
+    start_alarm.handler = tx_start_alarm;
     active_seq = NULL;
+    pending_seq = NULL;
     engine_active = false;
+    output_on = false;
+    next_valid = false;
+    tx_engine_reset_stats();
     printk("tx_engine: initialized\n");
 }
 
-void tx_engine_start(tx_sequence_t *seq) {
-    if (!seq || seq->total_symbols == 0) {
+/* late_us backdates the symbol clock, so a start that was scheduled
+ * but ran late still lands the following boundaries on time */
+static void start_sequence(tx_sequence_t *seq, uint32_t late_us) {
+    if (!seq || seq->total_symbols == 0 || (!seq->symbols && !seq->source)) {
         printk("tx_engine: start failed, seq is NULL or empty\n");
         return;
     }
 
+    if (swr_guard_tripped()) {
+        printk("tx_engine: start refused, SWR trip latched\n");
+        return;
+    }
+
     tx_engine_stop();
 
     active_seq = seq;
     active_seq->current_index = 0;
+    current_symbol = 0;
     engine_active = true;
 
     printk("tx_engine: started, base_freq=%u Hz, %u symbols, repeat=%d\n",
-           seq->base_freq_hz, seq->total_symbols, seq->repeat);
+           (uint32_t)(seq->base_freq_uhz / FREQ_UHZ_PER_HZ), seq->total_symbols, seq->repeat);
+
+    /* Symbols are fractional in general; integer mode would misinterpret
+     * the prepared parameter blocks. */
+    si5351a_set_clk_ctrl(si5351a, TX_CLK_OUTPUT, TX_CLK_PLL, false);
+    output_inverted = false;
+
+    tx_symbol_t sym;
+    if (seq_symbol(active_seq, 0, &sym)) {
+        printk("tx_engine: start failed, no first symbol\n");
+        tx_engine_stop();
+        return;
+    }
+    boundary_cycles = k_cycle_get_32();
+    seq_start_ticks = k_uptime_ticks() - k_us_to_ticks_near64(late_us);
+    seq_elapsed_us = 0;
+    arm_boundary(&sym);
+    time_symbol(&sym, true);
+    apply_symbol(&sym);
+    prepare_next(active_seq);
+}
+
+void tx_engine_start(tx_sequence_t *seq) {
+    start_sequence(seq, 0);
+}
 
-    const tx_symbol_t *sym = &active_seq->symbols[0];
-    apply_symbol(sym);
-    k_timer_start(&tx_timer, K_USEC(sym->duration_us), K_NO_WAIT);
+int tx_engine_start_at(tx_sequence_t *seq, int64_t utc_us) {
+    if (!seq || seq->total_symbols == 0 || (!seq->symbols && !seq->source)) {
+        return -EINVAL;
+    }
+
+    if (swr_guard_tripped()) {
+        printk("tx_engine: scheduled start refused, SWR trip latched\n");
+        return -EIO;
+    }
+
+    tx_engine_stop();
+
+    pending_seq = seq;
+    int ret = timebase_alarm_start(&start_alarm, utc_us);
+    if (ret) {
+        pending_seq = NULL;
+        return ret;
+    }
+
+    printk("tx_engine: %s scheduled in %lld us\n", seq->mode_name ? seq->mode_name : "sequence",
+           utc_us - timebase_now_us());
+    return 0;
+}
+
+void tx_engine_rf_off() {
+    si5351a_enable_output(si5351a, TX_CLK_OUTPUT, false);
+    if (regulator_is_enabled(regulator)) {
+        regulator_disable(regulator);
+    }
 }
 
 void tx_engine_stop() {
     printk("tx_engine: stopping\n");
     k_timer_stop(&tx_timer);
     k_work_cancel(&tx_work);
+    k_work_cancel(&tx_retry_work);
+    timebase_alarm_cancel(&start_alarm);
+    k_work_cancel(&start_work);
+    pending_seq = NULL;
+    atomic_clear_bit(&tx_flags, TX_FLAG_RETRY);
+    next_valid = false;
     tx_off();
     engine_active = false;
+    current_symbol = -1;
     active_seq = NULL;
 }
 
@@ -61,7 +213,111 @@ bool tx_engine_is_active() {
     return engine_active;
 }
 
+int32_t tx_engine_current_symbol() {
+    return current_symbol;
+}
+
+void tx_engine_get_stats(struct tx_engine_stats *out) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+    out->symbols = bus_stats.symbols;
+    out->overruns = bus_stats.overruns;
+    out->errors = bus_stats.errors;
+    out->last_bus_us = k_cyc_to_us_floor32(bus_stats.last_bus);
+    out->min_bus_us = bus_stats.symbols ? k_cyc_to_us_floor32(bus_stats.min_bus) : 0;
+    out->max_bus_us = k_cyc_to_us_floor32(bus_stats.max_bus);
+    out->avg_bus_us = bus_stats.symbols ?
+        k_cyc_to_us_floor32((uint32_t)(bus_stats.sum_bus / bus_stats.symbols)) : 0;
+    out->last_lag_us = k_cyc_to_us_floor32(bus_stats.last_lag);
+    out->max_lag_us = k_cyc_to_us_floor32(bus_stats.max_lag);
+    out->starts = bus_stats.starts;
+    out->last_start_late_us = bus_stats.last_start_late_us;
+    out->max_start_late_us = bus_stats.max_start_late_us;
+    out->flips = bus_stats.flips;
+    out->last_flip_lag_us = k_cyc_to_us_floor32(bus_stats.last_flip_lag);
+    out->max_flip_lag_us = k_cyc_to_us_floor32(bus_stats.max_flip_lag);
+    out->last_sym_err_us = bus_stats.last_sym_err_us;
+    out->max_sym_err_us = bus_stats.max_sym_err_us;
+    out->drift_us = bus_stats.drift_us;
+    out->max_drift_us = bus_stats.max_drift_us;
+
+    k_spin_unlock(&stats_lock, key);
+}
+
+void tx_engine_reset_stats() {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    bus_stats.min_bus = UINT32_MAX;
+    k_spin_unlock(&stats_lock, key);
+}
+
+/* Arm the timer for the end of sym, which starts at seq_elapsed_us */
+static void arm_boundary(const tx_symbol_t *sym) {
+    sym_start_ticks = seq_start_ticks + k_us_to_ticks_near64(seq_elapsed_us);
+    seq_elapsed_us += sym->duration_us;
+    sym_end_ticks = seq_start_ticks + k_us_to_ticks_near64(seq_elapsed_us);
+    k_timer_start(&tx_timer, K_TIMEOUT_ABS_TICKS(sym_end_ticks), K_NO_WAIT);
+}
+
+static int32_t cyc_to_us_signed(int64_t cycles) {
+    return (int32_t)(cycles * USEC_PER_SEC / sys_clock_hw_cycles_per_sec());
+}
+
+/* Called as sym is applied. The first symbol of a sequence only sets the
+ * reference; each later one measures how long the previous one lasted. */
+static void time_symbol(const tx_symbol_t *sym, bool first) {
+    uint32_t now = k_cycle_get_32();
+    uint32_t elapsed = now - applied_cycles;
+    uint32_t expected_us = applied_duration_us;
+
+    applied_cycles = now;
+    applied_duration_us = sym->duration_us;
+    if (first) {
+        drift_cycles = 0;
+        return;
+    }
+
+    int64_t err = (int64_t)elapsed - (int64_t)k_us_to_cyc_near64(expected_us);
+    drift_cycles += err;
+    int32_t err_us = cyc_to_us_signed(err);
+    int32_t drift_us = cyc_to_us_signed(drift_cycles);
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    bus_stats.last_sym_err_us = err_us;
+    bus_stats.max_sym_err_us = MAX(bus_stats.max_sym_err_us, (uint32_t)abs(err_us));
+    bus_stats.drift_us = drift_us;
+    bus_stats.max_drift_us = MAX(bus_stats.max_drift_us, (uint32_t)abs(drift_us));
+    k_spin_unlock(&stats_lock, key);
+}
+
+static void tx_start_alarm(struct timebase_alarm *alarm, uint32_t late_ns) {
+    start_alarm_cycles = k_cycle_get_32();
+    start_alarm_late_ns = late_ns;
+    k_work_submit(&start_work);
+}
+
+static void tx_start_work_handler(struct k_work *work) {
+    tx_sequence_t *seq = pending_seq;
+    if (!seq) {
+        return;
+    }
+    pending_seq = NULL;
+
+    /* Alarm lateness plus the hop to the workqueue */
+    uint32_t late_us = start_alarm_late_ns / 1000 +
+                       k_cyc_to_us_floor32(k_cycle_get_32() - start_alarm_cycles);
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    bus_stats.starts++;
+    bus_stats.last_start_late_us = late_us;
+    bus_stats.max_start_late_us = MAX(bus_stats.max_start_late_us, late_us);
+    k_spin_unlock(&stats_lock, key);
+
+    start_sequence(seq, late_us);
+}
+
 static void tx_timer_expiry(struct k_timer *timer) {
+    boundary_cycles = k_cycle_get_32();
     k_work_submit(&tx_work);
 }
 
@@ -83,37 +339,264 @@ static void tx_work_handler(struct k_work *work) {
             printk("tx_engine: sequence complete\n");
             tx_off();
             engine_active = false;
+            current_symbol = -1;
             active_seq = NULL;
             return;
         }
     }
 
-    const tx_symbol_t *sym = &seq->symbols[seq->current_index];
-    printk("tx_engine: symbol %u/%u, tx_on=%d, offset=%.2f Hz, dur=%u us\n",
-           seq->current_index, seq->total_symbols, sym->tx_on,
-           (double)sym->freq_offset_hz, sym->duration_us);
-    apply_symbol(sym);
+    tx_symbol_t sym;
+    int ret = seq_symbol(seq, seq->current_index, &sym);
+    if (ret) {
+        if (ret == -ENODATA) {
+            printk("tx_engine: stream complete\n");
+        } else {
+            printk("tx_engine: symbol %u unavailable, stopping\n", seq->current_index);
+        }
+        tx_off();
+        engine_active = false;
+        current_symbol = -1;
+        active_seq = NULL;
+        return;
+    }
+
+    current_symbol = seq->current_index;
 
-    k_timer_start(&tx_timer, K_USEC(sym->duration_us), K_NO_WAIT);
+    /* Arm the next boundary first so bus time does not stretch the symbol */
+    arm_boundary(&sym);
+    time_symbol(&sym, false);
+    apply_symbol(&sym);
+
+    if (!atomic_test_bit(&tx_flags, TX_FLAG_RETRY)) {
+        prepare_next(seq);
+    }
+
+    printk("tx_engine: symbol %u/%u, tx_on=%d, offset=%d mHz, dur=%u us\n",
+           seq->current_index, seq->total_symbols, sym.tx_on,
+           (int32_t)(sym.freq_offset_uhz / 1000), sym.duration_us);
 }
 
-static void apply_symbol(const tx_symbol_t *sym) {
-    if (sym->tx_on) {
-        // int64_t offset_fp = (int64_t)(sym->freq_offset_hz * SI5351A_FREQ_MULT);
-        // uint64_t freq = (uint64_t)((int64_t)(active_seq->base_freq_hz *
-        //                  (uint64_t)SI5351A_FREQ_MULT) + offset_fp);
-
-        // printk("tx_engine: TX on, freq_fp=%llu\n", freq);
-        // // si5351a_set_freq(si5351a, TX_CLK_OUTPUT, freq);
-        // // si5351a_output_enable(si5351a, TX_CLK_OUTPUT, true);
-        regulator_enable(regulator);
+/* Symbols come from the array when there is one, else from the source */
+static int seq_symbol(const tx_sequence_t *seq, size_t index, tx_symbol_t *out) {
+    if (seq->symbols) {
+        *out = seq->symbols[index];
+        return 0;
+    }
+    return seq->source(seq, index, out);
+}
+
+static int symbol_regs(const tx_sequence_t *seq, const tx_symbol_t *sym,
+                       struct si5351a_ms_regs *regs) {
+    freq_uhz_t freq = seq->base_freq_uhz + sym->freq_offset_uhz;
+    if (freq <= 0) {
+        return -EINVAL;
+    }
+
+    return si5351a_prepare_ms_freq(si5351a, TX_CLK_OUTPUT, (uint64_t)freq,
+                                   TX_CLK_PLL, regs);
+}
+
+static void prepare_next(tx_sequence_t *seq) {
+    size_t idx = seq->current_index + 1;
+
+    next_valid = false;
+
+    if (idx >= seq->total_symbols) {
+        if (!seq->repeat) {
+            return;
+        }
+        idx = 0;
+    }
+
+    /* The current tone carries on without a write */
+    tx_symbol_t sym;
+    if (seq_symbol(seq, idx, &sym) == 0 && sym.tx_on &&
+        !(output_on && sym.freq_offset_uhz == applied_offset) &&
+        symbol_regs(seq, &sym, &ms_regs[next_buf]) == 0) {
+        next_valid = true;
+        next_index = idx;
+    }
+}
+
+static void tx_bus_done(const struct device *dev, int result, void *user_data) {
+    uint32_t now = k_cycle_get_32();
+    uint32_t bus = now - submit_cycles;
+    uint32_t lag = now - boundary_cycles;
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    if (result) {
+        bus_stats.errors++;
     } else {
+        bus_stats.symbols++;
+        bus_stats.last_bus = bus;
+        bus_stats.min_bus = MIN(bus_stats.min_bus, bus);
+        bus_stats.max_bus = MAX(bus_stats.max_bus, bus);
+        bus_stats.sum_bus += bus;
+        bus_stats.last_lag = lag;
+        bus_stats.max_lag = MAX(bus_stats.max_lag, lag);
+    }
+    k_spin_unlock(&stats_lock, key);
+
+    if (atomic_test_bit(&tx_flags, TX_FLAG_RETRY)) {
+        k_work_submit(&tx_retry_work);
+    }
+}
+
+static int submit_prepared(void) {
+    submit_cycles = k_cycle_get_32();
+    int ret = si5351a_write_ms_regs_async(si5351a, &ms_regs[next_buf], tx_bus_done, NULL);
+    if (ret == -EBUSY) {
+        return ret;     // the block stays for the retry
+    }
+    if (ret) {
+        next_valid = false;
+        return ret;
+    }
+
+    next_buf ^= 1;
+    next_valid = false;
+    return 0;
+}
+
+static void tx_retry_handler(struct k_work *work) {
+    if (!engine_active || !atomic_test_bit(&tx_flags, TX_FLAG_RETRY)) {
+        return;
+    }
+
+    if (submit_prepared() == -EBUSY) {
+        return;
+    }
+
+    atomic_clear_bit(&tx_flags, TX_FLAG_RETRY);
+    if (active_seq) {
+        prepare_next(active_seq);
+    }
+}
+
+/* Flip the carrier with the envelope at its null, which the falling ramp
+ * of the previous symbol reached on this boundary */
+static void apply_phase(const tx_symbol_t *sym) {
+    if (si5351a_set_clk_invert(si5351a, TX_CLK_OUTPUT, sym->invert)) {
+        printk("tx_engine: phase write failed\n");
+        return;
+    }
+    output_inverted = sym->invert;
+
+    if (!output_on || !(sym->shape & TX_SHAPE_RAMP_UP)) {
+        return;
+    }
+
+    uint32_t lag = k_cycle_get_32() - envelope_null_cycles();
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    bus_stats.flips++;
+    bus_stats.last_flip_lag = lag;
+    bus_stats.max_flip_lag = MAX(bus_stats.max_flip_lag, lag);
+    k_spin_unlock(&stats_lock, key);
+}
+
+/* Program sym's tone and key the output on if it is off */
+static void apply_tone(const tx_symbol_t *sym) {
+    if (output_on && sym->freq_offset_uhz == applied_offset) {
+        return;
+    }
+    applied_offset = sym->freq_offset_uhz;
+
+    /* After an overrun the block waiting for the retry was prepared for
+     * an earlier symbol, and prepare_next has not run since. Build this
+     * symbol's into it instead, so neither this boundary nor the retry
+     * sends stale registers. The buffer on the bus is the other one. */
+    if (output_on && next_valid && next_index != active_seq->current_index) {
+        next_valid = symbol_regs(active_seq, sym, &ms_regs[next_buf]) == 0;
+        next_index = active_seq->current_index;
+    }
+
+    if (output_on && next_valid) {
+        /* Tone change: hand the prepared block to the bus and return */
+        atomic_set_bit(&tx_flags, TX_FLAG_RETRY);
+        int ret = submit_prepared();
+        if (ret == -EBUSY) {
+            /* Previous transfer still on the bus; resubmit on completion */
+            k_spinlock_key_t key = k_spin_lock(&stats_lock);
+            bus_stats.overruns++;
+            k_spin_unlock(&stats_lock, key);
+            return;
+        }
+        atomic_clear_bit(&tx_flags, TX_FLAG_RETRY);
+        if (ret) {
+            printk("tx_engine: async tone write failed (%d)\n", ret);
+        }
+        return;
+    }
+
+    /* Key-down: program the tone synchronously before enabling the output */
+    struct si5351a_ms_regs regs;
+    if (symbol_regs(active_seq, sym, &regs) == 0) {
+        si5351a_write_ms_regs(si5351a, &regs);
+    }
+
+    if (!output_on) {
+        si5351a_enable_output(si5351a, TX_CLK_OUTPUT, true);
+        regulator_enable(regulator);
+        pa_monitor_kick();
+        alc_kick();
+        output_on = true;
+    }
+}
+
+/* Keyed by the envelope: the output and PA supply stay on through key-up,
+ * so after the first key-down an element edge is one DMA start */
+static void apply_keyed(const tx_symbol_t *sym) {
+    if (!sym->tx_on) {
+        if (keyed_down) {
+            alc_set_gate(false);
+            envelope_key(false, sym->duration_us);
+            keyed_down = false;
+        }
+        return;
+    }
+
+    if (!output_on) {
+        envelope_key(false, 0);
+    }
+    apply_tone(sym);
+    if (!keyed_down) {
+        envelope_key(true, sym->duration_us);
+        alc_set_gate(true);
+        keyed_down = true;
+    }
+}
+
+static void apply_symbol(const tx_symbol_t *sym) {
+    if ((sym->shape & TX_SHAPE_KEYED) && envelope_ready()) {
+        apply_keyed(sym);
+        return;
+    }
+
+    if (!sym->tx_on) {
         tx_off();
+        return;
     }
+
+    /* The flip goes first so the rise starts from the reversed carrier */
+    if (sym->invert != output_inverted) {
+        apply_phase(sym);
+    }
+    if (sym->shape & (TX_SHAPE_RAMP_UP | TX_SHAPE_RAMP_DOWN)) {
+        envelope_shape(sym_start_ticks, sym_end_ticks, sym->shape);
+    }
+
+    apply_tone(sym);
 }
 
 static void tx_off() {
     printk("tx_engine: TX off\n");
     si5351a_enable_output(si5351a, TX_CLK_OUTPUT, false);
-    regulator_disable(regulator);
+    if (regulator_is_enabled(regulator)) {
+        regulator_disable(regulator);
+    }
+    envelope_stop();
+    alc_set_gate(true);
+    keyed_down = false;
+    output_on = false;
 }
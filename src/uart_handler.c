@@ -2,6 +2,7 @@
 #include "config.h"
 #include "protocol/packet_parser.h"
 #include "protocol/cobs.h"
+#include "radio/timebase.h"
 #include <zephyr/sys/ring_buffer.h>
 #include <zephyr/drivers/uart.h>
 #include <zephyr/kernel.h>
@@ -17,17 +18,22 @@ RING_BUF_DECLARE(tx_ring_buf, RING_BUF_SIZE);
 static uint8_t isr_cobs_buf[COBS_BUF_MAX];
 static uint8_t isr_decoded_buf[DECODED_PKT_MAX];
 
-#define RX_MSG_SIZE (sizeof(uint16_t) + DECODED_PKT_MAX)
+/* Queued packets carry their length and the timebase time at which the
+ * closing delimiter arrived */
+#define RX_MSG_HDR  (sizeof(uint16_t) + sizeof(int64_t))
+#define RX_MSG_SIZE (RX_MSG_HDR + DECODED_PKT_MAX)
 #define RX_QUEUE_DEPTH 4
 K_MSGQ_DEFINE(rx_pkt_msgq, RX_MSG_SIZE, RX_QUEUE_DEPTH, 4);
 
 static struct k_work rx_dispatch_work;
+static int64_t dispatch_rx_us;
 
 static void rx_dispatch_handler(struct k_work *work) {
     uint8_t msg[RX_MSG_SIZE];
     while (k_msgq_get(&rx_pkt_msgq, msg, K_NO_WAIT) == 0) {
         uint16_t len = (uint16_t)msg[0] | ((uint16_t)msg[1] << 8);
-        parse_dispatch_packet(&msg[sizeof(uint16_t)], len);
+        memcpy(&dispatch_rx_us, &msg[sizeof(uint16_t)], sizeof(dispatch_rx_us));
+        parse_dispatch_packet(&msg[RX_MSG_HDR], len);
     }
 }
 
@@ -42,6 +48,7 @@ static void uart_isr(const struct device *dev, void *user_data) {
         uart_fifo_read(dev, &byte, 1);
 
         if (byte == 0x00) {
+            int64_t rx_us = timebase_now_us();
             uint32_t len_in_buf = ring_buf_get(&rx_ring_buf, isr_cobs_buf,
                                                sizeof(isr_cobs_buf));
             if (len_in_buf > 0) {
@@ -52,7 +59,8 @@ static void uart_isr(const struct device *dev, void *user_data) {
                     uint8_t msg[RX_MSG_SIZE];
                     msg[0] = decoded_len & 0xFF;
                     msg[1] = (decoded_len >> 8) & 0xFF;
-                    memcpy(&msg[sizeof(uint16_t)], isr_decoded_buf,
+                    memcpy(&msg[sizeof(uint16_t)], &rx_us, sizeof(rx_us));
+                    memcpy(&msg[RX_MSG_HDR], isr_decoded_buf,
                            decoded_len);
                     if (k_msgq_put(&rx_pkt_msgq, msg, K_NO_WAIT) == 0) {
                         k_work_submit(&rx_dispatch_work);
@@ -86,6 +94,10 @@ void uart_handler_init() {
     uart_irq_rx_enable(uart_dev);
 }
 
+int64_t uart_handler_rx_time_us() {
+    return dispatch_rx_us;
+}
+
 int send_uart_data(const uint8_t *data, size_t length) {
     uint32_t written = ring_buf_put(&tx_ring_buf, data, length);
     uart_irq_tx_enable(uart_dev);
@@ -0,0 +1,121 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <math.h>
+
+#include "radio_core.h"
+#include "hardware/envelope.h"
+#include "modes/encoders/bpsk.h"
+
+ZTEST(envelope, test_raised_cosine) {
+    for (int i = 0; i <= ENVELOPE_STEPS; i++) {
+        double want = 2047.5 * (1.0 - cos(M_PI * i / ENVELOPE_STEPS));
+
+        zassert_within(envelope_rise[i], want, 1.0, "rise %d: %u", i, envelope_rise[i]);
+        zassert_equal(envelope_fall[i], envelope_rise[ENVELOPE_STEPS - i], "fall %d", i);
+        if (i > 0) {
+            zassert_true(envelope_rise[i] > envelope_rise[i - 1], "rise %d", i);
+        }
+    }
+    zassert_equal(envelope_rise[0], 0);
+    zassert_equal(envelope_fall[ENVELOPE_STEPS], 0);
+}
+
+/* Check the ramps of a symbol over [start, end) in ticks, and raise
+ * *max_lag to how many hardware cycles the null of its fall comes
+ * before end */
+static void check_ramps(int64_t start, int64_t end, uint8_t shape, uint64_t *max_lag) {
+    struct envelope_plan plan;
+    long long s = start, e = end;
+
+    envelope_plan_shape(start, end, &plan);
+
+    uint32_t step = envelope_step_cycles(plan.ramp_us);
+    zassert_true(step >= 2, "%lld-%lld: ramp of %u us set at once", s, e, plan.ramp_us);
+    uint64_t ramp_cycles = (uint64_t)step * ENVELOPE_STEPS;
+    uint64_t rise_end = k_ticks_to_cyc_floor64(start) + ramp_cycles;
+    uint64_t fall_start = k_ticks_to_cyc_floor64(plan.fall_ticks);
+    uint64_t null = fall_start + ramp_cycles;
+    uint64_t boundary = k_ticks_to_cyc_floor64(end);
+
+    /* The ramps of one symbol do not overlap */
+    if ((shape & TX_SHAPE_RAMP_UP) && (shape & TX_SHAPE_RAMP_DOWN)) {
+        zassert_true(rise_end <= fall_start, "%lld-%lld", s, e);
+    }
+    if (!(shape & TX_SHAPE_RAMP_DOWN)) {
+        return;
+    }
+
+    /* Never at amplitude on the boundary; early by at most the rounding
+     * of the fall's start to a tick and of the ramp to whole steps */
+    zassert_true(null <= boundary, "%lld-%lld: null %llu cycles after the flip", s, e,
+                 (unsigned long long)(null - boundary));
+    uint64_t lag = boundary - null;
+    zassert_true(lag <= k_ticks_to_cyc_floor64(1) + ENVELOPE_STEPS,
+                 "%lld-%lld: null %llu cycles early", s, e, (unsigned long long)lag);
+    *max_lag = MAX(*max_lag, lag);
+}
+
+/* Play a BPSK31 sequence on the tick grid tx_engine arms its boundaries
+ * on and work out, in hardware cycles, where each falling ramp reaches
+ * zero. The engine flips the carrier at the following boundary, so the
+ * time from null to boundary is the time the carrier is off before the
+ * flip: it must not be negative, as that would flip at amplitude, and
+ * must stay well under a millisecond. */
+ZTEST(envelope, test_null_before_flip) {
+    const int64_t seq_start_ticks = 12345;
+    tx_sequence_t seq = { 0 };
+    uint64_t elapsed_us = 0;
+    uint64_t max_lag = 0;
+    int flips = 0;
+    bool prev_invert = false;
+    uint8_t prev_shape = 0;
+
+    zassert_ok(generate_bpsk31_sequence("CQ CQ DE K1ABC K1ABC PSE K", &seq));
+
+    for (size_t i = 0; i < seq.total_symbols; i++) {
+        tx_symbol_t sym;
+
+        zassert_ok(seq.source(&seq, i, &sym));
+
+        int64_t start = seq_start_ticks + k_us_to_ticks_near64(elapsed_us);
+        elapsed_us += sym.duration_us;
+        int64_t end = seq_start_ticks + k_us_to_ticks_near64(elapsed_us);
+
+        /* A reversal only comes between a fall and a rise */
+        if (i > 0 && sym.invert != prev_invert) {
+            zassert_true(prev_shape & TX_SHAPE_RAMP_DOWN, "symbol %zu", i);
+            zassert_true(sym.shape & TX_SHAPE_RAMP_UP, "symbol %zu", i);
+            flips++;
+        }
+        prev_invert = sym.invert;
+        prev_shape = sym.shape;
+
+        if (sym.shape & (TX_SHAPE_RAMP_UP | TX_SHAPE_RAMP_DOWN)) {
+            check_ramps(start, end, sym.shape, &max_lag);
+        }
+    }
+
+    zassert_true(flips > BPSK31_PREAMBLE);
+    zassert_true(k_cyc_to_us_ceil64(max_lag) < 1000);
+    TC_PRINT("%d flips, null at most %llu us ahead of the flip\n", flips,
+             (unsigned long long)k_cyc_to_us_ceil64(max_lag));
+}
+
+/* Spans that are no whole number of ticks apart from the BPSK31 one, so
+ * the rounding of each ramp shows */
+ZTEST(envelope, test_null_odd_spans) {
+    const uint8_t both = TX_SHAPE_RAMP_UP | TX_SHAPE_RAMP_DOWN;
+    uint64_t max_lag = 0;
+
+    for (uint64_t us = 1000; us <= 200000; us += 777) {
+        int64_t start = k_us_to_ticks_near64(3 * us);
+        int64_t end = k_us_to_ticks_near64(4 * us);
+
+        check_ramps(start, end, both, &max_lag);
+    }
+    zassert_true(k_cyc_to_us_ceil64(max_lag) < 1000);
+    TC_PRINT("null at most %llu us ahead of the boundary\n",
+             (unsigned long long)k_cyc_to_us_ceil64(max_lag));
+}
+
+ZTEST_SUITE(envelope, NULL, NULL, NULL, NULL, NULL);
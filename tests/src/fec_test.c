@@ -0,0 +1,183 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modes/fec.h"
+#include "modes/ftx.h"
+
+/* Payload and codeword of each FT8 vector message, in hex as the LDPC
+ * lines of scripts/ftx_vectors.py print them: the CRC-14 and the parity
+ * on their own, ahead of the tone mapping the channel vectors add. */
+struct ldpc_vector {
+    const char *name;
+    const char *payload;
+    const char *codeword;
+};
+
+static const struct ldpc_vector ldpc_vectors[] = {
+    { "CQ K1ABC FN42", "000000204def1a8a1988",
+      "000000204def1a8a198965d5048de1e074b7d3485298" },
+    { "K1ABC W9XYZ EN37", "09bde3506149dc085648",
+      "09bde3506149dc08564e2fae93ca65df8402f4f9ab68" },
+    { "W9XYZ K1ABC -11", "0c293b804def1a9faa08",
+      "0c293b804def1a9faa0f0b1546c33c3c01f8d97f0764" },
+    { "K1ABC W9XYZ R-09", "09bde3506149dc3faa88",
+      "09bde3506149dc3faa8f849ac294195f277d5b4430a4" },
+    { "W9XYZ K1ABC RR73", "0c293b804def1a9fa4c8",
+      "0c293b804def1a9fa4cf1656832207893ac5a5fb8bc8" },
+    { "free text TNX BOB 73 GL", "63edcee2a4ae07f50000",
+      "63edcee2a4ae07f50007f175cfa166a3bd840af05088" },
+    { "free text HELLO", "000000000006d06f0a00",
+      "000000000006d06f0a005a82f6dc7e2d8a407bdff664" },
+    { "telemetry 123456789ABCDEF012", "2468acf13579bde02540",
+      "2468acf13579bde025432358a918aebc272cf72f7758" },
+    { "telemetry 7FFFFFFFFFFFFFFFFF", "ffffffffffffffffff40",
+      "ffffffffffffffffff4260b7c66808d17b035b4cd5dc" },
+};
+
+static void from_hex(const char *hex, uint8_t *out) {
+    for (size_t i = 0; hex[2 * i]; i++) {
+        char pair[3] = { hex[2 * i], hex[2 * i + 1], '\0' };
+        out[i] = (uint8_t)strtoul(pair, NULL, 16);
+    }
+}
+
+static uint32_t test_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/* Long division a bit at a time, the textbook form of the CRC */
+static uint32_t crc_bitwise(uint8_t width, uint32_t poly, const uint8_t *bits, size_t nbits) {
+    uint32_t mask = (uint32_t)((1ULL << width) - 1);
+    uint32_t reg = 0;
+
+    for (size_t i = 0; i < nbits; i++) {
+        uint32_t fb = ((reg >> (width - 1)) ^ (bits[i / 8] >> (7 - i % 8))) & 1;
+        reg = ((reg << 1) ^ (fb ? poly : 0)) & mask;
+    }
+    return reg;
+}
+
+static uint32_t crc24a_table[256];
+static const struct fec_crc crc24a = { 24, 0x864CFB, crc24a_table };
+
+/* The catalogue check value, CRC of "123456789" */
+ZTEST(fec, test_crc_check_values) {
+    static const uint8_t check[] = "123456789";
+    uint32_t table[256];
+
+    zassert_equal(fec_crc(&fec_crc14, check, 72), 0x0F31);
+
+    /* FST4W's, which no catalogue lists; from scripts/fst4w_vectors.py */
+    zassert_equal(fec_crc(&fec_crc24, check, 72), 0xE6C948);
+
+    /* CRC-24/LTE-A, a table built at run time */
+    zassert_equal(fec_crc(&crc24a, check, 72), 0xCDE703);
+
+    fec_crc_make_table(14, 0x2757, table);
+    zassert_mem_equal(table, fec_crc14.table, sizeof(table));
+    fec_crc_make_table(24, 0x00065B, table);
+    zassert_mem_equal(table, fec_crc24.table, sizeof(table));
+}
+
+/* Every length, so the trailing partial byte is covered */
+ZTEST(fec, test_crc_bitwise) {
+    uint32_t seed = 0x2757;
+    uint8_t bits[32];
+
+    for (size_t nbits = 0; nbits <= 8 * sizeof(bits); nbits++) {
+        for (size_t i = 0; i < sizeof(bits); i++) {
+            bits[i] = test_rand(&seed);
+        }
+        zassert_equal(fec_crc(&fec_crc14, bits, nbits), crc_bitwise(14, 0x2757, bits, nbits),
+                      "CRC-14 over %zu bits", nbits);
+        zassert_equal(fec_crc(&fec_crc24, bits, nbits), crc_bitwise(24, 0x00065B, bits, nbits),
+                      "CRC-24 over %zu bits", nbits);
+        zassert_equal(fec_crc(&crc24a, bits, nbits), crc_bitwise(24, 0x864CFB, bits, nbits),
+                      "CRC-24/LTE-A over %zu bits", nbits);
+    }
+}
+
+ZTEST(fec, test_ldpc_vectors) {
+    for (size_t v = 0; v < ARRAY_SIZE(ldpc_vectors); v++) {
+        const struct ldpc_vector *lv = &ldpc_vectors[v];
+        uint8_t payload[10], want[FTX_CODEWORD_BYTES], got[FTX_CODEWORD_BYTES];
+        uint8_t decoded[FTX_CODEWORD_BYTES];
+        int16_t llr[FTX_LDPC_N];
+
+        from_hex(lv->payload, payload);
+        from_hex(lv->codeword, want);
+
+        ftx_encode_codeword(payload, got);
+        zassert_mem_equal(got, want, sizeof(want), "%s", lv->name);
+        zassert_equal(ftx_crc14(payload),
+                      (want[9] & 0x07) << 11 | want[10] << 3 | want[11] >> 5, "%s", lv->name);
+
+        /* A codeword satisfies every parity check of the decoder's H,
+         * with a few bits received weakly and wrong */
+        for (int n = 0; n < FTX_LDPC_N; n++) {
+            llr[n] = fec_get_bit(want, n) ? 100 : -100;
+        }
+        for (int n = 3; n < FTX_LDPC_N; n += 29) {
+            llr[n] = -llr[n] / 4;
+        }
+        zassert_equal(ftx_ldpc_decode(llr, 20, decoded), 0, "%s", lv->name);
+        zassert_mem_equal(decoded, want, sizeof(want), "%s", lv->name);
+    }
+}
+
+/* Shift register a bit at a time against fec_conv_encode, and against
+ * fec_conv_state at every position, WSPR's K=32 code and the K=7 one */
+static void check_conv(const struct fec_conv *code) {
+    uint32_t seed = 0xC0DE;
+    uint8_t msg[16], got[40], want[40];
+
+    for (size_t nbits = 1; nbits <= 8 * sizeof(msg); nbits += 3) {
+        uint32_t state = 0;
+        size_t pos = 0;
+
+        for (size_t i = 0; i < sizeof(msg); i++) {
+            msg[i] = test_rand(&seed);
+        }
+        memset(got, 0, sizeof(got));
+        memset(want, 0, sizeof(want));
+
+        for (size_t k = 0; k < nbits + code->constraint - 1; k++) {
+            uint32_t in = k < nbits ? (msg[k / 8] >> (7 - k % 8)) & 1 : 0;
+            state = (state << 1) | in;
+            if (code->constraint < 32) {
+                state &= (1u << code->constraint) - 1;
+            }
+            zassert_equal(fec_conv_state(code, msg, nbits, k), state, "K=%d %zu bits, bit %zu",
+                          code->constraint, nbits, k);
+            for (int j = 0; j < code->rate; j++, pos++) {
+                if (__builtin_parity(state & code->polys[j])) {
+                    want[pos / 8] |= 0x80 >> (pos % 8);
+                }
+            }
+        }
+
+        fec_conv_encode(code, msg, nbits, got);
+        zassert_mem_equal(got, want, sizeof(want), "K=%d %zu bits", code->constraint, nbits);
+    }
+}
+
+ZTEST(fec, test_conv_bitwise) {
+    static const uint32_t wspr_polys[] = { 0xF2D05351, 0xE4613C47 };
+    static const uint32_t k7_polys[] = { 0171, 0133 };
+
+    check_conv(&(struct fec_conv){ 32, 2, wspr_polys });
+    check_conv(&(struct fec_conv){ 7, 2, k7_polys });
+}
+
+static void *fec_setup(void) {
+    fec_crc_make_table(24, 0x864CFB, crc24a_table);
+    return NULL;
+}
+
+ZTEST_SUITE(fec, NULL, fec_setup, NULL, NULL, NULL);
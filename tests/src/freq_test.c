@@ -0,0 +1,273 @@
+#include <zephyr/ztest.h>
+#include <math.h>
+#include <string.h>
+
+#include "clock_si5351a.h"
+#include "radio_core.h"
+#include "modes/encoders/wspr.h"
+#include "modes/encoders/ft8.h"
+
+/* Tones are checked as the synthesiser would make them: the multisynth
+ * a + b/c the driver programs for each frequency, divided into PLLA at
+ * the 600 MHz main.c sets.
+ *
+ * Offsets from the encoders are exact to the microhertz they are rounded
+ * to. On the output, a 20-bit denominator cannot land every frequency
+ * exactly: the worst over 30 m, where the divider sits by a fraction
+ * like 178/3, is 27 mHz, against 160 mHz for the 10^6 denominator the
+ * driver used to truncate to. test_best_divider checks no register
+ * setting would come closer. */
+#define PLL_HZ          600000000ULL
+#define TOLERANCE_HZ    0.03
+
+#define WSPR_SPACING_HZ (12000.0 / 8192)
+#define FT8_SPACING_HZ  6.25
+
+static void ms_output_hz(freq_uhz_t freq, double *hz) {
+    uint32_t a, b, c;
+
+    si5351a_calc_ratio(PLL_HZ * FREQ_UHZ_PER_HZ, (uint64_t)freq, &a, &b, &c);
+    zassert_true(a >= 6 && a <= 1800, "divider %u out of range", a);
+    zassert_true(c >= 1 && c <= si5351a_FRAC_DENOM_MAX, "denominator %u", c);
+    zassert_true(b < c, "b %u >= c %u", b, c);
+
+    *hz = (double)PLL_HZ * c / ((double)a * c + b);
+}
+
+/* Every symbol of seq from each base frequency lands tone * spacing
+ * above where the base itself does */
+static void check_spacing(const tx_sequence_t *seq, double spacing_hz, int tones,
+                          freq_uhz_t from, freq_uhz_t to, freq_uhz_t step) {
+    for (freq_uhz_t base = from; base <= to; base += step) {
+        double base_hz;
+        ms_output_hz(base, &base_hz);
+
+        for (size_t i = 0; i < seq->total_symbols; i++) {
+            tx_symbol_t sym;
+            if (seq->symbols) {
+                sym = seq->symbols[i];
+            } else {
+                zassert_ok(seq->source(seq, i, &sym));
+            }
+
+            long tone = lround(sym.freq_offset_uhz / (spacing_hz * FREQ_UHZ_PER_HZ));
+            zassert_true(tone >= 0 && tone < tones, "symbol %zu tone %ld", i, tone);
+            zassert_true(fabs(sym.freq_offset_uhz - tone * spacing_hz * FREQ_UHZ_PER_HZ) <= 0.5,
+                         "symbol %zu offset %lld uHz", i, (long long)sym.freq_offset_uhz);
+
+            double hz;
+            ms_output_hz(base + sym.freq_offset_uhz, &hz);
+
+            double err = hz - base_hz - tone * spacing_hz;
+            zassert_true(fabs(err) < TOLERANCE_HZ,
+                         "base %lld uHz symbol %zu: tone %ld off by %g Hz",
+                         (long long)base, i, tone, err);
+        }
+    }
+}
+
+ZTEST(freq, test_integer_ratio) {
+    uint32_t a, b, c;
+
+    si5351a_calc_ratio(PLL_HZ * FREQ_UHZ_PER_HZ, FREQ_HZ(10000000), &a, &b, &c);
+    zassert_equal(a, 60);
+    zassert_equal(b, 0);
+    zassert_equal(c, 1);
+}
+
+ZTEST(freq, test_best_fraction) {
+    uint32_t a, b, c;
+
+    /* 60 + 1/3 exactly, which no power of ten denominator holds */
+    si5351a_calc_ratio(181, 3, &a, &b, &c);
+    zassert_equal(a, 60);
+    zassert_equal(b, 1);
+    zassert_equal(c, 3);
+
+    /* pi: the last convergent under 2^20 is 3 + 51669/364913, and two
+     * steps on to the next is past half of its term of 3 */
+    si5351a_calc_ratio(3141592653589793ULL, 1000000000000000ULL, &a, &b, &c);
+    zassert_equal(a, 3);
+    zassert_equal(b, 140914);
+    zassert_equal(c, 995207);
+}
+
+/* Against every denominator the register takes */
+ZTEST(freq, test_best_divider) {
+    static const freq_uhz_t freqs[] = {
+        FREQ_HZ(10140200), FREQ_HZ(10140200) + FREQ_RATIO(12000, 8192),
+        10112356593787, 10112356593787 + FREQ_RATIO(3 * 12000, 8192),
+        FREQ_HZ(10136000) + FREQ_RATIO(7 * 12000, 1920),
+    };
+    const uint64_t num = PLL_HZ * FREQ_UHZ_PER_HZ;
+
+    for (size_t i = 0; i < ARRAY_SIZE(freqs); i++) {
+        uint64_t den = (uint64_t)freqs[i];
+        uint64_t rem = num % den;
+        uint32_t a, b, c;
+
+        si5351a_calc_ratio(num, den, &a, &b, &c);
+        zassert_equal(a, num / den);
+        double err = fabs((double)rem / den - (double)b / c);
+
+        for (uint64_t q = 1; q <= si5351a_FRAC_DENOM_MAX; q++) {
+            uint64_t p = (rem * q + den / 2) / den;
+            double e = fabs((double)rem / den - (double)p / q);
+            zassert_true(err <= e * (1 + 1e-9), "%llu uHz: %u/%u beaten by %llu/%llu",
+                         (unsigned long long)den, b, c,
+                         (unsigned long long)p, (unsigned long long)q);
+        }
+    }
+}
+
+/* P1/P2/P3 of one multisynth block as the chip reads them back: the
+ * register layout of AN619, which puts P3's top four bits beside P2's */
+static void unpack_p(const uint8_t r[8], uint32_t *p1, uint32_t *p2, uint32_t *p3) {
+    *p3 = (uint32_t)(r[5] >> 4) << 16 | r[0] << 8 | r[1];
+    *p1 = (uint32_t)(r[2] & 0x03) << 16 | r[3] << 8 | r[4];
+    *p2 = (uint32_t)(r[5] & 0x0F) << 16 | r[6] << 8 | r[7];
+}
+
+/* The divider the chip makes of them is (P1 + 512 + P2 / P3) / 128 */
+static double regs_output_hz(const struct si5351a_ms_regs *regs) {
+    uint32_t p1, p2, p3;
+
+    unpack_p(&regs->buf[1], &p1, &p2, &p3);
+    return (double)PLL_HZ * 128 * p3 / ((double)(p1 + 512) * p3 + p2);
+}
+
+ZTEST(freq, test_pack_params) {
+    static const struct {
+        uint32_t a, b, c;
+        uint8_t regs[8];
+    } vectors[] = {
+        /* Integer divide: P1 = 128 * 60 - 512, P2 = 0, P3 = 1 */
+        { 60, 0, 1, { 0x00, 0x01, 0x00, 0x1C, 0x00, 0x00, 0x00, 0x00 } },
+        /* The largest divider reaches P1 bits 17:16 */
+        { 1800, 0, 1, { 0x00, 0x01, 0x03, 0x82, 0x00, 0x00, 0x00, 0x00 } },
+        /* 20-bit P2 and P3, both top nibbles in the shared register */
+        { 59, 157081, 921764, { 0x10, 0xA4, 0x00, 0x1B, 0x95, 0xEB, 0x6F, 0x0C } },
+        { 6, 1048574, 1048575, { 0xFF, 0xFF, 0x00, 0x01, 0x7F, 0xFF, 0xFF, 0x7F } },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(vectors); i++) {
+        uint8_t regs[8];
+
+        si5351a_pack_params(vectors[i].a, vectors[i].b, vectors[i].c, regs);
+        zassert_mem_equal(regs, vectors[i].regs, sizeof(regs), "%u + %u/%u", vectors[i].a,
+                          vectors[i].b, vectors[i].c);
+    }
+}
+
+/* The bytes written for each tone of a WSPR transmission on 30 m and an
+ * FT8 one at 1500 Hz on 20 m. The expected blocks come from the best
+ * fraction under 2^20 of Python's Fraction.limit_denominator, packed
+ * by the AN619 formulas. P1 stays put from tone to tone: the whole
+ * 1.46 or 6.25 Hz step is in P2/P3, which only a microhertz tone
+ * frequency carries. */
+struct tone_regs {
+    freq_uhz_t base;
+    freq_uhz_t spacing_num;
+    freq_uhz_t spacing_den;
+    double spacing_hz;
+    int tones;
+    uint8_t regs[8][8];
+};
+
+static const struct tone_regs tone_vectors[] = {
+    {
+        FREQ_HZ(10140200), 12000, 8192, WSPR_SPACING_HZ, 4,
+        {
+            { 0xC6, 0x0D, 0x00, 0x1B, 0x95, 0x00, 0xA1, 0x6F },
+            { 0xF6, 0xEF, 0x00, 0x1B, 0x95, 0xA8, 0xEC, 0xE5 },
+            { 0x10, 0xA4, 0x00, 0x1B, 0x95, 0xEB, 0x6F, 0x0C },
+            { 0x24, 0x2F, 0x00, 0x1B, 0x95, 0xDA, 0xAB, 0x25 },
+        },
+    },
+    {
+        FREQ_HZ(14075500), 12000, 1920, FT8_SPACING_HZ, 8,
+        {
+            { 0x6D, 0xF7, 0x00, 0x13, 0x50, 0x00, 0x1F, 0xD0 },
+            { 0x81, 0xF2, 0x00, 0x13, 0x50, 0xF4, 0x72, 0xE0 },
+            { 0xBA, 0x33, 0x00, 0x13, 0x50, 0x51, 0xA1, 0x10 },
+            { 0xF6, 0x69, 0x00, 0x13, 0x50, 0xB3, 0x5F, 0xB0 },
+            { 0x97, 0x4D, 0x00, 0x13, 0x50, 0x82, 0x66, 0xF0 },
+            { 0x4A, 0x7B, 0x00, 0x13, 0x50, 0x20, 0xA2, 0x90 },
+            { 0xF5, 0x9B, 0x00, 0x13, 0x50, 0xF4, 0x62, 0x90 },
+            { 0x63, 0xF4, 0x00, 0x13, 0x50, 0x72, 0x03, 0x40 },
+        },
+    },
+};
+
+ZTEST(freq, test_tone_registers) {
+    for (size_t v = 0; v < ARRAY_SIZE(tone_vectors); v++) {
+        const struct tone_regs *tv = &tone_vectors[v];
+        double base_hz = 0;
+
+        for (int tone = 0; tone < tv->tones; tone++) {
+            freq_uhz_t freq = tv->base + FREQ_RATIO(tone * tv->spacing_num, tv->spacing_den);
+            struct si5351a_ms_regs regs;
+
+            zassert_ok(si5351a_plan_ms_regs(PLL_HZ, 2, (uint64_t)freq, &regs));
+            zassert_equal(regs.buf[0], si5351a_CLK0_PARAMETERS + 2 * 8);
+            zassert_mem_equal(&regs.buf[1], tv->regs[tone], 8, "%lld uHz",
+                              (long long)freq);
+
+            /* And the chip divides them down to the tone */
+            double hz = regs_output_hz(&regs);
+            if (tone == 0) {
+                base_hz = hz;
+            }
+            double err = hz - base_hz - tone * tv->spacing_hz;
+            zassert_true(fabs(err) < TOLERANCE_HZ, "%lld uHz: tone %d off by %g Hz",
+                         (long long)freq, tone, err);
+        }
+    }
+}
+
+ZTEST(freq, test_plan_ms_regs_range) {
+    struct si5351a_ms_regs regs;
+
+    zassert_ok(si5351a_plan_ms_regs(PLL_HZ, 7, FREQ_HZ(10000000), &regs));
+    zassert_equal(regs.buf[0], si5351a_CLK0_PARAMETERS + 7 * 8);
+    zassert_equal(si5351a_plan_ms_regs(PLL_HZ, 8, FREQ_HZ(10000000), &regs), -EINVAL);
+    zassert_equal(si5351a_plan_ms_regs(0, 0, FREQ_HZ(10000000), &regs), -EINVAL);
+    zassert_equal(si5351a_plan_ms_regs(PLL_HZ, 0, 0, &regs), -EINVAL);
+    zassert_equal(si5351a_plan_ms_regs(PLL_HZ, 0, FREQ_HZ(200000001), &regs), -EINVAL);
+
+    /* Dividers of 6 and 1800 are the ends the multisynth takes */
+    zassert_ok(si5351a_plan_ms_regs(PLL_HZ, 0, FREQ_HZ(100000000), &regs));
+    zassert_equal(si5351a_plan_ms_regs(PLL_HZ, 0, FREQ_HZ(100000001), &regs), -EINVAL);
+    zassert_ok(si5351a_plan_ms_regs(PLL_HZ, 0, FREQ_RATIO(600000000, 1800), &regs));
+    zassert_equal(si5351a_plan_ms_regs(PLL_HZ, 0, FREQ_HZ(333000), &regs), -EINVAL);
+}
+
+ZTEST(freq, test_wspr_tone_spacing) {
+    static const wspr_payload_t payload = { "K1ABC", "FN42", 37 };
+    tx_sequence_t seq = {0};
+
+    zassert_ok(generate_wspr_sequence(&payload, &seq));
+    zassert_equal(seq.total_symbols, 162);
+
+    /* The 200 Hz WSPR window on 30 m, then the band at large */
+    check_spacing(&seq, WSPR_SPACING_HZ, 4, FREQ_HZ(10140100), FREQ_HZ(10140300),
+                  FREQ_RATIO(171, 100));
+    check_spacing(&seq, WSPR_SPACING_HZ, 4, FREQ_HZ(10100000), FREQ_HZ(10150000),
+                  FREQ_RATIO(99991, 100));
+}
+
+ZTEST(freq, test_ft8_tone_spacing) {
+    ftx_payload_t payload = { .type = FTX_MODE_FREE_TEXT };
+    tx_sequence_t seq = {0};
+
+    strcpy(payload.data.free_text.text, "TNX BOB 73 GL");
+    zassert_ok(generate_ft8_sequence(&payload, &seq));
+    zassert_equal(seq.total_symbols, 79);
+
+    check_spacing(&seq, FT8_SPACING_HZ, 8, FREQ_HZ(10136000), FREQ_HZ(10139000),
+                  FREQ_RATIO(3137, 100));
+    check_spacing(&seq, FT8_SPACING_HZ, 8, FREQ_HZ(10100000), FREQ_HZ(10150000),
+                  FREQ_RATIO(99991, 100));
+}
+
+ZTEST_SUITE(freq, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,152 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "radio_core.h"
+#include "modes/encoders/fst4w.h"
+
+/* Channel symbols and codewords as scripts/fst4w_vectors.py prints them.
+ * That script solves the parity from the parity-check matrix for each
+ * message, where fst4w.c sums generator columns, and computes the CRC a
+ * bit at a time. The tones are the same in every T/R period. */
+struct fst4w_vector {
+    wspr_payload_t payload;
+    const char *symbols;
+    uint8_t codeword[FST4W_CODEWORD_BYTES];
+};
+
+static const struct fst4w_vector vectors[] = {
+    {
+        { "K1ABC", "FN42", 37 },
+        "0132102322120020030230320021013111011123103201103113030100213231332223232231013210231203133023303322021222320310322310320111231322020020112213120322302201321023",
+        { 0xF7, 0x0C, 0x23, 0x8B, 0x0D, 0x19, 0x51, 0x54, 0x96, 0x21,
+          0x0D, 0xB9, 0xAF, 0xEE, 0xF9, 0x72, 0x68, 0xE8, 0xAF, 0x37,
+          0xFB, 0x24, 0xB5, 0xE6, 0xF3, 0x0C, 0x5F, 0x67, 0x2F, 0x8F },
+    },
+    {
+        { "G4JNT", "IO90", 30 },
+        "0132102322131120001122122233311233301223103201202100122111313311111220201101013210231301333233322303000011232322032310320101010210102320003300233322002101321023",
+        { 0xF6, 0x5C, 0x05, 0xF7, 0xFA, 0x97, 0xA8, 0x7C, 0xD0, 0x7D,
+          0x59, 0xA5, 0x57, 0xCC, 0x51, 0x61, 0xAB, 0xAB, 0xE2, 0x00,
+          0x5E, 0xEF, 0x21, 0x13, 0x44, 0xEC, 0x0A, 0x0E, 0xAF, 0x0D },
+    },
+    {
+        { "KH6XYZ", "BL11", 23 },
+        "0132102330331231003100232101221123222323103201130201001332100121000211012303013210231202232211232320101030023320022310320103020300232212230131030101203201321023",
+        { 0x8A, 0x79, 0x09, 0x0E, 0xD1, 0xF5, 0xEF, 0xE6, 0x31, 0x06,
+          0xB4, 0x1D, 0x03, 0x51, 0xE2, 0x73, 0xEF, 0x5E, 0xEC, 0x44,
+          0x83, 0xAC, 0x32, 0x32, 0x0E, 0xF7, 0xE1, 0x92, 0x11, 0xCB },
+    },
+    {
+        { "W1AW", "FN31", 0 },
+        "0132102322311020232322320302120001103023103201032123203122221111203223310122013210232223033220000113132333223133202310320102130120320110000033212102332001321023",
+        { 0xF9, 0x4C, 0xEE, 0xFB, 0x23, 0x70, 0x14, 0x82, 0xDE, 0xC9,
+          0xFF, 0x55, 0xCB, 0xE9, 0x1F, 0xFE, 0x2B, 0xC0, 0x16, 0x6E,
+          0xAF, 0x9A, 0xC3, 0x61, 0xCB, 0x14, 0x00, 0xAD, 0xD3, 0xAC },
+    },
+};
+
+static int symbol_tone(const tx_sequence_t *seq, enum fst4w_period period, size_t i) {
+    uint32_t nsps = fst4w_symbol_samples(period);
+    tx_symbol_t sym;
+
+    if (seq->source(seq, i, &sym)) {
+        return -1;
+    }
+    for (int tone = 0; tone < 4; tone++) {
+        if (FREQ_RATIO(tone * 12000, nsps) == sym.freq_offset_uhz) {
+            return tone;
+        }
+    }
+    return -1;
+}
+
+ZTEST(fst4w, test_codewords) {
+    for (size_t v = 0; v < ARRAY_SIZE(vectors); v++) {
+        const wspr_payload_t *p = &vectors[v].payload;
+        uint8_t message[WSPR_MESSAGE_BYTES];
+        uint8_t codeword[FST4W_CODEWORD_BYTES];
+
+        zassert_ok(wspr_pack_message(p, message), "%s", p->callsign);
+        fst4w_encode_codeword(message, codeword);
+        zassert_mem_equal(codeword, vectors[v].codeword, sizeof(codeword), "%s %s %d",
+                          p->callsign, p->grid, p->power_dbm);
+    }
+}
+
+ZTEST(fst4w, test_reference_vectors) {
+    for (enum fst4w_period period = 0; period < FST4W_PERIOD_COUNT; period++) {
+        for (size_t v = 0; v < ARRAY_SIZE(vectors); v++) {
+            const wspr_payload_t *p = &vectors[v].payload;
+            tx_sequence_t seq = { 0 };
+            char symbols[FST4W_SYMBOL_COUNT + 1] = { 0 };
+
+            zassert_ok(generate_fst4w_sequence(p, period, &seq), "%s", p->callsign);
+            zassert_equal(seq.total_symbols, FST4W_SYMBOL_COUNT);
+            zassert_not_null(seq.source);
+
+            for (size_t i = 0; i < FST4W_SYMBOL_COUNT; i++) {
+                int tone = symbol_tone(&seq, period, i);
+                zassert_true(tone >= 0, "%s: symbol %zu", p->callsign, i);
+                symbols[i] = '0' + tone;
+            }
+
+            zassert_str_equal(symbols, vectors[v].symbols, "%s %s %d:\n got %s\nwant %s",
+                              p->callsign, p->grid, p->power_dbm, symbols, vectors[v].symbols);
+        }
+    }
+}
+
+/* Durations add up to the exact length of 160 symbols of nsps samples
+ * at 12 kHz, and none is more than half a microsecond off its share */
+ZTEST(fst4w, test_timing) {
+    static const uint64_t total_us[FST4W_PERIOD_COUNT] = {
+        109333333, 286720000, 887466667, 1792000000,
+    };
+
+    for (enum fst4w_period period = 0; period < FST4W_PERIOD_COUNT; period++) {
+        tx_sequence_t seq = { 0 };
+        uint64_t start_us = 0;
+
+        zassert_ok(generate_fst4w_sequence(&vectors[0].payload, period, &seq));
+        zassert_true(fst4w_period_us(period) > total_us[period] + FST4W_TX_DELAY_US);
+
+        for (size_t i = 0; i < FST4W_SYMBOL_COUNT; i++) {
+            tx_symbol_t sym;
+            zassert_ok(seq.source(&seq, i, &sym));
+            zassert_true(sym.tx_on);
+
+            /* 12000 * (start_us + duration) against (i + 1) * nsps * 1e6 */
+            start_us += sym.duration_us;
+            int64_t err = (int64_t)(start_us * 12000) -
+                          (int64_t)((i + 1) * fst4w_symbol_samples(period) * 1000000ULL);
+            zassert_true(err >= -6000 && err <= 6000, "period %d symbol %zu off by %lld/12000 us",
+                         period, i, (long long)err);
+
+            uint8_t shape = i == 0 ? TX_SHAPE_RAMP_UP :
+                            i == FST4W_SYMBOL_COUNT - 1 ? TX_SHAPE_RAMP_DOWN : 0;
+            zassert_equal(sym.shape, shape, "symbol %zu", i);
+        }
+        zassert_equal(start_us, total_us[period], "period %d", period);
+    }
+}
+
+ZTEST(fst4w, test_bad_payload) {
+    static const wspr_payload_t bad[] = {
+        { "K1ABC", "FN42", 36 },        // not a WSPR power
+        { "K1ABC", "SN42", 37 },        // field past R
+        { "K", "FN42", 37 },
+    };
+    tx_sequence_t seq = { 0 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(bad); i++) {
+        zassert_equal(generate_fst4w_sequence(&bad[i], FST4W_120, &seq), -1, "case %zu", i);
+    }
+    zassert_equal(generate_fst4w_sequence(&vectors[0].payload, FST4W_PERIOD_COUNT, &seq), -1);
+
+    tx_symbol_t sym;
+    zassert_ok(generate_fst4w_sequence(&vectors[0].payload, FST4W_120, &seq));
+    zassert_equal(seq.source(&seq, FST4W_SYMBOL_COUNT, &sym), -EINVAL);
+}
+
+ZTEST_SUITE(fst4w, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,216 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <math.h>
+#include <string.h>
+
+#include "radio_core.h"
+#include "modes/ftx.h"
+#include "modes/encoders/ft8.h"
+#include "modes/decoders/ft8.h"
+
+/* Slots synthesised from the FT8 encoder: each signal is continuous-phase
+ * FSK on the encoder's tones, summed with white noise, then wrapped in a
+ * WAV image as WSJT-X saves one and fed in through ft8_wav_samples. SNR
+ * is in 2500 Hz, as WSJT-X reports it. */
+#define SLOT_SAMPLES    FT8_RX_SLOT_SAMPLES
+#define SAMPLE_HZ       FT8_RX_SAMPLE_HZ
+#define WAV_HEADER      44
+#define NOISE_RMS       1000.0
+#define SLOTS           3
+#define FEED_CHUNK      960     // 80 ms at a time, as an audio driver would
+
+struct slot_signal {
+    ftx_payload_t payload;
+    double freq_hz;
+    double dt_s;
+    double snr_db;
+};
+
+#define CALL(c)     { .type = C28_TYPE_CALLSIGN, .payload.callsign = c }
+#define CQ          { .type = C28_TYPE_CQ }
+#define GRID(g)     { .type = G15_TYPE_GRID, .payload.grid = g }
+#define REPORT(r)   { .type = G15_TYPE_REPORT, .payload.report = r }
+
+/* Inside the default 350 Hz window about 1500 Hz, one half a tone off
+ * the bin grid and one early */
+static const struct slot_signal signals[] = {
+    {
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CQ, .c28_1 = CALL("K1ABC"),
+                                              .g15 = GRID("FN42") } },
+        1351.0, 0.0, -12.0,
+    },
+    {
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CALL("K1ABC"), .c28_1 = CALL("W9XYZ"),
+                                              .R1 = true, .g15 = REPORT(-12) } },
+        1503.1, 0.37, -14.0,
+    },
+    {
+        { .type = FTX_MODE_FREE_TEXT, .data.free_text.text = "TNX BOB 73 GL" },
+        1590.0, -0.3, -10.0,
+    },
+};
+
+static uint8_t wav[WAV_HEADER + 2 * SLOT_SAMPLES] __aligned(4);
+static float audio[SLOT_SAMPLES];
+static uint32_t noise_seed;
+
+static double noise_uniform(void) {
+    noise_seed ^= noise_seed << 13;
+    noise_seed ^= noise_seed >> 17;
+    noise_seed ^= noise_seed << 5;
+    return (noise_seed + 1.0) / 4294967297.0;
+}
+
+/* Box-Muller */
+static double noise_gauss(void) {
+    double u = noise_uniform(), v = noise_uniform();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void add_signal(const struct slot_signal *sig) {
+    tx_sequence_t seq;
+    double noise_power = NOISE_RMS * NOISE_RMS * 2500.0 / (SAMPLE_HZ / 2);
+    double amp = sqrt(2.0 * noise_power * pow(10.0, sig->snr_db / 10.0));
+    int start = (int)((0.5 + sig->dt_s) * SAMPLE_HZ);
+    double phase = 0;
+
+    zassert_ok(generate_ft8_sequence(&sig->payload, &seq));
+    for (size_t s = 0; s < seq.total_symbols; s++) {
+        double hz = sig->freq_hz + seq.symbols[s].freq_offset_uhz * 1e-6;
+        int samples = seq.symbols[s].duration_us * SAMPLE_HZ / 1000000;
+
+        for (int n = 0; n < samples; n++) {
+            int i = start + (int)s * samples + n;
+            phase += 2.0 * M_PI * hz / SAMPLE_HZ;
+            if (i >= 0 && i < SLOT_SAMPLES) {
+                audio[i] += (float)(amp * sin(phase));
+            }
+        }
+    }
+}
+
+/* 12 kHz mono 16-bit PCM, the canonical 44-byte header */
+static void make_wav(uint32_t seed, bool with_signals) {
+    uint8_t *h = wav;
+
+    memset(audio, 0, sizeof(audio));
+    for (size_t i = 0; with_signals && i < ARRAY_SIZE(signals); i++) {
+        add_signal(&signals[i]);
+    }
+
+    noise_seed = seed;
+    for (int i = 0; i < SLOT_SAMPLES; i++) {
+        double v = audio[i] + NOISE_RMS * noise_gauss();
+        v = CLAMP(v, INT16_MIN, INT16_MAX);
+        sys_put_le16((uint16_t)(int16_t)lrint(v), &wav[WAV_HEADER + 2 * i]);
+    }
+
+    memcpy(h, "RIFF", 4);
+    sys_put_le32(sizeof(wav) - 8, h + 4);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    sys_put_le32(16, h + 16);
+    sys_put_le16(1, h + 20);
+    sys_put_le16(1, h + 22);
+    sys_put_le32(SAMPLE_HZ, h + 24);
+    sys_put_le32(2 * SAMPLE_HZ, h + 28);
+    sys_put_le16(2, h + 32);
+    sys_put_le16(16, h + 34);
+    memcpy(h + 36, "data", 4);
+    sys_put_le32(2 * SLOT_SAMPLES, h + 40);
+}
+
+static void decode_wav(struct ft8_decode *out, int max_decodes, int *decodes) {
+    const int16_t *samples;
+    size_t count;
+
+    zassert_ok(ft8_wav_samples(wav, sizeof(wav), &samples, &count));
+    zassert_equal(count, SLOT_SAMPLES);
+
+    /* The waterfall fills a little before the slot's last sample */
+    zassert_ok(ft8_rx_start(1500));
+    size_t off = 0;
+    int taken;
+    do {
+        taken = ft8_rx_feed(samples + off, MIN(FEED_CHUNK, count - off));
+        off += taken;
+    } while (taken == FEED_CHUNK);
+    zassert_true(off > count - FEED_CHUNK, "slot full after %zu samples", off);
+
+    *decodes = ft8_rx_decode(out, max_decodes);
+}
+
+static bool same_message(const ftx_payload_t *a, const ftx_payload_t *b) {
+    uint8_t pa[10], pb[10];
+
+    encode_ftx_payload(a, pa);
+    encode_ftx_payload(b, pb);
+    return !memcmp(pa, pb, sizeof(pa));
+}
+
+/* Every signal comes out of every slot. The decodes per slot and the CPU
+ * time the decoder's stats report are printed; native_sim's clock only
+ * advances on idle, so the time means something on hardware and the
+ * host bench (host_bench --wav decodes recorded slots). */
+ZTEST(ft8_decode, test_synthetic_slots) {
+    uint32_t decodes = 0, feed_us = 0, decode_us = 0;
+
+    ft8_rx_reset_stats();
+
+    for (int slot = 0; slot < SLOTS; slot++) {
+        struct ft8_decode out[8];
+        struct ft8_rx_stats stats;
+
+        int n;
+
+        make_wav(0x5EED + slot, true);
+        decode_wav(out, ARRAY_SIZE(out), &n);
+        ft8_rx_get_stats(&stats);
+        zassert_equal(n, stats.decodes);
+
+        for (size_t i = 0; i < ARRAY_SIZE(signals); i++) {
+            int found = -1;
+            for (int d = 0; d < n; d++) {
+                if (same_message(&out[d].payload, &signals[i].payload)) {
+                    found = d;
+                }
+            }
+            zassert_true(found >= 0, "slot %d: signal %zu at %.0f Hz not decoded", slot, i,
+                         signals[i].freq_hz);
+            zassert_within(out[found].freq_hz, signals[i].freq_hz, 6.25, "slot %d", slot);
+            zassert_within(out[found].dt_ms, signals[i].dt_s * 1000, 80, "slot %d", slot);
+        }
+
+        decodes += n;
+        feed_us += stats.feed_cpu_us;
+        decode_us += stats.decode_cpu_us;
+    }
+
+    TC_PRINT("%d slots: %u decodes per slot, front end %u us, decode %u us per slot\n",
+             SLOTS, decodes / SLOTS, feed_us / SLOTS, decode_us / SLOTS);
+}
+
+/* A slot of noise alone decodes to nothing */
+ZTEST(ft8_decode, test_noise_slot) {
+    struct ft8_decode out[8];
+    int n;
+
+    make_wav(0xA5A5, false);
+    decode_wav(out, ARRAY_SIZE(out), &n);
+    zassert_equal(n, 0);
+}
+
+ZTEST(ft8_decode, test_wav_format) {
+    const int16_t *samples;
+    size_t count;
+
+    make_wav(1, false);
+    sys_put_le32(48000, wav + 24);
+    zassert_equal(ft8_wav_samples(wav, sizeof(wav), &samples, &count), -EINVAL);
+    sys_put_le32(SAMPLE_HZ, wav + 24);
+    zassert_equal(ft8_wav_samples(wav, WAV_HEADER - 4, &samples, &count), -EINVAL);
+    zassert_ok(ft8_wav_samples(wav, sizeof(wav), &samples, &count));
+    zassert_equal_ptr(samples, (const int16_t *)(wav + WAV_HEADER));
+}
+
+ZTEST_SUITE(ft8_decode, NULL, NULL, NULL, NULL, NULL);
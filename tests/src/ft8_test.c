@@ -0,0 +1,200 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "radio_core.h"
+#include "modes/ftx.h"
+#include "modes/encoders/ft8.h"
+
+/* Channel symbols for messages of each kind the firmware sends, as
+ * scripts/ftx_vectors.py prints them. That script is a separate encoder
+ * written from the protocol description, with the LDPC parity solved
+ * from the decoder's parity checks rather than the generator ft8.c
+ * uses, so a slip in packing, CRC, parity or tone mapping shows here. */
+struct ft8_vector {
+    const char *name;
+    ftx_payload_t payload;
+    const char *telemetry;
+    const char *packed;     // the 77 bits, as the script's LDPC lines print them
+    const char *tones;
+};
+
+#define CALL(c)     { .type = C28_TYPE_CALLSIGN, .payload.callsign = c }
+#define CQ          { .type = C28_TYPE_CQ }
+#define GRID(g)     { .type = G15_TYPE_GRID, .payload.grid = g }
+#define REPORT(r)   { .type = G15_TYPE_REPORT, .payload.report = r }
+
+static const struct ft8_vector vectors[] = {
+    {
+        "CQ K1ABC FN42",
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CQ, .c28_1 = CALL("K1ABC"),
+                                              .g15 = GRID("FN42") } },
+        NULL,
+        "000000204def1a8a1988",
+        "3140652000000001005476704606021533433140652736011047517007334745455133543140652",
+    },
+    {
+        "K1ABC W9XYZ EN37",
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CALL("K1ABC"), .c28_1 = CALL("W9XYZ"),
+                                              .g15 = GRID("EN37") } },
+        NULL,
+        "09bde3506149dc085648",
+        "3140652032247523504061147005134325373140652464557561564770300376175462233140652",
+    },
+    {
+        "W9XYZ K1ABC -11",
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CALL("W9XYZ"), .c28_1 = CALL("K1ABC"),
+                                              .g15 = REPORT(-11) } },
+        NULL,
+        "0c293b804def1a9faa08",
+        "3140652020355725005476704617463024063140652536316515751700077044377507213140652",
+    },
+    {
+        "K1ABC W9XYZ R-09",
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CALL("K1ABC"), .c28_1 = CALL("W9XYZ"),
+                                              .R1 = true, .g15 = REPORT(-9) } },
+        NULL,
+        "09bde3506149dc3faa88",
+        "3140652032247523504061147027463527033140652323406130213743267634453040613140652",
+    },
+    {
+        "W9XYZ K1ABC RR73",
+        { .type = FTX_MODE_STD, .data.std = { .c28_0 = CALL("W9XYZ"), .c28_1 = CALL("K1ABC"),
+                                              .g15 = { .type = G15_TYPE_RR73 } } },
+        NULL,
+        "0c293b804def1a9fa4c8",
+        "3140652020355725005476704617455424123140652134504310075332620661276412433140652",
+    },
+    {
+        "free text TNX BOB 73 GL",
+        { .type = FTX_MODE_FREE_TEXT, .data.free_text.text = "TNX BOB 73 GL" },
+        NULL,
+        "63edcee2a4ae07f50000",
+        "3140652207447147063336401773500017703140652646427306546072440503670130533140652",
+    },
+    {
+        "free text HELLO",
+        { .type = FTX_MODE_FREE_TEXT, .data.free_text.text = "HELLO" },
+        NULL,
+        "000000000006d06f0a00",
+        "3140652000000000000000445047513000663140652303766641741220610024767744213140652",
+    },
+    {
+        "telemetry 123456789ABCDEF012",
+        { .type = FTX_MODE_TELEMETRY },
+        "123456789ABCDEF012",
+        "2468acf13579bde02540",
+        "3140652110453657532367167240056304313140652620633153646703256576437647343140652",
+    },
+    {
+        "telemetry 7FFFFFFFFFFFFFFFFF",
+        { .type = FTX_MODE_TELEMETRY },
+        "7FFFFFFFFFFFFFFFFF",
+        "ffffffffffffffffff40",
+        "3140652777777777777777777777777305403140652347415450104537650234454236473140652",
+    },
+};
+
+#define FT8_SYMBOLS     79
+#define FT8_SYMBOL_US   160000
+
+static void vector_payload(const struct ft8_vector *v, ftx_payload_t *p) {
+    *p = v->payload;
+    if (v->telemetry) {
+        encode_t71(v->telemetry, p->data.telemetry.data);
+    }
+}
+
+ZTEST(ft8, test_reference_vectors) {
+    for (size_t i = 0; i < ARRAY_SIZE(vectors); i++) {
+        const struct ft8_vector *v = &vectors[i];
+        ftx_payload_t payload;
+        tx_sequence_t seq = { 0 };
+        char tones[FT8_SYMBOLS + 1] = { 0 };
+
+        vector_payload(v, &payload);
+        zassert_ok(generate_ft8_sequence(&payload, &seq), "%s", v->name);
+        zassert_equal(seq.total_symbols, FT8_SYMBOLS, "%s", v->name);
+
+        for (int s = 0; s < FT8_SYMBOLS; s++) {
+            const tx_symbol_t *sym = &seq.symbols[s];
+            int tone = 0;
+
+            while (tone < 8 && FREQ_RATIO(tone * 12000, 1920) != sym->freq_offset_uhz) {
+                tone++;
+            }
+            zassert_true(tone < 8, "%s: symbol %d offset %lld uHz", v->name, s,
+                         (long long)sym->freq_offset_uhz);
+            zassert_equal(sym->duration_us, FT8_SYMBOL_US);
+            zassert_true(sym->tx_on);
+            tones[s] = '0' + tone;
+        }
+
+        zassert_str_equal(tones, v->tones, "%s:\n got %s\nwant %s", v->name, tones, v->tones);
+    }
+}
+
+static void from_hex(const char *hex, uint8_t *out) {
+    for (size_t i = 0; hex[2 * i]; i++) {
+        char pair[3] = { hex[2 * i], hex[2 * i + 1], '\0' };
+        out[i] = (uint8_t)strtoul(pair, NULL, 16);
+    }
+}
+
+/* The payload bits ahead of the CRC and the parity. For free text and
+ * telemetry this pins pack_b71 to the low 71 bits of the nine bytes, as
+ * WSJT-X sends them: taking the top 71 would drop the last bit. */
+ZTEST(ft8, test_payload_vectors) {
+    for (size_t i = 0; i < ARRAY_SIZE(vectors); i++) {
+        const struct ft8_vector *v = &vectors[i];
+        ftx_payload_t payload;
+        uint8_t packed[10], want[10];
+
+        vector_payload(v, &payload);
+        from_hex(v->packed, want);
+        encode_ftx_payload(&payload, packed);
+        zassert_mem_equal(packed, want, sizeof(want), "%s", v->name);
+    }
+}
+
+/* The free text and telemetry bits land where a receiver reads them */
+ZTEST(ft8, test_b71_round_trip) {
+    for (size_t i = 0; i < ARRAY_SIZE(vectors); i++) {
+        const struct ft8_vector *v = &vectors[i];
+        ftx_payload_t payload, decoded;
+        uint8_t packed[10];
+
+        if (v->payload.type == FTX_MODE_STD) {
+            continue;
+        }
+
+        vector_payload(v, &payload);
+        encode_ftx_payload(&payload, packed);
+        zassert_ok(decode_ftx_payload(packed, &decoded), "%s", v->name);
+        zassert_equal(decoded.type, payload.type, "%s", v->name);
+        if (payload.type == FTX_MODE_FREE_TEXT) {
+            zassert_str_equal(decoded.data.free_text.text, payload.data.free_text.text);
+        } else {
+            zassert_mem_equal(decoded.data.telemetry.data, payload.data.telemetry.data, 9);
+        }
+    }
+}
+
+/* Time from message to the 79 symbols, which sets how late in the slot
+ * a reply can still be queued. native_sim's clock only advances on idle,
+ * so the figure means something on hardware and the host bench. */
+ZTEST(ft8, test_encode_time) {
+    const int rounds = 200;
+    tx_sequence_t seq;
+    uint32_t t0 = k_cycle_get_32();
+
+    for (int r = 0; r < rounds; r++) {
+        zassert_ok(generate_ft8_sequence(&vectors[r % ARRAY_SIZE(vectors)].payload, &seq));
+    }
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - t0);
+
+    TC_PRINT("%d FT8 encodes in %u us\n", rounds, us);
+}
+
+ZTEST_SUITE(ft8, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,263 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "modes/ftx.h"
+#include "modes/ftx_callhash.h"
+
+#define ENTRIES     CONFIG_FTX_CALLHASH_ENTRIES
+
+/* A settings backend in RAM that keeps the last value saved, which is
+ * all the table ever saves */
+static struct {
+    char name[32];
+    char value[ENTRIES * FTX_CALL_LEN];
+    size_t len;
+    int saves;
+} store;
+
+static ssize_t store_read(void *cb_arg, void *data, size_t len) {
+    len = MIN(len, store.len);
+    memcpy(data, store.value, len);
+    return len;
+}
+
+static int store_load(struct settings_store *cs, const struct settings_load_arg *arg) {
+    if (!store.saves) {
+        return 0;
+    }
+    return settings_call_set_handler(store.name, store.len, store_read, NULL, arg);
+}
+
+static int store_save(struct settings_store *cs, const char *name, const char *value,
+                      size_t val_len) {
+    if (strlen(name) >= sizeof(store.name) || val_len > sizeof(store.value)) {
+        return -ENOMEM;
+    }
+    strcpy(store.name, name);
+    memcpy(store.value, value, val_len);
+    store.len = val_len;
+    store.saves++;
+    return 0;
+}
+
+static const struct settings_store_itf store_itf = {
+    .csi_load = store_load,
+    .csi_save = store_save,
+};
+
+static struct settings_store ram_store = { .cs_itf = &store_itf };
+
+/* CONFIG_SETTINGS_CUSTOM leaves the backend to the application */
+int settings_backend_init(void) {
+    settings_dst_register(&ram_store);
+    settings_src_register(&ram_store);
+    return 0;
+}
+
+static bool known(const char *call) {
+    char found[FTX_CALL_LEN];
+
+    return ftx_callhash_find(hash_callsign(call, 22), 22, found) == 0 &&
+           strcmp(found, call) == 0;
+}
+
+/* Enough new calls to push out everything the table held before, the
+ * last one added the most recent */
+static void fill_table(const char *prefix, int count) {
+    char call[FTX_CALL_LEN];
+
+    for (int i = 0; i < count; i++) {
+        snprintf(call, sizeof(call), "%s%03d", prefix, i);
+        ftx_callhash_add(call);
+    }
+}
+
+ZTEST(ftx_callhash, test_widths) {
+    char call[FTX_CALL_LEN];
+    uint32_t h22 = ftx_callhash_add("K1ABC");
+
+    zassert_equal(h22, hash_callsign("K1ABC", 22));
+
+    /* The narrower hashes are the top bits of the 22-bit one */
+    zassert_ok(ftx_callhash_find(h22, 22, call));
+    zassert_str_equal(call, "K1ABC");
+    zassert_ok(ftx_callhash_find(h22 >> 10, 12, call));
+    zassert_str_equal(call, "K1ABC");
+    zassert_equal(h22 >> 10, hash_callsign("K1ABC", 12));
+    zassert_ok(ftx_callhash_find(h22 >> 12, 10, call));
+    zassert_str_equal(call, "K1ABC");
+    zassert_equal(h22 >> 12, hash_callsign("K1ABC", 10));
+
+    zassert_equal(ftx_callhash_find(h22, 11, call), -EINVAL);
+    zassert_equal(call[0], '\0');
+}
+
+ZTEST(ftx_callhash, test_normalise) {
+    char call[FTX_CALL_LEN];
+
+    zassert_equal(ftx_callhash_add("<pj4/k1abc>"), hash_callsign("PJ4/K1ABC", 22));
+    zassert_ok(ftx_callhash_find(hash_callsign("PJ4/K1ABC", 12), 12, call));
+    zassert_str_equal(call, "PJ4/K1ABC");
+
+    zassert_equal(ftx_callhash_add("< >"), 0);
+    zassert_equal(ftx_callhash_add(""), 0);
+}
+
+/* PA3XYZ and G4ABC/P share their 12 and 10-bit hashes but not the 22:
+ * the narrow ones name whichever was used last */
+ZTEST(ftx_callhash, test_collision) {
+    char call[FTX_CALL_LEN];
+    uint32_t h22 = ftx_callhash_add("PA3XYZ");
+
+    zassert_equal(ftx_callhash_add("G4ABC/P") >> 10, h22 >> 10);
+    zassert_ok(ftx_callhash_find(h22 >> 10, 12, call));
+    zassert_str_equal(call, "G4ABC/P");
+    zassert_ok(ftx_callhash_find(h22, 22, call));
+    zassert_str_equal(call, "PA3XYZ");
+
+    ftx_callhash_add("PA3XYZ");
+    zassert_ok(ftx_callhash_find(h22 >> 12, 10, call));
+    zassert_str_equal(call, "PA3XYZ");
+}
+
+/* A full table gives up its least recently used call, and finding a call
+ * does not count as using it */
+ZTEST(ftx_callhash, test_lru_eviction) {
+    char call[FTX_CALL_LEN];
+
+    fill_table("LRU", ENTRIES);
+    zassert_true(known("LRU001"));
+    ftx_callhash_add("LRU000");
+
+    ftx_callhash_add("N0NEW");
+    zassert_true(known("N0NEW"));
+    zassert_true(known("LRU000"));
+    zassert_false(known("LRU001"));
+    zassert_true(known("LRU002"));
+
+    fill_table("OUT", ENTRIES);
+    zassert_equal(ftx_callhash_find(hash_callsign("N0NEW", 22), 22, call), -ENOENT);
+    zassert_equal(call[0], '\0');
+}
+
+/* Type 0.1: the 10-bit hash of the DXpedition's call */
+ZTEST(ftx_callhash, test_dxpedition) {
+    ftx_payload_t p = { .type = FTX_MODE_DXPEDITION };
+    ftx_payload_t d;
+    uint8_t packed[10];
+
+    p.data.dxpedition.c28_0 = (c28_t){ .type = C28_TYPE_CALLSIGN, .payload.callsign = "K1ABC" };
+    p.data.dxpedition.c28_1 = (c28_t){ .type = C28_TYPE_CALLSIGN, .payload.callsign = "W9XYZ" };
+    p.data.dxpedition.r5 = -10;
+    strcpy(p.data.dxpedition.h10_call, "KH1/KH7Z");
+
+    encode_ftx_payload(&p, packed);
+    zassert_ok(decode_ftx_payload(packed, &d));
+    zassert_equal(d.type, FTX_MODE_DXPEDITION);
+    zassert_equal(d.data.dxpedition.h10, hash_callsign("KH1/KH7Z", 10));
+    zassert_str_equal(d.data.dxpedition.h10_call, "KH1/KH7Z");
+
+    /* Forgotten, the hash still comes through */
+    fill_table("DXP", ENTRIES);
+    zassert_ok(decode_ftx_payload(packed, &d));
+    zassert_equal(d.data.dxpedition.h10, hash_callsign("KH1/KH7Z", 10));
+    zassert_equal(d.data.dxpedition.h10_call[0], '\0');
+}
+
+/* Type 4: the 12-bit hash of the standard call beside a long one */
+ZTEST(ftx_callhash, test_nonstd) {
+    ftx_payload_t p = { .type = FTX_MODE_NONSTD };
+    ftx_payload_t d;
+    uint8_t packed[10];
+
+    strcpy(p.data.nonstd.h12_call, "K1ABC");
+    strcpy(p.data.nonstd.c58, "PJ4/K1ABC");
+    p.data.nonstd.h1 = true;
+    p.data.nonstd.r2 = R2_TYPE_RR73;
+
+    encode_ftx_payload(&p, packed);
+    zassert_ok(decode_ftx_payload(packed, &d));
+    zassert_equal(d.type, FTX_MODE_NONSTD);
+    zassert_equal(d.data.nonstd.h12, hash_callsign("K1ABC", 12));
+    zassert_str_equal(d.data.nonstd.h12_call, "K1ABC");
+    zassert_str_equal(d.data.nonstd.c58, "PJ4/K1ABC");
+
+    fill_table("NST", ENTRIES);
+    zassert_ok(decode_ftx_payload(packed, &d));
+    zassert_equal(d.data.nonstd.h12, hash_callsign("K1ABC", 12));
+    zassert_equal(d.data.nonstd.h12_call[0], '\0');
+}
+
+/* Type 5: a 12-bit and a 22-bit hash */
+ZTEST(ftx_callhash, test_eu_vhf) {
+    ftx_payload_t p = { .type = FTX_MODE_EU_VHF_5 };
+    ftx_payload_t d;
+    uint8_t packed[10];
+
+    strcpy(p.data.eu_vhf_5.h12_call, "PA3XYZ");
+    strcpy(p.data.eu_vhf_5.h22_call, "DL1ABC/P");
+    p.data.eu_vhf_5.R1 = true;
+    p.data.eu_vhf_5.r3 = 5;
+    p.data.eu_vhf_5.s11 = 123;
+    strcpy(p.data.eu_vhf_5.g25, "JO22DB");
+
+    encode_ftx_payload(&p, packed);
+    zassert_ok(decode_ftx_payload(packed, &d));
+    zassert_equal(d.type, FTX_MODE_EU_VHF_5);
+    zassert_equal(d.data.eu_vhf_5.h12, hash_callsign("PA3XYZ", 12));
+    zassert_equal(d.data.eu_vhf_5.h22, hash_callsign("DL1ABC/P", 22));
+    zassert_str_equal(d.data.eu_vhf_5.h12_call, "PA3XYZ");
+    zassert_str_equal(d.data.eu_vhf_5.h22_call, "DL1ABC/P");
+
+    fill_table("EU5", ENTRIES);
+    zassert_ok(decode_ftx_payload(packed, &d));
+    zassert_equal(d.data.eu_vhf_5.h22, hash_callsign("DL1ABC/P", 22));
+    zassert_equal(d.data.eu_vhf_5.h12_call[0], '\0');
+    zassert_equal(d.data.eu_vhf_5.h22_call[0], '\0');
+}
+
+/* Saved most recent first, and loaded back in the same order of use */
+ZTEST(ftx_callhash, test_persist_round_trip) {
+    static const char *const calls[] = { "K1ABC", "W9XYZ", "G4JNT", "VK2ZZZ" };
+    int saves = store.saves;
+
+    fill_table("OLD", ENTRIES);
+    for (size_t i = 0; i < ARRAY_SIZE(calls); i++) {
+        ftx_callhash_add(calls[i]);
+    }
+    k_sleep(K_SECONDS(CONFIG_FTX_CALLHASH_SAVE_DELAY_S + 1));
+
+    zassert_true(store.saves > saves);
+    zassert_str_equal(store.name, "chash/calls");
+    zassert_equal(store.len, ENTRIES * FTX_CALL_LEN);
+    for (size_t i = 0; i < ARRAY_SIZE(calls); i++) {
+        zassert_str_equal(&store.value[i * FTX_CALL_LEN], calls[ARRAY_SIZE(calls) - 1 - i]);
+    }
+
+    /* A reboot's worth of forgetting, then the load */
+    fill_table("NEW", ENTRIES);
+    zassert_false(known("VK2ZZZ"));
+    zassert_ok(settings_load());
+    for (size_t i = 0; i < ARRAY_SIZE(calls); i++) {
+        zassert_true(known(calls[i]), "%s", calls[i]);
+    }
+    zassert_false(known("NEW000"));
+
+    /* The two most recent outlive all but two new calls */
+    fill_table("EVT", ENTRIES - 2);
+    zassert_true(known("VK2ZZZ"));
+    zassert_true(known("G4JNT"));
+    zassert_false(known("W9XYZ"));
+    zassert_false(known("K1ABC"));
+}
+
+/* Registers the RAM backend; the round trip fails if it cannot */
+static void *callhash_setup(void) {
+    settings_subsys_init();
+    return NULL;
+}
+
+ZTEST_SUITE(ftx_callhash, NULL, callhash_setup, NULL, NULL, NULL);
@@ -0,0 +1,227 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#include "gnss_ublox_m10.h"
+
+/* The M10 stream parser on canned DDC output: NAV-PVT and NAV-TIMEUTC
+ * frames as the receiver sends them, with the NMEA it emits before
+ * CFG-VALSET takes effect, other UBX traffic and line noise between. */
+
+#define PVT_ITOW        403218000
+#define PVT_LAT_E7      425000000
+#define PVT_LON_E7      (-710000000)
+
+static struct m10_stream stream;
+
+static const char nmea[] =
+    "$GNRMC,120018.00,A,4230.00000,N,07100.00000,W,0.010,,181026,,,A,V*02\r\n"
+    "$GNGGA,120018.00,4230.00000,N,07100.00000,W,1,09,0.92,12.3,M,-33.6,M,,*40\r\n";
+
+static size_t ubx_put(uint8_t *out, uint8_t cls, uint8_t id, const uint8_t *payload, uint16_t len) {
+    uint8_t ck_a = 0, ck_b = 0;
+
+    out[0] = UBX_SYNC1;
+    out[1] = UBX_SYNC2;
+    out[2] = cls;
+    out[3] = id;
+    sys_put_le16(len, &out[4]);
+    memcpy(&out[6], payload, len);
+
+    for (size_t i = 2; i < 6 + len; i++) {
+        ck_a += out[i];
+        ck_b += ck_a;
+    }
+    out[6 + len] = ck_a;
+    out[7 + len] = ck_b;
+    return 8 + len;
+}
+
+static size_t put_pvt(uint8_t *out, uint8_t sec) {
+    uint8_t p[UBX_NAV_PVT_LEN] = { 0 };
+
+    sys_put_le32(PVT_ITOW + sec * 1000, &p[0]);
+    sys_put_le16(2026, &p[4]);
+    p[6] = 10;
+    p[7] = 18;
+    p[8] = 12;
+    p[9] = 0;
+    p[10] = sec;
+    p[11] = 0x07;                       // validDate | validTime | fullyResolved
+    sys_put_le32(25, &p[12]);           // tAcc
+    sys_put_le32((uint32_t)-120, &p[16]);
+    p[20] = M10_FIX_3D;
+    p[21] = 0x01;                       // gnssFixOK
+    p[23] = 9;
+    sys_put_le32((uint32_t)PVT_LON_E7, &p[24]);
+    sys_put_le32(PVT_LAT_E7, &p[28]);
+    sys_put_le32(12300, &p[36]);
+    sys_put_le32(1800, &p[40]);
+    sys_put_le32(2600, &p[44]);
+    return ubx_put(out, UBX_CLASS_NAV, UBX_ID_NAV_PVT, p, sizeof(p));
+}
+
+static size_t put_timeutc(uint8_t *out, uint8_t sec, uint8_t valid) {
+    uint8_t p[UBX_NAV_TIMEUTC_LEN] = { 0 };
+
+    sys_put_le32(PVT_ITOW + sec * 1000, &p[0]);
+    sys_put_le32(18, &p[4]);
+    sys_put_le32(40, &p[8]);
+    sys_put_le16(2026, &p[12]);
+    p[14] = 10;
+    p[15] = 18;
+    p[16] = 12;
+    p[17] = 0;
+    p[18] = sec;
+    p[19] = valid;
+    return ubx_put(out, UBX_CLASS_NAV, UBX_ID_NAV_TIMEUTC, p, sizeof(p));
+}
+
+/* One epoch as it sits in the DDC buffer, noise and all */
+static size_t put_epoch(uint8_t *out, uint8_t sec) {
+    static const uint8_t ack[] = { 0x06, 0x8A };
+    static const uint8_t noise[] = { 0xB5, 0x00, 0xFF, 0xB5, 0xB5 };
+    size_t n = 0;
+
+    memcpy(&out[n], nmea, sizeof(nmea) - 1);
+    n += sizeof(nmea) - 1;
+    n += ubx_put(&out[n], 0x05, 0x01, ack, sizeof(ack));  // ACK-ACK, no table
+    memcpy(&out[n], noise, sizeof(noise));
+    n += sizeof(noise);
+    n += put_pvt(&out[n], sec);
+    n += put_timeutc(&out[n], sec, 0x07);
+    return n;
+}
+
+static void gnss_before(void *fixture) {
+    m10_stream_init(&stream);
+}
+
+ZTEST(gnss, test_no_fix_before_first_message) {
+    struct m10_fix fix;
+
+    zassert_equal(m10_stream_get_fix(&stream, &fix), -EAGAIN);
+    zassert_equal(m10_stream_feed(&stream, (const uint8_t *)nmea, sizeof(nmea) - 1), 0);
+    zassert_equal(m10_stream_get_fix(&stream, &fix), -EAGAIN);
+}
+
+ZTEST(gnss, test_canned_epoch) {
+    uint8_t buf[512];
+    struct m10_fix fix;
+    struct m10_stats st;
+    size_t n = put_epoch(buf, 18);
+
+    zassert_equal(m10_stream_feed(&stream, buf, n), 2);
+    zassert_ok(m10_stream_get_fix(&stream, &fix));
+
+    zassert_equal(fix.itow_ms, PVT_ITOW + 18000);
+    zassert_equal(fix.year, 2026);
+    zassert_equal(fix.month, 10);
+    zassert_equal(fix.day, 18);
+    zassert_equal(fix.hour, 12);
+    zassert_equal(fix.sec, 18);
+    zassert_true(fix.time_valid);
+    zassert_equal(fix.fix_type, M10_FIX_3D);
+    zassert_true(fix.fix_ok);
+    zassert_equal(fix.num_sv, 9);
+    zassert_equal(fix.lat_e7, PVT_LAT_E7);
+    zassert_equal(fix.lon_e7, PVT_LON_E7);
+    zassert_equal(fix.height_msl_mm, 12300);
+    zassert_equal(fix.h_acc_mm, 1800);
+    zassert_equal(fix.v_acc_mm, 2600);
+    /* Time from TIMEUTC, which came last */
+    zassert_equal(fix.t_acc_ns, 18);
+    zassert_equal(fix.nano, 40);
+
+    st = stream.stats;
+    zassert_equal(st.bytes, n);
+    zassert_equal(st.pvt, 1);
+    zassert_equal(st.timeutc, 1);
+    zassert_equal(st.bad_checksum, 0);
+}
+
+/* DDC reads cut frames anywhere; every split must give the same fix */
+ZTEST(gnss, test_split_reads) {
+    uint8_t buf[512];
+    size_t n = put_epoch(buf, 30);
+    struct m10_fix whole, split;
+
+    zassert_equal(m10_stream_feed(&stream, buf, n), 2);
+    zassert_ok(m10_stream_get_fix(&stream, &whole));
+
+    for (size_t cut = 1; cut < n; cut += 7) {
+        m10_stream_init(&stream);
+        int applied = m10_stream_feed(&stream, buf, cut);
+        applied += m10_stream_feed(&stream, &buf[cut], n - cut);
+        zassert_equal(applied, 2, "cut at %zu", cut);
+        zassert_ok(m10_stream_get_fix(&stream, &split));
+        split.updated_ms = whole.updated_ms;
+        zassert_mem_equal(&split, &whole, sizeof(whole), "cut at %zu", cut);
+    }
+}
+
+ZTEST(gnss, test_bad_checksum) {
+    uint8_t buf[256];
+    struct m10_fix fix;
+    size_t n = put_pvt(buf, 5);
+
+    buf[6 + 10] ^= 0x01;                // corrupt sec
+    zassert_equal(m10_stream_feed(&stream, buf, n), 0);
+    zassert_equal(stream.stats.bad_checksum, 1);
+    zassert_equal(m10_stream_get_fix(&stream, &fix), -EAGAIN);
+
+    /* The parser resyncs on the next frame */
+    n = put_pvt(buf, 6);
+    zassert_equal(m10_stream_feed(&stream, buf, n), 1);
+    zassert_ok(m10_stream_get_fix(&stream, &fix));
+    zassert_equal(fix.sec, 6);
+}
+
+ZTEST(gnss, test_timeutc_invalid) {
+    uint8_t buf[256];
+    struct m10_fix fix;
+    size_t n = put_pvt(buf, 7);
+
+    n += put_timeutc(&buf[n], 7, 0x03);  // validTOW | validWKN, no validUTC
+    zassert_equal(m10_stream_feed(&stream, buf, n), 2);
+    zassert_ok(m10_stream_get_fix(&stream, &fix));
+    zassert_false(fix.time_valid);
+    zassert_equal(fix.lat_e7, PVT_LAT_E7);
+}
+
+/* Parse rate in the poll thread's chunk size. At one epoch per second the
+ * receiver produces well under 1 kB/s, so this is headroom, not a limit.
+ * native_sim only moves its clock when the CPU idles; the rate is real on
+ * hardware and the host bench. */
+ZTEST(gnss, test_parse_throughput) {
+    static uint8_t buf[8192];
+    size_t n = 0;
+    uint8_t epochs = 0;
+
+    while (n + 512 <= sizeof(buf)) {
+        n += put_epoch(&buf[n], epochs++ % 60);
+    }
+
+    const size_t chunk = 128;           // GNSS_UBLOX_M10_READ_CHUNK default
+    const int rounds = 16;
+    int applied = 0;
+    uint32_t t0 = k_cycle_get_32();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i += chunk) {
+            applied += m10_stream_feed(&stream, &buf[i], MIN(chunk, n - i));
+        }
+    }
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - t0);
+
+    zassert_equal(applied, 2 * epochs * rounds);
+    zassert_equal(stream.stats.bad_checksum, 0);
+    zassert_equal(stream.stats.bytes, n * rounds);
+    TC_PRINT("parsed %zu bytes, %d messages in %u us", n * rounds, applied, us);
+    if (us) {
+        TC_PRINT(" (%u bytes/ms)", (uint32_t)((uint64_t)n * rounds * 1000 / us));
+    }
+    TC_PRINT("\n");
+}
+
+ZTEST_SUITE(gnss, NULL, NULL, gnss_before, NULL, NULL);
@@ -0,0 +1,113 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "radio_core.h"
+#include "modes/encoders/hell.h"
+
+/* Twenty characters, 8 s on air */
+#define MESSAGE     "CQ CQ DE K1ABC K1ABC"
+#define MESSAGE_LEN (sizeof(MESSAGE) - 1)
+#define PIXELS      (MESSAGE_LEN * HELL_CELL_PIXELS)
+
+static bool pixels[PIXELS];
+
+static uint64_t pixel_start_us(size_t k) {
+    return ((uint64_t)k * HELL_CELL_US + HELL_CELL_PIXELS / 2) / HELL_CELL_PIXELS;
+}
+
+/* Walk the whole stream, checking every run ends on a pixel boundary,
+ * and fill pixels[] from the runs */
+static void scan_message(const char *text, uint64_t *total_us) {
+    tx_sequence_t seq = { 0 };
+    tx_symbol_t sym;
+    uint64_t end_us = 0;
+    size_t pixel = 0;
+    size_t index = 0;
+    int ret;
+
+    *total_us = 0;
+    zassert_ok(generate_hell_sequence(text, &seq));
+    zassert_not_null(seq.source);
+
+    while ((ret = seq.source(&seq, index, &sym)) == 0) {
+        zassert_true(sym.duration_us > 0, "run %zu", index);
+        zassert_equal(sym.shape, TX_SHAPE_KEYED, "run %zu", index);
+        zassert_equal(sym.freq_offset_uhz, 0, "run %zu", index);
+        if (index > 0) {
+            /* Runs merge equal pixels, so they alternate */
+            zassert_not_equal(sym.tx_on, pixels[pixel - 1], "run %zu", index);
+        }
+
+        end_us += sym.duration_us;
+        size_t next = (end_us * HELL_CELL_PIXELS + HELL_CELL_US / 2) / HELL_CELL_US;
+        zassert_true(next > pixel && next <= PIXELS, "run %zu ends at %llu us", index,
+                     (unsigned long long)end_us);
+        zassert_equal(end_us, pixel_start_us(next), "run %zu ends at %llu us, not on pixel %zu",
+                      index, (unsigned long long)end_us, next);
+
+        while (pixel < next) {
+            pixels[pixel++] = sym.tx_on;
+        }
+        index++;
+    }
+
+    zassert_equal(ret, -ENODATA, "run %zu", index);
+    zassert_equal(pixel, PIXELS);
+    *total_us = end_us;
+}
+
+ZTEST(hell, test_run_boundaries) {
+    uint64_t total_us;
+
+    scan_message(MESSAGE, &total_us);
+    zassert_equal(total_us, MESSAGE_LEN * HELL_CELL_US, "%llu us",
+                  (unsigned long long)total_us);
+}
+
+/* Glyphs drawn top row first, as they print on the receiver */
+struct glyph_vector {
+    size_t cell;
+    const char *rows[HELL_PIXELS];
+};
+
+static const struct glyph_vector glyphs[] = {
+    { 2, { ".....", ".....", ".....", ".....", ".....", ".....", "....." } },   // ' '
+    { 7, { "#####", "#....", "#....", "####.", "#....", "#....", "#####" } },   // 'E'
+    { 9, { "#...#", "#..#.", "#.#..", "##...", "#.#..", "#..#.", "#...#" } },   // 'K'
+    { 10, { "..#..", ".##..", "..#..", "..#..", "..#..", "..#..", ".###." } },  // '1'
+};
+
+/* Columns are scanned left to right, each from the bottom pixel up, with
+ * a blank column either side of the five inked ones */
+ZTEST(hell, test_glyph_bits) {
+    uint64_t total_us;
+
+    scan_message(MESSAGE, &total_us);
+
+    for (size_t g = 0; g < ARRAY_SIZE(glyphs); g++) {
+        const bool *cell = &pixels[glyphs[g].cell * HELL_CELL_PIXELS];
+
+        for (int col = 0; col < HELL_COLUMNS; col++) {
+            for (int row = 0; row < HELL_PIXELS; row++) {
+                bool want = col > 0 && col <= 5 &&
+                            glyphs[g].rows[HELL_PIXELS - 1 - row][col - 1] == '#';
+                zassert_equal(cell[col * HELL_PIXELS + row], want,
+                              "'%c' column %d row %d", MESSAGE[glyphs[g].cell], col, row);
+            }
+        }
+    }
+}
+
+/* Lower case is sent as upper case */
+ZTEST(hell, test_lower_case) {
+    static bool upper[PIXELS];
+    uint64_t total_us;
+
+    scan_message(MESSAGE, &total_us);
+    memcpy(upper, pixels, sizeof(upper));
+    scan_message("cq cq de k1abc k1abc", &total_us);
+    zassert_mem_equal(pixels, upper, sizeof(upper));
+}
+
+ZTEST_SUITE(hell, NULL, NULL, NULL, NULL, NULL);
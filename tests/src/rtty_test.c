@@ -0,0 +1,190 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "radio_core.h"
+#include "modes/encoders/rtty.h"
+
+/* Reference ITA2 encoder, written from the code chart rather than from
+ * rtty.c's ASCII table: each row lists the character on codes 0x00 to
+ * 0x1F, '~' marking the shift codes and codes with nothing to print. The
+ * figures row is the US TTY one rtty.c sends ('#' on H, '&' on G, '!' on
+ * F, '=' on V), with WRU (ENQ) on D and BEL on J. */
+static const char ita2_ltrs[32] = "~E\nA SIU\rDRJNFCKTZLWHYPQOBG~MXV~";
+static const char ita2_figs[32] = "~3\n- '87\r\x05" "4\a,!:(5+)2#6019?&~./=~";
+
+#define ITA2_FIGS   0x1B
+#define ITA2_LTRS   0x1F
+
+static int ita2_find(const char *row, char c) {
+    for (int code = 0; code < 32; code++) {
+        if (row[code] == c && c != '~') {
+            return code;
+        }
+    }
+    return -1;
+}
+
+/* The whole stream as mark ('1') and space ('0') bits: diddles, then
+ * each character as start, five data bits LSB first and stop. */
+static size_t reference_bits(const char *text, bool usos, int diddles, char *bits) {
+    bool figs = false;
+    size_t n = 0;
+    uint8_t codes[128];
+    size_t nc = 0;
+
+    while (diddles-- > 0) {
+        codes[nc++] = ITA2_LTRS;
+    }
+    for (const char *p = text; *p; p++) {
+        char c = (*p >= 'a' && *p <= 'z') ? *p - 'a' + 'A' : *p;
+        int l = ita2_find(ita2_ltrs, c);
+        int f = ita2_find(ita2_figs, c);
+
+        if (l < 0 && f < 0) {
+            continue;
+        }
+        if (l >= 0 && f >= 0) {
+            /* Same code in both cases: space, CR, LF */
+            codes[nc++] = l;
+        } else if (l >= 0) {
+            if (figs) {
+                codes[nc++] = ITA2_LTRS;
+                figs = false;
+            }
+            codes[nc++] = l;
+        } else {
+            if (!figs) {
+                codes[nc++] = ITA2_FIGS;
+                figs = true;
+            }
+            codes[nc++] = f;
+        }
+        if (usos && c == ' ') {
+            figs = false;
+        }
+    }
+
+    for (size_t i = 0; i < nc; i++) {
+        bits[n++] = '0';
+        for (int b = 0; b < 5; b++) {
+            bits[n++] = '0' + ((codes[i] >> b) & 1);
+        }
+        bits[n++] = '1';
+    }
+    bits[n] = '\0';
+    return n;
+}
+
+struct rtty_case {
+    const char *text;
+    bool usos;
+    uint8_t diddles;
+};
+
+static const struct rtty_case cases[] = {
+    /* Letters only, and the usual test line */
+    { "RYRYRYRY THE QUICK BROWN FOX", false, 0 },
+    /* Figures after a space: with USOS each group needs FIGS again */
+    { "CQ DE K1ABC UR 599 599 QTH 73", true, 2 },
+    { "CQ DE K1ABC UR 599 599 QTH 73", false, 2 },
+    /* Shift in the middle of a word, punctuation, lower case */
+    { "w1aw/3 de k1abc: tnx, rst=5nn? 73!", true, 5 },
+    { "G4JNT (IO90) #1 & 'OK'-+.", false, 1 },
+    /* Case-free codes do not shift, nor unset the figures state */
+    { "12\r\n34 5\r\nAB", false, 0 },
+    { "12\r\n34 5\r\nAB", true, 0 },
+    /* WRU and BEL, and characters ITA2 cannot send */
+    { "\x05\a@*~ZZ", false, 3 },
+};
+
+static void check_case(const struct rtty_case *tc, const rtty_config_t *base) {
+    rtty_config_t config = *base;
+    rtty_keying_t keying;
+    tx_sequence_t seq = { 0 };
+    char want[128 * RTTY_SYMBOLS_PER_CHAR + 1];
+    char got[sizeof(want)];
+    size_t n;
+
+    config.unshift_on_space = tc->usos;
+    config.diddles = tc->diddles;
+    rtty_keying(&config, &keying);
+    n = reference_bits(tc->text, tc->usos, tc->diddles, want);
+
+    zassert_ok(generate_rtty_sequence(tc->text, &config, &seq), "%s", tc->text);
+    zassert_is_null(seq.symbols);
+    zassert_equal(seq.total_symbols, n, "%s: %zu symbols, want %zu", tc->text,
+                  (size_t)seq.total_symbols, n);
+
+    for (size_t i = 0; i < n; i++) {
+        tx_symbol_t sym;
+        bool stop = i % RTTY_SYMBOLS_PER_CHAR == RTTY_SYMBOLS_PER_CHAR - 1;
+
+        zassert_ok(seq.source(&seq, i, &sym), "%s: symbol %zu", tc->text, i);
+        zassert_true(sym.freq_offset_uhz == keying.mark_offset ||
+                     sym.freq_offset_uhz == keying.space_offset,
+                     "%s: symbol %zu offset %lld uHz", tc->text, i,
+                     (long long)sym.freq_offset_uhz);
+        zassert_equal(sym.duration_us, stop ? keying.stop_us : keying.bit_us,
+                      "%s: symbol %zu", tc->text, i);
+        zassert_true(sym.tx_on);
+        got[i] = sym.freq_offset_uhz == keying.mark_offset ? '1' : '0';
+    }
+    got[n] = '\0';
+
+    tx_symbol_t sym;
+    zassert_equal(seq.source(&seq, n, &sym), -EINVAL);
+    zassert_str_equal(got, want, "%s:\n got %s\nwant %s", tc->text, got, want);
+}
+
+/* 45.45 Bd, 170 Hz, 1.5 stop bits: mark on the carrier, space above */
+ZTEST(rtty, test_reference_bits) {
+    const rtty_config_t config = { .baud_rate = 45.45f, .shift_hz = 170, .stop_bits = 1.5f };
+
+    for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+        check_case(&cases[i], &config);
+    }
+}
+
+/* The tones swap and move about the centre, the bits stay the same */
+ZTEST(rtty, test_reference_bits_keying) {
+    const rtty_config_t configs[] = {
+        { .baud_rate = 50.0f, .shift_hz = 850, .stop_bits = 1.0f, .reverse_shift = true },
+        { .baud_rate = 75.0f, .shift_hz = 170, .stop_bits = 2.0f, .use_center_freq = true },
+        { .baud_rate = 45.45f, .shift_hz = 170, .stop_bits = 1.5f, .reverse_shift = true,
+          .use_center_freq = true },
+    };
+
+    for (size_t c = 0; c < ARRAY_SIZE(configs); c++) {
+        for (size_t i = 0; i < ARRAY_SIZE(cases); i++) {
+            check_case(&cases[i], &configs[c]);
+        }
+    }
+}
+
+/* Tone offsets and bit times from the configuration */
+ZTEST(rtty, test_keying) {
+    rtty_keying_t k;
+
+    rtty_keying(&(rtty_config_t){ .baud_rate = 45.45f, .shift_hz = 170, .stop_bits = 1.5f }, &k);
+    zassert_equal(k.bit_us, 22002);
+    zassert_equal(k.stop_us, 33003);
+    zassert_equal(k.mark_offset, 0);
+    zassert_equal(k.space_offset, FREQ_HZ(170));
+
+    rtty_keying(&(rtty_config_t){ .baud_rate = 50.0f, .shift_hz = 850, .stop_bits = 1.0f,
+                                  .reverse_shift = true }, &k);
+    zassert_equal(k.bit_us, 20000);
+    zassert_equal(k.stop_us, 20000);
+    zassert_equal(k.mark_offset, FREQ_HZ(850));
+    zassert_equal(k.space_offset, 0);
+
+    rtty_keying(&(rtty_config_t){ .baud_rate = 75.0f, .shift_hz = 170, .stop_bits = 2.0f,
+                                  .use_center_freq = true }, &k);
+    zassert_equal(k.bit_us, 13333);
+    zassert_equal(k.stop_us, 26666);
+    zassert_equal(k.mark_offset, FREQ_HZ(85));
+    zassert_equal(k.space_offset, -FREQ_HZ(85));
+}
+
+ZTEST_SUITE(rtty, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,173 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/irq_offload.h>
+#include <string.h>
+
+#include "hardware/swr_guard.h"
+#include "hardware/adc_sampler.h"
+
+/* swr_guard.c runs against an emulated analog watchdog. A conversion on
+ * the reflected channel is injected from interrupt context with
+ * irq_offload, as the ADC would raise it, and every step of the trip
+ * path records the cycle counter.
+ *
+ * The bounds are the budget on the STM32L431: the relay drops inside the
+ * ISR, and the Si5351 and PA supply are off after one I2C transaction
+ * from the guard thread. On native_sim time stands still while code
+ * runs, so here they prove the order of events and that nothing on the
+ * path sleeps or waits for a timeout. */
+#define RX_BOUND_NS     5000
+#define OFF_BOUND_US    500
+
+#define SWR_TRIP_EVENT  0xF9
+
+/* Emulated watchdog: one-shot, like AWD1 with its interrupt cleared */
+static adc_sampler_awd_handler_t awd_handler;
+static uint16_t awd_high_raw;
+static bool awd_armed;
+
+int adc_sampler_arm_watchdog(uint16_t high_raw, adc_sampler_awd_handler_t handler) {
+    awd_high_raw = high_raw;
+    awd_handler = handler;
+    awd_armed = true;
+    return 0;
+}
+
+void adc_sampler_disarm_watchdog(void) {
+    awd_armed = false;
+}
+
+static void awd_convert(const void *arg) {
+    uint16_t ref = (uint16_t)(uintptr_t)arg;
+
+    if (awd_armed && ref > awd_high_raw) {
+        awd_armed = false;
+        awd_handler();
+    }
+}
+
+/* What the guard drives, in place of the hardware and the engine */
+static uint32_t inject_cycles;
+static uint32_t rx_cycles;
+static uint32_t rf_off_cycles;
+static int rx_calls;
+static int rf_off_calls;
+static int stop_calls;
+static bool rx_in_isr;
+static uint8_t event[16];
+static size_t event_len;
+static int events;
+
+char dbg_buf[256];
+
+void tr_set_rx(void) {
+    rx_cycles = k_cycle_get_32();
+    rx_in_isr = k_is_in_isr();
+    rx_calls++;
+}
+
+void tx_engine_rf_off(void) {
+    rf_off_cycles = k_cycle_get_32();
+    rf_off_calls++;
+}
+
+void tx_engine_stop(void) {
+    stop_calls++;
+}
+
+void send_packet(uint8_t cmd_id, const uint8_t *payload, size_t payload_len, uint16_t id) {
+    if (cmd_id == SWR_TRIP_EVENT) {
+        event_len = MIN(payload_len, sizeof(event));
+        memcpy(event, payload, event_len);
+        events++;
+    }
+}
+
+void send_debug_message(const char *message) {
+}
+
+static void inject_ref_mv(uint32_t mv) {
+    inject_cycles = k_cycle_get_32();
+    irq_offload(awd_convert, (const void *)(uintptr_t)adc_sampler_from_mv(mv));
+}
+
+static void swr_before(void *fixture) {
+    swr_guard_set_threshold(0);
+    rx_calls = rf_off_calls = stop_calls = events = 0;
+    rx_in_isr = false;
+
+    /* Preemptible, so the guard's threads run as soon as the ISR returns */
+    k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(1));
+}
+
+ZTEST(swr_guard, test_trip_latency) {
+    zassert_ok(swr_guard_set_threshold(1000));
+    zassert_true(awd_armed);
+
+    inject_ref_mv(1500);
+
+    /* Before this thread runs again: relay from the ISR, RF off after */
+    zassert_equal(rx_calls, 1);
+    zassert_true(rx_in_isr, "relay must drop inside the ISR");
+    zassert_equal(rf_off_calls, 1, "guard thread did not preempt");
+
+    uint32_t rx_ns = (uint32_t)k_cyc_to_ns_floor64(rx_cycles - inject_cycles);
+    uint32_t off_us = k_cyc_to_us_floor32(rf_off_cycles - inject_cycles);
+    TC_PRINT("breach to RX %u ns, to RF off %u us\n", rx_ns, off_us);
+    zassert_true(rx_ns <= RX_BOUND_NS, "RX after %u ns", rx_ns);
+    zassert_true(off_us <= OFF_BOUND_US, "RF off after %u us", off_us);
+
+    /* What the guard reports to the host, from ISR entry */
+    struct swr_guard_status st;
+    swr_guard_get_status(&st);
+    zassert_true(st.tripped);
+    zassert_false(st.armed);
+    zassert_true(st.rx_latency_ns <= RX_BOUND_NS, "reported %u ns", st.rx_latency_ns);
+    zassert_true(st.off_latency_us <= OFF_BOUND_US, "reported %u us", st.off_latency_us);
+
+    /* Engine stopped and host told from the workqueue */
+    k_sleep(K_MSEC(1));
+    zassert_equal(stop_calls, 1);
+    zassert_equal(events, 1);
+    zassert_equal(event_len, 11);
+    zassert_equal(event[0], 0x02, "event flags %02x", event[0]);
+    zassert_equal(event[1] | event[2] << 8, 1000);
+    zassert_true(swr_guard_tripped());
+}
+
+ZTEST(swr_guard, test_below_threshold) {
+    zassert_ok(swr_guard_set_threshold(1000));
+
+    inject_ref_mv(900);
+    k_sleep(K_MSEC(1));
+
+    zassert_equal(rx_calls, 0);
+    zassert_equal(rf_off_calls, 0);
+    zassert_equal(events, 0);
+    zassert_false(swr_guard_tripped());
+}
+
+ZTEST(swr_guard, test_latched_until_rearmed) {
+    zassert_ok(swr_guard_set_threshold(1000));
+    inject_ref_mv(2000);
+    k_sleep(K_MSEC(1));
+    zassert_true(swr_guard_tripped());
+
+    /* One-shot: a second breach before re-arming does nothing more */
+    inject_ref_mv(2500);
+    k_sleep(K_MSEC(1));
+    zassert_equal(rx_calls, 1);
+    zassert_equal(events, 1);
+
+    zassert_ok(swr_guard_set_threshold(1000));
+    zassert_false(swr_guard_tripped());
+    zassert_true(awd_armed);
+}
+
+ZTEST(swr_guard, test_threshold_range) {
+    zassert_equal(swr_guard_set_threshold(ADC_SAMPLER_VREF_MV + 1), -EINVAL);
+    zassert_ok(swr_guard_set_threshold(0));
+    zassert_false(awd_armed);
+}
+
+ZTEST_SUITE(swr_guard, NULL, NULL, swr_before, NULL, NULL);
@@ -0,0 +1,94 @@
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "radio_core.h"
+#include "modes/encoders/wspr.h"
+
+/* Channel symbols as scripts/wspr_vectors.py prints them. That script
+ * runs the convolutional encoder bit by bit over the whole message and
+ * interleaves the result, where wspr.c computes each symbol on its own
+ * from a window of the message, so the two share nothing but the
+ * protocol. */
+struct wspr_vector {
+    wspr_payload_t payload;
+    const char *symbols;
+};
+
+static const struct wspr_vector vectors[] = {
+    {
+        { "K1ABC", "FN42", 37 },
+        "330020001020131222100323133220200032012322002232110233210221321222033030301210212032132003323032203020201023021112330231212221332000010320132222202332323320031222",
+    },
+    {
+        { "G4JNT", "IO90", 30 },
+        "332200001222333022100121133220200030012100002012112033030201121020213010301012032010110221123012223200023201001112112031230003312222012120310022222130121320031222",
+    },
+    {
+        { "KH6XYZ", "BL11", 23 },
+        "310202203222333202320323131222022212010300200210332211012203103200011232303030230232310203123030203222003223001312110211232221332020232302132220020332323102011002",
+    },
+    {
+        { "W1AW", "FN31", 0 },
+        "332222021222333022322301333202000010010322200230312213012023123020013212121212210210132203321010221000001223201132130211232003312222210102312000220130321102033020",
+    },
+    {
+        { "VK2ZZZ", "QF56", 60 },
+        "310000001000313220100323311220020032230120020230330011012021123020011212123010212032332223323230003220223221023310112233212221312220210320312022000132103120231000",
+    },
+};
+
+#define WSPR_SYMBOLS    162
+
+static int symbol_tone(const tx_sequence_t *seq, size_t i) {
+    tx_symbol_t sym;
+
+    if (seq->source(seq, i, &sym)) {
+        return -1;
+    }
+    for (int tone = 0; tone < 4; tone++) {
+        if (FREQ_RATIO(tone * 12000, 8192) == sym.freq_offset_uhz) {
+            return tone;
+        }
+    }
+    return -1;
+}
+
+ZTEST(wspr, test_reference_vectors) {
+    for (size_t v = 0; v < ARRAY_SIZE(vectors); v++) {
+        const wspr_payload_t *p = &vectors[v].payload;
+        tx_sequence_t seq = { 0 };
+        char symbols[WSPR_SYMBOLS + 1] = { 0 };
+
+        zassert_ok(generate_wspr_sequence(p, &seq), "%s", p->callsign);
+        zassert_equal(seq.total_symbols, WSPR_SYMBOLS);
+        zassert_not_null(seq.source);
+
+        for (size_t i = 0; i < WSPR_SYMBOLS; i++) {
+            int tone = symbol_tone(&seq, i);
+            zassert_true(tone >= 0, "%s: symbol %zu", p->callsign, i);
+            symbols[i] = '0' + tone;
+        }
+
+        zassert_str_equal(symbols, vectors[v].symbols, "%s %s %d:\n got %s\nwant %s",
+                          p->callsign, p->grid, p->power_dbm, symbols, vectors[v].symbols);
+    }
+}
+
+/* The engine asks for symbols as it goes, and again after a retry, so
+ * any symbol must come out the same in any order */
+ZTEST(wspr, test_any_order) {
+    const struct wspr_vector *v = &vectors[0];
+    tx_sequence_t seq = { 0 };
+
+    zassert_ok(generate_wspr_sequence(&v->payload, &seq));
+    for (size_t n = 0; n < WSPR_SYMBOLS; n++) {
+        size_t i = (n * 61) % WSPR_SYMBOLS;
+        zassert_equal(symbol_tone(&seq, i), v->symbols[i] - '0', "symbol %zu", i);
+    }
+
+    tx_symbol_t sym;
+    zassert_equal(seq.source(&seq, WSPR_SYMBOLS, &sym), -EINVAL);
+}
+
+ZTEST_SUITE(wspr, NULL, NULL, NULL, NULL, NULL);